@@ -0,0 +1,1477 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/access/src/access.c.
+ *
+ * The stock access layer offers every received message to every model in the pool: for each
+ * model it looks up the destination address in the DSM and tests the bit of the returned handle
+ * in the model's subscription list, then searches the model's opcode table. This version keeps
+ * the same API and storage, but dispatches group and virtual address messages through the
+ * address-to-model index of sub_index.h: a binary search over the distinct subscription
+ * addresses yields the subscribed models, and only those are offered the message. Messages to a
+ * unicast address are only offered to the models of the addressed element.
+ *
+ * The index is kept up to date by the application from the Config Server events, see main.c.
+ */
+
+#include "access.h"
+#include "access_config.h"
+#include "access_internal.h"
+#include "access_publish.h"
+#include "access_publish_retransmission.h"
+#include "access_reliable.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "bitfield.h"
+#include "device_state_manager.h"
+#include "mesh_config_entry.h"
+#include "mesh_mem.h"
+#include "mesh_opt_access.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_assert.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_events.h"
+#include "nrf_mesh_utils.h"
+#include "log.h"
+#include "utils.h"
+
+#include "sub_index.h"
+
+/* The subscribed models are returned as a bitmask of model handles. */
+NRF_MESH_STATIC_ASSERT(ACCESS_MODEL_COUNT <= sizeof(sub_index_model_mask_t) * 8);
+
+/** Reserved 1 byte opcode. */
+#define ACCESS_OPCODE_RFU               (0x7F)
+
+/* ********** Static variables ********** */
+
+static access_common_t m_model_pool[ACCESS_MODEL_COUNT];
+static access_element_t m_element_pool[ACCESS_ELEMENT_COUNT];
+static access_subscription_list_t m_subscription_list_pool[ACCESS_SUBSCRIPTION_LIST_COUNT];
+static uint8_t m_default_ttl = ACCESS_DEFAULT_TTL;
+/* Models whose state was loaded from flash since the last access_load_config_apply(). */
+static bool m_model_restored[ACCESS_MODEL_COUNT];
+static nrf_mesh_evt_handler_t m_mesh_evt_handler;
+
+/* ********** Handle validation ********** */
+
+static inline bool model_handle_valid_and_allocated(access_model_handle_t handle)
+{
+    return (handle < ACCESS_MODEL_COUNT &&
+            ACCESS_INTERNAL_STATE_IS_ALLOCATED(m_model_pool[handle].internal_state));
+}
+
+static inline bool element_index_valid(uint16_t element_index)
+{
+    return (element_index < ACCESS_ELEMENT_COUNT);
+}
+
+static inline bool model_has_subscription_list(access_model_handle_t handle)
+{
+    return (m_model_pool[handle].model_info.subscription_pool_index < ACCESS_SUBSCRIPTION_LIST_COUNT);
+}
+
+static inline void model_outdated_set(access_model_handle_t handle)
+{
+    ACCESS_INTERNAL_STATE_OUTDATED_SET(m_model_pool[handle].internal_state);
+}
+
+/* ********** Opcodes ********** */
+
+static bool is_opcode_valid(access_opcode_t opcode)
+{
+    if (opcode.company_id == ACCESS_COMPANY_ID_NONE)
+    {
+        /* SIG opcodes: 1 byte opcodes are 0x00-0x7E, 2 byte opcodes have the top bits 0b10. */
+        return ((opcode.opcode < ACCESS_OPCODE_RFU) ||
+                (opcode.opcode >= 0x8000 && opcode.opcode <= 0xBFFF));
+    }
+    else
+    {
+        /* Vendor opcodes are 6 bits, the top bits 0b11 are added on the air. */
+        return (opcode.opcode <= 0x3F);
+    }
+}
+
+static uint16_t opcode_size_get(access_opcode_t opcode)
+{
+    if (opcode.company_id != ACCESS_COMPANY_ID_NONE)
+    {
+        return 3;
+    }
+    return (opcode.opcode > 0xFF) ? 2 : 1;
+}
+
+static uint16_t opcode_raw_write(access_opcode_t opcode, uint8_t * p_buffer)
+{
+    if (opcode.company_id != ACCESS_COMPANY_ID_NONE)
+    {
+        p_buffer[0] = (uint8_t) (0xC0 | (opcode.opcode & 0x3F));
+        p_buffer[1] = (uint8_t) (opcode.company_id & 0xFF);
+        p_buffer[2] = (uint8_t) (opcode.company_id >> 8);
+        return 3;
+    }
+    else if (opcode.opcode > 0xFF)
+    {
+        p_buffer[0] = (uint8_t) (opcode.opcode >> 8);
+        p_buffer[1] = (uint8_t) (opcode.opcode & 0xFF);
+        return 2;
+    }
+    else
+    {
+        p_buffer[0] = (uint8_t) opcode.opcode;
+        return 1;
+    }
+}
+
+static bool opcode_get(const uint8_t * p_buffer, uint16_t length, access_opcode_t * p_opcode, uint16_t * p_opcode_length)
+{
+    if (length == 0)
+    {
+        return false;
+    }
+
+    switch (p_buffer[0] >> 6)
+    {
+        case 0:
+        case 1:
+            if (p_buffer[0] == ACCESS_OPCODE_RFU)
+            {
+                return false;
+            }
+            p_opcode->opcode = p_buffer[0];
+            p_opcode->company_id = ACCESS_COMPANY_ID_NONE;
+            *p_opcode_length = 1;
+            return true;
+
+        case 2:
+            if (length < 2)
+            {
+                return false;
+            }
+            p_opcode->opcode = (uint16_t) ((p_buffer[0] << 8) | p_buffer[1]);
+            p_opcode->company_id = ACCESS_COMPANY_ID_NONE;
+            *p_opcode_length = 2;
+            return true;
+
+        default:
+            if (length < 3)
+            {
+                return false;
+            }
+            p_opcode->opcode = (uint16_t) (p_buffer[0] & 0x3F);
+            p_opcode->company_id = (uint16_t) (p_buffer[1] | (p_buffer[2] << 8));
+            *p_opcode_length = 3;
+            return true;
+    }
+}
+
+static bool opcode_handler_find(const access_common_t * p_model, access_opcode_t opcode, uint32_t * p_index)
+{
+    for (uint32_t i = 0; i < p_model->opcode_count; ++i)
+    {
+        if (p_model->p_opcode_handlers[i].opcode.opcode == opcode.opcode &&
+            p_model->p_opcode_handlers[i].opcode.company_id == opcode.company_id)
+        {
+            *p_index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool opcode_handlers_valid(const access_opcode_handler_t * p_handlers, uint16_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (!is_opcode_valid(p_handlers[i].opcode) || p_handlers[i].handler == NULL)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ********** Message reception ********** */
+
+static inline bool is_appkey_bound(const access_common_t * p_model, dsm_handle_t appkey_handle)
+{
+    return (appkey_handle < DSM_APP_MAX + DSM_DEVICE_MAX &&
+            bitfield_get(p_model->model_info.application_keys_bitfield, appkey_handle));
+}
+
+/* Offers the message to one model, returns true if it has a handler for the opcode and is bound
+ * to the key the message was encrypted with. */
+static bool model_message_handle(access_model_handle_t handle, const access_message_rx_t * p_message)
+{
+    const access_common_t * p_model = &m_model_pool[handle];
+    uint32_t opcode_index;
+    if (!opcode_handler_find(p_model, p_message->opcode, &opcode_index) ||
+        !is_appkey_bound(p_model, p_message->meta_data.appkey_handle))
+    {
+        return false;
+    }
+
+    __LOG(LOG_SRC_ACCESS, LOG_LEVEL_DBG1, "RX: [aop: 0x%04x] handle %u\n", p_message->opcode.opcode, handle);
+    p_model->p_opcode_handlers[opcode_index].handler(handle, p_message, p_model->p_args);
+    access_reliable_message_rx_cb(handle, p_message, p_model->p_args);
+    return true;
+}
+
+/* The index is keyed on the virtual address hash, so a subscription to another label with the same
+ * hash must not deliver the message. */
+static bool is_subscribed_to_label(access_model_handle_t handle, const nrf_mesh_address_t * p_dst)
+{
+    dsm_handle_t address_handle;
+    if (dsm_address_handle_get(p_dst, &address_handle) != NRF_SUCCESS)
+    {
+        return false;
+    }
+    const access_subscription_list_t * p_list =
+        &m_subscription_list_pool[m_model_pool[handle].model_info.subscription_pool_index];
+    return bitfield_get(p_list->bitfield, address_handle);
+}
+
+static bool subscribed_models_handle(const access_message_rx_t * p_message)
+{
+    bool handled = false;
+    sub_index_model_mask_t models = sub_index_lookup(p_message->meta_data.dst.value);
+    while (models != 0)
+    {
+        access_model_handle_t handle = (access_model_handle_t) __builtin_ctz(models);
+        models &= (sub_index_model_mask_t) (models - 1);
+
+        if (!model_handle_valid_and_allocated(handle) || !model_has_subscription_list(handle))
+        {
+            continue;
+        }
+        if (p_message->meta_data.dst.type == NRF_MESH_ADDRESS_TYPE_VIRTUAL &&
+            !is_subscribed_to_label(handle, &p_message->meta_data.dst))
+        {
+            continue;
+        }
+        handled = model_message_handle(handle, p_message) || handled;
+    }
+    return handled;
+}
+
+static bool element_models_handle(uint16_t element_index, const access_message_rx_t * p_message)
+{
+    bool handled = false;
+    for (access_model_handle_t handle = 0; handle < ACCESS_MODEL_COUNT; ++handle)
+    {
+        if (model_handle_valid_and_allocated(handle) &&
+            m_model_pool[handle].model_info.element_index == element_index)
+        {
+            handled = model_message_handle(handle, p_message) || handled;
+        }
+    }
+    return handled;
+}
+
+static void access_incoming_handle(const access_message_rx_t * p_message)
+{
+    bool handled = false;
+    const nrf_mesh_address_t * p_dst = &p_message->meta_data.dst;
+
+    switch (p_dst->type)
+    {
+        case NRF_MESH_ADDRESS_TYPE_UNICAST:
+        {
+            dsm_local_unicast_address_t local_address;
+            dsm_local_unicast_addresses_get(&local_address);
+            if (p_dst->value >= local_address.address_start &&
+                p_dst->value < local_address.address_start + ACCESS_ELEMENT_COUNT)
+            {
+                handled = element_models_handle(p_dst->value - local_address.address_start, p_message);
+            }
+            break;
+        }
+
+        case NRF_MESH_ADDRESS_TYPE_GROUP:
+            if (p_dst->value >= NRF_MESH_ALL_PROXIES_ADDR)
+            {
+                /* Fixed group addresses are received by the primary element. */
+                handled = element_models_handle(0, p_message);
+            }
+            else
+            {
+                handled = subscribed_models_handle(p_message);
+            }
+            break;
+
+        case NRF_MESH_ADDRESS_TYPE_VIRTUAL:
+            handled = subscribed_models_handle(p_message);
+            break;
+
+        default:
+            break;
+    }
+
+    if (!handled)
+    {
+        __LOG(LOG_SRC_ACCESS, LOG_LEVEL_INFO, "Unhandled message [aop: 0x%04x, dst: 0x%04x]\n",
+              p_message->opcode.opcode, p_dst->value);
+    }
+}
+
+static void mesh_msg_handle(const nrf_mesh_evt_message_t * p_evt)
+{
+    access_opcode_t opcode;
+    uint16_t opcode_length;
+    if (!opcode_get(p_evt->p_buffer, p_evt->length, &opcode, &opcode_length))
+    {
+        return;
+    }
+
+    const access_message_rx_t message =
+    {
+        .opcode = opcode,
+        .p_data = &p_evt->p_buffer[opcode_length],
+        .length = (uint16_t) (p_evt->length - opcode_length),
+        .meta_data =
+        {
+            .src = p_evt->src,
+            .dst = p_evt->dst,
+            .ttl = p_evt->ttl,
+            .appkey_handle = dsm_appkey_handle_get(p_evt->secmat.p_app),
+            .subnet_handle = dsm_subnet_handle_get(p_evt->secmat.p_net),
+            .p_core_metadata = &p_evt->rx_metadata
+        }
+    };
+    access_incoming_handle(&message);
+}
+
+static void mesh_evt_cb(const nrf_mesh_evt_t * p_evt)
+{
+    switch (p_evt->type)
+    {
+        case NRF_MESH_EVT_MESSAGE_RECEIVED:
+            mesh_msg_handle(&p_evt->params.message);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* ********** Message transmission ********** */
+
+static uint8_t model_publish_ttl(const access_common_t * p_model)
+{
+    return (p_model->model_info.publish_ttl == ACCESS_TTL_USE_DEFAULT) ?
+           m_default_ttl : p_model->model_info.publish_ttl;
+}
+
+static uint32_t element_address_get(uint16_t element_index, uint16_t * p_address)
+{
+    dsm_local_unicast_address_t local_address;
+    dsm_local_unicast_addresses_get(&local_address);
+    if (local_address.address_start == NRF_MESH_ADDR_UNASSIGNED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    *p_address = (uint16_t) (local_address.address_start + element_index);
+    return NRF_SUCCESS;
+}
+
+static uint32_t packet_tx(access_model_handle_t handle,
+                          const access_message_tx_t * p_tx_message,
+                          const nrf_mesh_address_t * p_dst,
+                          const nrf_mesh_secmat_t * p_secmat,
+                          uint8_t ttl)
+{
+    const access_common_t * p_model = &m_model_pool[handle];
+    uint16_t length = (uint16_t) (opcode_size_get(p_tx_message->opcode) + p_tx_message->length);
+    if (length > ACCESS_MESSAGE_LENGTH_MAX)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    nrf_mesh_tx_params_t tx_params;
+    memset(&tx_params, 0, sizeof(tx_params));
+    uint32_t status = element_address_get(p_model->model_info.element_index, &tx_params.src);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    uint8_t * p_buffer = mesh_mem_alloc(length);
+    if (p_buffer == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    uint16_t opcode_length = opcode_raw_write(p_tx_message->opcode, p_buffer);
+    if (p_tx_message->length > 0)
+    {
+        memcpy(&p_buffer[opcode_length], p_tx_message->p_buffer, p_tx_message->length);
+    }
+
+    tx_params.dst = *p_dst;
+    tx_params.ttl = ttl;
+    tx_params.force_segmented = p_tx_message->force_segmented;
+    tx_params.transmic_size = p_tx_message->transmic_size;
+    tx_params.p_data = p_buffer;
+    tx_params.data_len = length;
+    tx_params.security_material = *p_secmat;
+    tx_params.tx_token = p_tx_message->access_token;
+
+    status = nrf_mesh_packet_send(&tx_params, NULL);
+    mesh_mem_free(p_buffer);
+    return status;
+}
+
+/* ********** Subscription list helpers ********** */
+
+static void subscription_list_outdated_set(uint16_t index)
+{
+    ACCESS_INTERNAL_STATE_OUTDATED_SET(m_subscription_list_pool[index].internal_state);
+}
+
+static bool subscription_list_is_shared(uint16_t index)
+{
+    uint32_t owners = 0;
+    for (uint32_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        if (model_handle_valid_and_allocated(i) && m_model_pool[i].model_info.subscription_pool_index == index)
+        {
+            owners++;
+        }
+    }
+    return (owners > 1);
+}
+
+/* ********** Persistent storage ********** */
+
+static uint32_t metadata_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    (void) id;
+    const access_flash_metadata_t * p_metadata = p_entry;
+    /* The composition must match the one the stored configuration was made for. */
+    if (p_metadata->element_count != ACCESS_ELEMENT_COUNT ||
+        p_metadata->model_count != ACCESS_MODEL_COUNT ||
+        p_metadata->subscription_list_count != ACCESS_SUBSCRIPTION_LIST_COUNT)
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+    return NRF_SUCCESS;
+}
+
+static void metadata_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    (void) id;
+    access_flash_metadata_t * p_metadata = p_entry;
+    p_metadata->element_count = ACCESS_ELEMENT_COUNT;
+    p_metadata->model_count = ACCESS_MODEL_COUNT;
+    p_metadata->subscription_list_count = ACCESS_SUBSCRIPTION_LIST_COUNT;
+}
+
+static uint32_t subscriptions_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    uint16_t index = (uint16_t) (id.record - MESH_OPT_ACCESS_SUBSCRIPTIONS_RECORD);
+    NRF_MESH_ASSERT(index < ACCESS_SUBSCRIPTION_LIST_COUNT);
+    memcpy(m_subscription_list_pool[index].bitfield, p_entry, sizeof(m_subscription_list_pool[index].bitfield));
+    ACCESS_INTERNAL_STATE_ALLOCATED_SET(m_subscription_list_pool[index].internal_state);
+    return NRF_SUCCESS;
+}
+
+static void subscriptions_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    uint16_t index = (uint16_t) (id.record - MESH_OPT_ACCESS_SUBSCRIPTIONS_RECORD);
+    NRF_MESH_ASSERT(index < ACCESS_SUBSCRIPTION_LIST_COUNT);
+    memcpy(p_entry, m_subscription_list_pool[index].bitfield, sizeof(m_subscription_list_pool[index].bitfield));
+}
+
+static void subscriptions_delete(mesh_config_entry_id_t id)
+{
+    uint16_t index = (uint16_t) (id.record - MESH_OPT_ACCESS_SUBSCRIPTIONS_RECORD);
+    NRF_MESH_ASSERT(index < ACCESS_SUBSCRIPTION_LIST_COUNT);
+    bitfield_clear_all(m_subscription_list_pool[index].bitfield, DSM_ADDR_MAX);
+}
+
+static uint32_t elements_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    uint16_t index = (uint16_t) (id.record - MESH_OPT_ACCESS_ELEMENTS_RECORD);
+    NRF_MESH_ASSERT(index < ACCESS_ELEMENT_COUNT);
+    m_element_pool[index].location = *(const uint16_t *) p_entry;
+    return NRF_SUCCESS;
+}
+
+static void elements_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    uint16_t index = (uint16_t) (id.record - MESH_OPT_ACCESS_ELEMENTS_RECORD);
+    NRF_MESH_ASSERT(index < ACCESS_ELEMENT_COUNT);
+    *(uint16_t *) p_entry = m_element_pool[index].location;
+}
+
+static uint32_t models_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    access_model_handle_t handle = (access_model_handle_t) (id.record - MESH_OPT_ACCESS_MODELS_RECORD);
+    NRF_MESH_ASSERT(handle < ACCESS_MODEL_COUNT);
+    const access_model_state_data_t * p_data = p_entry;
+    access_common_t * p_model = &m_model_pool[handle];
+
+    /* Only restore the state of the model the application added with this handle. */
+    if (!ACCESS_INTERNAL_STATE_IS_ALLOCATED(p_model->internal_state) ||
+        p_model->model_info.model_id.model_id != p_data->model_id.model_id ||
+        p_model->model_info.model_id.company_id != p_data->model_id.company_id ||
+        p_model->model_info.element_index != p_data->element_index)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    p_model->model_info = *p_data;
+    m_model_restored[handle] = true;
+    return NRF_SUCCESS;
+}
+
+static void models_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    access_model_handle_t handle = (access_model_handle_t) (id.record - MESH_OPT_ACCESS_MODELS_RECORD);
+    NRF_MESH_ASSERT(handle < ACCESS_MODEL_COUNT);
+    *(access_model_state_data_t *) p_entry = m_model_pool[handle].model_info;
+}
+
+static uint32_t default_ttl_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    (void) id;
+    uint8_t ttl = *(const uint8_t *) p_entry;
+    if (ttl > NRF_MESH_TTL_MAX || ttl == 1)
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+    m_default_ttl = ttl;
+    return NRF_SUCCESS;
+}
+
+static void default_ttl_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    (void) id;
+    *(uint8_t *) p_entry = m_default_ttl;
+}
+
+MESH_CONFIG_FILE(m_access_file, MESH_OPT_ACCESS_FILE_ID, MESH_CONFIG_STRATEGY_CONTINUOUS);
+
+MESH_CONFIG_ENTRY(m_access_metadata_entry,
+                  MESH_OPT_ACCESS_METADATA_EID,
+                  1,
+                  sizeof(access_flash_metadata_t),
+                  metadata_set,
+                  metadata_get,
+                  NULL,
+                  false);
+
+MESH_CONFIG_ENTRY(m_access_subscriptions_entry,
+                  MESH_OPT_ACCESS_SUBSCRIPTIONS_EID,
+                  ACCESS_SUBSCRIPTION_LIST_COUNT,
+                  sizeof(((access_subscription_list_t *) NULL)->bitfield),
+                  subscriptions_set,
+                  subscriptions_get,
+                  subscriptions_delete,
+                  false);
+
+MESH_CONFIG_ENTRY(m_access_elements_entry,
+                  MESH_OPT_ACCESS_ELEMENTS_EID,
+                  ACCESS_ELEMENT_COUNT,
+                  sizeof(uint16_t),
+                  elements_set,
+                  elements_get,
+                  NULL,
+                  false);
+
+MESH_CONFIG_ENTRY(m_access_models_entry,
+                  MESH_OPT_ACCESS_MODELS_EID,
+                  ACCESS_MODEL_COUNT,
+                  sizeof(access_model_state_data_t),
+                  models_set,
+                  models_get,
+                  NULL,
+                  false);
+
+MESH_CONFIG_ENTRY(m_access_default_ttl_entry,
+                  MESH_OPT_ACCESS_DEFAULT_TTL_EID,
+                  1,
+                  sizeof(uint8_t),
+                  default_ttl_set,
+                  default_ttl_get,
+                  NULL,
+                  true);
+
+/* ********** Public API ********** */
+
+void access_init(void)
+{
+    access_clear();
+    m_mesh_evt_handler.evt_cb = mesh_evt_cb;
+    nrf_mesh_evt_handler_add(&m_mesh_evt_handler);
+    access_publish_init();
+    access_publish_retransmission_init();
+    access_reliable_init();
+}
+
+void access_clear(void)
+{
+    access_reliable_cancel_all();
+    access_publish_clear();
+
+    m_default_ttl = ACCESS_DEFAULT_TTL;
+    memset(m_model_pool, 0, sizeof(m_model_pool));
+    memset(m_element_pool, 0, sizeof(m_element_pool));
+    memset(m_subscription_list_pool, 0, sizeof(m_subscription_list_pool));
+
+    for (uint32_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        m_model_pool[i].model_info.publish_address_handle = DSM_HANDLE_INVALID;
+        m_model_pool[i].model_info.publish_appkey_handle = DSM_HANDLE_INVALID;
+        m_model_pool[i].model_info.element_index = ACCESS_ELEMENT_INDEX_INVALID;
+        m_model_pool[i].model_info.subscription_pool_index = ACCESS_SUBSCRIPTION_LIST_COUNT;
+        m_model_pool[i].model_info.publish_ttl = ACCESS_TTL_USE_DEFAULT;
+    }
+    memset(m_model_restored, 0, sizeof(m_model_restored));
+}
+
+uint32_t access_model_add(const access_model_add_params_t * p_model_params, access_model_handle_t * p_model_handle)
+{
+    if (p_model_params == NULL || p_model_handle == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if ((p_model_params->opcode_count > 0 && p_model_params->p_opcode_handlers == NULL) ||
+        !element_index_valid(p_model_params->element_index))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!opcode_handlers_valid(p_model_params->p_opcode_handlers, p_model_params->opcode_count))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    access_model_handle_t free_handle = ACCESS_HANDLE_INVALID;
+    for (access_model_handle_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        if (!ACCESS_INTERNAL_STATE_IS_ALLOCATED(m_model_pool[i].internal_state))
+        {
+            if (free_handle == ACCESS_HANDLE_INVALID)
+            {
+                free_handle = i;
+            }
+        }
+        else if (m_model_pool[i].model_info.element_index == p_model_params->element_index &&
+                 m_model_pool[i].model_info.model_id.model_id == p_model_params->model_id.model_id &&
+                 m_model_pool[i].model_info.model_id.company_id == p_model_params->model_id.company_id)
+        {
+            *p_model_handle = i;
+            return NRF_ERROR_FORBIDDEN;
+        }
+    }
+    if (free_handle == ACCESS_HANDLE_INVALID)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    access_element_t * p_element = &m_element_pool[p_model_params->element_index];
+    if (p_model_params->model_id.company_id == ACCESS_COMPANY_ID_NONE)
+    {
+        p_element->sig_model_count++;
+    }
+    else
+    {
+        p_element->vendor_model_count++;
+    }
+
+    access_common_t * p_model = &m_model_pool[free_handle];
+    p_model->model_info.model_id = p_model_params->model_id;
+    p_model->model_info.element_index = p_model_params->element_index;
+    p_model->p_opcode_handlers = p_model_params->p_opcode_handlers;
+    p_model->opcode_count = p_model_params->opcode_count;
+    p_model->p_args = p_model_params->p_args;
+    p_model->publication_state.model_handle = free_handle;
+    p_model->publication_state.publish_timeout_cb = p_model_params->publish_timeout_cb;
+    ACCESS_INTERNAL_STATE_ALLOCATED_SET(p_model->internal_state);
+    model_outdated_set(free_handle);
+
+    *p_model_handle = free_handle;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish(access_model_handle_t handle, const access_message_tx_t * p_message)
+{
+    if (p_message == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!is_opcode_valid(p_message->opcode) || (p_message->length > 0 && p_message->p_buffer == NULL))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    const access_common_t * p_model = &m_model_pool[handle];
+    if (p_model->model_info.publish_address_handle == DSM_HANDLE_INVALID ||
+        p_model->model_info.publish_appkey_handle == DSM_HANDLE_INVALID)
+    {
+        /* No publication configured, the message is dropped. */
+        return NRF_SUCCESS;
+    }
+
+    nrf_mesh_address_t dst;
+    nrf_mesh_secmat_t secmat;
+    uint32_t status = dsm_address_get(p_model->model_info.publish_address_handle, &dst);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+    if (p_model->model_info.friendship_credential_flag)
+    {
+        status = dsm_tx_friendship_secmat_get(DSM_HANDLE_INVALID, p_model->model_info.publish_appkey_handle, &secmat);
+    }
+    else
+    {
+        status = dsm_tx_secmat_get(DSM_HANDLE_INVALID, p_model->model_info.publish_appkey_handle, &secmat);
+    }
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    status = packet_tx(handle, p_message, &dst, &secmat, model_publish_ttl(p_model));
+    if (status == NRF_SUCCESS && p_model->model_info.publication_retransmit.count > 0)
+    {
+        access_publish_retransmission_message_add(handle, &p_model->model_info.publication_retransmit, p_message);
+    }
+    return status;
+}
+
+uint32_t access_model_reply(access_model_handle_t handle, const access_message_rx_t * p_message, const access_message_tx_t * p_reply)
+{
+    if (p_message == NULL || p_reply == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!is_opcode_valid(p_reply->opcode) || (p_reply->length > 0 && p_reply->p_buffer == NULL))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    nrf_mesh_secmat_t secmat;
+    uint32_t status = dsm_tx_secmat_get(p_message->meta_data.subnet_handle, p_message->meta_data.appkey_handle, &secmat);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    /* Replies to messages received with TTL 0 are sent with TTL 0, see Mesh Profile 3.7.4.4. */
+    uint8_t ttl = (p_message->meta_data.ttl == 0) ? 0 : model_publish_ttl(&m_model_pool[handle]);
+    return packet_tx(handle, p_reply, &p_message->meta_data.src, &secmat, ttl);
+}
+
+uint32_t access_model_p_args_get(access_model_handle_t handle, void ** pp_args)
+{
+    if (pp_args == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *pp_args = m_model_pool[handle].p_args;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_load_config_apply(void)
+{
+    for (access_model_handle_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        access_common_t * p_model = &m_model_pool[i];
+        if (!ACCESS_INTERNAL_STATE_IS_ALLOCATED(p_model->internal_state))
+        {
+            continue;
+        }
+        if (!m_model_restored[i])
+        {
+            /* The stored configuration was made for another composition. */
+            memset(m_model_restored, 0, sizeof(m_model_restored));
+            return NRF_ERROR_INVALID_DATA;
+        }
+
+        uint16_t list_index = p_model->model_info.subscription_pool_index;
+        if (list_index < ACCESS_SUBSCRIPTION_LIST_COUNT)
+        {
+            ACCESS_INTERNAL_STATE_ALLOCATED_SET(m_subscription_list_pool[list_index].internal_state);
+        }
+
+        if (p_model->model_info.publication_period.step_num != 0 &&
+            p_model->publication_state.publish_timeout_cb != NULL)
+        {
+            access_publish_period_set(&p_model->publication_state,
+                                      (access_publish_resolution_t) p_model->model_info.publication_period.step_res,
+                                      p_model->model_info.publication_period.step_num);
+        }
+        ACCESS_INTERNAL_STATE_OUTDATED_CLR(p_model->internal_state);
+    }
+
+    memset(m_model_restored, 0, sizeof(m_model_restored));
+    return NRF_SUCCESS;
+}
+
+void access_flash_config_store(void)
+{
+    const access_flash_metadata_t metadata =
+    {
+        .element_count = ACCESS_ELEMENT_COUNT,
+        .model_count = ACCESS_MODEL_COUNT,
+        .subscription_list_count = ACCESS_SUBSCRIPTION_LIST_COUNT
+    };
+    NRF_MESH_ERROR_CHECK(mesh_config_entry_set(MESH_OPT_ACCESS_METADATA_EID, &metadata));
+
+    for (uint16_t i = 0; i < ACCESS_SUBSCRIPTION_LIST_COUNT; ++i)
+    {
+        access_subscription_list_t * p_list = &m_subscription_list_pool[i];
+        if (ACCESS_INTERNAL_STATE_IS_OUTDATED(p_list->internal_state))
+        {
+            mesh_config_entry_id_t id = MESH_OPT_ACCESS_SUBSCRIPTIONS_EID;
+            id.record += i;
+            if (ACCESS_INTERNAL_STATE_IS_ALLOCATED(p_list->internal_state))
+            {
+                NRF_MESH_ERROR_CHECK(mesh_config_entry_set(id, p_list->bitfield));
+            }
+            else
+            {
+                (void) mesh_config_entry_delete(id);
+            }
+            ACCESS_INTERNAL_STATE_OUTDATED_CLR(p_list->internal_state);
+        }
+    }
+
+    for (uint16_t i = 0; i < ACCESS_ELEMENT_COUNT; ++i)
+    {
+        if (ACCESS_INTERNAL_STATE_IS_OUTDATED(m_element_pool[i].internal_state))
+        {
+            mesh_config_entry_id_t id = MESH_OPT_ACCESS_ELEMENTS_EID;
+            id.record += i;
+            NRF_MESH_ERROR_CHECK(mesh_config_entry_set(id, &m_element_pool[i].location));
+            ACCESS_INTERNAL_STATE_OUTDATED_CLR(m_element_pool[i].internal_state);
+        }
+    }
+
+    for (access_model_handle_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        if (model_handle_valid_and_allocated(i) &&
+            ACCESS_INTERNAL_STATE_IS_OUTDATED(m_model_pool[i].internal_state))
+        {
+            mesh_config_entry_id_t id = MESH_OPT_ACCESS_MODELS_EID;
+            id.record += i;
+            NRF_MESH_ERROR_CHECK(mesh_config_entry_set(id, &m_model_pool[i].model_info));
+            ACCESS_INTERNAL_STATE_OUTDATED_CLR(m_model_pool[i].internal_state);
+        }
+    }
+}
+
+/* ********** Access configuration API ********** */
+
+uint32_t access_default_ttl_set(uint8_t ttl)
+{
+    if (ttl > NRF_MESH_TTL_MAX || ttl == 1)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    return mesh_config_entry_set(MESH_OPT_ACCESS_DEFAULT_TTL_EID, &ttl);
+}
+
+uint8_t access_default_ttl_get(void)
+{
+    return m_default_ttl;
+}
+
+uint32_t access_model_publish_address_set(access_model_handle_t handle, dsm_handle_t address_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    nrf_mesh_address_t address;
+    if (dsm_address_get(address_handle, &address) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_model_pool[handle].model_info.publish_address_handle = address_handle;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_address_get(access_model_handle_t handle, dsm_handle_t * p_address_handle)
+{
+    if (p_address_handle == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_address_handle = m_model_pool[handle].model_info.publish_address_handle;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publication_stop(access_model_handle_t handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    access_common_t * p_model = &m_model_pool[handle];
+    p_model->model_info.publish_address_handle = DSM_HANDLE_INVALID;
+    p_model->model_info.publish_appkey_handle = DSM_HANDLE_INVALID;
+    p_model->model_info.publication_period.step_num = 0;
+    p_model->model_info.publication_period.step_res = 0;
+    p_model->model_info.publication_retransmit.count = 0;
+    p_model->model_info.publication_retransmit.interval_steps = 0;
+    p_model->model_info.publish_ttl = ACCESS_TTL_USE_DEFAULT;
+    p_model->model_info.friendship_credential_flag = false;
+    access_publish_period_set(&p_model->publication_state, ACCESS_PUBLISH_RESOLUTION_100MS, 0);
+    access_publish_retransmission_message_cancel(handle);
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_retransmit_set(access_model_handle_t handle, access_publish_retransmit_t retransmit_params)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_model_pool[handle].model_info.publication_retransmit = retransmit_params;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_retransmit_get(access_model_handle_t handle, access_publish_retransmit_t * p_retransmit_params)
+{
+    if (p_retransmit_params == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_retransmit_params = m_model_pool[handle].model_info.publication_retransmit;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_application_set(access_model_handle_t handle, dsm_handle_t appkey_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (appkey_handle >= DSM_APP_MAX + DSM_DEVICE_MAX)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_model_pool[handle].model_info.publish_appkey_handle = appkey_handle;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_application_get(access_model_handle_t handle, dsm_handle_t * p_appkey_handle)
+{
+    if (p_appkey_handle == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_appkey_handle = m_model_pool[handle].model_info.publish_appkey_handle;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_friendship_credential_flag_set(access_model_handle_t handle, bool flag)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_model_pool[handle].model_info.friendship_credential_flag = flag;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_friendship_credential_flag_get(access_model_handle_t handle, bool * p_flag)
+{
+    if (p_flag == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_flag = m_model_pool[handle].model_info.friendship_credential_flag;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_period_set(access_model_handle_t handle, access_publish_resolution_t resolution, uint8_t step_number)
+{
+    if (step_number > ACCESS_PUBLISH_PERIOD_STEP_MAX || resolution > ACCESS_PUBLISH_RESOLUTION_MAX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    access_common_t * p_model = &m_model_pool[handle];
+    if (p_model->publication_state.publish_timeout_cb == NULL)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    p_model->model_info.publication_period.step_res = resolution;
+    p_model->model_info.publication_period.step_num = step_number;
+    access_publish_period_set(&p_model->publication_state, resolution, step_number);
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_period_get(access_model_handle_t handle, access_publish_resolution_t * p_resolution, uint8_t * p_step_number)
+{
+    if (p_resolution == NULL || p_step_number == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_resolution = (access_publish_resolution_t) m_model_pool[handle].model_info.publication_period.step_res;
+    *p_step_number = m_model_pool[handle].model_info.publication_period.step_num;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscription_add(access_model_handle_t handle, dsm_handle_t address_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!model_has_subscription_list(handle))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    nrf_mesh_address_t address;
+    if (dsm_address_get(address_handle, &address) != NRF_SUCCESS)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (address.type != NRF_MESH_ADDRESS_TYPE_GROUP && address.type != NRF_MESH_ADDRESS_TYPE_VIRTUAL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    uint16_t list_index = m_model_pool[handle].model_info.subscription_pool_index;
+    bitfield_set(m_subscription_list_pool[list_index].bitfield, address_handle);
+    subscription_list_outdated_set(list_index);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscription_remove(access_model_handle_t handle, dsm_handle_t address_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!model_has_subscription_list(handle))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    uint16_t list_index = m_model_pool[handle].model_info.subscription_pool_index;
+    if (address_handle >= DSM_ADDR_MAX || !bitfield_get(m_subscription_list_pool[list_index].bitfield, address_handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    bitfield_clear(m_subscription_list_pool[list_index].bitfield, address_handle);
+    subscription_list_outdated_set(list_index);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscriptions_get(access_model_handle_t handle, dsm_handle_t * p_address_handles, uint16_t * p_count)
+{
+    if (p_address_handles == NULL || p_count == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!model_has_subscription_list(handle))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    const uint32_t * p_bitfield = m_subscription_list_pool[m_model_pool[handle].model_info.subscription_pool_index].bitfield;
+    uint16_t count = 0;
+    for (dsm_handle_t i = 0; i < DSM_ADDR_MAX; ++i)
+    {
+        if (bitfield_get(p_bitfield, i))
+        {
+            if (count == *p_count)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            p_address_handles[count++] = i;
+        }
+    }
+    *p_count = count;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_application_bind(access_model_handle_t handle, dsm_handle_t appkey_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (appkey_handle >= DSM_APP_MAX + DSM_DEVICE_MAX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    bitfield_set(m_model_pool[handle].model_info.application_keys_bitfield, appkey_handle);
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_application_unbind(access_model_handle_t handle, dsm_handle_t appkey_handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (appkey_handle >= DSM_APP_MAX + DSM_DEVICE_MAX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    bitfield_clear(m_model_pool[handle].model_info.application_keys_bitfield, appkey_handle);
+    if (m_model_pool[handle].model_info.publish_appkey_handle == appkey_handle)
+    {
+        m_model_pool[handle].model_info.publish_appkey_handle = DSM_HANDLE_INVALID;
+    }
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_applications_get(access_model_handle_t handle, dsm_handle_t * p_appkey_handles, uint16_t * p_count)
+{
+    if (p_appkey_handles == NULL || p_count == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    uint16_t count = 0;
+    for (dsm_handle_t i = 0; i < DSM_APP_MAX; ++i)
+    {
+        if (bitfield_get(m_model_pool[handle].model_info.application_keys_bitfield, i))
+        {
+            if (count == *p_count)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            p_appkey_handles[count++] = i;
+        }
+    }
+    *p_count = count;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_ttl_set(access_model_handle_t handle, uint8_t ttl)
+{
+    if (ttl > NRF_MESH_TTL_MAX && ttl != ACCESS_TTL_USE_DEFAULT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_model_pool[handle].model_info.publish_ttl = ttl;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_ttl_get(access_model_handle_t handle, uint8_t * p_ttl)
+{
+    if (p_ttl == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_ttl = m_model_pool[handle].model_info.publish_ttl;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_id_get(access_model_handle_t handle, access_model_id_t * p_model_id)
+{
+    if (p_model_id == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_model_id = m_model_pool[handle].model_info.model_id;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_handle_get(uint16_t element_index, access_model_id_t model_id, access_model_handle_t * p_handle)
+{
+    if (p_handle == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    for (access_model_handle_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        if (model_handle_valid_and_allocated(i) &&
+            m_model_pool[i].model_info.element_index == element_index &&
+            m_model_pool[i].model_info.model_id.model_id == model_id.model_id &&
+            m_model_pool[i].model_info.model_id.company_id == model_id.company_id)
+        {
+            *p_handle = i;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NOT_FOUND;
+}
+
+uint32_t access_element_location_set(uint16_t element_index, uint16_t location)
+{
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    m_element_pool[element_index].location = location;
+    ACCESS_INTERNAL_STATE_OUTDATED_SET(m_element_pool[element_index].internal_state);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_element_location_get(uint16_t element_index, uint16_t * p_location)
+{
+    if (p_location == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_location = m_element_pool[element_index].location;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_element_sig_model_count_get(uint16_t element_index, uint8_t * p_sig_model_count)
+{
+    if (p_sig_model_count == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_sig_model_count = m_element_pool[element_index].sig_model_count;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_element_vendor_model_count_get(uint16_t element_index, uint8_t * p_vendor_model_count)
+{
+    if (p_vendor_model_count == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_vendor_model_count = m_element_pool[element_index].vendor_model_count;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_element_models_get(uint16_t element_index, access_model_handle_t * p_models, uint16_t * p_count)
+{
+    if (p_models == NULL || p_count == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!element_index_valid(element_index))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    uint16_t count = 0;
+    for (access_model_handle_t i = 0; i < ACCESS_MODEL_COUNT; ++i)
+    {
+        if (model_handle_valid_and_allocated(i) && m_model_pool[i].model_info.element_index == element_index)
+        {
+            if (count == *p_count)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            p_models[count++] = i;
+        }
+    }
+    *p_count = count;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_element_index_get(access_model_handle_t handle, uint16_t * p_element_index)
+{
+    if (p_element_index == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_element_index = m_model_pool[handle].model_info.element_index;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscription_list_alloc(access_model_handle_t handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (model_has_subscription_list(handle))
+    {
+        /* Already allocated, also after a restore from flash. */
+        return NRF_SUCCESS;
+    }
+
+    for (uint16_t i = 0; i < ACCESS_SUBSCRIPTION_LIST_COUNT; ++i)
+    {
+        if (!ACCESS_INTERNAL_STATE_IS_ALLOCATED(m_subscription_list_pool[i].internal_state))
+        {
+            ACCESS_INTERNAL_STATE_ALLOCATED_SET(m_subscription_list_pool[i].internal_state);
+            bitfield_clear_all(m_subscription_list_pool[i].bitfield, DSM_ADDR_MAX);
+            subscription_list_outdated_set(i);
+            m_model_pool[handle].model_info.subscription_pool_index = i;
+            model_outdated_set(handle);
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+uint32_t access_model_subscription_lists_share(access_model_handle_t owner, access_model_handle_t other)
+{
+    if (!model_handle_valid_and_allocated(owner) || !model_handle_valid_and_allocated(other))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (owner == other)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!model_has_subscription_list(owner))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    uint16_t other_index = m_model_pool[other].model_info.subscription_pool_index;
+    if (other_index < ACCESS_SUBSCRIPTION_LIST_COUNT && other_index != m_model_pool[owner].model_info.subscription_pool_index)
+    {
+        if (!subscription_list_is_shared(other_index))
+        {
+            m_subscription_list_pool[other_index].internal_state = 0;
+            subscription_list_outdated_set(other_index);
+        }
+    }
+    m_model_pool[other].model_info.subscription_pool_index = m_model_pool[owner].model_info.subscription_pool_index;
+    model_outdated_set(other);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscription_list_dealloc(access_model_handle_t handle)
+{
+    if (!model_handle_valid_and_allocated(handle))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (!model_has_subscription_list(handle))
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    uint16_t index = m_model_pool[handle].model_info.subscription_pool_index;
+    if (subscription_list_is_shared(index))
+    {
+        return NRF_ERROR_FORBIDDEN;
+    }
+    m_subscription_list_pool[index].internal_state = 0;
+    bitfield_clear_all(m_subscription_list_pool[index].bitfield, DSM_ADDR_MAX);
+    subscription_list_outdated_set(index);
+    m_model_pool[handle].model_info.subscription_pool_index = ACCESS_SUBSCRIPTION_LIST_COUNT;
+    model_outdated_set(handle);
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,340 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/core/src/ccm_soft.c, see ccm_backend.h.
+ *
+ * AES-CCM as specified in RFC 3610 with a 13 byte nonce (L = 2), as used by the mesh.
+ */
+
+#include "ccm_soft.h"
+#include "ccm_backend.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "aes.h"
+#include "nrf_error.h"
+#include "nrf_mesh_assert.h"
+#include "nrf_soc.h"
+
+/** Size of the length field in the CCM blocks. */
+#define CCM_LENGTH_FIELD_SIZE   (2)
+/** Size of the nonce. */
+#define CCM_NONCE_SIZE          (13)
+/** Keystream blocks computed with one SoftDevice call. */
+#define CCM_BATCH_BLOCKS        (8)
+
+static ccm_backend_t m_backend = CCM_BACKEND_BATCHED;
+
+static inline void block_xor(uint8_t * p_dst, const uint8_t * p_src, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        p_dst[i] ^= p_src[i];
+    }
+}
+
+/* Counter block A_i: flags, nonce, counter. */
+static void counter_block_make(uint8_t * p_block, const uint8_t * p_nonce, uint16_t counter)
+{
+    p_block[0] = CCM_LENGTH_FIELD_SIZE - 1;
+    memcpy(&p_block[1], p_nonce, CCM_NONCE_SIZE);
+    p_block[14] = (uint8_t) (counter >> 8);
+    p_block[15] = (uint8_t) counter;
+}
+
+/* CBC-MAC over B_0, the additional data and the message. These blocks depend on each other and
+ * are always computed one at a time. */
+static void cbc_mac(const ccm_soft_data_t * p_data, const uint8_t * p_m, uint8_t * p_tag)
+{
+    uint8_t block[NRF_MESH_KEY_SIZE];
+
+    block[0] = ((p_data->a_len > 0) ? 0x40 : 0) |
+               (((p_data->mic_len - 2) / 2) << 3) |
+               (CCM_LENGTH_FIELD_SIZE - 1);
+    memcpy(&block[1], p_data->p_nonce, CCM_NONCE_SIZE);
+    block[14] = (uint8_t) (p_data->m_len >> 8);
+    block[15] = (uint8_t) p_data->m_len;
+    aes_encrypt(p_data->p_key, block, p_tag);
+
+    if (p_data->a_len > 0)
+    {
+        /* The first additional data block starts with the 2 byte length. */
+        uint32_t offset = 2;
+        uint32_t a_done = 0;
+        memset(block, 0, sizeof(block));
+        block[0] = (uint8_t) (p_data->a_len >> 8);
+        block[1] = (uint8_t) p_data->a_len;
+        while (a_done < p_data->a_len)
+        {
+            uint32_t chunk = NRF_MESH_KEY_SIZE - offset;
+            if (chunk > p_data->a_len - a_done)
+            {
+                chunk = p_data->a_len - a_done;
+            }
+            memcpy(&block[offset], &p_data->p_a[a_done], chunk);
+            a_done += chunk;
+
+            block_xor(block, p_tag, NRF_MESH_KEY_SIZE);
+            aes_encrypt(p_data->p_key, block, p_tag);
+            memset(block, 0, sizeof(block));
+            offset = 0;
+        }
+    }
+
+    for (uint32_t done = 0; done < p_data->m_len; done += NRF_MESH_KEY_SIZE)
+    {
+        uint32_t chunk = p_data->m_len - done;
+        if (chunk > NRF_MESH_KEY_SIZE)
+        {
+            chunk = NRF_MESH_KEY_SIZE;
+        }
+        memcpy(block, p_tag, NRF_MESH_KEY_SIZE);
+        block_xor(block, &p_m[done], chunk);
+        aes_encrypt(p_data->p_key, block, p_tag);
+    }
+}
+
+/* Keystream S_first..S_first+count-1 in one SoftDevice call. */
+static bool keystream_batch(const ccm_soft_data_t * p_data, uint16_t first, uint32_t count,
+                            uint8_t p_stream[][NRF_MESH_KEY_SIZE])
+{
+    uint8_t counters[CCM_BATCH_BLOCKS][NRF_MESH_KEY_SIZE];
+    nrf_ecb_hal_data_block_t blocks[CCM_BATCH_BLOCKS];
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        counter_block_make(counters[i], p_data->p_nonce, (uint16_t) (first + i));
+        blocks[i].p_key = (const soc_ecb_key_t *) p_data->p_key;
+        blocks[i].p_cleartext = (const soc_ecb_cleartext_t *) counters[i];
+        blocks[i].p_ciphertext = (soc_ecb_ciphertext_t *) p_stream[i];
+    }
+    return (sd_ecb_blocks_encrypt((uint8_t) count, blocks) == NRF_SUCCESS);
+}
+
+static void keystream_soft(const ccm_soft_data_t * p_data, uint16_t first, uint32_t count,
+                           uint8_t p_stream[][NRF_MESH_KEY_SIZE])
+{
+    uint8_t counter[NRF_MESH_KEY_SIZE];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        counter_block_make(counter, p_data->p_nonce, (uint16_t) (first + i));
+        aes_encrypt(p_data->p_key, counter, p_stream[i]);
+    }
+}
+
+/* CTR encryption of the message from p_in to p_data->p_out, and the MIC from the tag. */
+static void ctr_crypt(const ccm_soft_data_t * p_data, const uint8_t * p_in, const uint8_t * p_tag, uint8_t * p_mic)
+{
+    uint8_t stream[CCM_BATCH_BLOCKS][NRF_MESH_KEY_SIZE];
+    /* Block 0 of the keystream encrypts the MIC, the message starts at block 1. */
+    uint32_t total = 1 + (p_data->m_len + NRF_MESH_KEY_SIZE - 1) / NRF_MESH_KEY_SIZE;
+    uint32_t done = 0;
+
+    for (uint32_t first = 0; first < total; first += CCM_BATCH_BLOCKS)
+    {
+        uint32_t count = total - first;
+        if (count > CCM_BATCH_BLOCKS)
+        {
+            count = CCM_BATCH_BLOCKS;
+        }
+
+        if (m_backend != CCM_BACKEND_BATCHED || !keystream_batch(p_data, (uint16_t) first, count, stream))
+        {
+            keystream_soft(p_data, (uint16_t) first, count, stream);
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (first + i == 0)
+            {
+                memcpy(p_mic, p_tag, p_data->mic_len);
+                block_xor(p_mic, stream[i], p_data->mic_len);
+                continue;
+            }
+
+            uint32_t chunk = p_data->m_len - done;
+            if (chunk > NRF_MESH_KEY_SIZE)
+            {
+                chunk = NRF_MESH_KEY_SIZE;
+            }
+            for (uint32_t j = 0; j < chunk; ++j)
+            {
+                p_data->p_out[done + j] = p_in[done + j] ^ stream[i][j];
+            }
+            done += chunk;
+        }
+    }
+}
+
+void ccm_soft_encrypt(ccm_soft_data_t * p_data)
+{
+    NRF_MESH_ASSERT(p_data->mic_len >= 4 && p_data->mic_len <= 16 && (p_data->mic_len & 1) == 0);
+
+    uint8_t tag[NRF_MESH_KEY_SIZE];
+    /* The tag is computed before the output may overwrite the input. */
+    cbc_mac(p_data, p_data->p_m, tag);
+    ctr_crypt(p_data, p_data->p_m, tag, p_data->p_mic);
+}
+
+void ccm_soft_decrypt(ccm_soft_data_t * p_data, bool * p_mic_passed)
+{
+    NRF_MESH_ASSERT(p_data->mic_len >= 4 && p_data->mic_len <= 16 && (p_data->mic_len & 1) == 0);
+
+    uint8_t tag[NRF_MESH_KEY_SIZE];
+    uint8_t mic[NRF_MESH_KEY_SIZE];
+    uint8_t zero_tag[NRF_MESH_KEY_SIZE] = {0};
+
+    /* Decrypt first, then authenticate the plaintext. The received MIC decrypts to the tag. */
+    ctr_crypt(p_data, p_data->p_m, zero_tag, mic);
+    block_xor(mic, p_data->p_mic, p_data->mic_len);
+    cbc_mac(p_data, p_data->p_out, tag);
+
+    uint8_t diff = 0;
+    for (uint32_t i = 0; i < p_data->mic_len; ++i)
+    {
+        diff |= (uint8_t) (tag[i] ^ mic[i]);
+    }
+    *p_mic_passed = (diff == 0);
+}
+
+void ccm_backend_set(ccm_backend_t backend)
+{
+    m_backend = backend;
+}
+
+ccm_backend_t ccm_backend_get(void)
+{
+    return m_backend;
+}
+
+#if CCM_BACKEND_SELFTEST_ENABLED
+
+typedef struct
+{
+    uint8_t key[NRF_MESH_KEY_SIZE];
+    uint8_t nonce[CCM_NONCE_SIZE];
+    uint8_t a[8];
+    uint8_t a_len;
+    uint8_t m[23];
+    uint8_t m_len;
+    uint8_t c[23];
+    uint8_t mic[8];
+    uint8_t mic_len;
+} ccm_vector_t;
+
+static const ccm_vector_t m_vectors[] =
+{
+    /* RFC 3610, packet vector #1. */
+    {
+        .key = {0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF},
+        .nonce = {0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5},
+        .a = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07},
+        .a_len = 8,
+        .m = {0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+              0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E},
+        .m_len = 23,
+        .c = {0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2, 0xF0, 0x66, 0xD0, 0xC2, 0xC0, 0xF9, 0x89, 0x80,
+              0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84},
+        .mic = {0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0},
+        .mic_len = 8,
+    },
+    /* Network PDU layout: network nonce, no additional data, 32-bit NetMIC. */
+    {
+        .key = {0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF},
+        .nonce = {0x00, 0x04, 0x00, 0x00, 0x01, 0x12, 0x01, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78},
+        .a_len = 0,
+        .m = {0xFF, 0xFD, 0x03, 0x48, 0x02, 0x01, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06},
+        .m_len = 13,
+        .c = {0xD6, 0xF5, 0x6A, 0xB7, 0xE3, 0xA9, 0xBF, 0xBA, 0x79, 0x14, 0x36, 0x25, 0x1B},
+        .mic = {0x1C, 0x2F, 0xBA, 0x64},
+        .mic_len = 4,
+    },
+};
+
+bool ccm_backend_selftest(void)
+{
+    for (uint32_t i = 0; i < sizeof(m_vectors) / sizeof(m_vectors[0]); ++i)
+    {
+        const ccm_vector_t * p_vector = &m_vectors[i];
+        uint8_t out[sizeof(p_vector->m)];
+        uint8_t mic[sizeof(p_vector->mic)];
+        bool mic_passed = false;
+
+        ccm_soft_data_t data =
+        {
+            .p_key = p_vector->key,
+            .p_nonce = p_vector->nonce,
+            .p_m = p_vector->m,
+            .m_len = p_vector->m_len,
+            .p_a = p_vector->a,
+            .a_len = p_vector->a_len,
+            .p_out = out,
+            .p_mic = mic,
+            .mic_len = p_vector->mic_len
+        };
+        ccm_soft_encrypt(&data);
+        if (memcmp(out, p_vector->c, p_vector->m_len) != 0 ||
+            memcmp(mic, p_vector->mic, p_vector->mic_len) != 0)
+        {
+            return false;
+        }
+
+        data.p_m = p_vector->c;
+        data.p_mic = (uint8_t *) p_vector->mic;
+        ccm_soft_decrypt(&data, &mic_passed);
+        if (!mic_passed || memcmp(out, p_vector->m, p_vector->m_len) != 0)
+        {
+            return false;
+        }
+
+        /* A corrupted MIC must be rejected. */
+        memcpy(mic, p_vector->mic, p_vector->mic_len);
+        mic[0] ^= 0x01;
+        data.p_mic = mic;
+        ccm_soft_decrypt(&data, &mic_passed);
+        if (mic_passed)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif /* CCM_BACKEND_SELFTEST_ENABLED */
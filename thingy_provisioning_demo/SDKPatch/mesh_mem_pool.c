@@ -0,0 +1,284 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/core/src/mesh_mem_stdlib.c, see mesh_mem_pool.h.
+ */
+
+#include "mesh_mem.h"
+#include "mesh_mem_pool.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf_balloc.h"
+#include "nrf_mesh_assert.h"
+#include "toolchain.h"
+#include "utils.h"
+#include "diag_model.h"
+#if MESH_MEM_POOL_TRACE_ENABLED
+#include "log.h"
+#endif
+
+NRF_BALLOC_DEF(m_pool_small, MESH_MEM_POOL_SMALL_SIZE, MESH_MEM_POOL_SMALL_COUNT);
+NRF_BALLOC_DEF(m_pool_medium, MESH_MEM_POOL_MEDIUM_SIZE, MESH_MEM_POOL_MEDIUM_COUNT);
+NRF_BALLOC_DEF(m_pool_large, MESH_MEM_POOL_LARGE_SIZE, MESH_MEM_POOL_LARGE_COUNT);
+
+/* Block size of the donated region class, word aligned so the free list links stay aligned. */
+#define REGION_BLOCK_SIZE   ((MESH_MEM_POOL_LARGE_SIZE + 3) & ~3u)
+
+typedef struct
+{
+    /* Backing pool, or NULL for the donated region class. */
+    const nrf_balloc_t * p_pool;
+    uint16_t block_size;
+    uint16_t block_count;
+    uint16_t in_use;
+    uint16_t hwm;
+    uint16_t request_max;
+    diag_counter_t hwm_counter;
+    const uint8_t * p_begin;
+    const uint8_t * p_end;
+} size_class_t;
+
+/* Ordered by block size, the donated region class is tried last. */
+static size_class_t m_classes[MESH_MEM_POOL_CLASS_COUNT] =
+{
+    {.p_pool = &m_pool_small,  .block_size = MESH_MEM_POOL_SMALL_SIZE,  .block_count = MESH_MEM_POOL_SMALL_COUNT,
+     .hwm_counter = DIAG_COUNTER_MEM_SMALL_HWM},
+    {.p_pool = &m_pool_medium, .block_size = MESH_MEM_POOL_MEDIUM_SIZE, .block_count = MESH_MEM_POOL_MEDIUM_COUNT,
+     .hwm_counter = DIAG_COUNTER_MEM_MEDIUM_HWM},
+    {.p_pool = &m_pool_large,  .block_size = MESH_MEM_POOL_LARGE_SIZE,  .block_count = MESH_MEM_POOL_LARGE_COUNT,
+     .hwm_counter = DIAG_COUNTER_MEM_LARGE_HWM},
+    {.p_pool = NULL,           .block_size = REGION_BLOCK_SIZE,         .block_count = 0,
+     .hwm_counter = DIAG_COUNTER_MEM_REGION_HWM},
+};
+
+/* Free list of the donated region class, linked through the first word of each free block. */
+static void * mp_region_free;
+static uint32_t m_failures;
+static uint32_t m_bytes_in_use;
+static uint16_t m_size_histogram[MESH_MEM_POOL_SIZE_BUCKET_COUNT];
+
+static void size_histogram_add(size_t size)
+{
+    uint32_t bucket = (size + MESH_MEM_POOL_SEGMENT_SIZE - 1) / MESH_MEM_POOL_SEGMENT_SIZE;
+    if (bucket > MESH_MEM_POOL_SEGMENTS_MAX)
+    {
+        bucket = MESH_MEM_POOL_SEGMENTS_MAX + 1;
+    }
+    if (m_size_histogram[bucket] < UINT16_MAX)
+    {
+        m_size_histogram[bucket]++;
+    }
+}
+
+static void * class_alloc(size_class_t * p_class)
+{
+    if (p_class->p_pool != NULL)
+    {
+        return nrf_balloc_alloc(p_class->p_pool);
+    }
+
+    void * ptr = mp_region_free;
+    if (ptr != NULL)
+    {
+        mp_region_free = *(void **) ptr;
+    }
+    return ptr;
+}
+
+static void class_free(size_class_t * p_class, void * ptr)
+{
+    if (p_class->p_pool != NULL)
+    {
+        nrf_balloc_free(p_class->p_pool, ptr);
+    }
+    else
+    {
+        *(void **) ptr = mp_region_free;
+        mp_region_free = ptr;
+    }
+}
+
+void mesh_mem_init(void)
+{
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        size_class_t * p_class = &m_classes[i];
+        if (p_class->p_pool != NULL)
+        {
+            NRF_MESH_ERROR_CHECK(nrf_balloc_init(p_class->p_pool));
+            p_class->p_begin = p_class->p_pool->p_memory_begin;
+            p_class->p_end = p_class->p_begin + (uint32_t) p_class->p_pool->block_size * p_class->block_count;
+        }
+        p_class->in_use = 0;
+        p_class->hwm = 0;
+        p_class->request_max = 0;
+    }
+    memset(m_size_histogram, 0, sizeof(m_size_histogram));
+}
+
+void mesh_mem_pool_region_add(void * p_region, uint32_t size)
+{
+    size_class_t * p_class = &m_classes[MESH_MEM_POOL_CLASS_REGION];
+    /* Only one region can be donated. */
+    NRF_MESH_ASSERT(p_class->block_count == 0);
+    NRF_MESH_ASSERT(IS_WORD_ALIGNED(p_region));
+
+    uint32_t count = size / REGION_BLOCK_SIZE;
+    if (count == 0)
+    {
+        return;
+    }
+
+    uint8_t * p_block = p_region;
+    for (uint32_t i = 0; i < count; ++i, p_block += REGION_BLOCK_SIZE)
+    {
+        *(void **) p_block = (i + 1 < count) ? (p_block + REGION_BLOCK_SIZE) : NULL;
+    }
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    mp_region_free = p_region;
+    p_class->p_begin = p_region;
+    p_class->p_end = p_block;
+    p_class->block_count = count;
+    _ENABLE_IRQS(was_masked);
+}
+
+void * mesh_mem_alloc(size_t size)
+{
+    void * ptr = NULL;
+    uint32_t was_masked;
+
+    _DISABLE_IRQS(was_masked);
+    size_histogram_add(size);
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT && ptr == NULL; ++i)
+    {
+        size_class_t * p_class = &m_classes[i];
+        if (size > p_class->block_size)
+        {
+            continue;
+        }
+
+        ptr = class_alloc(p_class);
+        if (ptr != NULL)
+        {
+            p_class->in_use++;
+            if (p_class->in_use > p_class->hwm)
+            {
+                p_class->hwm = p_class->in_use;
+                diag_counter_max(p_class->hwm_counter, p_class->hwm);
+            }
+            if (size > p_class->request_max)
+            {
+                p_class->request_max = (uint16_t) size;
+            }
+            m_bytes_in_use += p_class->block_size;
+            diag_counter_max(DIAG_COUNTER_MEM_HWM, m_bytes_in_use);
+        }
+    }
+
+    if (ptr == NULL)
+    {
+        m_failures++;
+        diag_counter_add(DIAG_COUNTER_MEM_ALLOC_FAILURES, 1);
+    }
+    _ENABLE_IRQS(was_masked);
+
+#if MESH_MEM_POOL_TRACE_ENABLED
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "mem a %08x %u\n", (uint32_t) ptr, (uint32_t) size);
+#endif
+    return ptr;
+}
+
+void mesh_mem_free(void * ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+#if MESH_MEM_POOL_TRACE_ENABLED
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "mem f %08x\n", (uint32_t) ptr);
+#endif
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        size_class_t * p_class = &m_classes[i];
+        if ((const uint8_t *) ptr >= p_class->p_begin && (const uint8_t *) ptr < p_class->p_end)
+        {
+            class_free(p_class, ptr);
+            p_class->in_use--;
+            m_bytes_in_use -= p_class->block_size;
+            _ENABLE_IRQS(was_masked);
+            return;
+        }
+    }
+    _ENABLE_IRQS(was_masked);
+
+    /* Not a block from any of the pools. */
+    NRF_MESH_ASSERT(false);
+}
+
+void mesh_mem_pool_stats_get(mesh_mem_pool_class_t size_class, mesh_mem_pool_stats_t * p_stats)
+{
+    NRF_MESH_ASSERT(size_class < MESH_MEM_POOL_CLASS_COUNT);
+    p_stats->block_size = m_classes[size_class].block_size;
+    p_stats->block_count = m_classes[size_class].block_count;
+    p_stats->in_use = m_classes[size_class].in_use;
+    p_stats->hwm = m_classes[size_class].hwm;
+    p_stats->request_max = m_classes[size_class].request_max;
+}
+
+void mesh_mem_pool_size_histogram_get(uint16_t * p_counts)
+{
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    memcpy(p_counts, m_size_histogram, sizeof(m_size_histogram));
+    _ENABLE_IRQS(was_masked);
+}
+
+uint32_t mesh_mem_pool_failures_get(void)
+{
+    return m_failures;
+}
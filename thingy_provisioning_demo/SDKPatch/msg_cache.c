@@ -0,0 +1,213 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/core/src/msg_cache.c.
+ *
+ * The stock cache is a small ring of (SRC, SEQ) pairs that is scanned linearly for every received
+ * network PDU. This version keeps the same API, sizes the ring for the expected packet rate and
+ * indexes it with a chained hash table on (SRC, SEQ), so the cost of a duplicate check does not
+ * grow with the cache size. The ring is kept in arrival order and an entry is only evicted, oldest
+ * first, to make room for a new one: a late copy of a flooded PDU is recognised for as long as its
+ * entry is in the ring, however old it is. An eviction counts as a capacity eviction when the
+ * entry is younger than MSG_CACHE_MAX_AGE_MS, which means the cache is too small for the packet
+ * rate.
+ */
+
+#include "msg_cache.h"
+#include "msg_cache_stats.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_mesh_config_core.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_assert.h"
+#include "timer.h"
+#include "diag_model.h"
+
+#define MSG_CACHE_HASH_SIZE (1u << MSG_CACHE_HASH_BITS)
+#define MSG_CACHE_HASH_MASK (MSG_CACHE_HASH_SIZE - 1)
+/** Terminates a hash chain. */
+#define MSG_CACHE_INDEX_NONE (0xFFFF)
+
+/** Entry timestamps are kept in units of 2^16 us (about 65 ms) in 8 bits. */
+#define MSG_CACHE_TIME_SHIFT (16)
+#define MSG_CACHE_TIME_MASK  (0xFF)
+#define MSG_CACHE_MAX_AGE    ((MSG_CACHE_MAX_AGE_MS * 1000ull) >> MSG_CACHE_TIME_SHIFT)
+#define MSG_CACHE_MAX_AGE_US (MSG_CACHE_MAX_AGE_MS * 1000ull)
+
+NRF_MESH_STATIC_ASSERT(MSG_CACHE_ENTRY_COUNT < MSG_CACHE_INDEX_NONE);
+NRF_MESH_STATIC_ASSERT(MSG_CACHE_HASH_SIZE >= MSG_CACHE_ENTRY_COUNT);
+/* The 8-bit timestamps must not wrap within the maximum age. */
+NRF_MESH_STATIC_ASSERT(MSG_CACHE_MAX_AGE < MSG_CACHE_TIME_MASK / 2);
+
+typedef struct
+{
+    uint16_t src;
+    /* Next entry in the same hash chain. */
+    uint16_t next;
+    /* 24-bit sequence number and 8-bit arrival time. */
+    uint32_t seq : 24;
+    uint32_t time : 8;
+} msg_cache_entry_t;
+
+static msg_cache_entry_t m_entries[MSG_CACHE_ENTRY_COUNT];
+static uint16_t m_buckets[MSG_CACHE_HASH_SIZE];
+/* The ring holds m_count entries starting at the oldest one, m_oldest. The first m_aged of them
+ * are known to be older than the maximum age. */
+static uint32_t m_oldest;
+static uint32_t m_count;
+static uint32_t m_aged;
+static timestamp_t m_last_add;
+static msg_cache_stats_t m_stats;
+
+static inline uint32_t hash(uint16_t src, uint32_t seq)
+{
+    return ((seq * 2654435761u) ^ ((uint32_t) src * 40503u)) >> (32 - MSG_CACHE_HASH_BITS);
+}
+
+static inline uint32_t time_units(timestamp_t time_us)
+{
+    return (time_us >> MSG_CACHE_TIME_SHIFT) & MSG_CACHE_TIME_MASK;
+}
+
+static inline uint32_t entry_age(const msg_cache_entry_t * p_entry, uint32_t now)
+{
+    return (now - p_entry->time) & MSG_CACHE_TIME_MASK;
+}
+
+static void oldest_evict(void)
+{
+    msg_cache_entry_t * p_entry = &m_entries[m_oldest];
+    uint16_t * p_link = &m_buckets[hash(p_entry->src, p_entry->seq)];
+    while (*p_link != m_oldest)
+    {
+        NRF_MESH_ASSERT(*p_link != MSG_CACHE_INDEX_NONE);
+        p_link = &m_entries[*p_link].next;
+    }
+    *p_link = p_entry->next;
+
+    m_oldest = (m_oldest + 1) % MSG_CACHE_ENTRY_COUNT;
+    m_count--;
+}
+
+/* Counts the entries that reached the maximum age since the last insertion. The 8-bit times of
+ * the entries past m_aged are at most two maximum ages old here, so they have not wrapped. */
+static void aged_mark(timestamp_t now_us, uint32_t now)
+{
+    if (now_us - m_last_add > MSG_CACHE_MAX_AGE_US)
+    {
+        m_aged = m_count;
+    }
+    while (m_aged < m_count &&
+           entry_age(&m_entries[(m_oldest + m_aged) % MSG_CACHE_ENTRY_COUNT], now) > MSG_CACHE_MAX_AGE)
+    {
+        m_aged++;
+    }
+    m_last_add = now_us;
+}
+
+void msg_cache_init(void)
+{
+    msg_cache_clear();
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool msg_cache_entry_exists(uint16_t src_addr, uint32_t sequence_number)
+{
+    m_stats.lookups++;
+
+    for (uint16_t i = m_buckets[hash(src_addr, sequence_number)]; i != MSG_CACHE_INDEX_NONE; i = m_entries[i].next)
+    {
+        const msg_cache_entry_t * p_entry = &m_entries[i];
+        if (p_entry->src == src_addr && p_entry->seq == sequence_number)
+        {
+            m_stats.hits++;
+            diag_counter_add(DIAG_COUNTER_MSG_CACHE_HITS, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void msg_cache_entry_add(uint16_t src, uint32_t seq)
+{
+    timestamp_t now_us = timer_now();
+    uint32_t now = time_units(now_us);
+    aged_mark(now_us, now);
+
+    if (m_count == MSG_CACHE_ENTRY_COUNT)
+    {
+        oldest_evict();
+        if (m_aged > 0)
+        {
+            m_aged--;
+            m_stats.age_evictions++;
+        }
+        else
+        {
+            m_stats.capacity_evictions++;
+            diag_counter_add(DIAG_COUNTER_MSG_CACHE_CAPACITY_EVICTIONS, 1);
+        }
+    }
+
+    uint32_t index = (m_oldest + m_count) % MSG_CACHE_ENTRY_COUNT;
+    uint16_t * p_bucket = &m_buckets[hash(src, seq)];
+    msg_cache_entry_t * p_entry = &m_entries[index];
+    p_entry->src = src;
+    p_entry->seq = seq;
+    p_entry->time = now;
+    p_entry->next = *p_bucket;
+    *p_bucket = (uint16_t) index;
+    m_count++;
+}
+
+void msg_cache_clear(void)
+{
+    memset(m_buckets, 0xFF, sizeof(m_buckets));
+    m_oldest = 0;
+    m_count = 0;
+    m_aged = 0;
+}
+
+void msg_cache_stats_get(msg_cache_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+    p_stats->entries = m_count;
+}
@@ -0,0 +1,273 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/core/src/replay_cache.c.
+ *
+ * The stock replay protection list is scanned linearly for every received message. This version
+ * keeps the same API but indexes the entries with an open addressing hash table keyed on the
+ * source address, so both lookup and insert cost are independent of the number of sources.
+ *
+ * Entries are also kept in a least recently updated order. Entries whose IV index can no longer
+ * be received are reclaimed when the IV index changes, and when a new source arrives while the
+ * list is full, the entry that has been silent for the longest time is evicted instead of
+ * rejecting the new source forever. Removed entries are taken out of the hash index with backward
+ * shift deletion, so probe sequences stay short without tombstones.
+ *
+ * Evicting an entry forgets the sequence number of its source, so old messages from that source
+ * could be replayed until it sends again. Evictions are counted by DIAG_COUNTER_REPLAY_EVICTIONS;
+ * a node that sees them regularly needs a larger sizing profile.
+ */
+
+#include "replay_cache.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh_config_core.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_assert.h"
+#include "net_state.h"
+#include "diag_model.h"
+
+#define REPLAY_CACHE_HASH_SIZE (1u << REPLAY_CACHE_HASH_BITS)
+#define REPLAY_CACHE_HASH_MASK (REPLAY_CACHE_HASH_SIZE - 1)
+/** Marks an unused slot in the hash index and terminates the entry lists. */
+#define REPLAY_CACHE_INDEX_NONE (0xFFFF)
+
+NRF_MESH_STATIC_ASSERT(REPLAY_CACHE_ENTRIES < REPLAY_CACHE_INDEX_NONE);
+NRF_MESH_STATIC_ASSERT(REPLAY_CACHE_HASH_SIZE >= REPLAY_CACHE_ENTRIES * 2);
+
+typedef struct
+{
+    uint16_t src;
+    /* Neighbors in the update order, towards the most and the least recently updated entry. The
+     * free list is chained through next. */
+    uint16_t newer;
+    uint16_t older;
+    uint32_t seqno;
+    uint32_t iv_index;
+} replay_cache_entry_t;
+
+static replay_cache_entry_t m_entries[REPLAY_CACHE_ENTRIES];
+static uint16_t m_index[REPLAY_CACHE_HASH_SIZE];
+static uint16_t m_newest;
+static uint16_t m_oldest;
+static uint16_t m_free;
+
+/* Fibonacci hashing of the 16-bit address. Unicast addresses are handed out sequentially, the
+ * multiplication spreads them over the whole table. */
+static inline uint32_t hash(uint16_t src)
+{
+    return (((uint32_t) src * 40503u) >> (16 - REPLAY_CACHE_HASH_BITS)) & REPLAY_CACHE_HASH_MASK;
+}
+
+/* Finds the slot holding the entry of src, or the empty slot ending its probe sequence. */
+static uint32_t slot_find(uint16_t src)
+{
+    uint32_t slot = hash(src);
+    while (m_index[slot] != REPLAY_CACHE_INDEX_NONE && m_entries[m_index[slot]].src != src)
+    {
+        slot = (slot + 1) & REPLAY_CACHE_HASH_MASK;
+    }
+    return slot;
+}
+
+/* Empties a slot and moves later entries of the probe run back, so that every entry stays
+ * reachable from its home slot. */
+static void slot_remove(uint32_t slot)
+{
+    uint32_t next = slot;
+    for (;;)
+    {
+        next = (next + 1) & REPLAY_CACHE_HASH_MASK;
+        if (m_index[next] == REPLAY_CACHE_INDEX_NONE)
+        {
+            break;
+        }
+
+        /* The entry can fill the hole if the hole lies between its home slot and its slot. */
+        uint32_t home = hash(m_entries[m_index[next]].src);
+        if (((next - home) & REPLAY_CACHE_HASH_MASK) >= ((next - slot) & REPLAY_CACHE_HASH_MASK))
+        {
+            m_index[slot] = m_index[next];
+            slot = next;
+        }
+    }
+    m_index[slot] = REPLAY_CACHE_INDEX_NONE;
+}
+
+static void order_unlink(uint16_t index)
+{
+    replay_cache_entry_t * p_entry = &m_entries[index];
+    if (p_entry->newer != REPLAY_CACHE_INDEX_NONE)
+    {
+        m_entries[p_entry->newer].older = p_entry->older;
+    }
+    else
+    {
+        m_newest = p_entry->older;
+    }
+
+    if (p_entry->older != REPLAY_CACHE_INDEX_NONE)
+    {
+        m_entries[p_entry->older].newer = p_entry->newer;
+    }
+    else
+    {
+        m_oldest = p_entry->newer;
+    }
+}
+
+static void order_push_newest(uint16_t index)
+{
+    replay_cache_entry_t * p_entry = &m_entries[index];
+    p_entry->newer = REPLAY_CACHE_INDEX_NONE;
+    p_entry->older = m_newest;
+    if (m_newest != REPLAY_CACHE_INDEX_NONE)
+    {
+        m_entries[m_newest].newer = index;
+    }
+    else
+    {
+        m_oldest = index;
+    }
+    m_newest = index;
+}
+
+static void entry_remove(uint16_t index)
+{
+    uint32_t slot = slot_find(m_entries[index].src);
+    NRF_MESH_ASSERT(m_index[slot] == index);
+    slot_remove(slot);
+    order_unlink(index);
+
+    m_entries[index].newer = m_free;
+    m_free = index;
+}
+
+/* A message is new if it comes from a later IV index, or from the same IV index with a higher
+ * sequence number. */
+static inline bool is_newer(const replay_cache_entry_t * p_entry, uint32_t seqno, uint32_t iv_index)
+{
+    return (iv_index > p_entry->iv_index ||
+            (iv_index == p_entry->iv_index && seqno > p_entry->seqno));
+}
+
+void replay_cache_init(void)
+{
+    replay_cache_clear();
+}
+
+uint32_t replay_cache_add(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    uint32_t slot = slot_find(src);
+    uint16_t index = m_index[slot];
+    if (index != REPLAY_CACHE_INDEX_NONE)
+    {
+        replay_cache_entry_t * p_entry = &m_entries[index];
+        if (is_newer(p_entry, seqno, iv_index))
+        {
+            p_entry->seqno = seqno;
+            p_entry->iv_index = iv_index;
+            order_unlink(index);
+            order_push_newest(index);
+        }
+        return NRF_SUCCESS;
+    }
+
+    if (m_free == REPLAY_CACHE_INDEX_NONE)
+    {
+        entry_remove(m_oldest);
+        diag_counter_add(DIAG_COUNTER_REPLAY_EVICTIONS, 1);
+        /* The deletion may have moved the end of the probe sequence. */
+        slot = slot_find(src);
+    }
+
+    index = m_free;
+    m_free = m_entries[index].newer;
+
+    replay_cache_entry_t * p_entry = &m_entries[index];
+    p_entry->src = src;
+    p_entry->seqno = seqno;
+    p_entry->iv_index = iv_index;
+    order_push_newest(index);
+    m_index[slot] = index;
+    return NRF_SUCCESS;
+}
+
+bool replay_cache_has_elem(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    uint16_t index = m_index[slot_find(src)];
+    if (index != REPLAY_CACHE_INDEX_NONE && !is_newer(&m_entries[index], seqno, iv_index))
+    {
+        diag_counter_add(DIAG_COUNTER_REPLAY_REJECT, 1);
+        return true;
+    }
+    return false;
+}
+
+void replay_cache_on_iv_update(void)
+{
+    /* The network layer accepts messages from the current and the previous IV index only, so
+     * entries from older IV indices can never match again. */
+    uint32_t iv_index = net_state_beacon_iv_index_get();
+    uint16_t index = m_oldest;
+    while (index != REPLAY_CACHE_INDEX_NONE)
+    {
+        uint16_t newer = m_entries[index].newer;
+        if (m_entries[index].iv_index + 1 < iv_index)
+        {
+            entry_remove(index);
+        }
+        index = newer;
+    }
+}
+
+void replay_cache_clear(void)
+{
+    memset(m_index, 0xFF, sizeof(m_index));
+    m_newest = REPLAY_CACHE_INDEX_NONE;
+    m_oldest = REPLAY_CACHE_INDEX_NONE;
+    m_free = 0;
+    for (uint32_t i = 0; i < REPLAY_CACHE_ENTRIES; ++i)
+    {
+        m_entries[i].newer = (i + 1 < REPLAY_CACHE_ENTRIES) ? (uint16_t) (i + 1) : REPLAY_CACHE_INDEX_NONE;
+    }
+}
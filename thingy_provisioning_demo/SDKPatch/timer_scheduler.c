@@ -0,0 +1,335 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replacement for mesh/core/src/timer_scheduler.c.
+ *
+ * The stock scheduler keeps the pending timer events in a linked list sorted by expiry, so every
+ * schedule and abort walks the list. app_timer_mesh.c runs every app_timer on this scheduler as
+ * well, so the list holds both the mesh timers and the application timers. This version keeps
+ * the same API and keeps the events in a binary min-heap ordered by expiry instead: scheduling,
+ * rescheduling and aborting an event cost O(log n), and the next expiry is always at the root.
+ *
+ * The heap is an array of TIMER_SCH_EVENTS_MAX event pointers. The position of a pending event in
+ * the heap is kept in its p_next field, which nothing but the scheduler uses, so an event is
+ * aborted without searching for it. Expiries are compared as signed differences, so the order is
+ * right across the wrap of the 32 bit timestamp as long as the pending timeouts are less than
+ * 2^31 us (35 minutes) apart, as for the stock scheduler.
+ *
+ * Expired events are fired from a bearer event flag, set by the timer interrupt. The scheduler
+ * counts the pending events, their high-water mark and the largest delay of a timeout after its
+ * expiry, see timer_scheduler_stats.h.
+ */
+
+#include "timer_scheduler.h"
+#include "timer_scheduler_stats.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "nrf_mesh_config_core.h"
+#include "nrf_mesh_assert.h"
+#include "bearer_event.h"
+#include "timer.h"
+#include "toolchain.h"
+#include "diag_model.h"
+
+#ifndef TIMER_SCH_EVENTS_MAX
+#define TIMER_SCH_EVENTS_MAX (64)
+#endif
+
+static timer_event_t * m_heap[TIMER_SCH_EVENTS_MAX];
+static uint32_t m_count;
+static bearer_event_flag_t m_event_flag;
+static timer_sch_stats_t m_stats;
+
+/* ********** Heap ********** */
+
+static inline bool expires_before(const timer_event_t * p_a, const timer_event_t * p_b)
+{
+    return ((int32_t) (p_a->timestamp - p_b->timestamp) < 0);
+}
+
+static inline void position_set(uint32_t pos, timer_event_t * p_evt)
+{
+    m_heap[pos] = p_evt;
+    p_evt->p_next = (timer_event_t *) (uintptr_t) pos;
+}
+
+static inline uint32_t position_get(const timer_event_t * p_evt)
+{
+    return (uint32_t) (uintptr_t) p_evt->p_next;
+}
+
+static void sift_up(uint32_t pos)
+{
+    timer_event_t * p_evt = m_heap[pos];
+    while (pos > 0)
+    {
+        uint32_t parent = (pos - 1) / 2;
+        if (!expires_before(p_evt, m_heap[parent]))
+        {
+            break;
+        }
+        position_set(pos, m_heap[parent]);
+        pos = parent;
+    }
+    position_set(pos, p_evt);
+}
+
+static void sift_down(uint32_t pos)
+{
+    timer_event_t * p_evt = m_heap[pos];
+    for (;;)
+    {
+        uint32_t child = 2 * pos + 1;
+        if (child >= m_count)
+        {
+            break;
+        }
+        if (child + 1 < m_count && expires_before(m_heap[child + 1], m_heap[child]))
+        {
+            child++;
+        }
+        if (!expires_before(m_heap[child], p_evt))
+        {
+            break;
+        }
+        position_set(pos, m_heap[child]);
+        pos = child;
+    }
+    position_set(pos, p_evt);
+}
+
+static void heap_insert(timer_event_t * p_evt)
+{
+    NRF_MESH_ASSERT(m_count < TIMER_SCH_EVENTS_MAX);
+    position_set(m_count, p_evt);
+    m_count++;
+    sift_up(m_count - 1);
+    p_evt->state = TIMER_EVENT_STATE_QUEUED;
+
+    m_stats.pending = m_count;
+    if (m_count > m_stats.pending_hwm)
+    {
+        m_stats.pending_hwm = m_count;
+        diag_counter_max(DIAG_COUNTER_TIMER_SCH_PENDING_HWM, m_count);
+    }
+}
+
+static void heap_remove(timer_event_t * p_evt)
+{
+    uint32_t pos = position_get(p_evt);
+    NRF_MESH_ASSERT(pos < m_count && m_heap[pos] == p_evt);
+
+    m_count--;
+    if (pos < m_count)
+    {
+        position_set(pos, m_heap[m_count]);
+        /* The moved event may belong above or below the position of the removed one. */
+        if (pos > 0 && expires_before(m_heap[pos], m_heap[(pos - 1) / 2]))
+        {
+            sift_up(pos);
+        }
+        else
+        {
+            sift_down(pos);
+        }
+    }
+    m_stats.pending = m_count;
+}
+
+/* Places a pending event at its new expiry. */
+static void heap_update(timer_event_t * p_evt)
+{
+    uint32_t pos = position_get(p_evt);
+    NRF_MESH_ASSERT(pos < m_count && m_heap[pos] == p_evt);
+    sift_up(pos);
+    sift_down(position_get(p_evt));
+}
+
+/* ********** Timeouts ********** */
+
+static void timer_cb(timestamp_t timestamp)
+{
+    (void) timestamp;
+    bearer_event_flag_set(m_event_flag);
+}
+
+static void timeout_setup(void)
+{
+    if (m_count > 0)
+    {
+        timer_start(m_heap[0]->timestamp, timer_cb);
+    }
+    else
+    {
+        timer_stop();
+    }
+}
+
+static void skew_record(timestamp_t now, const timer_event_t * p_evt)
+{
+    uint32_t skew_us = now - p_evt->timestamp;
+    m_stats.fired++;
+    if (skew_us > m_stats.skew_max_us)
+    {
+        m_stats.skew_max_us = skew_us;
+        diag_counter_max(DIAG_COUNTER_TIMER_SCH_SKEW_MAX_US, skew_us);
+    }
+}
+
+static bool flag_event_cb(void)
+{
+    timestamp_t now = timer_now();
+    uint32_t was_masked;
+
+    for (;;)
+    {
+        _DISABLE_IRQS(was_masked);
+        if (m_count == 0 || (int32_t) (m_heap[0]->timestamp - now) > 0)
+        {
+            _ENABLE_IRQS(was_masked);
+            break;
+        }
+        timer_event_t * p_evt = m_heap[0];
+        heap_remove(p_evt);
+        p_evt->state = TIMER_EVENT_STATE_IN_CALLBACK;
+        skew_record(now, p_evt);
+        _ENABLE_IRQS(was_masked);
+
+        p_evt->cb(now, p_evt->p_context);
+
+        _DISABLE_IRQS(was_masked);
+        /* The callback may have scheduled or aborted the event itself. */
+        if (p_evt->state == TIMER_EVENT_STATE_IN_CALLBACK)
+        {
+            if (p_evt->interval > 0)
+            {
+                p_evt->timestamp += p_evt->interval;
+                heap_insert(p_evt);
+            }
+            else
+            {
+                p_evt->state = TIMER_EVENT_STATE_UNUSED;
+            }
+        }
+        _ENABLE_IRQS(was_masked);
+    }
+
+    _DISABLE_IRQS(was_masked);
+    timeout_setup();
+    _ENABLE_IRQS(was_masked);
+    return true;
+}
+
+/* ********** Public API ********** */
+
+void timer_sch_init(void)
+{
+    m_count = 0;
+    m_stats = (timer_sch_stats_t) {0};
+    m_event_flag = bearer_event_flag_add(flag_event_cb);
+}
+
+void timer_sch_schedule(timer_event_t * p_timer_evt)
+{
+    NRF_MESH_ASSERT(p_timer_evt != NULL);
+    NRF_MESH_ASSERT(p_timer_evt->cb != NULL);
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    const timer_event_t * p_first = (m_count > 0) ? m_heap[0] : NULL;
+    if (p_timer_evt->state == TIMER_EVENT_STATE_QUEUED)
+    {
+        heap_update(p_timer_evt);
+    }
+    else
+    {
+        heap_insert(p_timer_evt);
+    }
+    /* The timer only needs to be moved if the first expiry changed. */
+    if (m_heap[0] != p_first || p_first == p_timer_evt)
+    {
+        timeout_setup();
+    }
+    _ENABLE_IRQS(was_masked);
+}
+
+void timer_sch_abort(timer_event_t * p_timer_evt)
+{
+    NRF_MESH_ASSERT(p_timer_evt != NULL);
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    if (p_timer_evt->state == TIMER_EVENT_STATE_QUEUED)
+    {
+        bool was_first = (m_heap[0] == p_timer_evt);
+        heap_remove(p_timer_evt);
+        if (was_first)
+        {
+            timeout_setup();
+        }
+    }
+    p_timer_evt->state = TIMER_EVENT_STATE_UNUSED;
+    _ENABLE_IRQS(was_masked);
+}
+
+void timer_sch_reschedule(timer_event_t * p_timer_evt, timestamp_t new_timeout)
+{
+    NRF_MESH_ASSERT(p_timer_evt != NULL);
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    /* The expiry is the heap key, so it is changed and the heap fixed in one critical section. */
+    p_timer_evt->timestamp = new_timeout;
+    timer_sch_schedule(p_timer_evt);
+    _ENABLE_IRQS(was_masked);
+}
+
+bool timer_sch_is_scheduled(const timer_event_t * p_timer_evt)
+{
+    /* A periodic event is put back in the heap when its callback returns. */
+    return (p_timer_evt->state == TIMER_EVENT_STATE_QUEUED ||
+            (p_timer_evt->state == TIMER_EVENT_STATE_IN_CALLBACK && p_timer_evt->interval > 0));
+}
+
+void timer_sch_stats_get(timer_sch_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
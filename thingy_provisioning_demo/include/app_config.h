@@ -52,6 +52,12 @@
 /** Controls the MIC size used by the model instance for sending the mesh messages. */
 #define APP_CONFIG_MIC_SIZE            (NRF_MESH_TRANSMIC_SIZE_SMALL)
 
+/** OnOff state of the light until one has been stored, see @ref LIGHT_STATE. */
+#define APP_CONFIG_LIGHT_POWER_UP_ONOFF (false)
+
+/** Output OOB as a color sequence (Output Numeric, see @ref OOB_COLOR) instead of counted blinks. */
+#define APP_CONFIG_OUTPUT_OOB_COLOR     (true)
+
 /** @} end of APP_SPECIFIC_DEFINES */
 
 
@@ -0,0 +1,73 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BOOT_TIMELINE_H__
+#define BOOT_TIMELINE_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup BOOT_TIMELINE Boot timeline
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Records a timestamp at the end of each boot step and logs the duration of every step once
+ * the node is up. Timestamps are taken with the cycle counter, relative to the first mark.
+ * @{
+ */
+
+/** Maximum number of boot steps recorded, further marks are ignored. */
+#define BOOT_TIMELINE_STEPS_MAX (16)
+
+/**
+ * Marks the end of a boot step.
+ *
+ * @param[in] p_step Name of the step, must be a string literal.
+ */
+void boot_timeline_mark(const char * p_step);
+
+/**
+ * Gets the time since the first mark.
+ *
+ * @returns Time since the first mark in microseconds.
+ */
+uint32_t boot_timeline_elapsed_us(void);
+
+/** Logs the duration of all recorded steps. */
+void boot_timeline_log(void);
+
+/** @} end of BOOT_TIMELINE */
+
+#endif /* BOOT_TIMELINE_H__ */
@@ -0,0 +1,105 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CCM_BACKEND_H__
+#define CCM_BACKEND_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup CCM_BACKEND AES-CCM backend selection
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Backend control of the AES-CCM implementation in SDKPatch/ccm_soft.c, used for network,
+ * application and device key encryption.
+ *
+ * AES-CCM needs one AES block operation per 16 bytes for the CBC-MAC, plus one per 16 bytes of
+ * CTR keystream and one for the MIC. The CBC-MAC blocks depend on each other, but the keystream
+ * blocks do not. The batched backend computes all keystream blocks of a message with a single
+ * SoftDevice ECB call (@c sd_ecb_blocks_encrypt), instead of one SoftDevice call per block as the
+ * software backend does. If the batched call fails, the software path is used for that message.
+ *
+ * The nRF52 CCM peripheral is not used: it always authenticates a one byte packet header as
+ * additional data and only produces 4 byte MICs, while mesh network encryption has no additional
+ * data and uses both 4 and 8 byte MICs, so its output would not match the mesh CCM.
+ * @{
+ */
+
+/** Compile the known-answer self test, see @ref ccm_backend_selftest. */
+#ifndef CCM_BACKEND_SELFTEST_ENABLED
+#define CCM_BACKEND_SELFTEST_ENABLED (0)
+#endif
+
+/** AES-CCM backends. */
+typedef enum
+{
+    /** One AES block operation per call, as in the stock implementation. */
+    CCM_BACKEND_SOFT,
+    /** CTR keystream blocks batched into one SoftDevice ECB call. */
+    CCM_BACKEND_BATCHED
+} ccm_backend_t;
+
+/**
+ * Selects the AES-CCM backend. The batched backend is used by default.
+ *
+ * @param[in] backend Backend to use.
+ */
+void ccm_backend_set(ccm_backend_t backend);
+
+/**
+ * Gets the selected AES-CCM backend.
+ *
+ * @returns The selected backend.
+ */
+ccm_backend_t ccm_backend_get(void);
+
+#if CCM_BACKEND_SELFTEST_ENABLED
+/**
+ * Runs known-answer tests on the selected backend.
+ *
+ * Uses RFC 3610 packet vector #1 (8 byte MIC, additional data) and a mesh network PDU
+ * encrypted with the same key and nonce length (no additional data, 4 byte MIC), in both
+ * directions, including MIC failure detection.
+ *
+ * @returns Whether all tests passed.
+ */
+bool ccm_backend_selftest(void);
+#endif
+
+/** @} end of CCM_BACKEND */
+
+#endif /* CCM_BACKEND_H__ */
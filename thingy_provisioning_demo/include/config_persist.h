@@ -0,0 +1,148 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONFIG_PERSIST_H__
+#define CONFIG_PERSIST_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config_server_events.h"
+
+/**
+ * @defgroup CONFIG_PERSIST Configuration persistence write coalescing
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Batches configuration changes into a single flash transaction.
+ *
+ * Two kinds of state go through the module:
+ * - Mesh configuration entries of the DSM and the access layer, stored by the Config Server.
+ *   Their backend stores are intercepted (the module is linked with
+ *   --wrap=mesh_config_backend_store and --wrap=mesh_config_backend_erase): the entry ID is
+ *   recorded, and the current value is read back with mesh_config_entry_get() and stored when the
+ *   window closes. Several changes to the same entry, such as a burst of subscription changes to
+ *   one model, therefore cost one flash write. Other mesh configuration files, in particular the
+ *   sequence number blocks, are stored immediately.
+ * - Application records: modules owning persistent application state register a record and mark
+ *   it dirty on every change.
+ *
+ * Changes arriving within @ref CONFIG_PERSIST_WINDOW_MS of each other are collected, and
+ * everything pending is flushed together once the window closes. A flush is never delayed more
+ * than @ref CONFIG_PERSIST_MAX_DELAY_MS after the first change, except while a radio-critical
+ * phase (provisioning link, GATT database reset) is active: flash erases stall radio timeslots,
+ * so flushing waits until the phase ends.
+ *
+ * Crash safety: each entry or record is written as a single flash manager entry (or flash word),
+ * which is only valid once completely written. After a power loss, it holds either its previous
+ * or its new value, never a mix. Changes that were still waiting in an open window are lost, so at
+ * most @ref CONFIG_PERSIST_MAX_DELAY_MS worth of changes (plus any radio-critical phase) can be
+ * lost. A node reset drops the pending mesh configuration entries.
+ *
+ * The module also tracks configuration sessions: a session starts with the first Config Server
+ * change and ends after @ref CONFIG_PERSIST_SESSION_IDLE_MS without changes. Flash operations are
+ * counted where they are queued to the mesh flash module (--wrap=mesh_flash_op_push), so the
+ * writes and erases logged for a session and reported through the diagnostics model are the ones
+ * that actually happened, by any flash user.
+ * @{
+ */
+
+/** Window in which consecutive changes are coalesced into one flash transaction. */
+#define CONFIG_PERSIST_WINDOW_MS            (250)
+/** Longest time a change is held back outside of a radio-critical phase. */
+#define CONFIG_PERSIST_MAX_DELAY_MS         (2000)
+/** Time without Config Server changes that ends a configuration session. */
+#define CONFIG_PERSIST_SESSION_IDLE_MS      (5000)
+/** Number of mesh configuration entries that can be pending at the same time. Stores beyond that
+ * are passed through immediately. */
+#define CONFIG_PERSIST_ENTRIES_MAX          (16)
+/** Largest mesh configuration entry that is held back, in bytes. */
+#define CONFIG_PERSIST_ENTRY_SIZE_MAX       (64)
+
+/**
+ * Flush callback type.
+ *
+ * Writes the current value of the record to flash.
+ */
+typedef void (*config_persist_flush_cb_t)(void);
+
+/** Persistent record. Must be statically allocated, the fields are private. */
+typedef struct config_persist_record
+{
+    config_persist_flush_cb_t flush_cb;
+    bool dirty;
+    struct config_persist_record * p_next;
+} config_persist_record_t;
+
+/** Initializes the module. Must be called after app_timer_init(). */
+void config_persist_init(void);
+
+/**
+ * Registers a persistent record.
+ *
+ * @param[in,out] p_record Record to register.
+ * @param[in]     flush_cb Function writing the record to flash.
+ */
+void config_persist_record_register(config_persist_record_t * p_record, config_persist_flush_cb_t flush_cb);
+
+/**
+ * Marks a record as changed. The record is written with the next coalesced flush.
+ *
+ * @param[in,out] p_record Changed record.
+ */
+void config_persist_mark_dirty(config_persist_record_t * p_record);
+
+/**
+ * Enters or leaves a radio-critical phase. Phases may nest, flushing resumes when all are left.
+ *
+ * @param[in] active @c true when entering a phase, @c false when leaving it.
+ */
+void config_persist_radio_critical_set(bool active);
+
+/**
+ * Writes all pending entries and dirty records immediately, e.g. before a reset.
+ */
+void config_persist_flush(void);
+
+/**
+ * Tracks the configuration session from a Config Server event, and drops the pending mesh
+ * configuration entries on a node reset.
+ *
+ * @param[in] p_evt Config Server event.
+ */
+void config_persist_config_server_evt(const config_server_evt_t * p_evt);
+
+/** @} end of CONFIG_PERSIST */
+
+#endif /* CONFIG_PERSIST_H__ */
@@ -0,0 +1,86 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CRYPTO_BENCH_H__
+#define CRYPTO_BENCH_H__
+
+/**
+ * @defgroup CRYPTO_BENCH Crypto microbenchmarks
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Runs the mesh security primitives (AES, AES-CMAC, AES-CCM, s1, k1-k4, key generation and
+ * P-256 ECDH) over fixed vectors and reports their cost.
+ *
+ * Only compiled in the Benchmark build configuration, which defines CRYPTO_BENCH_ENABLED and
+ * otherwise uses the Release settings. Cycles are measured with the DWT cycle counter. Results
+ * are printed to RTT channel 0 as one JSON document, between the lines "CRYPTO_BENCH_BEGIN" and
+ * "CRYPTO_BENCH_END" so they can be cut out of the log:
+ *
+ * @code
+ * {"tag":"...","build":"...","cpu_hz":64000000,"comb_equal":true,"results":[
+ * {"name":"aes_ecb","bytes":16,"iterations":200,"cycles_min":...,"cycles_avg":...,"bytes_per_s":...},
+ * ...]}
+ * @endcode
+ *
+ * @c cycles_min and @c cycles_avg are per call. @c bytes_per_s is computed from @c cycles_avg.
+ * @c comb_equal reports whether @ref P256_COMB and micro-ecc computed the same public key for a
+ * random key pair; @c ecc_public_key and @c ecc_public_key_comb time the two on the same key.
+ * Set CRYPTO_BENCH_TAG to label a run, e.g. with the uECC settings under test.
+ * @{
+ */
+
+/** Compile the benchmarks. */
+#ifndef CRYPTO_BENCH_ENABLED
+#define CRYPTO_BENCH_ENABLED (0)
+#endif
+
+/** Label included in the results. */
+#ifndef CRYPTO_BENCH_TAG
+#define CRYPTO_BENCH_TAG ""
+#endif
+
+#if CRYPTO_BENCH_ENABLED
+/**
+ * Runs all benchmarks and prints the results.
+ *
+ * Blocks for several seconds. The SoftDevice must be enabled.
+ */
+void crypto_bench_run(void);
+#endif
+
+/** @} end of CRYPTO_BENCH */
+
+#endif /* CRYPTO_BENCH_H__ */
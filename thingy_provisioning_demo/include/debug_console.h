@@ -0,0 +1,96 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DEBUG_CONSOLE_H__
+#define DEBUG_CONSOLE_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup DEBUG_CONSOLE Debug console
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Command console on RTT channel 0.
+ *
+ * RTT input is only polled while a debugger is attached. Without one, the console wakes the CPU
+ * once every @ref DEBUG_CONSOLE_DETECT_INTERVAL_MS to check for it. The console is only compiled
+ * in when DEBUG_CONSOLE_ENABLED is set (Debug and Benchmark configurations), Release builds
+ * have no RTT input at all.
+ *
+ * Input is read as lines. A line with a single character is passed to the key handler given to
+ * @ref debug_console_init, longer lines are commands:
+ * - @c help: lists the commands.
+ * - @c counters: prints the diagnostics counters.
+ * - @c wakeups: prints the idle loop wakeups per second since the previous call, see
+ *   @ref DIAG_COUNTER_IDLE_WAKEUPS.
+ * - @c log @c <level>: sets the log level (see log.h).
+ * - @c mem: prints the mesh memory pool statistics and the histogram of requested sizes, see
+ *   @ref MESH_MEM_POOL.
+ * - @c bench: runs the crypto benchmarks (Benchmark configuration only).
+ * @{
+ */
+
+/** Compile the debug console. */
+#ifndef DEBUG_CONSOLE_ENABLED
+#define DEBUG_CONSOLE_ENABLED (0)
+#endif
+
+/** Interval of the debugger detection while no debugger is attached. */
+#define DEBUG_CONSOLE_DETECT_INTERVAL_MS    (1000)
+/** RTT input poll interval while a debugger is attached. */
+#define DEBUG_CONSOLE_POLL_INTERVAL_MS      (100)
+/** Maximum length of a command line. */
+#define DEBUG_CONSOLE_LINE_LENGTH_MAX       (32)
+
+/**
+ * Key handler type.
+ *
+ * @param[in] key Character of a single character line.
+ */
+typedef void (*debug_console_key_handler_t)(int key);
+
+#if DEBUG_CONSOLE_ENABLED
+/**
+ * Starts the console. Must be called after app_timer_init().
+ *
+ * @param[in] key_handler Handler of single character lines.
+ */
+void debug_console_init(debug_console_key_handler_t key_handler);
+#endif
+
+/** @} end of DEBUG_CONSOLE */
+
+#endif /* DEBUG_CONSOLE_H__ */
@@ -0,0 +1,225 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DIAG_MODEL_H__
+#define DIAG_MODEL_H__
+
+#include <stdint.h>
+#include "access.h"
+
+/**
+ * @defgroup DIAG_MODEL Diagnostics vendor model
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Vendor model exposing runtime performance counters of the node over the mesh.
+ *
+ * A client reads the counters with a Diagnostics Get message carrying the index of the first
+ * counter it wants. The server answers with as many counters as fit in an unsegmented access
+ * message, so polling a large group of nodes never causes segmentation. The client continues
+ * from the next index until all @ref DIAG_COUNTER_COUNT counters are read.
+ *
+ * Status message parameters:
+ * - Start index (1 byte)
+ * - Total number of counters on the node (1 byte)
+ * - Counter values starting at the start index, each encoded as a little endian base-128
+ *   varint (7 value bits per byte, MSB set on all bytes except the last one).
+ * @{
+ */
+
+/** Vendor model ID of the Diagnostics server. */
+#define DIAG_MODEL_SERVER_ID            (0x0100)
+
+/** Diagnostics Get opcode (vendor specific). */
+#define DIAG_OPCODE_GET                 (0xC1)
+/** Diagnostics Status opcode (vendor specific). */
+#define DIAG_OPCODE_STATUS              (0xC2)
+
+/** Largest access payload that fits in an unsegmented message with a 32-bit TransMIC. */
+#define DIAG_UNSEG_ACCESS_PAYLOAD_MAX   (11)
+/** Size of a vendor opcode on air. */
+#define DIAG_VENDOR_OPCODE_SIZE         (3)
+/** Maximum number of parameter bytes in a Diagnostics Status message. */
+#define DIAG_STATUS_PARAMS_MAXLEN       (DIAG_UNSEG_ACCESS_PAYLOAD_MAX - DIAG_VENDOR_OPCODE_SIZE)
+
+/** Runtime counters reported by the Diagnostics server. Indices are part of the on-air format. */
+typedef enum
+{
+    /** Mesh packets transmitted by this node. */
+    DIAG_COUNTER_MSG_TX,
+    /** Access messages received by this node. */
+    DIAG_COUNTER_MSG_RX,
+    /** Network PDUs relayed by this node, counted when the core TX layer accepts them (see @ref TX_PRIORITY). */
+    DIAG_COUNTER_RELAY,
+    /** Messages rejected by the replay protection cache. */
+    DIAG_COUNTER_REPLAY_REJECT,
+    /** TWI transfers (writes and reads) issued by the Thingy drivers, counted in the TWI driver. */
+    DIAG_COUNTER_TWI_TRANSACTIONS,
+    /** Number of pending LED toggle commands. */
+    DIAG_COUNTER_LED_QUEUE_DEPTH,
+    /** Time from start of listening to the provisioning invite, in milliseconds. */
+    DIAG_COUNTER_PROV_INVITE_MS,
+    /** Time from the provisioning invite to the provisioning start PDU, in milliseconds. */
+    DIAG_COUNTER_PROV_START_MS,
+    /** Time from the provisioning start PDU to provisioning complete, in milliseconds. */
+    DIAG_COUNTER_PROV_COMPLETE_MS,
+    /** High-water mark of dynamically allocated mesh memory, in bytes. */
+    DIAG_COUNTER_MEM_HWM,
+    /** Config Server changes in the last configuration session. */
+    DIAG_COUNTER_CONFIG_CHANGES,
+    /** Flash write operations queued in the last configuration session, counted at mesh_flash_op_push(). */
+    DIAG_COUNTER_CONFIG_FLASH_WRITES,
+    /** Highest number of application timers running at the same time. */
+    DIAG_COUNTER_TIMER_ACTIVE_HWM,
+    /** Largest lateness of an application timer timeout, in microseconds. */
+    DIAG_COUNTER_TIMER_SKEW_MAX_US,
+    /** Application timer starts rejected by the timer backend. */
+    DIAG_COUNTER_TIMER_START_FAILURES,
+    /** Mesh memory allocations that could not be served. */
+    DIAG_COUNTER_MEM_ALLOC_FAILURES,
+    /** Largest delay from a user-initiated send to the first completed transmission of its message, in microseconds. */
+    DIAG_COUNTER_TX_INTERACTIVE_DELAY_MAX_US,
+    /** Times the relay advertiser yielded to a user-initiated message. */
+    DIAG_COUNTER_TX_RELAY_YIELDS,
+    /** Relay yields refused to protect relayed traffic from starvation. */
+    DIAG_COUNTER_TX_RELAY_YIELDS_REFUSED,
+    /** Advertisements dropped by the scanner AD type filter. */
+    DIAG_COUNTER_SCAN_DROPPED_ADTYPE,
+    /** Advertisements dropped by the scanner RSSI filter. */
+    DIAG_COUNTER_SCAN_DROPPED_RSSI,
+    /** Advertisements dropped by the scanner address deny list. */
+    DIAG_COUNTER_SCAN_DROPPED_ADDRESS,
+    /** Current scanner RSSI floor, as a positive number of -dBm. */
+    DIAG_COUNTER_SCAN_RSSI_FLOOR_NEG_DBM,
+    /** Network PDUs found in the message cache (duplicates). */
+    DIAG_COUNTER_MSG_CACHE_HITS,
+    /** Message cache entries evicted before their maximum age because the cache was full. */
+    DIAG_COUNTER_MSG_CACHE_CAPACITY_EVICTIONS,
+    /** Relay transmissions dropped at allocation because the relay policy suppressed relaying. */
+    DIAG_COUNTER_RELAY_SUPPRESSED,
+    /** Relay transmissions let through by the relay policy. */
+    DIAG_COUNTER_RELAY_FORWARDED,
+    /** Time spent in mesh_stack_init() at boot, including loading and deriving the keys, in us. */
+    DIAG_COUNTER_BOOT_STACK_INIT_US,
+    /** Time from the start of main() until the light state was restored at boot, in us. */
+    DIAG_COUNTER_BOOT_LIGHT_RESTORE_US,
+    /** Time from the start of main() until the mesh was started at boot, in us. */
+    DIAG_COUNTER_BOOT_MESH_START_US,
+    /** Light state records written to flash. */
+    DIAG_COUNTER_LIGHT_STATE_FLASH_WRITES,
+    /** Light state writes postponed by the minimum write interval. */
+    DIAG_COUNTER_LIGHT_STATE_WRITES_DEFERRED,
+    /** Returns from sd_app_evt_wait() in the idle loop. */
+    DIAG_COUNTER_IDLE_WAKEUPS,
+    /** Provisioning listening periods started, see @ref PROV_CADENCE. */
+    DIAG_COUNTER_PROV_LISTEN_WINDOWS,
+    /** Total provisioning listening time in milliseconds, up to the end of the last period. */
+    DIAG_COUNTER_PROV_LISTEN_MS,
+    /** Current silent gap between listening windows in milliseconds, 0 in the fast phase. */
+    DIAG_COUNTER_PROV_CADENCE_GAP_MS,
+    /** Returns to the fast phase requested by the application. */
+    DIAG_COUNTER_PROV_CADENCE_BOOSTS,
+    /** Replay protection entries evicted to make room for a new source, see SDKPatch/replay_cache.c. */
+    DIAG_COUNTER_REPLAY_EVICTIONS,
+    /** High-water mark of the small mesh memory pool, in blocks. */
+    DIAG_COUNTER_MEM_SMALL_HWM,
+    /** High-water mark of the medium mesh memory pool, in blocks. */
+    DIAG_COUNTER_MEM_MEDIUM_HWM,
+    /** High-water mark of the large mesh memory pool, in blocks. */
+    DIAG_COUNTER_MEM_LARGE_HWM,
+    /** High-water mark of the mesh memory region donated after provisioning, in blocks. */
+    DIAG_COUNTER_MEM_REGION_HWM,
+    /** Largest queue delay of a relayed PDU in the relay advertiser, in microseconds. */
+    DIAG_COUNTER_TX_RELAY_DELAY_MAX_US,
+    /** Largest queue delay of a beacon or other non-mesh-message advertisement, in microseconds. */
+    DIAG_COUNTER_TX_BACKGROUND_DELAY_MAX_US,
+    /** Key derivations answered from the persistent derived-key cache. */
+    DIAG_COUNTER_KEY_CACHE_HITS,
+    /** Key derivations passed to the stack because the key was not cached. */
+    DIAG_COUNTER_KEY_CACHE_MISSES,
+    /** Highest number of pending mesh and application timers, see SDKPatch/timer_scheduler.c. */
+    DIAG_COUNTER_TIMER_SCH_PENDING_HWM,
+    /** Largest lateness of any mesh or application timer timeout, in microseconds. */
+    DIAG_COUNTER_TIMER_SCH_SKEW_MAX_US,
+    /** Number of counters, not a counter. */
+    DIAG_COUNTER_COUNT
+} diag_counter_t;
+
+/**
+ * Adds to a counter.
+ *
+ * @param[in] counter Counter to update.
+ * @param[in] value   Value to add.
+ */
+void diag_counter_add(diag_counter_t counter, uint32_t value);
+
+/**
+ * Sets a gauge counter to the given value.
+ *
+ * @param[in] counter Counter to update.
+ * @param[in] value   New value.
+ */
+void diag_counter_set(diag_counter_t counter, uint32_t value);
+
+/**
+ * Raises a high-water mark counter if @p value is larger than its current value.
+ *
+ * @param[in] counter Counter to update.
+ * @param[in] value   Candidate value.
+ */
+void diag_counter_max(diag_counter_t counter, uint32_t value);
+
+/**
+ * Gets the current value of a counter.
+ *
+ * @param[in] counter Counter to read.
+ *
+ * @returns The counter value.
+ */
+uint32_t diag_counter_get(diag_counter_t counter);
+
+/**
+ * Initializes the Diagnostics server and adds it to the given element.
+ *
+ * @param[in] element_index Element to add the model to.
+ *
+ * @retval NRF_SUCCESS The model was added successfully.
+ * @returns Otherwise, an error code from @ref access_model_add.
+ */
+uint32_t diag_model_init(uint16_t element_index);
+
+/** @} end of DIAG_MODEL */
+
+#endif /* DIAG_MODEL_H__ */
@@ -0,0 +1,91 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FACTORY_OOB_H__
+#define FACTORY_OOB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup FACTORY_OOB Factory provisioning static OOB
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Per-device static OOB data for bulk provisioning without a human in the loop.
+ *
+ * A 16 byte factory secret is programmed into the UICR customer registers
+ * @ref FACTORY_OOB_UICR_CUSTOMER_INDEX to @ref FACTORY_OOB_UICR_CUSTOMER_INDEX + 3 (little endian
+ * words) when the device is produced. When the secret is present, the static OOB data of the
+ * device is
+ *
+ *     static_oob = AES-CMAC(secret, device UUID)
+ *
+ * where the device UUID is the one in the unprovisioned device beacon, which the mesh stack
+ * derives from the FICR device ID. A provisioner holding the secret computes the static OOB
+ * data of every beacon it hears and can provision any number of devices in parallel. In this
+ * mode the device only offers static OOB authentication, so no output OOB action is chosen.
+ *
+ * Without a secret (UICR erased) the device keeps the shared static OOB data and the blink
+ * output OOB action.
+ *
+ * @note Enable the access port protection in production, otherwise the secret can be read
+ * out over SWD.
+ * @{
+ */
+
+/** First UICR customer register holding the factory secret. */
+#define FACTORY_OOB_UICR_CUSTOMER_INDEX (0)
+
+/**
+ * Checks if a factory secret is programmed.
+ *
+ * @returns @c true if the device is in factory provisioning mode.
+ */
+bool factory_oob_available(void);
+
+/**
+ * Derives the static OOB data of the device. Must be called after the mesh stack is initialized.
+ *
+ * @param[out] p_static_data 16 byte static OOB data.
+ *
+ * @retval NRF_SUCCESS         The static OOB data was derived.
+ * @retval NRF_ERROR_NOT_FOUND No factory secret is programmed, @p p_static_data is untouched.
+ */
+uint32_t factory_oob_static_data_get(uint8_t * p_static_data);
+
+/** @} end of FACTORY_OOB */
+
+#endif /* FACTORY_OOB_H__ */
@@ -0,0 +1,105 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef KEY_CACHE_H__
+#define KEY_CACHE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf_mesh_config_dsm.h"
+
+/**
+ * @defgroup KEY_CACHE Persistent derived-key cache
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Keeps the key material the stack derives from network and application keys in flash, next to
+ * the DSM, so that it is not derived again at every boot.
+ *
+ * The DSM derives the NID, encryption and privacy keys (k2), the network ID and beacon key (k3,
+ * k1), the node identity key (k1) of every subnet and the AID (k4) of every application key when
+ * it applies the loaded configuration in mesh_stack_init(), and again when keys are added or
+ * updated. Each derivation costs several AES-CMAC operations. The module is linked with
+ * --wrap=nrf_mesh_keygen_network_secmat, --wrap=nrf_mesh_keygen_beacon_secmat,
+ * --wrap=nrf_mesh_keygen_identitykey and --wrap=nrf_mesh_keygen_aid: a derivation whose input key
+ * is in the cache is answered from it, any other is passed to the stack and its result stored.
+ *
+ * Entries live in their own mesh configuration file, @ref KEY_CACHE_FILE_ID, in the mesh
+ * persistent storage area, and are cleared with the rest of the mesh configuration on a node
+ * reset. Each entry holds the input key, the derived material and a hash over both, which is
+ * checked when the entry is loaded: an entry that does not match is ignored and derived again.
+ * During a key refresh both the old and the new keys of a subnet are cached, so changing phase
+ * only selects the other, already derived, set.
+ *
+ * Entries not needed by the configuration any more (deleted or refreshed keys) are removed by
+ * @ref key_cache_prune after the stack has applied the stored configuration.
+ * @{
+ */
+
+/** Mesh configuration file of the cache, above the files of the stack. */
+#define KEY_CACHE_FILE_ID           (0x0010)
+/** Number of entries: network, beacon and identity material of every subnet and the AID of every
+ * application key, twice, for the old and new keys during a key refresh. */
+#define KEY_CACHE_ENTRIES_MAX       (2 * (3 * DSM_SUBNET_MAX + DSM_APP_MAX))
+/** Flash size of an entry, including the flash manager entry header. */
+#define KEY_CACHE_ENTRY_FLASH       (60)
+
+/** Resets the RAM state of the cache and its counters. Must be called before mesh_stack_init(). */
+void key_cache_init(void);
+
+/**
+ * Removes the entries of every kind of material the stack derived while applying the stored
+ * configuration that were not used in doing so. Must be called after mesh_stack_init().
+ */
+void key_cache_prune(void);
+
+/**
+ * Gets the number of derivations answered from the cache since @ref key_cache_init.
+ *
+ * @returns The number of hits.
+ */
+uint32_t key_cache_hits_get(void);
+
+/**
+ * Gets the number of derivations passed to the stack since @ref key_cache_init.
+ *
+ * @returns The number of misses.
+ */
+uint32_t key_cache_misses_get(void);
+
+/** @} end of KEY_CACHE */
+
+#endif /* KEY_CACHE_H__ */
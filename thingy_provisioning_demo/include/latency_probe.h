@@ -0,0 +1,186 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LATENCY_PROBE_H__
+#define LATENCY_PROBE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "access.h"
+#include "access_config.h"
+
+/**
+ * @defgroup LATENCY_PROBE Latency probe vendor model
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Vendor model measuring end-to-end latency, both as ping/echo round trips and as the time from
+ * a switch press on one node to the light changing on another.
+ *
+ * All probe messages are published to the publication address of the model, so it must be
+ * configured to publish to the same group as the Generic OnOff client.
+ *
+ * Press-to-light latency needs a shared time base. A node becomes the time reference by sending
+ * a Sync message (@ref latency_probe_sync_send); receivers adopt its clock, corrected by the
+ * estimated transit delay (measured per relay hop from ping round trips). The switch node
+ * timestamps the press and, once the OnOff Set has been queued, publishes a Mark message; the light
+ * node timestamps the OnOff Set callback and pairs the two.
+ *
+ * Sending or receiving a Sync starts a probe session of @ref LATENCY_PROBE_SESSION_TIMEOUT_MS, after
+ * which the clocks have drifted apart. Marks are only sent and paired during a session, so a
+ * switch that is not being measured sends nothing but its OnOff messages.
+ *
+ * Latencies are collected in histograms per number of relay hops, derived from the TTL the
+ * message was sent with (carried in the message) and the TTL it was received with. They are
+ * printed to RTT with @ref latency_probe_report_log and can be read over the mesh with the
+ * Histogram Get message. All messages fit in one unsegmented access PDU (8 parameter bytes with a
+ * vendor opcode), so a histogram is read in pages of @ref LATENCY_PROBE_HIST_VALUES_PER_STATUS
+ * values: the sample count, the mean and maximum in milliseconds, then the bucket counts, as
+ * listed by @ref LATENCY_PROBE_HIST_VALUE_COUNT. The client asks for the next page with the start
+ * index of the previous one plus the number of values it carried, until a Status carries none.
+ *
+ * Message parameters (little endian):
+ * - Ping:             Sequence (1), origin time in us (4), TTL (1)
+ * - Echo:             Sequence (1), origin time in us (4), relay hops of the ping (1)
+ * - Mark:             Sequence (1), press time in network time us (4), TTL (1), flags (1)
+ * - Sync:             Network time in us (4), TTL (1)
+ * - Histogram Get:    Kind (1), relay hops (1), start index (1)
+ * - Histogram Status: Kind (1), relay hops (1), start index (1), up to
+ *                     @ref LATENCY_PROBE_HIST_VALUES_PER_STATUS values from the start index (2 each)
+ * @{
+ */
+
+/** Vendor model ID of the Latency probe. */
+#define LATENCY_PROBE_MODEL_ID              (0x0101)
+
+/** Ping opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_PING           (0xC3)
+/** Echo opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_ECHO           (0xC4)
+/** Mark opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_MARK           (0xC5)
+/** Sync opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_SYNC           (0xC6)
+/** Histogram Get opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_HIST_GET       (0xC7)
+/** Histogram Status opcode (vendor specific). */
+#define LATENCY_PROBE_OPCODE_HIST_STATUS    (0xC8)
+
+/** Highest number of relay hops with its own histogram. Larger hop counts are added to the last one. */
+#define LATENCY_PROBE_HOPS_MAX              (ACCESS_DEFAULT_TTL)
+
+/**
+ * Number of histogram buckets. Bucket 0 holds latencies below 8 ms, each following bucket doubles
+ * the upper bound, and the last one holds everything from 512 ms.
+ */
+#define LATENCY_PROBE_BUCKET_COUNT          (8)
+
+/** Number of values of a histogram read with Histogram Get: sample count, mean, max and the buckets. */
+#define LATENCY_PROBE_HIST_VALUE_COUNT      (3 + LATENCY_PROBE_BUCKET_COUNT)
+
+/** Number of histogram values in one Histogram Status. */
+#define LATENCY_PROBE_HIST_VALUES_PER_STATUS (2)
+
+/** Length of a probe session after the last Sync. */
+#define LATENCY_PROBE_SESSION_TIMEOUT_MS    (10 * 60 * 1000)
+
+/** Initial transit delay estimate per relay hop, used for time sync until pings have been answered. */
+#define LATENCY_PROBE_HOP_DELAY_US_DEFAULT  (15000)
+
+/** Largest time between a press Mark and the OnOff Set on the light node for the two to be paired. */
+#define LATENCY_PROBE_PAIR_WINDOW_MS        (2000)
+
+/** Histogram kinds. */
+typedef enum
+{
+    /** One-way latency estimated as half of a ping round trip. */
+    LATENCY_PROBE_KIND_PING,
+    /** Time from a switch press to the OnOff Set callback on the light node. */
+    LATENCY_PROBE_KIND_PRESS,
+    LATENCY_PROBE_KIND_COUNT
+} latency_probe_kind_t;
+
+/**
+ * Initializes the Latency probe model.
+ *
+ * @param[in] element_index Element to add the model to.
+ *
+ * @retval NRF_SUCCESS             The model was added.
+ * @retval NRF_ERROR_INVALID_STATE The model has already been initialized.
+ * @returns Otherwise, an error code from @ref access_model_add.
+ */
+uint32_t latency_probe_init(uint16_t element_index);
+
+/**
+ * Publishes a Ping message.
+ *
+ * @returns Status code from @ref access_model_publish.
+ */
+uint32_t latency_probe_ping_send(void);
+
+/**
+ * Publishes a Sync message, making this node the time reference.
+ *
+ * @returns Status code from @ref access_model_publish.
+ */
+uint32_t latency_probe_sync_send(void);
+
+/**
+ * Timestamps a switch press.
+ *
+ * Call as early as possible in the button handling. Does nothing outside a probe session.
+ */
+void latency_probe_press_begin(void);
+
+/**
+ * Publishes a Mark message for the press timestamped by @ref latency_probe_press_begin.
+ *
+ * Call after the OnOff Set has been queued, so the Mark does not delay it.
+ */
+void latency_probe_press_mark(void);
+
+/**
+ * Timestamps a light change on this node.
+ *
+ * Call from the OnOff Set callback.
+ */
+void latency_probe_light_mark(void);
+
+/** Prints the collected histograms to the log. */
+void latency_probe_report_log(void);
+
+/** @} end of LATENCY_PROBE */
+
+#endif /* LATENCY_PROBE_H__ */
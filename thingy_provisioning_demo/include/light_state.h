@@ -0,0 +1,136 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIGHT_STATE_H__
+#define LIGHT_STATE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup LIGHT_STATE Persistent light state
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Keeps the Generic OnOff and Generic OnPowerUp states of the light in flash, and computes the
+ * OnOff state to apply at power-up.
+ *
+ * Both states are packed into one 32-bit record, appended to a pair of dedicated flash pages.
+ * A page is only erased when the other one is full, which spreads the erase cycles over both
+ * pages, and the newest record is found by its sequence number. A record is a single word, so
+ * it is either completely written or not at all. The pages are memory mapped, so the state is
+ * read at boot before the mesh stack is initialized. The linker places them directly below the
+ * mesh persistent storage, at an address that only depends on the sizing profile, and they are
+ * not part of the application image, so programming a new image or a DFU keeps the stored state.
+ *
+ * Writes go through @ref CONFIG_PERSIST, so changes in quick succession are coalesced, and
+ * records are written with the mesh flash module, between radio timeslots. Additionally, two
+ * writes are always at least @ref LIGHT_STATE_WRITE_INTERVAL_MIN_MS apart, which bounds the
+ * number of flash writes during rapid toggling to 60000 / @ref LIGHT_STATE_WRITE_INTERVAL_MIN_MS
+ * per minute. A change is only lost if power fails within that interval.
+ * @{
+ */
+
+/** Minimum time between two flash writes. */
+#define LIGHT_STATE_WRITE_INTERVAL_MIN_MS   (6000)
+/** Number of flash pages used for the records. */
+#define LIGHT_STATE_FLASH_PAGE_COUNT        (2)
+/** Size of a flash page. */
+#define LIGHT_STATE_FLASH_PAGE_SIZE         (4096)
+
+/** Generic OnPowerUp states. */
+typedef enum
+{
+    /** The light is off after power-up. */
+    LIGHT_STATE_ON_POWER_UP_OFF,
+    /** The light is on after power-up. */
+    LIGHT_STATE_ON_POWER_UP_DEFAULT,
+    /** The light is restored to the last OnOff state after power-up. */
+    LIGHT_STATE_ON_POWER_UP_RESTORE,
+    /** Number of states, not a state. */
+    LIGHT_STATE_ON_POWER_UP_COUNT
+} light_state_on_power_up_t;
+
+/** OnPowerUp state used until one is set. */
+#define LIGHT_STATE_ON_POWER_UP_INITIAL     (LIGHT_STATE_ON_POWER_UP_RESTORE)
+
+/**
+ * Loads the stored state. Must be called after app_timer_init(), and may be called before the
+ * mesh stack is initialized.
+ */
+void light_state_init(void);
+
+/**
+ * Registers the module as the application user of the mesh flash module. Must be called once,
+ * after mesh_stack_init(), which initializes the mesh flash module, and before the first change is
+ * written. Fails with @c NRF_ERROR_NO_MEM if the mesh persistent storage starts below the end
+ * of the light state pages.
+ */
+void light_state_flash_init(void);
+
+/**
+ * Gets the OnOff state to apply at power-up, according to the stored OnPowerUp state.
+ *
+ * @returns @c true if the light shall be on.
+ */
+bool light_state_power_up_onoff_get(void);
+
+/**
+ * Records a new OnOff state.
+ *
+ * @param[in] onoff New OnOff state.
+ */
+void light_state_onoff_set(bool onoff);
+
+/**
+ * Gets the OnPowerUp state.
+ *
+ * @returns The OnPowerUp state.
+ */
+light_state_on_power_up_t light_state_on_power_up_get(void);
+
+/**
+ * Sets the OnPowerUp state.
+ *
+ * @param[in] on_power_up New OnPowerUp state.
+ *
+ * @retval NRF_SUCCESS             The state was set.
+ * @retval NRF_ERROR_INVALID_PARAM The state is not a valid OnPowerUp state.
+ */
+uint32_t light_state_on_power_up_set(light_state_on_power_up_t on_power_up);
+
+/** @} end of LIGHT_STATE */
+
+#endif /* LIGHT_STATE_H__ */
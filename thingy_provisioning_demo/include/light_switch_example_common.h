@@ -44,12 +44,9 @@
  */
 
 /** Number of active servers.
- * Note: If the value of SERVER_NODE_COUNT is increased, you may need to scale up the the replay
- * protection list size (@ref REPLAY_CACHE_ENTRIES), by the appropriate amount, for the provisioner and
- * client examples. For the provisioner example to work as expected, its replay protection list size should
- * be greater than or equal to the total number of nodes it is going to configure after provisioning them.
- * The replay protection list size of the client example should be greater than or equal to the total
- * number of unicast addresses in the network that it can receive a message from.
+ * Note: With the small sizing profile, the replay protection list size (@ref REPLAY_CACHE_ENTRIES) is
+ * derived from SERVER_NODE_COUNT and CLIENT_NODE_COUNT in nrf_mesh_config_app.h, so it scales with
+ * the network automatically.
  */
 #define SERVER_NODE_COUNT (30)
 #if SERVER_NODE_COUNT > 30
@@ -0,0 +1,184 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MESH_APP_SIZING_H__
+#define MESH_APP_SIZING_H__
+
+/**
+ * @defgroup MESH_APP_SIZING Network sizing cost model
+ * @ingroup NRF_MESH_CONFIG_APP
+ * RAM and flash cost of the limits selected by the sizing profile in nrf_mesh_config_app.h.
+ *
+ * The per-entry sizes are upper estimates of the Mesh SDK v3.2 storage structures, including the
+ * 4 byte flash manager entry header for the flash figures. All expressions are plain integer
+ * arithmetic so that they can be used in preprocessor conditions and exported to the linker.
+ *
+ * The flash cost is enforced at link time: @ref mesh_app_sizing.c places a reservation of
+ * @ref MESH_APP_SIZING_FLASH_BYTES at the end of the FLASH region, and the light state pages of
+ * @ref LIGHT_STATE are placed directly below it, so the link fails when the FLASH region cannot
+ * hold the image and both (see linker/nrf52832_xxAA_s132_6.1.1.ld and flash_placement.xml).
+ *
+ * The RAM figure is an estimate for the boot log only. The actual RAM check is done by the linker
+ * on the real sections: all the storage that scales with the profile is statically allocated, so
+ * the link fails when .bss, .ram_overlay, the heap and the stack do not fit in the RAM region
+ * together (the ASSERT at the end of linker/nrf52832_xxAA_s132_6.1.1.ld, and the RAM segment of
+ * flash_placement.xml, where the stack is placed from the end of the segment).
+ * @{
+ */
+
+/** Size of a flash page on the nRF52. */
+#define MESH_APP_SIZING_FLASH_PAGE_SIZE         (4096)
+/** Usable bytes of a flash manager page, after the page metadata. */
+#define MESH_APP_SIZING_FLASH_PAGE_PAYLOAD      (MESH_APP_SIZING_FLASH_PAGE_SIZE - 8)
+/** Flash manager areas need room to append updated entries before defragmenting. */
+#define MESH_APP_SIZING_FLASH_HEADROOM          (2)
+
+/** Pages needed to store @p bytes with headroom. */
+#define MESH_APP_SIZING_PAGES(bytes)            (((bytes) * MESH_APP_SIZING_FLASH_HEADROOM +       \
+                                                  MESH_APP_SIZING_FLASH_PAGE_PAYLOAD - 1) /        \
+                                                 MESH_APP_SIZING_FLASH_PAGE_PAYLOAD)
+
+/** Bits of the smallest power-of-two hash table with at least @p slots slots (64 to 4096). */
+#define MESH_APP_SIZING_HASH_BITS(slots)        ((slots) <= 64   ? 6  : \
+                                                 (slots) <= 128  ? 7  : \
+                                                 (slots) <= 256  ? 8  : \
+                                                 (slots) <= 512  ? 9  : \
+                                                 (slots) <= 1024 ? 10 : \
+                                                 (slots) <= 2048 ? 11 : 12)
+
+/**
+ * @defgroup MESH_APP_SIZING_ENTRIES Estimated entry sizes
+ * @{
+ */
+#define MESH_APP_SIZING_SUBNET_FLASH            (40)
+#define MESH_APP_SIZING_APPKEY_FLASH            (40)
+#define MESH_APP_SIZING_DEVKEY_FLASH            (24)
+#define MESH_APP_SIZING_NONVIRTUAL_FLASH        (8)
+#define MESH_APP_SIZING_VIRTUAL_FLASH           (24)
+#define MESH_APP_SIZING_DSM_METADATA_FLASH      (16)
+#define MESH_APP_SIZING_MODEL_FLASH             (24)
+#define MESH_APP_SIZING_ELEMENT_FLASH           (8)
+#define MESH_APP_SIZING_ACCESS_METADATA_FLASH   (16)
+
+/* Subnets keep the key material of both the current and the key refresh network key. */
+#define MESH_APP_SIZING_SUBNET_RAM              (220)
+#define MESH_APP_SIZING_APPKEY_RAM              (40)
+#define MESH_APP_SIZING_DEVKEY_RAM              (24)
+#define MESH_APP_SIZING_NONVIRTUAL_RAM          (4)
+#define MESH_APP_SIZING_VIRTUAL_RAM             (20)
+/* Replay entry, see SDKPatch/replay_cache.c. The hash index is counted separately. */
+#define MESH_APP_SIZING_REPLAY_RAM              (16)
+/* Replay protection hash index slot. */
+#define MESH_APP_SIZING_REPLAY_SLOT_RAM         (2)
+/* Message cache entry, see SDKPatch/msg_cache.c. The hash buckets are counted separately. */
+#define MESH_APP_SIZING_MSG_CACHE_RAM           (8)
+/* Message cache hash bucket. */
+#define MESH_APP_SIZING_MSG_CACHE_BUCKET_RAM    (2)
+/* Subscription index entry: address and model bitmask, see sub_index.h. */
+#define MESH_APP_SIZING_SUB_INDEX_RAM           (4)
+/* Mesh memory pool of @p count blocks of @p size bytes: nrf_balloc rounds the blocks up to a word
+ * and keeps a one byte free stack slot per block. */
+#define MESH_APP_SIZING_MEM_POOL_RAM(size, count) ((((size) + 3) / 4 * 4 + 1) * (count))
+/** @} end of MESH_APP_SIZING_ENTRIES */
+
+/** Total number of DSM addresses. */
+#define MESH_APP_SIZING_ADDR_COUNT              (DSM_NONVIRTUAL_ADDR_MAX + DSM_VIRTUAL_ADDR_MAX)
+
+/** DSM bytes stored in flash. */
+#define MESH_APP_SIZING_DSM_FLASH_BYTES         (DSM_SUBNET_MAX * MESH_APP_SIZING_SUBNET_FLASH +              \
+                                                 DSM_APP_MAX * MESH_APP_SIZING_APPKEY_FLASH +                 \
+                                                 DSM_DEVICE_MAX * MESH_APP_SIZING_DEVKEY_FLASH +              \
+                                                 DSM_NONVIRTUAL_ADDR_MAX * MESH_APP_SIZING_NONVIRTUAL_FLASH + \
+                                                 DSM_VIRTUAL_ADDR_MAX * MESH_APP_SIZING_VIRTUAL_FLASH +       \
+                                                 MESH_APP_SIZING_DSM_METADATA_FLASH)
+
+/** Access layer bytes stored in flash: models with their subscription list bitfields, and elements. */
+#define MESH_APP_SIZING_ACCESS_FLASH_BYTES      (ACCESS_MODEL_COUNT * MESH_APP_SIZING_MODEL_FLASH +                \
+                                                 ACCESS_SUBSCRIPTION_LIST_COUNT *                                 \
+                                                 (4 + (MESH_APP_SIZING_ADDR_COUNT + 31) / 32 * 4) +              \
+                                                 ACCESS_ELEMENT_COUNT * MESH_APP_SIZING_ELEMENT_FLASH +           \
+                                                 MESH_APP_SIZING_ACCESS_METADATA_FLASH)
+
+/** Flash pages for the DSM, see @ref DSM_FLASH_PAGE_COUNT. */
+#define MESH_APP_SIZING_DSM_FLASH_PAGES         MESH_APP_SIZING_PAGES(MESH_APP_SIZING_DSM_FLASH_BYTES)
+/** Flash pages for the access layer, see @ref ACCESS_FLASH_PAGE_COUNT. */
+#define MESH_APP_SIZING_ACCESS_FLASH_PAGES      MESH_APP_SIZING_PAGES(MESH_APP_SIZING_ACCESS_FLASH_BYTES)
+/** Flash pages for the derived-key cache. Uses the sizes from key_cache.h, which must be included
+ * where this is expanded. */
+#define MESH_APP_SIZING_KEY_CACHE_FLASH_PAGES   MESH_APP_SIZING_PAGES(KEY_CACHE_ENTRIES_MAX * KEY_CACHE_ENTRY_FLASH)
+/** Flash pages of the mesh core that do not scale with the profile: net state and recovery page. */
+#define MESH_APP_SIZING_CORE_FLASH_PAGES        (2)
+
+/** Total number of persistent storage pages. */
+#define MESH_APP_SIZING_FLASH_PAGES             (DSM_FLASH_PAGE_COUNT + ACCESS_FLASH_PAGE_COUNT + \
+                                                 MESH_APP_SIZING_KEY_CACHE_FLASH_PAGES +          \
+                                                 MESH_APP_SIZING_CORE_FLASH_PAGES)
+/** Total persistent storage in bytes. */
+#define MESH_APP_SIZING_FLASH_BYTES             (MESH_APP_SIZING_FLASH_PAGES * MESH_APP_SIZING_FLASH_PAGE_SIZE)
+
+/** RAM of the mesh memory pools. Uses the class sizes from mesh_mem_pool.h, which must be included
+ * where this is expanded. */
+#define MESH_APP_SIZING_MEM_POOLS_RAM           (MESH_APP_SIZING_MEM_POOL_RAM(MESH_MEM_POOL_SMALL_SIZE,       \
+                                                                              MESH_MEM_POOL_SMALL_COUNT) +    \
+                                                 MESH_APP_SIZING_MEM_POOL_RAM(MESH_MEM_POOL_MEDIUM_SIZE,      \
+                                                                              MESH_MEM_POOL_MEDIUM_COUNT) +   \
+                                                 MESH_APP_SIZING_MEM_POOL_RAM(MESH_MEM_POOL_LARGE_SIZE,       \
+                                                                              MESH_MEM_POOL_LARGE_COUNT))
+
+/** Estimated RAM used by the storage that scales with the profile. */
+#define MESH_APP_SIZING_RAM_BYTES               (DSM_SUBNET_MAX * MESH_APP_SIZING_SUBNET_RAM +                \
+                                                 DSM_APP_MAX * MESH_APP_SIZING_APPKEY_RAM +                   \
+                                                 DSM_DEVICE_MAX * MESH_APP_SIZING_DEVKEY_RAM +                \
+                                                 DSM_NONVIRTUAL_ADDR_MAX * MESH_APP_SIZING_NONVIRTUAL_RAM +   \
+                                                 DSM_VIRTUAL_ADDR_MAX * MESH_APP_SIZING_VIRTUAL_RAM +         \
+                                                 REPLAY_CACHE_ENTRIES * MESH_APP_SIZING_REPLAY_RAM +          \
+                                                 (1 << REPLAY_CACHE_HASH_BITS) *                              \
+                                                 MESH_APP_SIZING_REPLAY_SLOT_RAM +                            \
+                                                 MSG_CACHE_ENTRY_COUNT * MESH_APP_SIZING_MSG_CACHE_RAM +      \
+                                                 (1 << MSG_CACHE_HASH_BITS) *                                 \
+                                                 MESH_APP_SIZING_MSG_CACHE_BUCKET_RAM +                       \
+                                                 MESH_APP_SIZING_MEM_POOLS_RAM +                              \
+                                                 ACCESS_SUBSCRIPTION_LIST_COUNT *                             \
+                                                 ((MESH_APP_SIZING_ADDR_COUNT + 31) / 32 * 4) +               \
+                                                 MESH_APP_SIZING_ADDR_COUNT * MESH_APP_SIZING_SUB_INDEX_RAM)
+
+/** Logs the selected profile and its RAM and flash cost. */
+void mesh_app_sizing_log(void);
+
+/** @} end of MESH_APP_SIZING */
+
+#endif /* MESH_APP_SIZING_H__ */
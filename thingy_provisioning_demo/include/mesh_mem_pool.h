@@ -0,0 +1,181 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MESH_MEM_POOL_H__
+#define MESH_MEM_POOL_H__
+
+#include <stdint.h>
+#include "nrf_mesh_config_core.h"
+
+/**
+ * @defgroup MESH_MEM_POOL Fixed-block mesh memory backend
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Implementation of the mesh_mem API on size-class block pools (nrf_balloc) instead of malloc.
+ *
+ * Each allocation is served by the smallest size class that fits it. If that class is exhausted,
+ * the next larger class is tried, so an allocation touches at most @ref MESH_MEM_POOL_CLASS_COUNT
+ * pools and both allocation and free run in constant time, without fragmentation. Allocations
+ * that no class can serve return @c NULL and are counted as failures.
+ *
+ * The stack allocates in units of lower transport segments: a SAR receive buffer holds
+ * SegN + 1 segments of @ref MESH_MEM_POOL_SEGMENT_SIZE bytes, a SAR transmit buffer holds the access
+ * message and its MIC, and unsegmented messages fit in one segment plus the MIC. The class sizes
+ * are therefore given in segments:
+ * - Small blocks for unsegmented messages and reliable transfer contexts
+ *   (@ref ACCESS_RELIABLE_TRANSFER_COUNT).
+ * - Medium blocks for short segmented messages, such as most Config Server status messages.
+ * - Large blocks for SAR buffers of up to a full upper transport PDU.
+ *
+ * The allocator keeps a histogram of the requested sizes in segments
+ * (@ref mesh_mem_pool_size_histogram_get), printed with per-class statistics by the "mem" command of
+ * the debug console. Retune the segment counts and block counts from the histogram and the
+ * high-water marks of a representative run. With @ref MESH_MEM_POOL_TRACE_ENABLED every allocation
+ * and free is logged, and test/bench_mesh_mem_pool replays the captured log against malloc.
+ *
+ * Nothing else in the application uses malloc, so the heap is sized to 0 and the pools are part of
+ * @ref MESH_APP_SIZING_RAM_BYTES.
+ * @{
+ */
+
+/** Payload size of a lower transport segment, the allocation granularity of the stack. */
+#define MESH_MEM_POOL_SEGMENT_SIZE  (12)
+
+/** Block size of the small class, in segments. One segment and the MIC. */
+#ifndef MESH_MEM_POOL_SMALL_SEGMENTS
+#define MESH_MEM_POOL_SMALL_SEGMENTS    (2)
+#endif
+/** Number of blocks in the small class. */
+#ifndef MESH_MEM_POOL_SMALL_COUNT
+#define MESH_MEM_POOL_SMALL_COUNT   (ACCESS_RELIABLE_TRANSFER_COUNT * 2)
+#endif
+/** Block size of the medium class, in segments. */
+#ifndef MESH_MEM_POOL_MEDIUM_SEGMENTS
+#define MESH_MEM_POOL_MEDIUM_SEGMENTS   (8)
+#endif
+/** Number of blocks in the medium class. */
+#ifndef MESH_MEM_POOL_MEDIUM_COUNT
+#define MESH_MEM_POOL_MEDIUM_COUNT  (TRANSPORT_SAR_SESSIONS_MAX * 2)
+#endif
+/** Number of blocks in the large class. */
+#ifndef MESH_MEM_POOL_LARGE_COUNT
+#define MESH_MEM_POOL_LARGE_COUNT   (TRANSPORT_SAR_SESSIONS_MAX)
+#endif
+
+/** Block size of the small class. */
+#define MESH_MEM_POOL_SMALL_SIZE    (MESH_MEM_POOL_SMALL_SEGMENTS * MESH_MEM_POOL_SEGMENT_SIZE)
+/** Block size of the medium class. */
+#define MESH_MEM_POOL_MEDIUM_SIZE   (MESH_MEM_POOL_MEDIUM_SEGMENTS * MESH_MEM_POOL_SEGMENT_SIZE)
+/** Block size of the large class, a full upper transport PDU. */
+#define MESH_MEM_POOL_LARGE_SIZE    (NRF_MESH_UPPER_TRANSPORT_PDU_SIZE_MAX)
+
+/** Number of segments of a full upper transport PDU. */
+#define MESH_MEM_POOL_SEGMENTS_MAX  ((NRF_MESH_UPPER_TRANSPORT_PDU_SIZE_MAX + MESH_MEM_POOL_SEGMENT_SIZE - 1) / \
+                                     MESH_MEM_POOL_SEGMENT_SIZE)
+/** Number of buckets of the size histogram: one per segment count from 0 to
+ * @ref MESH_MEM_POOL_SEGMENTS_MAX, and the last for larger requests. */
+#define MESH_MEM_POOL_SIZE_BUCKET_COUNT (MESH_MEM_POOL_SEGMENTS_MAX + 2)
+
+/** Logs every allocation and free, for replay by the host benchmark. */
+#ifndef MESH_MEM_POOL_TRACE_ENABLED
+#define MESH_MEM_POOL_TRACE_ENABLED (0)
+#endif
+
+/** Size classes. */
+typedef enum
+{
+    MESH_MEM_POOL_CLASS_SMALL,
+    MESH_MEM_POOL_CLASS_MEDIUM,
+    MESH_MEM_POOL_CLASS_LARGE,
+    /** Large-sized blocks in a region donated with @ref mesh_mem_pool_region_add. */
+    MESH_MEM_POOL_CLASS_REGION,
+    MESH_MEM_POOL_CLASS_COUNT
+} mesh_mem_pool_class_t;
+
+/** Statistics of a size class. */
+typedef struct
+{
+    /** Block size in bytes. */
+    uint16_t block_size;
+    /** Number of blocks. */
+    uint16_t block_count;
+    /** Blocks currently allocated. */
+    uint16_t in_use;
+    /** Highest number of blocks allocated at the same time. */
+    uint16_t hwm;
+    /** Largest request served by the class, in bytes. */
+    uint16_t request_max;
+} mesh_mem_pool_stats_t;
+
+/**
+ * Donates a RAM region to the allocator.
+ *
+ * The region is split into large-sized blocks that are used when the large class is exhausted.
+ * The region must stay reserved for the allocator until reset.
+ *
+ * @param[in] p_region Word-aligned start of the region, may be @c NULL if @p size is 0.
+ * @param[in] size     Size of the region in bytes.
+ */
+void mesh_mem_pool_region_add(void * p_region, uint32_t size);
+
+/**
+ * Gets the statistics of a size class.
+ *
+ * @param[in]  size_class Size class.
+ * @param[out] p_stats    Statistics of the class.
+ */
+void mesh_mem_pool_stats_get(mesh_mem_pool_class_t size_class, mesh_mem_pool_stats_t * p_stats);
+
+/**
+ * Gets the histogram of requested sizes.
+ *
+ * Bucket @c n counts the requests that need @c n segments, the last bucket the requests larger than
+ * a full upper transport PDU. The counts saturate at @c UINT16_MAX.
+ *
+ * @param[out] p_counts Array of @ref MESH_MEM_POOL_SIZE_BUCKET_COUNT counts.
+ */
+void mesh_mem_pool_size_histogram_get(uint16_t * p_counts);
+
+/**
+ * Gets the number of failed allocations.
+ *
+ * @returns Number of allocations that returned @c NULL.
+ */
+uint32_t mesh_mem_pool_failures_get(void);
+
+/** @} end of MESH_MEM_POOL */
+
+#endif /* MESH_MEM_POOL_H__ */
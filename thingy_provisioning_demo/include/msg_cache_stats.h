@@ -0,0 +1,79 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MSG_CACHE_STATS_H__
+#define MSG_CACHE_STATS_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup MSG_CACHE_STATS Network message cache statistics
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Statistics of the hashed network message cache in SDKPatch/msg_cache.c.
+ *
+ * The cache keeps the (SRC, SEQ) pairs of recent network PDUs in arrival order, indexed by a
+ * chained hash table, so duplicate checks and inserts take constant time. Entries are only
+ * evicted when the cache is full, oldest first, so a PDU is recognised for as long as its entry
+ * is in the cache. An entry should reach @ref MSG_CACHE_MAX_AGE_MS before it is evicted.
+ * @{
+ */
+
+/** Message cache statistics. */
+typedef struct
+{
+    /** Duplicate checks. */
+    uint32_t lookups;
+    /** Duplicate checks that found the PDU in the cache. */
+    uint32_t hits;
+    /** Entries evicted to make room after they reached the maximum age. */
+    uint32_t age_evictions;
+    /** Entries evicted before reaching the maximum age because the cache was full. */
+    uint32_t capacity_evictions;
+    /** Number of entries in the cache. */
+    uint32_t entries;
+} msg_cache_stats_t;
+
+/**
+ * Gets the message cache statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void msg_cache_stats_get(msg_cache_stats_t * p_stats);
+
+/** @} end of MSG_CACHE_STATS */
+
+#endif /* MSG_CACHE_STATS_H__ */
@@ -142,6 +142,21 @@ typedef struct
      */
     const uint8_t * p_static_data;
 
+    /**
+     * Only offer static OOB authentication, for provisioning without a human in the loop
+     * (see @ref FACTORY_OOB). @c auth_output_cb is not used and can be set to @c NULL.
+     */
+    bool static_oob_only;
+
+    /**
+     * Output OOB actions offered, a combination of @c NRF_MESH_PROV_OOB_OUTPUT_ACTION_* flags.
+     * Set to 0 to not offer output OOB.
+     */
+    uint16_t oob_output_actions;
+
+    /** Maximum number of digits (or blinks, beeps...) of the output OOB value. */
+    uint8_t oob_output_size;
+
 } mesh_provisionee_start_params_t;
 
 /**
@@ -165,6 +180,12 @@ uint32_t mesh_provisionee_prov_start(const mesh_provisionee_start_params_t * p_s
  */
 uint32_t mesh_provisionee_prov_listen_stop(void);
 
+/**
+ * Advertises at the fast cadence again while waiting to be provisioned, see @ref PROV_CADENCE.
+ * Has no effect when the device is not listening, e.g. during provisioning.
+ */
+void mesh_provisionee_prov_boost(void);
+
 /**
  * @}
  */
@@ -38,6 +38,8 @@
 #ifndef NRF_MESH_CONFIG_APP_H__
 #define NRF_MESH_CONFIG_APP_H__
 
+#include "light_switch_example_common.h"
+
 /**
  * @defgroup NRF_MESH_CONFIG_APP nRF Mesh app config
  *
@@ -63,6 +65,62 @@
 
 /** @} end of DEVICE_CONFIG */
 
+/**
+ * @defgroup MESH_APP_SIZING_CONFIG Network sizing profile
+ * Build-time profile from which the DSM, access layer and replay protection limits are derived.
+ *
+ * Select the profile by defining @ref MESH_APP_SIZING_PROFILE in the project preprocessor
+ * definitions. The RAM and flash cost of the resulting configuration is computed in
+ * mesh_app_sizing.h, and the build fails if it does not fit the target.
+ * @{
+ */
+/** Small network: the light switch example topology. */
+#define MESH_APP_SIZING_SMALL                           (0)
+/** Medium network: a floor with room and floor scenes. */
+#define MESH_APP_SIZING_MEDIUM                          (1)
+/** Large network: a building with room, floor and building scenes. */
+#define MESH_APP_SIZING_LARGE                           (2)
+
+#ifndef MESH_APP_SIZING_PROFILE
+/** Selected sizing profile. */
+#define MESH_APP_SIZING_PROFILE                         MESH_APP_SIZING_SMALL
+#endif
+
+#if MESH_APP_SIZING_PROFILE == MESH_APP_SIZING_SMALL
+/** Number of nodes in the network. */
+#define MESH_APP_TARGET_NODE_COUNT                      (SERVER_NODE_COUNT + CLIENT_NODE_COUNT)
+/** Number of group addresses a node subscribes to. */
+#define MESH_APP_TARGET_GROUP_COUNT                     (1)
+/** Number of virtual addresses a node uses. */
+#define MESH_APP_TARGET_VIRTUAL_COUNT                   (1)
+/** Number of subnetworks a node belongs to. */
+#define MESH_APP_TARGET_SUBNET_COUNT                    (4)
+/** Number of application keys a node holds. */
+#define MESH_APP_TARGET_APPKEY_COUNT                    (8)
+/** Message cache entries needed to recognise every copy of a flood, see @ref MSG_CACHE_CONFIG. */
+#define MESH_APP_TARGET_FLOOD_CACHE_ENTRIES             (96)
+#elif MESH_APP_SIZING_PROFILE == MESH_APP_SIZING_MEDIUM
+#define MESH_APP_TARGET_NODE_COUNT                      (100)
+#define MESH_APP_TARGET_GROUP_COUNT                     (8)
+#define MESH_APP_TARGET_VIRTUAL_COUNT                   (2)
+#define MESH_APP_TARGET_SUBNET_COUNT                    (4)
+#define MESH_APP_TARGET_APPKEY_COUNT                    (8)
+#define MESH_APP_TARGET_FLOOD_CACHE_ENTRIES             (160)
+#elif MESH_APP_SIZING_PROFILE == MESH_APP_SIZING_LARGE
+#define MESH_APP_TARGET_NODE_COUNT                      (200)
+#define MESH_APP_TARGET_GROUP_COUNT                     (16)
+#define MESH_APP_TARGET_VIRTUAL_COUNT                   (4)
+#define MESH_APP_TARGET_SUBNET_COUNT                    (8)
+#define MESH_APP_TARGET_APPKEY_COUNT                    (16)
+#define MESH_APP_TARGET_FLOOD_CACHE_ENTRIES             (224)
+#else
+#error "Unknown MESH_APP_SIZING_PROFILE"
+#endif
+
+/** Number of publication addresses in use (Generic OnOff and Health publication). */
+#define MESH_APP_PUBLICATION_ADDR_COUNT                 (2)
+/** @} end of MESH_APP_SIZING_CONFIG */
+
 /**
  * @defgroup ACCESS_CONFIG Access layer configuration
  * @{
@@ -78,8 +136,16 @@
  *
  * @note To fit the configuration and health models, this value must equal at least
  * the number of models needed by the application plus two.
+ * - Configuration server
+ * - Health server
+ * - Generic OnOff server
+ * - Generic OnOff client
+ * - Diagnostics server
+ * - Latency probe
+ * - Generic Power OnOff server
+ * - Generic Power OnOff setup server
  */
-#define ACCESS_MODEL_COUNT (4)
+#define ACCESS_MODEL_COUNT (8)
 
 /**
  * The number of elements in the application.
@@ -93,14 +159,15 @@
  * The number of allocated subscription lists for the application.
  *
  * @note This value must equal @ref ACCESS_MODEL_COUNT minus the number of
- * models operating on shared states.
+ * models operating on shared states. The Generic Power OnOff setup server shares the
+ * list of the Generic Power OnOff server.
  */
-#define ACCESS_SUBSCRIPTION_LIST_COUNT (ACCESS_MODEL_COUNT)
+#define ACCESS_SUBSCRIPTION_LIST_COUNT (ACCESS_MODEL_COUNT - 1)
 
 /**
  * The number of pages of flash storage reserved for the access layer for persistent data storage.
  */
-#define ACCESS_FLASH_PAGE_COUNT (1)
+#define ACCESS_FLASH_PAGE_COUNT (MESH_APP_SIZING_ACCESS_FLASH_PAGES)
 
 /**
  * @defgroup ACCESS_RELIABLE_CONFIG Configuration of access layer reliable transfer
@@ -122,23 +189,116 @@
  * @{
  */
 /** Maximum number of subnetworks. */
-#define DSM_SUBNET_MAX                                  (4)
+#define DSM_SUBNET_MAX                                  (MESH_APP_TARGET_SUBNET_COUNT)
 /** Maximum number of applications. */
-#define DSM_APP_MAX                                     (8)
+#define DSM_APP_MAX                                     (MESH_APP_TARGET_APPKEY_COUNT)
 /** Maximum number of device keys. */
 #define DSM_DEVICE_MAX                                  (1)
 /** Maximum number of virtual addresses. */
-#define DSM_VIRTUAL_ADDR_MAX                            (1)
+#define DSM_VIRTUAL_ADDR_MAX                            (MESH_APP_TARGET_VIRTUAL_COUNT)
 /** Maximum number of non-virtual addresses.
  * - Generic OnOff publication
  * - Health publication
- * - Subscription address
+ * - Subscription addresses
  */
-#define DSM_NONVIRTUAL_ADDR_MAX                         (3)
+#define DSM_NONVIRTUAL_ADDR_MAX                         (MESH_APP_PUBLICATION_ADDR_COUNT + MESH_APP_TARGET_GROUP_COUNT)
 /** Number of flash pages reserved for the DSM storage. */
-#define DSM_FLASH_PAGE_COUNT                            (1)
+#define DSM_FLASH_PAGE_COUNT                            (MESH_APP_SIZING_DSM_FLASH_PAGES)
 /** @} end of DSM_CONFIG */
 
+/**
+ * @defgroup REPLAY_CACHE_CONFIG Replay protection configuration
+ * @{
+ */
+/** Replay protection entries reserved for the provisioner and configuration clients. */
+#define REPLAY_CACHE_PROVISIONER_ENTRIES                (2)
+/** Size of the replay protection list.
+ * Every node in the network can send from each of its elements, so one entry is reserved per
+ * element of every node, plus the provisioner.
+ */
+#define REPLAY_CACHE_ENTRIES                            (MESH_APP_TARGET_NODE_COUNT * ACCESS_ELEMENT_COUNT + \
+                                                         REPLAY_CACHE_PROVISIONER_ENTRIES)
+/** Number of bits of the replay protection hash index, for a load factor of at most 50 %. */
+#define REPLAY_CACHE_HASH_BITS                          MESH_APP_SIZING_HASH_BITS(REPLAY_CACHE_ENTRIES * 2)
+/** @} end of REPLAY_CACHE_CONFIG */
+
+/**
+ * @defgroup MSG_CACHE_CONFIG Network message cache configuration
+ * The network message cache holds the (SRC, SEQ) pair of every recently received network PDU, so
+ * that copies of a flooded message arriving through other relays are dropped instead of being
+ * relayed again. Entries are only evicted to make room, oldest first, so the cache is sized for
+ * the larger of two needs: every PDU heard within @ref MSG_CACHE_MAX_AGE_MS at the peak packet
+ * rate, and the worst flood of the network size of the profile. For the latter, test/sim_mesh.c
+ * measures how many newer PDUs a node has cached when the last copy of a PDU arrives, with one
+ * node in four pressing its switch at once and every server publishing its Status: 63 at 50
+ * nodes, 113 at 100 and 159 at 200. @ref MESH_APP_TARGET_FLOOD_CACHE_ENTRIES adds at least 40% to
+ * these, and the simulation fails if a copy is missed with the cache of the profile.
+ * @{
+ */
+/** Peak rate of network PDUs heard by a relay, in packets per second (10,000 per minute). */
+#define MESH_APP_PEAK_PACKET_RATE                       (167)
+/** Time a PDU should at least stay in the message cache at the peak packet rate. Copies of a
+ * flooded message arrive within a few hundred milliseconds, even over @ref ACCESS_DEFAULT_TTL relay
+ * hops. Entries evicted younger than this are counted as capacity evictions. */
+#define MSG_CACHE_MAX_AGE_MS                            (1000)
+/** Message cache entries for the PDUs heard within @ref MSG_CACHE_MAX_AGE_MS at the peak rate. */
+#define MSG_CACHE_RATE_ENTRIES                          (MESH_APP_PEAK_PACKET_RATE * MSG_CACHE_MAX_AGE_MS / 1000)
+/** Number of message cache entries. */
+#define MSG_CACHE_ENTRY_COUNT                           (MSG_CACHE_RATE_ENTRIES > MESH_APP_TARGET_FLOOD_CACHE_ENTRIES ? \
+                                                         MSG_CACHE_RATE_ENTRIES : MESH_APP_TARGET_FLOOD_CACHE_ENTRIES)
+/** Number of bits of the message cache hash index, for a load factor of at most 1. */
+#define MSG_CACHE_HASH_BITS                             MESH_APP_SIZING_HASH_BITS(MSG_CACHE_ENTRY_COUNT)
+/** @} end of MSG_CACHE_CONFIG */
+
+/**
+ * @defgroup TIMER_SCH_CONFIG Timer scheduler configuration
+ * The timer scheduler of SDKPatch/timer_scheduler.c keeps the pending mesh and application timers
+ * in a fixed-size heap. The high-water mark is reported in the diag counters.
+ * @{
+ */
+/** Maximum number of pending timers: about 30 in the mesh stack and the models, and the
+ * application timers of @ref TIMER_SERVICE, with headroom. */
+#define TIMER_SCH_EVENTS_MAX                            (64)
+/** @} end of TIMER_SCH_CONFIG */
+
+/**
+ * @defgroup SEQNUM_CONFIG Sequence number persistence
+ * The network layer reserves sequence numbers in blocks. Before the current block runs out, the
+ * start of the next block is written to flash (write-ahead), and only then are numbers from it
+ * used. After a power loss the node resumes from the stored block start, skipping the unused part
+ * of the block, so a sequence number is never reused.
+ *
+ * Every switch press sends 1 + @c APP_UNACK_MSG_REPEAT_COUNT messages, so a busy switch node
+ * consumes sequence numbers quickly. A larger block covers more messages per flash write: with
+ * 16384 numbers per block there is one write per 16384 messages, half as many as with the stack
+ * default of 8192.
+ *
+ * The price is paid at every reboot: the node resumes from the stored block start, so up to
+ * @c NETWORK_SEQNUM_FLASH_BLOCK_SIZE + @c NETWORK_SEQNUM_FLASH_BLOCK_THRESHOLD sequence numbers are
+ * skipped, about half a block on average. An IV index covers 2^24 sequence numbers, which is 2048
+ * reboots with the stack default and only 1024 with 16384, before the node has to wait for an IV
+ * update to send again. Every Thingy of this application is a light, and lights are power cycled
+ * often, e.g. when mains switched, so the stack default is kept. A build for nodes that are only
+ * switches and rarely reboot can define @c NETWORK_SEQNUM_FLASH_BLOCK_SIZE as 16384 in the
+ * project preprocessor definitions.
+ *
+ * test/sim_seqnum.c simulates the reservation on a fake flash with random power losses and reports
+ * flash writes per 10,000 messages for the stack default, the application setting and a switch
+ * only block of 16384 (`make -C test sim`).
+ * @{
+ */
+/** Number of sequence numbers reserved with each flash write, the stack default. */
+#ifndef NETWORK_SEQNUM_FLASH_BLOCK_SIZE
+#define NETWORK_SEQNUM_FLASH_BLOCK_SIZE                 (8192)
+#endif
+/** Remaining sequence numbers in the current block when the next block is written to flash.
+ * Leaves room for bursts of presses while the flash write is waiting for a timeslot.
+ */
+#define NETWORK_SEQNUM_FLASH_BLOCK_THRESHOLD            (256)
+/** Flash writes per 10,000 messages, times 100. */
+#define MESH_APP_SEQNUM_FLASH_WRITES_PER_10K_X100       ((10000 * 100) / NETWORK_SEQNUM_FLASH_BLOCK_SIZE)
+/** @} end of SEQNUM_CONFIG */
+
 /** @} */
 
 /**
@@ -173,4 +333,6 @@
 
 /** @} end of NRF_MESH_CONFIG_CORE */
 
+#include "mesh_app_sizing.h"
+
 #endif /* NRF_MESH_CONFIG_APP_H__ */
@@ -0,0 +1,112 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OOB_COLOR_H__
+#define OOB_COLOR_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup OOB_COLOR Color coded output OOB
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Shows a numeric output OOB value on the lightwell LED, one decimal digit at a time, so that
+ * every digit is read off the table below and typed as it is shown. The provisioner asks for
+ * Output Numeric with @ref OOB_COLOR_OUTPUT_SIZE digits, the same authentication strength as
+ * the blink output.
+ *
+ * A digit is one of five colors, steady for 0 to 4 and flashing for 5 to 9. Only colors with
+ * every LED channel fully on or off are used, and of those cyan and magenta, the mixes closest
+ * to green, blue and red on the lightwell, are left out.
+ *
+ * | Color  | Steady | Flashing |
+ * |--------|--------|----------|
+ * | White  | 0      | 5        |
+ * | Red    | 1      | 6        |
+ * | Green  | 2      | 7        |
+ * | Blue   | 3      | 8        |
+ * | Yellow | 4      | 9        |
+ *
+ * For example steady red, flashing blue, steady white, flashing white, steady yellow is 18054.
+ *
+ * The flashing is run by the LED engine of the SX1509 IO extender (drv_ext_light_rgb_sequence()),
+ * on and off for @ref OOB_COLOR_FLASH_MS each, so it keeps its timing whatever the CPU and the
+ * TWI bus are doing. The application timer only moves from one digit to the next: every digit is
+ * shown for @ref OOB_COLOR_DIGIT_MS, two flashes, followed by @ref OOB_COLOR_GAP_MS dark so that
+ * repeated digits are seen apart. After the last digit the LED stays dark for
+ * @ref OOB_COLOR_REPEAT_GAP_MS and the sequence repeats until @ref oob_color_stop is called.
+ *
+ * A sequence takes @ref OOB_COLOR_SEQUENCE_MS, 1.95 s, against 2.7 s for the six base 7 colors
+ * this replaces and up to 50 s for counting 99 blinks. It cannot be brought under 1 s: five
+ * digits in 1 s leave 200 ms per digit with its gap, less than two flash periods at the shortest
+ * on/off step of the SX1509, so a flashing digit would be a single short pulse, hard to tell from
+ * a steady one. Fewer digits would fit, but would weaken the authentication.
+ * @{
+ */
+
+/** Output OOB size in decimal digits. The provisioner picks a value below 10^5. */
+#define OOB_COLOR_OUTPUT_SIZE       (5)
+/** Number of colors, each shown steady or flashing. */
+#define OOB_COLOR_COUNT             (5)
+/** On and off time of a flashing digit: one step of the SX1509 on/off time registers,
+ * 64 * 255 clock cycles of ClkX, at the 250 kHz ClkX set in main.c (2 MHz divided by 8). */
+#define OOB_COLOR_FLASH_MS          (65)
+/** Time a digit is shown, two flash periods. */
+#define OOB_COLOR_DIGIT_MS          (4 * OOB_COLOR_FLASH_MS)
+/** Dark time after a digit. */
+#define OOB_COLOR_GAP_MS            (2 * OOB_COLOR_FLASH_MS)
+/** Time to show every digit once. */
+#define OOB_COLOR_SEQUENCE_MS       (OOB_COLOR_OUTPUT_SIZE * (OOB_COLOR_DIGIT_MS + OOB_COLOR_GAP_MS))
+/** Additional dark time before the sequence repeats. */
+#define OOB_COLOR_REPEAT_GAP_MS     (1000)
+
+/** Initializes the module. Must be called after app_timer_init(). */
+void oob_color_init(void);
+
+/**
+ * Starts showing a value. A value that is already shown is replaced.
+ *
+ * @param[in] value Value to show, the @ref OOB_COLOR_OUTPUT_SIZE least significant decimal digits
+ *                  are shown, most significant first.
+ */
+void oob_color_show(uint32_t value);
+
+/** Stops showing the value and turns the lightwell off. */
+void oob_color_stop(void);
+
+/** @} end of OOB_COLOR */
+
+#endif /* OOB_COLOR_H__ */
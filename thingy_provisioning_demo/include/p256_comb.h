@@ -0,0 +1,103 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef P256_COMB_H__
+#define P256_COMB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup P256_COMB Fixed-base P-256 key generation
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Computes P-256 public keys with a fixed-base comb over a precomputed table in flash, for the
+ * provisioning key pair generated in @ref provisionee_start.
+ *
+ * micro-ecc computes the public key with the same Montgomery ladder it uses for ECDH, 256
+ * conditional swaps, doublings and additions on a variable point. For the fixed generator the
+ * scalar is instead split into @ref P256_COMB_TEETH interleaved 64 bit slices, and each of the
+ * 64 comb columns costs one doubling and one addition of a point read from a 16 entry table of
+ * the sums of 2^(64 j) G. The table (1 kB) is generated by test/gen_p256_comb_table.py.
+ *
+ * The multiplication runs in constant time: the field arithmetic has no data dependent
+ * branches, every table entry is read for each column, and the complete addition formulas of
+ * Renes, Costello and Batina handle doubling and the point at infinity without special cases.
+ * The field multiplication is a word-serial Montgomery multiplication, whose 32 x 32 + 32 + 32
+ * bit multiply-accumulate steps compile to UMAAL on Cortex-M4.
+ *
+ * The keys are in the format of micro-ecc and @ref nrf_mesh_prov_generate_keys: big endian
+ * private key, and big endian X followed by Y for the public key. The ECDH shared secret is still
+ * computed by micro-ecc in the mesh stack.
+ * @{
+ */
+
+/** Size of a private key in bytes. */
+#define P256_COMB_PRIVATE_KEY_SIZE (32)
+/** Size of a public key in bytes. */
+#define P256_COMB_PUBLIC_KEY_SIZE  (64)
+/** Number of scalar slices of the comb. */
+#define P256_COMB_TEETH            (4)
+/** Number of entries of the comb table. */
+#define P256_COMB_TABLE_SIZE       (1 << P256_COMB_TEETH)
+
+/** Comb table, generated by test/gen_p256_comb_table.py. */
+extern const uint32_t p256_comb_table[P256_COMB_TABLE_SIZE][2][8];
+
+/**
+ * Computes the public key of a private key.
+ *
+ * @param[in]  p_private Private key, big endian.
+ * @param[out] p_public  Public key, big endian X and Y.
+ *
+ * @retval true  The public key was computed.
+ * @retval false The private key is zero or not below the group order, @p p_public is unchanged.
+ */
+bool p256_comb_public_key_compute(const uint8_t * p_private, uint8_t * p_public);
+
+/**
+ * Generates a key pair from the hardware random number generator.
+ *
+ * Random values outside the valid private key range are drawn again.
+ *
+ * @param[out] p_public  Public key, big endian X and Y.
+ * @param[out] p_private Private key, big endian.
+ */
+void p256_comb_key_pair_generate(uint8_t * p_public, uint8_t * p_private);
+
+/** @} end of P256_COMB */
+
+#endif /* P256_COMB_H__ */
@@ -0,0 +1,81 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PONOFF_SERVER_H__
+#define PONOFF_SERVER_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup PONOFF_SERVER Generic Power OnOff server
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Generic Power OnOff Server and Generic Power OnOff Setup Server, exposing the Generic
+ * OnPowerUp state of the light kept by @ref LIGHT_STATE.
+ *
+ * Both models must be on the element of the Generic OnOff server. The setup server shares the
+ * subscription list of the server. A change of the OnPowerUp state is published by the server.
+ * @{
+ */
+
+/** Generic Power OnOff Server model ID. */
+#define PONOFF_SERVER_MODEL_ID          (0x1006)
+/** Generic Power OnOff Setup Server model ID. */
+#define PONOFF_SETUP_SERVER_MODEL_ID    (0x1007)
+
+/** Generic OnPowerUp Get opcode. */
+#define PONOFF_OPCODE_GET               (0x8211)
+/** Generic OnPowerUp Status opcode. */
+#define PONOFF_OPCODE_STATUS            (0x8212)
+/** Generic OnPowerUp Set opcode. */
+#define PONOFF_OPCODE_SET               (0x8213)
+/** Generic OnPowerUp Set Unacknowledged opcode. */
+#define PONOFF_OPCODE_SET_UNACKNOWLEDGED (0x8214)
+
+/**
+ * Adds the Generic Power OnOff Server and Setup Server models.
+ *
+ * @param[in] element_index Index of the element with the Generic OnOff server.
+ *
+ * @retval NRF_SUCCESS             The models were added.
+ * @retval NRF_ERROR_INVALID_STATE The models were already added.
+ * @returns Other errors from access_model_add().
+ */
+uint32_t ponoff_server_init(uint16_t element_index);
+
+/** @} end of PONOFF_SERVER */
+
+#endif /* PONOFF_SERVER_H__ */
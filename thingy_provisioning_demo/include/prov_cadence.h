@@ -0,0 +1,100 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROV_CADENCE_H__
+#define PROV_CADENCE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup PROV_CADENCE Adaptive unprovisioned advertising cadence
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Limits the air time used by an unprovisioned device that nobody provisions, so that a large
+ * number of unprovisioned devices do not saturate the advertising channels and slow down the
+ * provisioner's scanning.
+ *
+ * The unprovisioned beacon (PB-ADV) and PB-GATT advertising intervals are fixed by the mesh
+ * stack, so the cadence is adapted by switching provisioning listening on and off. The device
+ * listens continuously for @ref PROV_CADENCE_FAST_MS after listening is started, and after
+ * @ref prov_cadence_boost is called, e.g. on a button press. It then listens for windows of
+ * @ref PROV_CADENCE_WINDOW_MS separated by silent gaps that start at @ref PROV_CADENCE_GAP_MIN_MS
+ * and double after every window up to @ref PROV_CADENCE_GAP_MAX_MS. A random jitter of up to a
+ * quarter of the gap keeps devices that were powered up together from advertising together.
+ *
+ * When a provisioning link is opened the cadence is stopped, and when a link closes without the
+ * device being provisioned it is started again from the fast phase, so that a provisioner that
+ * has sent an invite finds the device quickly when it retries.
+ * @{
+ */
+
+/** Continuous listening time after start and boost. */
+#define PROV_CADENCE_FAST_MS        (10000)
+/** Listening window during backoff, long enough for three unprovisioned beacons, so that a
+ *  provisioner gets more than one chance to hear the device per window. */
+#define PROV_CADENCE_WINDOW_MS      (6100)
+/** First silent gap after the fast phase. */
+#define PROV_CADENCE_GAP_MIN_MS     (2000)
+/** Largest silent gap. */
+#define PROV_CADENCE_GAP_MAX_MS     (4000)
+
+/**
+ * Switches provisioning listening on or off.
+ *
+ * @param[in] listen @c true to start listening, @c false to stop.
+ */
+typedef void (*prov_cadence_listen_cb_t)(bool listen);
+
+/**
+ * Initializes the module. Must be called after app_timer_init().
+ *
+ * @param[in] listen_cb Function used to switch listening.
+ */
+void prov_cadence_init(prov_cadence_listen_cb_t listen_cb);
+
+/** Takes control of listening, which the caller has just started, beginning with the fast phase. */
+void prov_cadence_start(void);
+
+/** Returns to the fast phase, starting listening if it is in a gap. Has no effect when stopped. */
+void prov_cadence_boost(void);
+
+/** Releases control of listening, leaving its current state, e.g. when a link is opened. */
+void prov_cadence_stop(void);
+
+/** @} end of PROV_CADENCE */
+
+#endif /* PROV_CADENCE_H__ */
@@ -0,0 +1,106 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RAM_OVERLAY_H__
+#define RAM_OVERLAY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup RAM_OVERLAY Provisioning RAM overlay
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * RAM region shared between the provisioning phase and runtime consumers.
+ *
+ * State that is only needed while the device is unprovisioned (provisioning context, ECDH key pair
+ * and provisioning bearers) is placed in the @c .ram_overlay section with @ref RAM_OVERLAY. Once
+ * the device is known to be provisioned, the region is released and handed out to runtime
+ * consumers with @ref ram_overlay_alloc. The size of the region is listed for the @c .ram_overlay
+ * output section in the linker map file, and is logged when the region is released.
+ *
+ * The region is released at boot only: the provisioning bearers stay registered with the stack
+ * after a provisioning session, so RAM used for provisioning in the current power cycle is
+ * reclaimed on the next reset.
+ * @{
+ */
+
+/** Places a variable in the provisioning RAM overlay. The variable is zeroed by @ref ram_overlay_init. */
+#define RAM_OVERLAY __attribute__((section(".ram_overlay")))
+
+/**
+ * Initializes the overlay region.
+ *
+ * Zeroes the region, as it is not covered by the startup code. Must be called before any
+ * provisioning state is used.
+ */
+void ram_overlay_init(void);
+
+/**
+ * Releases the overlay region from the provisioning phase.
+ *
+ * After this call, the provisioning state must not be used until reset.
+ */
+void ram_overlay_release(void);
+
+/**
+ * Checks whether the overlay region has been released.
+ *
+ * @returns Whether the region has been released.
+ */
+bool ram_overlay_is_released(void);
+
+/**
+ * Gets the number of bytes left for runtime consumers.
+ *
+ * @returns Number of unallocated bytes, 0 if the region has not been released.
+ */
+uint32_t ram_overlay_free_get(void);
+
+/**
+ * Allocates a word-aligned block from the released region.
+ *
+ * Blocks are never returned to the region.
+ *
+ * @param[in] size Size of the block in bytes.
+ *
+ * @returns Pointer to the block, or @c NULL if the region has not been released or is exhausted.
+ */
+void * ram_overlay_alloc(uint32_t size);
+
+/** @} end of RAM_OVERLAY */
+
+#endif /* RAM_OVERLAY_H__ */
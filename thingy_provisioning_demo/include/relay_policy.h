@@ -0,0 +1,144 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RELAY_POLICY_H__
+#define RELAY_POLICY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config_server_events.h"
+
+/**
+ * @defgroup RELAY_POLICY Density-aware relay suppression
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Optional policy that stops this node from relaying when its neighbours already rebroadcast
+ * enough copies of every PDU, in the spirit of counter-based flooding suppression.
+ *
+ * The network layer relays a PDU as soon as it is first received, so the decision cannot be made
+ * per PDU from the application. Instead, the policy counts copies per PDU in the network message
+ * cache (every duplicate is a copy rebroadcast by a neighbour) over a window of
+ * @ref RELAY_POLICY_WINDOW_MS with random jitter. When the average number of copies heard
+ * reaches @ref RELAY_POLICY_COPY_THRESHOLD, the node suppresses relaying for the next window with
+ * probability 1 - threshold / copies, so that in a dense area only about the threshold number of
+ * neighbours keep relaying. Each relay state is held for at least @ref RELAY_POLICY_HOLD_MS.
+ *
+ * Suppression is a runtime state only: relay transmissions are dropped when they are allocated,
+ * see @ref relay_policy_relay_allowed, and the Relay state of the Config Server is never written.
+ * Switching costs no flash write, a Config Client keeps reading the configured state, and a reset
+ * or power loss always starts with relaying as configured. The policy is only active while
+ * relaying is enabled by configuration.
+ * @{
+ */
+
+/** Whether the policy is enabled at boot. */
+#ifndef RELAY_POLICY_ENABLED_DEFAULT
+#define RELAY_POLICY_ENABLED_DEFAULT    (0)
+#endif
+/** Average number of copies per PDU from which relaying may be suppressed. */
+#ifndef RELAY_POLICY_COPY_THRESHOLD
+#define RELAY_POLICY_COPY_THRESHOLD     (4)
+#endif
+/** Base length of an evaluation window. */
+#define RELAY_POLICY_WINDOW_MS          (5000)
+/** Largest random jitter added to each window, desynchronizing the decisions of neighbours. */
+#define RELAY_POLICY_JITTER_MS          (1000)
+/** Minimum number of new PDUs in a window for a decision to be made. */
+#define RELAY_POLICY_MIN_PDUS           (8)
+/** Minimum time between two relay state changes. */
+#define RELAY_POLICY_HOLD_MS            (60000)
+
+/** Relay policy statistics. */
+typedef struct
+{
+    /** Relay transmissions refused at allocation because relaying was suppressed. */
+    uint32_t suppressed;
+    /** Relay transmissions let through to the core TX layer. */
+    uint32_t forwarded;
+    /** Number of relay state changes made by the policy. */
+    uint32_t state_changes;
+} relay_policy_stats_t;
+
+/** Initializes the relay policy. Must be called after the mesh stack has been initialized. */
+void relay_policy_init(void);
+
+/**
+ * Enables or disables the relay policy. Disabling it restores relaying if it was suppressed.
+ *
+ * @param[in] enabled Whether the policy is enabled.
+ */
+void relay_policy_enable(bool enabled);
+
+/**
+ * Checks whether the relay policy is enabled.
+ *
+ * @returns Whether the policy is enabled.
+ */
+bool relay_policy_is_enabled(void);
+
+/**
+ * Checks whether relay transmissions may be sent. Called for every relay packet allocated by
+ * the core TX module, packets are dropped while the policy suppresses relaying.
+ *
+ * @returns Whether relaying is allowed.
+ */
+bool relay_policy_relay_allowed(void);
+
+/**
+ * Counts a relay transmission at its allocation by the core TX module, as forwarded or as
+ * suppressed by the policy.
+ *
+ * @param[in] forwarded Whether the allocation was let through.
+ */
+void relay_policy_relay_count(bool forwarded);
+
+/**
+ * Gets the relay policy statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void relay_policy_stats_get(relay_policy_stats_t * p_stats);
+
+/**
+ * Config Server event handler. A Relay Set from a Config Client overrides the policy's state.
+ *
+ * @param[in] p_evt Config Server event.
+ */
+void relay_policy_config_server_evt(const config_server_evt_t * p_evt);
+
+/** @} end of RELAY_POLICY */
+
+#endif /* RELAY_POLICY_H__ */
@@ -0,0 +1,164 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SCAN_FILTER_H__
+#define SCAN_FILTER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+
+/**
+ * @defgroup SCAN_FILTER Scanner filter policy
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Application policy for the bearer scanner filters, dropping irrelevant advertisements before
+ * they reach the mesh network layer.
+ *
+ * Three filter stages are configured:
+ * - AD type: only mesh AD types (Mesh Message, Mesh Beacon and, while unprovisioned, PB-ADV)
+ *   are accepted.
+ * - RSSI: packets below an RSSI floor are dropped. In adaptive mode, the floor follows the rate
+ *   of mesh packets heard: it is raised by @ref SCAN_FILTER_RSSI_STEP_DB while more than
+ *   @ref SCAN_FILTER_RATE_HIGH packets per second arrive, and lowered again below
+ *   @ref SCAN_FILTER_RATE_LOW, bounded by @ref SCAN_FILTER_RSSI_FLOOR_MAX so that distant
+ *   neighbors in a sparse network are never cut off. The rate is measured in front of the RSSI
+ *   stage (packets accepted plus packets dropped by the RSSI filter), so raising the floor does not
+ *   lower the measured rate and the floor settles instead of oscillating.
+ *
+ *   The floor is also kept @ref SCAN_FILTER_NEIGHBOR_MARGIN_DB below the weakest neighbor that sent
+ *   a mesh message in the last @ref SCAN_FILTER_NEIGHBOR_TIMEOUT_MS, so a neighbor relaying
+ *   traffic to this node is never filtered out. Up to @ref SCAN_FILTER_NEIGHBORS_MAX neighbors are
+ *   tracked by advertiser address with an average of their RSSI. When a tracked neighbor goes
+ *   silent while the floor is raised, the floor is lowered one step, in case the floor silenced it.
+ * - GAP address: advertisers on the deny list are dropped.
+ *
+ * Drop counters of each stage are available through @ref scan_filter_stats_get and the
+ * diagnostics model.
+ * @{
+ */
+
+/** Lowest RSSI floor, in dBm. At this floor the RSSI filter is disabled. */
+#define SCAN_FILTER_RSSI_FLOOR_MIN  (-100)
+/** Highest RSSI floor the adaptive mode may set, in dBm. */
+#define SCAN_FILTER_RSSI_FLOOR_MAX  (-75)
+/** RSSI floor adjustment per adaptation period, in dB. */
+#define SCAN_FILTER_RSSI_STEP_DB    (3)
+/** Adaptation period of the RSSI floor. */
+#define SCAN_FILTER_ADAPT_INTERVAL_MS (2000)
+/** Mesh packet rate above which the RSSI floor is raised, in packets per second. */
+#define SCAN_FILTER_RATE_HIGH       (40)
+/** Mesh packet rate below which the RSSI floor is lowered, in packets per second. */
+#define SCAN_FILTER_RATE_LOW        (10)
+/** Number of neighbors whose RSSI is tracked. */
+#define SCAN_FILTER_NEIGHBORS_MAX   (16)
+/** Time after which a silent neighbor is no longer tracked. */
+#define SCAN_FILTER_NEIGHBOR_TIMEOUT_MS (60000)
+/** Margin between the weakest tracked neighbor and the RSSI floor, in dB. */
+#define SCAN_FILTER_NEIGHBOR_MARGIN_DB  (6)
+/** Size of the advertiser address deny list. */
+#define SCAN_FILTER_DENY_LIST_SIZE  (8)
+
+/** Scanner filter statistics. */
+typedef struct
+{
+    /** Packets dropped because of their AD type. */
+    uint32_t adtype_dropped;
+    /** Packets dropped below the RSSI floor. */
+    uint32_t rssi_dropped;
+    /** Packets dropped by the address deny list. */
+    uint32_t address_dropped;
+    /** Mesh packets that passed all filters. */
+    uint32_t accepted;
+    /** Number of neighbors currently tracked. */
+    uint8_t neighbor_count;
+    /** Average RSSI of the weakest tracked neighbor, in dBm, or 0 if none is tracked. */
+    int8_t neighbor_rssi_min;
+    /** Current RSSI floor, in dBm. */
+    int8_t rssi_floor;
+} scan_filter_stats_t;
+
+/**
+ * Initializes the filter policy: mesh-only AD types including PB-ADV and adaptive RSSI floor.
+ *
+ * Must be called after the mesh stack has been initialized.
+ */
+void scan_filter_init(void);
+
+/**
+ * Sets whether PB-ADV packets pass the AD type filter.
+ *
+ * @param[in] allowed Set to @c false once the device is provisioned.
+ */
+void scan_filter_pb_adv_set(bool allowed);
+
+/**
+ * Enables or disables the adaptive RSSI floor.
+ *
+ * @param[in] enabled Whether the floor adapts to the mesh packet rate.
+ */
+void scan_filter_rssi_adaptive_set(bool enabled);
+
+/**
+ * Sets a fixed RSSI floor and disables the adaptive mode.
+ *
+ * @param[in] rssi_floor Floor in dBm, @ref SCAN_FILTER_RSSI_FLOOR_MIN disables the filter.
+ */
+void scan_filter_rssi_floor_set(int8_t rssi_floor);
+
+/**
+ * Adds an advertiser to the deny list.
+ *
+ * @param[in] p_addr Address to deny.
+ *
+ * @retval NRF_SUCCESS      The address was added.
+ * @retval NRF_ERROR_NO_MEM The deny list is full.
+ */
+uint32_t scan_filter_deny_add(const ble_gap_addr_t * p_addr);
+
+/** Clears the deny list. */
+void scan_filter_deny_clear(void);
+
+/**
+ * Gets the filter statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void scan_filter_stats_get(scan_filter_stats_t * p_stats);
+
+/** @} end of SCAN_FILTER */
+
+#endif /* SCAN_FILTER_H__ */
@@ -101,9 +101,11 @@ bool hal_led_pin_get(void);
  * Blinks (one toggle cycle) pin_mask a specified number of times.
  *
  * @note If the API is called twice, the blink sequence is reset.
+ * @note When the sequence completes, the LED returns to the state last set with @ref hal_led_pin_set.
  * @note If @p delay_ms is less than @ref HAL_LED_BLINK_PERIOD_MIN_MS or @p blink_count is zero, the
  * call will be ignored.
- * @note If the APP_TIMER queue is full, this call may fail silently.
+ * @note If the blink timer cannot be started, the LED is left untouched and the failure is logged
+ * and counted in the timer service statistics (see @ref TIMER_SERVICE).
  *
  * @param[in] pin_mask      Mask of LED pins.
  * @param[in] delay_ms      Delay in milliseconds between each state change.
@@ -0,0 +1,129 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SUB_INDEX_H__
+#define SUB_INDEX_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "access.h"
+#include "nrf_mesh_config_dsm.h"
+#include "config_server_events.h"
+
+/**
+ * @defgroup SUB_INDEX Subscription address index
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Address-to-model index of the group and virtual address subscriptions on this node.
+ *
+ * The index is a sorted array of subscription addresses, each with a bitmask of the model handles
+ * subscribed to it. Looking up the receivers of a group-addressed message is a binary search over
+ * the distinct subscription addresses, independent of how many subscriptions each model has. The
+ * access layer of SDKPatch/access.c uses it to dispatch group and virtual address messages.
+ *
+ * The index is rebuilt from the access layer at boot and after every Config Server subscription
+ * event. Rebuilding instead of applying the event keeps shared subscription lists right: a change
+ * to the list of the Power OnOff server also changes the list of the Power OnOff Setup server, but
+ * the event only names the model it was addressed to. Subscriptions only change at configuration
+ * time, so the cost of a rebuild does not matter.
+ *
+ * @note Subscriptions changed by other means than the Config Server must be followed by a call to
+ * @ref sub_index_rebuild.
+ * @{
+ */
+
+/** Maximum number of distinct subscription addresses, bounded by the DSM address pool. Virtual
+ * addresses are indexed by their hash. */
+#define SUB_INDEX_ENTRIES_MAX   (DSM_NONVIRTUAL_ADDR_MAX + DSM_VIRTUAL_ADDR_MAX)
+
+/** Bitmask of model handles, bit @c n is set if model handle @c n is subscribed. */
+typedef uint16_t sub_index_model_mask_t;
+
+/** Index entry. */
+typedef struct
+{
+    /** Subscription address. */
+    uint16_t address;
+    /** Models subscribed to the address. */
+    sub_index_model_mask_t models;
+} sub_index_entry_t;
+
+/**
+ * Rebuilds the index from the subscription lists stored in the access layer.
+ *
+ * @note Call after the mesh stack has loaded its configuration from flash.
+ */
+void sub_index_rebuild(void);
+
+/**
+ * Updates the index from a Config Server event.
+ *
+ * Subscription add, delete, overwrite and delete all events rebuild the index, node reset clears
+ * it. Other events are ignored.
+ *
+ * @param[in] p_evt Config Server event.
+ */
+void sub_index_config_server_evt(const config_server_evt_t * p_evt);
+
+/**
+ * Gets the models subscribed to an address.
+ *
+ * @param[in] address Group address, or hash of a virtual address.
+ *
+ * @returns Bitmask of the subscribed model handles, 0 if no model is subscribed.
+ */
+sub_index_model_mask_t sub_index_lookup(uint16_t address);
+
+/**
+ * Checks if a model is subscribed to an address.
+ *
+ * @param[in] model_handle Model handle.
+ * @param[in] address      Group address, or hash of a virtual address.
+ *
+ * @returns @c true if the model is subscribed to the address.
+ */
+bool sub_index_is_subscribed(access_model_handle_t model_handle, uint16_t address);
+
+/**
+ * Gets the number of distinct addresses in the index.
+ *
+ * @returns Number of index entries in use.
+ */
+uint32_t sub_index_count_get(void);
+
+/** @} end of SUB_INDEX */
+
+#endif /* SUB_INDEX_H__ */
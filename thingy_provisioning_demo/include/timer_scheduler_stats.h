@@ -0,0 +1,76 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMER_SCHEDULER_STATS_H__
+#define TIMER_SCHEDULER_STATS_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup TIMER_SCHEDULER_STATS Timer scheduler statistics
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Statistics of the heap-based timer scheduler in SDKPatch/timer_scheduler.c.
+ *
+ * The scheduler runs both the mesh timers and the application timers of app_timer_mesh.c, so the
+ * figures cover every timer on the node, while @ref TIMER_SERVICE only sees the application
+ * timers.
+ * @{
+ */
+
+/** Timer scheduler statistics. */
+typedef struct
+{
+    /** Number of pending timers. */
+    uint32_t pending;
+    /** Highest number of pending timers, to check @ref TIMER_SCH_EVENTS_MAX. */
+    uint32_t pending_hwm;
+    /** Timeouts fired. */
+    uint32_t fired;
+    /** Largest delay of a timeout after its expiry, in microseconds. */
+    uint32_t skew_max_us;
+} timer_sch_stats_t;
+
+/**
+ * Gets the timer scheduler statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void timer_sch_stats_get(timer_sch_stats_t * p_stats);
+
+/** @} end of TIMER_SCHEDULER_STATS */
+
+#endif /* TIMER_SCHEDULER_STATS_H__ */
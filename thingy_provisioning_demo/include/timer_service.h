@@ -0,0 +1,145 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TIMER_SERVICE_H__
+#define TIMER_SERVICE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_timer.h"
+#include "timer.h"
+
+/**
+ * @defgroup TIMER_SERVICE Application timer service
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Application timers with statistics, on top of the mesh timer scheduler.
+ *
+ * The application timer API is provided by app_timer_mesh.c, which runs every app_timer on the
+ * mesh timer scheduler. Mesh and application timers therefore share one RTC compare channel and
+ * one sorted timer queue; there is no separate app_timer operation queue that can overflow.
+ *
+ * This module wraps the app_timer API for the application timers and keeps statistics: the
+ * high-water mark of concurrently running timers, the largest lateness (skew) of a timeout
+ * relative to its programmed expiry, and the number of failed starts. A failed start is reported
+ * to the caller and counted, never dropped silently.
+ * @{
+ */
+
+/** Application timer. The fields are private. */
+typedef struct
+{
+    const app_timer_id_t * p_id;
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t mode;
+    void * p_context;
+    timestamp_t expected;
+    uint32_t interval_us;
+    bool active;
+} timer_service_t;
+
+/** Timer statistics. */
+typedef struct
+{
+    /** Number of running timers. */
+    uint32_t active;
+    /** Highest number of timers running at the same time. */
+    uint32_t active_hwm;
+    /** Largest delay of a timeout after its programmed expiry, in microseconds. */
+    uint32_t skew_max_us;
+    /** Number of starts rejected by the timer backend. */
+    uint32_t start_failures;
+} timer_service_stats_t;
+
+/**
+ * Defines a timer instance.
+ *
+ * @param[in] name Name of the timer instance.
+ */
+#define TIMER_SERVICE_DEF(name)                                   \
+    APP_TIMER_DEF(name##_id);                                     \
+    static timer_service_t name = {.p_id = &name##_id}
+
+/**
+ * Creates a timer.
+ *
+ * @param[in,out] p_timer Timer defined with @ref TIMER_SERVICE_DEF.
+ * @param[in]     mode    Single shot or repeated.
+ * @param[in]     handler Timeout handler.
+ *
+ * @returns Result of app_timer_create().
+ */
+uint32_t timer_service_create(timer_service_t * p_timer,
+                              app_timer_mode_t mode,
+                              app_timer_timeout_handler_t handler);
+
+/**
+ * Starts or restarts a timer.
+ *
+ * @param[in,out] p_timer     Timer to start.
+ * @param[in]     timeout_ms  Timeout (and interval for repeated timers) in milliseconds.
+ * @param[in]     p_context   Context passed to the timeout handler.
+ *
+ * @returns Result of app_timer_start(). Failures are also counted in the statistics.
+ */
+uint32_t timer_service_start(timer_service_t * p_timer, uint32_t timeout_ms, void * p_context);
+
+/**
+ * Stops a timer. Stopping a timer that is not running has no effect.
+ *
+ * @param[in,out] p_timer Timer to stop.
+ */
+void timer_service_stop(timer_service_t * p_timer);
+
+/**
+ * Checks if a timer is running.
+ *
+ * @param[in] p_timer Timer to check.
+ *
+ * @returns @c true if the timer is running.
+ */
+bool timer_service_is_active(const timer_service_t * p_timer);
+
+/**
+ * Gets the timer statistics.
+ *
+ * @returns Pointer to the statistics.
+ */
+const timer_service_stats_t * timer_service_stats_get(void);
+
+/** @} end of TIMER_SERVICE */
+
+#endif /* TIMER_SERVICE_H__ */
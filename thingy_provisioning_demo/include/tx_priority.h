@@ -0,0 +1,159 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TX_PRIORITY_H__
+#define TX_PRIORITY_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup TX_PRIORITY Advertising TX priority for interactive messages
+ * @ingroup MESH_API_GROUP_APP_SUPPORT
+ * Gives user-initiated messages precedence over relayed traffic on the advertising bearer.
+ *
+ * The core TX layer already sends through one advertiser per role, so traffic falls in three
+ * classes:
+ * - Interactive: messages originated by this node, such as OnOff Sets from a button press.
+ * - Relay: network PDUs relayed for other nodes.
+ * - Background: secure network beacons and the unprovisioned beacon, which have their own
+ *   advertisers and fixed intervals. Heartbeats are originated messages and share the
+ *   interactive advertiser.
+ *
+ * When an interactive message is about to be sent, the relay advertiser yields airtime by
+ * running at @ref TX_PRIORITY_RELAY_YIELD_INTERVAL_MS for at most @ref TX_PRIORITY_YIELD_MAX_MS.
+ * To protect relayed traffic from starvation, a new yield is refused until the relay advertiser
+ * has run at its configured interval for @ref TX_PRIORITY_RELAY_GUARD_MS. The interval is changed
+ * at runtime only, the persistent advertiser options are left untouched, and the end of a yield
+ * restores the interval currently configured in mesh_opt_core, so Config Server changes made
+ * during a yield are kept.
+ *
+ * The queue delay of each class is measured from the time a packet is handed to its advertiser
+ * to the advertiser's TX complete, with link-time wrappers of advertiser_instance_init(),
+ * advertiser_packet_send(), core_tx_packet_alloc() and core_tx_packet_send() (see the project
+ * linker options). Packets sent through the core TX layer are classified by the role they were
+ * allocated with, all other advertisers count as background. The interactive delay is measured
+ * on the first packet originated between @ref tx_priority_interactive_begin and
+ * @ref tx_priority_interactive_end, from the begin call. Each advertiser keeps the send times of
+ * the last @ref TX_PRIORITY_DELAY_QUEUE_SIZE packets; when more are queued, the oldest one is not
+ * measured.
+ *
+ * The core TX allocation wrapper also counts relayed PDUs (@ref DIAG_COUNTER_RELAY) and drops
+ * them while the relay policy suppresses relaying (@ref relay_policy_relay_allowed), counting
+ * every relay allocation as forwarded or suppressed (@ref relay_policy_relay_count).
+ *
+ * The press_under_load scenarios of test/sim_mesh.c compare the class delays with and without the
+ * yield. As the originator advertiser does not queue behind relayed packets, the yield only frees
+ * the radio of the node: the interactive delay drops from 6.6-7.1 ms to 6.3-6.6 ms on average and
+ * its maximum by up to 6 ms, while the largest relay delay grows by 60-160 ms.
+ * @{
+ */
+
+/** Relay advertiser interval while yielding to an interactive message. */
+#define TX_PRIORITY_RELAY_YIELD_INTERVAL_MS (100)
+/** Longest relay yield for one interactive message. */
+#define TX_PRIORITY_YIELD_MAX_MS            (250)
+/** Minimum time at the configured relay interval between two yields. */
+#define TX_PRIORITY_RELAY_GUARD_MS          (1000)
+/** Number of advertisers whose queue delay can be measured. */
+#define TX_PRIORITY_ADVERTISERS_MAX         (6)
+/** Number of queued packets per advertiser whose send time is kept. */
+#define TX_PRIORITY_DELAY_QUEUE_SIZE        (8)
+
+/** Traffic classes. */
+typedef enum
+{
+    TX_PRIORITY_CLASS_INTERACTIVE,
+    TX_PRIORITY_CLASS_RELAY,
+    TX_PRIORITY_CLASS_BACKGROUND,
+    TX_PRIORITY_CLASS_COUNT
+} tx_priority_class_t;
+
+/** Queue delay statistics of a traffic class. */
+typedef struct
+{
+    /** Packets whose queue delay has been measured. */
+    uint32_t count;
+    /** Largest queue delay, in microseconds. */
+    uint32_t delay_max_us;
+    /** Sum of the measured queue delays, in microseconds. */
+    uint32_t delay_sum_us;
+} tx_priority_delay_stats_t;
+
+/** TX priority statistics. */
+typedef struct
+{
+    /** Queue delays per traffic class. For the interactive class, from the request to the first
+     * completed transmission of the message. */
+    tx_priority_delay_stats_t delay[TX_PRIORITY_CLASS_COUNT];
+    /** Packets that were not measured because their advertiser queue was longer than
+     * @ref TX_PRIORITY_DELAY_QUEUE_SIZE. */
+    uint32_t unmeasured;
+    /** Number of relay yields. */
+    uint32_t relay_yields;
+    /** Number of yields refused by the starvation guard. */
+    uint32_t relay_yields_refused;
+    /** Total time the relay advertiser has been yielding, in milliseconds. */
+    uint32_t relay_yield_time_ms;
+} tx_priority_stats_t;
+
+/** Initializes the TX priority module. Must be called after the mesh stack has been initialized. */
+void tx_priority_init(void);
+
+/**
+ * Signals that an interactive message is about to be sent.
+ *
+ * Call right before sending a user-initiated message.
+ */
+void tx_priority_interactive_begin(void);
+
+/**
+ * Signals that the interactive message has been handed to the mesh stack.
+ *
+ * Call right after the send call returns.
+ */
+void tx_priority_interactive_end(void);
+
+/**
+ * Gets the TX priority statistics.
+ *
+ * @param[out] p_stats Statistics.
+ */
+void tx_priority_stats_get(tx_priority_stats_t * p_stats);
+
+/** @} end of TX_PRIORITY */
+
+#endif /* TX_PRIORITY_H__ */
@@ -0,0 +1,89 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "boot_timeline.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "cycle_counter.h"
+#include "log.h"
+
+typedef struct
+{
+    const char * p_step;
+    uint32_t cycles;
+} boot_step_t;
+
+static boot_step_t m_steps[BOOT_TIMELINE_STEPS_MAX];
+static uint32_t m_step_count;
+static uint32_t m_start;
+
+void boot_timeline_mark(const char * p_step)
+{
+    if (m_step_count == 0)
+    {
+        cycle_counter_enable();
+        m_start = cycle_counter_get();
+    }
+    if (m_step_count < BOOT_TIMELINE_STEPS_MAX)
+    {
+        m_steps[m_step_count].p_step = p_step;
+        m_steps[m_step_count].cycles = cycle_counter_get() - m_start;
+        m_step_count++;
+    }
+}
+
+uint32_t boot_timeline_elapsed_us(void)
+{
+    return cycle_counter_to_us(cycle_counter_get() - m_start);
+}
+
+void boot_timeline_log(void)
+{
+    uint32_t previous = 0;
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Boot timeline:\n");
+    for (uint32_t i = 0; i < m_step_count; ++i)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "  %-20s %8u us (at %8u us)\n",
+              m_steps[i].p_step,
+              cycle_counter_to_us(m_steps[i].cycles - previous),
+              cycle_counter_to_us(m_steps[i].cycles));
+        previous = m_steps[i].cycles;
+    }
+}
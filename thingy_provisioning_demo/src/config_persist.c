@@ -0,0 +1,313 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config_persist.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_error.h"
+#include "nrf_error.h"
+#include "mesh_config.h"
+#include "mesh_config_backend.h"
+#include "mesh_opt_dsm.h"
+#include "mesh_opt_access.h"
+#include "mesh_flash.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "diag_model.h"
+#include "log.h"
+
+typedef struct
+{
+    mesh_config_entry_id_t id;
+    uint16_t length;
+} pending_entry_t;
+
+TIMER_SERVICE_DEF(m_window_timer);
+TIMER_SERVICE_DEF(m_session_timer);
+
+static config_persist_record_t * mp_records;
+static pending_entry_t m_pending[CONFIG_PERSIST_ENTRIES_MAX];
+static uint32_t m_pending_count;
+static uint32_t m_radio_critical_count;
+static bool m_flush_pending;
+static timestamp_t m_first_change;
+
+static bool m_session_active;
+static uint32_t m_session_changes;
+static uint32_t m_session_flash_writes;
+static uint32_t m_session_flash_erases;
+
+uint32_t __real_mesh_config_backend_store(mesh_config_entry_id_t id, const uint8_t * p_entry, uint32_t entry_len);
+uint32_t __real_mesh_config_backend_erase(mesh_config_entry_id_t id);
+uint32_t __real_mesh_flash_op_push(mesh_flash_user_t user, const flash_operation_t * p_op, uint16_t * p_token);
+
+static void window_start(void)
+{
+    uint32_t window_ms = CONFIG_PERSIST_WINDOW_MS;
+    if (!m_flush_pending)
+    {
+        m_flush_pending = true;
+        m_first_change = timer_now();
+    }
+    else
+    {
+        /* Extend the window, but never past the maximum delay from the first change. */
+        uint32_t elapsed_ms = (timer_now() - m_first_change) / 1000;
+        if (elapsed_ms >= CONFIG_PERSIST_MAX_DELAY_MS)
+        {
+            return;
+        }
+        if (elapsed_ms + window_ms > CONFIG_PERSIST_MAX_DELAY_MS)
+        {
+            window_ms = CONFIG_PERSIST_MAX_DELAY_MS - elapsed_ms;
+        }
+    }
+    APP_ERROR_CHECK(timer_service_start(&m_window_timer, window_ms, NULL));
+}
+
+static bool entry_id_equal(mesh_config_entry_id_t a, mesh_config_entry_id_t b)
+{
+    return (a.file == b.file && a.record == b.record);
+}
+
+static pending_entry_t * pending_find(mesh_config_entry_id_t id)
+{
+    for (uint32_t i = 0; i < m_pending_count; ++i)
+    {
+        if (entry_id_equal(m_pending[i].id, id))
+        {
+            return &m_pending[i];
+        }
+    }
+    return NULL;
+}
+
+static void pending_remove(pending_entry_t * p_entry)
+{
+    *p_entry = m_pending[--m_pending_count];
+}
+
+/* Stores the current value of the pending entries. Returns false if the backend is out of room
+ * and some entries are still pending. */
+static bool entries_flush(void)
+{
+    static uint8_t buffer[CONFIG_PERSIST_ENTRY_SIZE_MAX];
+    uint32_t i = 0;
+    while (i < m_pending_count)
+    {
+        pending_entry_t * p_entry = &m_pending[i];
+        uint32_t status = mesh_config_entry_get(p_entry->id, buffer);
+        if (status == NRF_SUCCESS)
+        {
+            status = __real_mesh_config_backend_store(p_entry->id, buffer, p_entry->length);
+            if (status == NRF_ERROR_NO_MEM)
+            {
+                i++;
+                continue;
+            }
+            APP_ERROR_CHECK(status);
+        }
+        /* Entries deleted in the meantime have been erased by the backend. */
+        pending_remove(p_entry);
+    }
+    return (m_pending_count == 0);
+}
+
+static void flush_all(void)
+{
+    m_flush_pending = false;
+    for (config_persist_record_t * p_record = mp_records; p_record != NULL; p_record = p_record->p_next)
+    {
+        if (p_record->dirty)
+        {
+            p_record->dirty = false;
+            p_record->flush_cb();
+        }
+    }
+
+    if (!entries_flush())
+    {
+        /* The flash manager is busy, try again after another window. */
+        window_start();
+    }
+}
+
+static void window_timeout_handler(void * p_context)
+{
+    /* Deferred flushes are picked up when the radio-critical phase ends. */
+    if (m_radio_critical_count == 0)
+    {
+        flush_all();
+    }
+}
+
+static void session_timeout_handler(void * p_context)
+{
+    m_session_active = false;
+    diag_counter_set(DIAG_COUNTER_CONFIG_CHANGES, m_session_changes);
+    diag_counter_set(DIAG_COUNTER_CONFIG_FLASH_WRITES, m_session_flash_writes);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Configuration session: %u changes, %u flash writes, %u page erases\n",
+          m_session_changes, m_session_flash_writes, m_session_flash_erases);
+}
+
+/*****************************************************************************
+ * Link-time wrappers
+ *****************************************************************************/
+
+/* The DSM and the access layer store their entries through the mesh config backend. Their stores
+ * are recorded and replayed with the latest value when the window closes. */
+uint32_t __wrap_mesh_config_backend_store(mesh_config_entry_id_t id, const uint8_t * p_entry, uint32_t entry_len)
+{
+    if ((id.file != MESH_OPT_DSM_FILE_ID && id.file != MESH_OPT_ACCESS_FILE_ID) ||
+        entry_len > CONFIG_PERSIST_ENTRY_SIZE_MAX)
+    {
+        return __real_mesh_config_backend_store(id, p_entry, entry_len);
+    }
+
+    pending_entry_t * p_pending = pending_find(id);
+    if (p_pending == NULL)
+    {
+        if (m_pending_count == CONFIG_PERSIST_ENTRIES_MAX)
+        {
+            return __real_mesh_config_backend_store(id, p_entry, entry_len);
+        }
+        p_pending = &m_pending[m_pending_count++];
+        p_pending->id = id;
+    }
+    p_pending->length = (uint16_t) entry_len;
+    window_start();
+    return NRF_SUCCESS;
+}
+
+uint32_t __wrap_mesh_config_backend_erase(mesh_config_entry_id_t id)
+{
+    pending_entry_t * p_pending = pending_find(id);
+    if (p_pending != NULL)
+    {
+        pending_remove(p_pending);
+    }
+    return __real_mesh_config_backend_erase(id);
+}
+
+uint32_t __wrap_mesh_flash_op_push(mesh_flash_user_t user, const flash_operation_t * p_op, uint16_t * p_token)
+{
+    uint32_t status = __real_mesh_flash_op_push(user, p_op, p_token);
+    if (status == NRF_SUCCESS && m_session_active)
+    {
+        if (p_op->type == FLASH_OP_TYPE_WRITE)
+        {
+            m_session_flash_writes++;
+        }
+        else if (p_op->type == FLASH_OP_TYPE_ERASE)
+        {
+            m_session_flash_erases++;
+        }
+    }
+    return status;
+}
+
+/*****************************************************************************
+ * Public API
+ *****************************************************************************/
+
+void config_persist_init(void)
+{
+    APP_ERROR_CHECK(timer_service_create(&m_window_timer, APP_TIMER_MODE_SINGLE_SHOT, window_timeout_handler));
+    APP_ERROR_CHECK(timer_service_create(&m_session_timer, APP_TIMER_MODE_SINGLE_SHOT, session_timeout_handler));
+}
+
+void config_persist_record_register(config_persist_record_t * p_record, config_persist_flush_cb_t flush_cb)
+{
+    p_record->flush_cb = flush_cb;
+    p_record->dirty = false;
+    p_record->p_next = mp_records;
+    mp_records = p_record;
+}
+
+void config_persist_mark_dirty(config_persist_record_t * p_record)
+{
+    p_record->dirty = true;
+    window_start();
+}
+
+void config_persist_radio_critical_set(bool active)
+{
+    if (active)
+    {
+        m_radio_critical_count++;
+    }
+    else if (m_radio_critical_count > 0)
+    {
+        m_radio_critical_count--;
+        if (m_radio_critical_count == 0 && m_flush_pending)
+        {
+            /* Give the radio a full window before hitting flash. */
+            m_flush_pending = false;
+            window_start();
+        }
+    }
+}
+
+void config_persist_flush(void)
+{
+    timer_service_stop(&m_window_timer);
+    flush_all();
+}
+
+void config_persist_config_server_evt(const config_server_evt_t * p_evt)
+{
+    if (p_evt->type == CONFIG_SERVER_EVT_NODE_RESET)
+    {
+        /* The stack clears its configuration, nothing pending may be written back. */
+        m_pending_count = 0;
+        return;
+    }
+
+    if (!m_session_active)
+    {
+        m_session_active = true;
+        m_session_changes = 0;
+        m_session_flash_writes = 0;
+        m_session_flash_erases = 0;
+    }
+
+    m_session_changes++;
+    APP_ERROR_CHECK(timer_service_start(&m_session_timer, CONFIG_PERSIST_SESSION_IDLE_MS, NULL));
+}
@@ -0,0 +1,330 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "crypto_bench.h"
+
+#if CRYPTO_BENCH_ENABLED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "SEGGER_RTT.h"
+#include "cycle_counter.h"
+
+#include "aes.h"
+#include "aes_cmac.h"
+#include "ccm_soft.h"
+#include "ccm_backend.h"
+#include "enc.h"
+#include "nrf_mesh_keygen.h"
+#include "p256_comb.h"
+#include "rand.h"
+#include "uECC.h"
+
+/** Iterations of the symmetric benchmarks. */
+#define BENCH_ITERATIONS_SYMMETRIC  (200)
+/** Iterations of the P-256 benchmarks. */
+#define BENCH_ITERATIONS_ECC        (4)
+/** Largest access payload of a segmented message. */
+#define BENCH_ACCESS_PAYLOAD_SIZE   (380)
+/** Transport PDU of an unsegmented message. */
+#define BENCH_NETWORK_PAYLOAD_SIZE  (16)
+#define BENCH_ECC_KEY_SIZE          (32)
+
+typedef struct
+{
+    const char * p_name;
+    uint16_t bytes;
+    uint16_t iterations;
+    void (*run)(void);
+} bench_case_t;
+
+static const uint8_t m_key[NRF_MESH_KEY_SIZE] =
+    {0x32, 0x16, 0xD1, 0x50, 0x98, 0x84, 0xB5, 0x33, 0x24, 0x85, 0x41, 0x79, 0x2B, 0x87, 0x7F, 0x98};
+static const uint8_t m_nonce[13] =
+    {0x01, 0x00, 0x00, 0x00, 0x07, 0x12, 0x01, 0xFF, 0xFF, 0x12, 0x34, 0x56, 0x78};
+static const uint8_t m_k2_p[1] = {0x00};
+static const uint8_t m_k1_info[4] = {'p', 'r', 'c', 'k'};
+
+static uint8_t m_buffer[BENCH_ACCESS_PAYLOAD_SIZE];
+static uint8_t m_mic[8];
+static uint8_t m_out[NRF_MESH_KEY_SIZE];
+static nrf_mesh_network_secmat_t m_secmat;
+static uint8_t m_ecc_private[BENCH_ECC_KEY_SIZE];
+static uint8_t m_ecc_public[BENCH_ECC_KEY_SIZE * 2];
+static uint8_t m_ecc_peer_private[BENCH_ECC_KEY_SIZE];
+static uint8_t m_ecc_peer_public[BENCH_ECC_KEY_SIZE * 2];
+static uint8_t m_ecc_secret[BENCH_ECC_KEY_SIZE];
+
+static void ccm_run(uint16_t length, uint8_t mic_len, bool decrypt)
+{
+    ccm_soft_data_t data =
+    {
+        .p_key = m_key,
+        .p_nonce = m_nonce,
+        .p_m = m_buffer,
+        .m_len = length,
+        .p_a = NULL,
+        .a_len = 0,
+        .p_out = m_buffer,
+        .p_mic = m_mic,
+        .mic_len = mic_len
+    };
+
+    if (decrypt)
+    {
+        bool mic_passed;
+        ccm_soft_decrypt(&data, &mic_passed);
+    }
+    else
+    {
+        ccm_soft_encrypt(&data);
+    }
+}
+
+static void bench_aes_ecb(void)
+{
+    aes_encrypt(m_key, m_buffer, m_out);
+}
+
+static void bench_aes_cmac_16(void)
+{
+    aes_cmac(m_key, m_buffer, 16, m_out);
+}
+
+static void bench_aes_cmac_64(void)
+{
+    aes_cmac(m_key, m_buffer, 64, m_out);
+}
+
+static void bench_ccm_net_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(BENCH_NETWORK_PAYLOAD_SIZE, 4, false);
+}
+
+static void bench_ccm_net_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(BENCH_NETWORK_PAYLOAD_SIZE, 4, false);
+}
+
+static void bench_ccm_access_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(BENCH_ACCESS_PAYLOAD_SIZE, 4, false);
+}
+
+static void bench_ccm_access_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(BENCH_ACCESS_PAYLOAD_SIZE, 4, false);
+}
+
+static void bench_ccm_net_decrypt_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(BENCH_NETWORK_PAYLOAD_SIZE, 4, true);
+}
+
+static void bench_ccm_net_decrypt_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(BENCH_NETWORK_PAYLOAD_SIZE, 4, true);
+}
+
+static void bench_ccm_access_decrypt_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(BENCH_ACCESS_PAYLOAD_SIZE, 4, true);
+}
+
+static void bench_ccm_access_decrypt(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(BENCH_ACCESS_PAYLOAD_SIZE, 4, true);
+}
+
+static void bench_s1(void)
+{
+    enc_s1(m_k1_info, sizeof(m_k1_info), m_out);
+}
+
+static void bench_k1(void)
+{
+    enc_k1(m_ecc_secret, sizeof(m_ecc_secret), m_key, m_k1_info, sizeof(m_k1_info), m_out);
+}
+
+static void bench_k2(void)
+{
+    enc_k2(m_key, m_k2_p, sizeof(m_k2_p), &m_secmat);
+}
+
+static void bench_k3(void)
+{
+    enc_k3(m_key, m_out);
+}
+
+static void bench_k4(void)
+{
+    enc_k4(m_key, m_out);
+}
+
+static void bench_keygen_network_secmat(void)
+{
+    (void) nrf_mesh_keygen_network_secmat(m_key, &m_secmat);
+}
+
+static void bench_ecc_make_key(void)
+{
+    (void) uECC_make_key(m_ecc_public, m_ecc_private, uECC_secp256r1());
+}
+
+static void bench_ecc_public_key(void)
+{
+    (void) uECC_compute_public_key(m_ecc_private, m_ecc_public, uECC_secp256r1());
+}
+
+static void bench_ecc_public_key_comb(void)
+{
+    (void) p256_comb_public_key_compute(m_ecc_private, m_ecc_public);
+}
+
+static void bench_ecdh_shared_secret(void)
+{
+    (void) uECC_shared_secret(m_ecc_peer_public, m_ecc_private, m_ecc_secret, uECC_secp256r1());
+}
+
+static const bench_case_t m_cases[] =
+{
+    {"aes_ecb",                 NRF_MESH_KEY_SIZE,          BENCH_ITERATIONS_SYMMETRIC, bench_aes_ecb},
+    {"aes_cmac_16",             16,                         BENCH_ITERATIONS_SYMMETRIC, bench_aes_cmac_16},
+    {"aes_cmac_64",             64,                         BENCH_ITERATIONS_SYMMETRIC, bench_aes_cmac_64},
+    {"ccm_net_soft",            BENCH_NETWORK_PAYLOAD_SIZE, BENCH_ITERATIONS_SYMMETRIC, bench_ccm_net_soft},
+    {"ccm_net_batched",         BENCH_NETWORK_PAYLOAD_SIZE, BENCH_ITERATIONS_SYMMETRIC, bench_ccm_net_batched},
+    {"ccm_access_soft",         BENCH_ACCESS_PAYLOAD_SIZE,  BENCH_ITERATIONS_SYMMETRIC, bench_ccm_access_soft},
+    {"ccm_access_batched",      BENCH_ACCESS_PAYLOAD_SIZE,  BENCH_ITERATIONS_SYMMETRIC, bench_ccm_access_batched},
+    {"ccm_net_decrypt_soft",    BENCH_NETWORK_PAYLOAD_SIZE, BENCH_ITERATIONS_SYMMETRIC, bench_ccm_net_decrypt_soft},
+    {"ccm_net_decrypt_batched", BENCH_NETWORK_PAYLOAD_SIZE, BENCH_ITERATIONS_SYMMETRIC, bench_ccm_net_decrypt_batched},
+    {"ccm_access_decrypt_soft", BENCH_ACCESS_PAYLOAD_SIZE,  BENCH_ITERATIONS_SYMMETRIC, bench_ccm_access_decrypt_soft},
+    {"ccm_access_decrypt",      BENCH_ACCESS_PAYLOAD_SIZE,  BENCH_ITERATIONS_SYMMETRIC, bench_ccm_access_decrypt},
+    {"s1",                      sizeof(m_k1_info),          BENCH_ITERATIONS_SYMMETRIC, bench_s1},
+    {"k1",                      BENCH_ECC_KEY_SIZE,         BENCH_ITERATIONS_SYMMETRIC, bench_k1},
+    {"k2",                      NRF_MESH_KEY_SIZE,          BENCH_ITERATIONS_SYMMETRIC, bench_k2},
+    {"k3",                      NRF_MESH_KEY_SIZE,          BENCH_ITERATIONS_SYMMETRIC, bench_k3},
+    {"k4",                      NRF_MESH_KEY_SIZE,          BENCH_ITERATIONS_SYMMETRIC, bench_k4},
+    {"keygen_network_secmat",   NRF_MESH_KEY_SIZE,          BENCH_ITERATIONS_SYMMETRIC, bench_keygen_network_secmat},
+    {"ecc_make_key",            BENCH_ECC_KEY_SIZE,         BENCH_ITERATIONS_ECC,       bench_ecc_make_key},
+    {"ecc_public_key",          BENCH_ECC_KEY_SIZE,         BENCH_ITERATIONS_ECC,       bench_ecc_public_key},
+    {"ecc_public_key_comb",     BENCH_ECC_KEY_SIZE,         BENCH_ITERATIONS_ECC,       bench_ecc_public_key_comb},
+    {"ecdh_shared_secret",      BENCH_ECC_KEY_SIZE,         BENCH_ITERATIONS_ECC,       bench_ecdh_shared_secret},
+};
+
+static int bench_rng(uint8_t * p_dest, unsigned size)
+{
+    rand_hw_rng_get(p_dest, (uint16_t) size);
+    return 1;
+}
+
+/* Checks that the comb and micro-ecc agree on the public key of a fresh random key pair. */
+static bool comb_equal(void)
+{
+    uint8_t public_key[BENCH_ECC_KEY_SIZE * 2];
+    (void) uECC_make_key(m_ecc_public, m_ecc_private, uECC_secp256r1());
+    return p256_comb_public_key_compute(m_ecc_private, public_key) &&
+           memcmp(public_key, m_ecc_public, sizeof(public_key)) == 0;
+}
+
+static void case_run(const bench_case_t * p_case, bool last)
+{
+    uint32_t min = UINT32_MAX;
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < p_case->iterations; ++i)
+    {
+        uint32_t start = cycle_counter_get();
+        p_case->run();
+        uint32_t cycles = cycle_counter_get() - start;
+
+        sum += cycles;
+        if (cycles < min)
+        {
+            min = cycles;
+        }
+    }
+
+    uint32_t avg = (uint32_t) (sum / p_case->iterations);
+    uint32_t bytes_per_s = (avg == 0) ? 0 : (uint32_t) (((uint64_t) p_case->bytes * CYCLE_COUNTER_HZ) / avg);
+
+    SEGGER_RTT_printf(0,
+                      "{\"name\":\"%s\",\"bytes\":%u,\"iterations\":%u,\"cycles_min\":%u,\"cycles_avg\":%u,\"bytes_per_s\":%u}%s\n",
+                      p_case->p_name, p_case->bytes, p_case->iterations, min, avg, bytes_per_s, last ? "" : ",");
+}
+
+void crypto_bench_run(void)
+{
+    ccm_backend_t backend = ccm_backend_get();
+
+    cycle_counter_enable();
+    if (uECC_get_rng() == NULL)
+    {
+        uECC_set_rng(bench_rng);
+    }
+
+    memset(m_buffer, 0xA5, sizeof(m_buffer));
+    /* The ECDH benchmark needs a peer key and the k1 benchmark a shared secret as input. */
+    (void) uECC_make_key(m_ecc_peer_public, m_ecc_peer_private, uECC_secp256r1());
+    (void) uECC_make_key(m_ecc_public, m_ecc_private, uECC_secp256r1());
+    (void) uECC_shared_secret(m_ecc_peer_public, m_ecc_private, m_ecc_secret, uECC_secp256r1());
+
+    SEGGER_RTT_WriteString(0, "CRYPTO_BENCH_BEGIN\n");
+    SEGGER_RTT_printf(0, "{\"tag\":\"%s\",\"build\":\"%s %s\",\"cpu_hz\":%u,\"comb_equal\":%s,\"results\":[\n",
+                      CRYPTO_BENCH_TAG, __DATE__, __TIME__, (unsigned) CYCLE_COUNTER_HZ,
+                      comb_equal() ? "true" : "false");
+
+    const uint32_t case_count = sizeof(m_cases) / sizeof(m_cases[0]);
+    for (uint32_t i = 0; i < case_count; ++i)
+    {
+        case_run(&m_cases[i], (i + 1 == case_count));
+    }
+
+    SEGGER_RTT_WriteString(0, "]}\nCRYPTO_BENCH_END\n");
+    ccm_backend_set(backend);
+}
+
+#endif /* CRYPTO_BENCH_ENABLED */
@@ -0,0 +1,250 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "debug_console.h"
+
+#if DEBUG_CONSOLE_ENABLED
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "nrf.h"
+#include "app_error.h"
+#include "SEGGER_RTT.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "diag_model.h"
+#include "crypto_bench.h"
+#include "mesh_mem_pool.h"
+#include "log.h"
+
+typedef struct
+{
+    const char * p_name;
+    const char * p_help;
+    void (*handler)(const char * p_args);
+} command_t;
+
+TIMER_SERVICE_DEF(m_poll_timer);
+static debug_console_key_handler_t m_key_handler;
+static bool m_attached;
+static char m_line[DEBUG_CONSOLE_LINE_LENGTH_MAX + 1];
+static uint32_t m_line_length;
+static uint32_t m_wakeups_last;
+static timestamp_t m_wakeups_time;
+
+static void command_help(const char * p_args);
+
+static void command_counters(const char * p_args)
+{
+    for (uint32_t i = 0; i < DIAG_COUNTER_COUNT; ++i)
+    {
+        SEGGER_RTT_printf(0, "%2u: %u\n", i, diag_counter_get((diag_counter_t) i));
+    }
+}
+
+static void command_wakeups(const char * p_args)
+{
+    timestamp_t now = timer_now();
+    uint32_t wakeups = diag_counter_get(DIAG_COUNTER_IDLE_WAKEUPS);
+    uint32_t elapsed_ms = (now - m_wakeups_time) / 1000;
+
+    if (elapsed_ms > 0)
+    {
+        SEGGER_RTT_printf(0, "%u wakeups in %u ms (%u/s)\n", wakeups - m_wakeups_last, elapsed_ms,
+                          (uint32_t) (((uint64_t) (wakeups - m_wakeups_last) * 1000) / elapsed_ms));
+    }
+    m_wakeups_last = wakeups;
+    m_wakeups_time = now;
+}
+
+static void command_log(const char * p_args)
+{
+    char * p_end;
+    unsigned long level = strtoul(p_args, &p_end, 10);
+    if (p_end == p_args || level > LOG_LEVEL_DBG3)
+    {
+        SEGGER_RTT_printf(0, "Usage: log <0-%u>\n", LOG_LEVEL_DBG3);
+        return;
+    }
+    g_log_dbg_lvl = (uint32_t) level;
+}
+
+static void command_mem(const char * p_args)
+{
+    static const char * const class_names[MESH_MEM_POOL_CLASS_COUNT] = {"small", "medium", "large", "region"};
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        mesh_mem_pool_stats_t stats;
+        mesh_mem_pool_stats_get((mesh_mem_pool_class_t) i, &stats);
+        SEGGER_RTT_printf(0, "%-6s %3u x %3u bytes, in use %u, hwm %u, largest request %u\n", class_names[i],
+                          stats.block_count, stats.block_size, stats.in_use, stats.hwm, stats.request_max);
+    }
+    SEGGER_RTT_printf(0, "failures %u\n", mesh_mem_pool_failures_get());
+
+    uint16_t counts[MESH_MEM_POOL_SIZE_BUCKET_COUNT];
+    mesh_mem_pool_size_histogram_get(counts);
+    for (uint32_t i = 0; i < MESH_MEM_POOL_SIZE_BUCKET_COUNT; ++i)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+        if (i <= MESH_MEM_POOL_SEGMENTS_MAX)
+        {
+            SEGGER_RTT_printf(0, "%2u segments (<= %3u bytes): %u\n", i, i * MESH_MEM_POOL_SEGMENT_SIZE, counts[i]);
+        }
+        else
+        {
+            SEGGER_RTT_printf(0, "larger: %u\n", counts[i]);
+        }
+    }
+}
+
+#if CRYPTO_BENCH_ENABLED
+static void command_bench(const char * p_args)
+{
+    crypto_bench_run();
+}
+#endif
+
+static const command_t m_commands[] =
+{
+    {"help",     "list commands",                 command_help},
+    {"counters", "print diagnostics counters",    command_counters},
+    {"wakeups",  "idle wakeups since last call",  command_wakeups},
+    {"log",      "<level>: set the log level",    command_log},
+    {"mem",      "mesh memory pool statistics",   command_mem},
+#if CRYPTO_BENCH_ENABLED
+    {"bench",    "run the crypto benchmarks",     command_bench},
+#endif
+};
+
+static void command_help(const char * p_args)
+{
+    for (uint32_t i = 0; i < sizeof(m_commands) / sizeof(m_commands[0]); ++i)
+    {
+        SEGGER_RTT_printf(0, "%-10s %s\n", m_commands[i].p_name, m_commands[i].p_help);
+    }
+}
+
+static void line_execute(void)
+{
+    if (m_line_length == 1)
+    {
+        if (m_key_handler != NULL)
+        {
+            m_key_handler(m_line[0]);
+        }
+        return;
+    }
+
+    char * p_args = strchr(m_line, ' ');
+    uint32_t name_length = (p_args == NULL) ? m_line_length : (uint32_t) (p_args - m_line);
+    p_args = (p_args == NULL) ? &m_line[m_line_length] : p_args + 1;
+
+    for (uint32_t i = 0; i < sizeof(m_commands) / sizeof(m_commands[0]); ++i)
+    {
+        if (strlen(m_commands[i].p_name) == name_length &&
+            memcmp(m_commands[i].p_name, m_line, name_length) == 0)
+        {
+            m_commands[i].handler(p_args);
+            return;
+        }
+    }
+    SEGGER_RTT_printf(0, "Unknown command, try \"help\"\n");
+}
+
+static void input_read(void)
+{
+    char c;
+    while (SEGGER_RTT_Read(0, &c, 1) == 1)
+    {
+        if (c == '\r' || c == '\n')
+        {
+            if (m_line_length > 0)
+            {
+                m_line[m_line_length] = '\0';
+                line_execute();
+                m_line_length = 0;
+            }
+        }
+        else if (m_line_length < DEBUG_CONSOLE_LINE_LENGTH_MAX)
+        {
+            m_line[m_line_length++] = c;
+        }
+    }
+}
+
+static bool debugger_attached(void)
+{
+    return (CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0;
+}
+
+static void poll_timeout_handler(void * p_context)
+{
+    bool attached = debugger_attached();
+    if (attached != m_attached)
+    {
+        m_attached = attached;
+        APP_ERROR_CHECK(timer_service_start(&m_poll_timer,
+                                            attached ? DEBUG_CONSOLE_POLL_INTERVAL_MS : DEBUG_CONSOLE_DETECT_INTERVAL_MS,
+                                            NULL));
+        m_line_length = 0;
+    }
+
+    if (attached)
+    {
+        input_read();
+    }
+}
+
+void debug_console_init(debug_console_key_handler_t key_handler)
+{
+    m_key_handler = key_handler;
+    m_attached = debugger_attached();
+    m_wakeups_time = timer_now();
+
+    APP_ERROR_CHECK(timer_service_create(&m_poll_timer, APP_TIMER_MODE_REPEATED, poll_timeout_handler));
+    APP_ERROR_CHECK(timer_service_start(&m_poll_timer,
+                                        m_attached ? DEBUG_CONSOLE_POLL_INTERVAL_MS : DEBUG_CONSOLE_DETECT_INTERVAL_MS,
+                                        NULL));
+}
+
+#endif /* DEBUG_CONSOLE_ENABLED */
@@ -0,0 +1,214 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "diag_model.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "access.h"
+#include "access_config.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_events.h"
+#include "nrf_mesh_assert.h"
+#include "log.h"
+
+static uint32_t m_counters[DIAG_COUNTER_COUNT];
+static access_model_handle_t m_model_handle = ACCESS_HANDLE_INVALID;
+
+static void mesh_evt_handler(const nrf_mesh_evt_t * p_evt);
+static nrf_mesh_evt_handler_t m_mesh_evt_handler = {
+    .evt_cb = mesh_evt_handler,
+};
+
+/*****************************************************************************
+ * Counters
+ *****************************************************************************/
+
+void diag_counter_add(diag_counter_t counter, uint32_t value)
+{
+    NRF_MESH_ASSERT(counter < DIAG_COUNTER_COUNT);
+    m_counters[counter] += value;
+}
+
+void diag_counter_set(diag_counter_t counter, uint32_t value)
+{
+    NRF_MESH_ASSERT(counter < DIAG_COUNTER_COUNT);
+    m_counters[counter] = value;
+}
+
+void diag_counter_max(diag_counter_t counter, uint32_t value)
+{
+    NRF_MESH_ASSERT(counter < DIAG_COUNTER_COUNT);
+    if (value > m_counters[counter])
+    {
+        m_counters[counter] = value;
+    }
+}
+
+uint32_t diag_counter_get(diag_counter_t counter)
+{
+    NRF_MESH_ASSERT(counter < DIAG_COUNTER_COUNT);
+    return m_counters[counter];
+}
+
+static void mesh_evt_handler(const nrf_mesh_evt_t * p_evt)
+{
+    switch (p_evt->type)
+    {
+        case NRF_MESH_EVT_MESSAGE_RECEIVED:
+            diag_counter_add(DIAG_COUNTER_MSG_RX, 1);
+            break;
+
+        case NRF_MESH_EVT_TX_COMPLETE:
+            diag_counter_add(DIAG_COUNTER_MSG_TX, 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*****************************************************************************
+ * Opcode handlers
+ *****************************************************************************/
+
+/* Encodes a value as a little endian base-128 varint. Returns the number of bytes written, or 0 if
+ * the value does not fit in the remaining space. */
+static uint32_t varint_encode(uint32_t value, uint8_t * p_out, uint32_t space)
+{
+    uint32_t length = 0;
+    do
+    {
+        if (length == space)
+        {
+            return 0;
+        }
+        p_out[length] = (uint8_t) (value & 0x7F);
+        value >>= 7;
+        if (value != 0)
+        {
+            p_out[length] |= 0x80;
+        }
+        length++;
+    } while (value != 0);
+
+    return length;
+}
+
+static void handle_get(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    uint8_t start = 0;
+    if (p_message->length == 1)
+    {
+        start = p_message->p_data[0];
+    }
+    else if (p_message->length != 0)
+    {
+        return;
+    }
+
+    if (start >= DIAG_COUNTER_COUNT)
+    {
+        start = DIAG_COUNTER_COUNT;
+    }
+
+    uint8_t params[DIAG_STATUS_PARAMS_MAXLEN];
+    uint32_t length = 0;
+    params[length++] = start;
+    params[length++] = DIAG_COUNTER_COUNT;
+
+    for (uint32_t i = start; i < DIAG_COUNTER_COUNT; ++i)
+    {
+        uint32_t encoded = varint_encode(m_counters[i], &params[length], sizeof(params) - length);
+        if (encoded == 0)
+        {
+            break;
+        }
+        length += encoded;
+    }
+
+    access_message_tx_t reply =
+    {
+        .opcode = ACCESS_OPCODE_VENDOR(DIAG_OPCODE_STATUS, ACCESS_COMPANY_ID_NORDIC),
+        .p_buffer = params,
+        .length = (uint16_t) length,
+        .force_segmented = false,
+        .transmic_size = NRF_MESH_TRANSMIC_SIZE_SMALL,
+        .access_token = nrf_mesh_unique_token_get()
+    };
+
+    uint32_t status = access_model_reply(handle, p_message, &reply);
+    if (status != NRF_SUCCESS)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "Diagnostics reply failed: %d\n", status);
+    }
+}
+
+static const access_opcode_handler_t m_opcode_handlers[] =
+{
+    {ACCESS_OPCODE_VENDOR(DIAG_OPCODE_GET, ACCESS_COMPANY_ID_NORDIC), handle_get},
+};
+
+/*****************************************************************************
+ * Public API
+ *****************************************************************************/
+
+uint32_t diag_model_init(uint16_t element_index)
+{
+    if (m_model_handle != ACCESS_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    access_model_add_params_t add_params =
+    {
+        .model_id = ACCESS_MODEL_VENDOR(DIAG_MODEL_SERVER_ID, ACCESS_COMPANY_ID_NORDIC),
+        .element_index = element_index,
+        .p_opcode_handlers = &m_opcode_handlers[0],
+        .opcode_count = sizeof(m_opcode_handlers) / sizeof(m_opcode_handlers[0]),
+        .p_args = NULL,
+        .publish_timeout_cb = NULL
+    };
+
+    uint32_t status = access_model_add(&add_params, &m_model_handle);
+    if (status == NRF_SUCCESS)
+    {
+        nrf_mesh_evt_handler_add(&m_mesh_evt_handler);
+    }
+    return status;
+}
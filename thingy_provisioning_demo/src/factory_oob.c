@@ -0,0 +1,86 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "factory_oob.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_configure.h"
+#include "aes_cmac.h"
+
+#define SECRET_WORDS    (NRF_MESH_KEY_SIZE / sizeof(uint32_t))
+
+static bool secret_get(uint8_t * p_secret)
+{
+    bool erased = true;
+    for (uint32_t i = 0; i < SECRET_WORDS; ++i)
+    {
+        uint32_t word = NRF_UICR->CUSTOMER[FACTORY_OOB_UICR_CUSTOMER_INDEX + i];
+        if (word != 0xFFFFFFFF)
+        {
+            erased = false;
+        }
+        if (p_secret != NULL)
+        {
+            memcpy(&p_secret[i * sizeof(word)], &word, sizeof(word));
+        }
+    }
+    return !erased;
+}
+
+bool factory_oob_available(void)
+{
+    return secret_get(NULL);
+}
+
+uint32_t factory_oob_static_data_get(uint8_t * p_static_data)
+{
+    uint8_t secret[NRF_MESH_KEY_SIZE];
+    if (!secret_get(secret))
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    aes_cmac(secret, nrf_mesh_configure_device_uuid_get(), NRF_MESH_UUID_SIZE, p_static_data);
+    memset(secret, 0, sizeof(secret));
+    return NRF_SUCCESS;
+}
@@ -0,0 +1,333 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "key_cache.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_keygen.h"
+#include "mesh_config.h"
+#include "mesh_config_entry.h"
+#include "diag_model.h"
+
+/** First record of the entries in the file. */
+#define KEY_CACHE_RECORD_START      (1)
+/** Largest derived material, the network security material. */
+#define KEY_CACHE_MATERIAL_SIZE     (sizeof(nrf_mesh_network_secmat_t))
+
+typedef enum
+{
+    KEY_CACHE_KIND_NONE,
+    KEY_CACHE_KIND_NETWORK,
+    KEY_CACHE_KIND_BEACON,
+    KEY_CACHE_KIND_IDENTITY,
+    KEY_CACHE_KIND_AID,
+    KEY_CACHE_KIND_COUNT
+} key_cache_kind_t;
+
+/** Stored entry. */
+typedef struct
+{
+    uint8_t kind;
+    uint8_t key[NRF_MESH_KEY_SIZE];
+    uint8_t material[KEY_CACHE_MATERIAL_SIZE];
+    uint8_t reserved[2];
+    /** FNV-1a hash of the fields above. */
+    uint32_t check;
+} key_cache_entry_t;
+
+NRF_MESH_STATIC_ASSERT(sizeof(nrf_mesh_beacon_secmat_t) <= KEY_CACHE_MATERIAL_SIZE);
+NRF_MESH_STATIC_ASSERT(sizeof(key_cache_entry_t) + 4 <= KEY_CACHE_ENTRY_FLASH);
+
+typedef struct
+{
+    key_cache_entry_t entry;
+    bool valid;
+    /** Looked up since boot. */
+    bool used;
+} slot_t;
+
+static slot_t m_slots[KEY_CACHE_ENTRIES_MAX];
+/** Kinds looked up since boot, bit per kind. */
+static uint32_t m_kinds_used;
+static uint32_t m_hits;
+static uint32_t m_misses;
+
+uint32_t __real_nrf_mesh_keygen_network_secmat(const uint8_t * p_key, nrf_mesh_network_secmat_t * p_secmat);
+uint32_t __real_nrf_mesh_keygen_beacon_secmat(const uint8_t * p_key, nrf_mesh_beacon_secmat_t * p_secmat);
+uint32_t __real_nrf_mesh_keygen_identitykey(const uint8_t * p_key, uint8_t * p_identitykey);
+uint32_t __real_nrf_mesh_keygen_aid(const uint8_t * p_key, uint8_t * p_aid);
+
+static uint32_t entry_check(const key_cache_entry_t * p_entry)
+{
+    const uint8_t * p_bytes = (const uint8_t *) p_entry;
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < offsetof(key_cache_entry_t, check); ++i)
+    {
+        hash = (hash ^ p_bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool entry_valid(const key_cache_entry_t * p_entry)
+{
+    return p_entry->kind > KEY_CACHE_KIND_NONE && p_entry->kind < KEY_CACHE_KIND_COUNT &&
+           p_entry->check == entry_check(p_entry);
+}
+
+static mesh_config_entry_id_t slot_id(uint32_t index)
+{
+    return MESH_CONFIG_ENTRY_ID(KEY_CACHE_FILE_ID, KEY_CACHE_RECORD_START + index);
+}
+
+static uint32_t entry_setter(mesh_config_entry_id_t id, const void * p_entry)
+{
+    uint32_t index = id.record - KEY_CACHE_RECORD_START;
+    if (index >= KEY_CACHE_ENTRIES_MAX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!entry_valid(p_entry))
+    {
+        return NRF_ERROR_INVALID_DATA;
+    }
+
+    memcpy(&m_slots[index].entry, p_entry, sizeof(key_cache_entry_t));
+    m_slots[index].valid = true;
+    return NRF_SUCCESS;
+}
+
+static void entry_getter(mesh_config_entry_id_t id, void * p_entry)
+{
+    uint32_t index = id.record - KEY_CACHE_RECORD_START;
+    if (index < KEY_CACHE_ENTRIES_MAX)
+    {
+        memcpy(p_entry, &m_slots[index].entry, sizeof(key_cache_entry_t));
+    }
+}
+
+static void entry_deleter(mesh_config_entry_id_t id)
+{
+    uint32_t index = id.record - KEY_CACHE_RECORD_START;
+    if (index < KEY_CACHE_ENTRIES_MAX)
+    {
+        memset(&m_slots[index], 0, sizeof(m_slots[index]));
+    }
+}
+
+MESH_CONFIG_FILE(m_key_cache_file, KEY_CACHE_FILE_ID, MESH_CONFIG_STRATEGY_CONTINUOUS);
+MESH_CONFIG_ENTRY(m_key_cache_entry,
+                  MESH_CONFIG_ENTRY_ID(KEY_CACHE_FILE_ID, KEY_CACHE_RECORD_START),
+                  KEY_CACHE_ENTRIES_MAX,
+                  sizeof(key_cache_entry_t),
+                  entry_setter,
+                  entry_getter,
+                  entry_deleter,
+                  false);
+
+static bool lookup(key_cache_kind_t kind, const uint8_t * p_key, void * p_material, uint32_t size)
+{
+    m_kinds_used |= 1u << kind;
+    for (uint32_t i = 0; i < KEY_CACHE_ENTRIES_MAX; ++i)
+    {
+        slot_t * p_slot = &m_slots[i];
+        if (p_slot->valid && p_slot->entry.kind == kind &&
+            memcmp(p_slot->entry.key, p_key, NRF_MESH_KEY_SIZE) == 0)
+        {
+            memcpy(p_material, p_slot->entry.material, size);
+            p_slot->used = true;
+            m_hits++;
+            diag_counter_add(DIAG_COUNTER_KEY_CACHE_HITS, 1);
+            return true;
+        }
+    }
+
+    m_misses++;
+    diag_counter_add(DIAG_COUNTER_KEY_CACHE_MISSES, 1);
+    return false;
+}
+
+/** Stores derived material in a free slot, or in one not used since boot. Nothing is stored when
+ * every slot is in use, the material is then derived each time. */
+static void insert(key_cache_kind_t kind, const uint8_t * p_key, const void * p_material, uint32_t size)
+{
+    uint32_t index = KEY_CACHE_ENTRIES_MAX;
+    for (uint32_t i = 0; i < KEY_CACHE_ENTRIES_MAX; ++i)
+    {
+        if (!m_slots[i].valid)
+        {
+            index = i;
+            break;
+        }
+        if (!m_slots[i].used && index == KEY_CACHE_ENTRIES_MAX)
+        {
+            index = i;
+        }
+    }
+    if (index == KEY_CACHE_ENTRIES_MAX)
+    {
+        return;
+    }
+
+    key_cache_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.kind = (uint8_t) kind;
+    memcpy(entry.key, p_key, NRF_MESH_KEY_SIZE);
+    memcpy(entry.material, p_material, size);
+    entry.check = entry_check(&entry);
+
+    /* The setter fills the slot. If the store cannot be scheduled the material is derived again
+     * next time. */
+    if (mesh_config_entry_set(slot_id(index), &entry) == NRF_SUCCESS)
+    {
+        m_slots[index].used = true;
+    }
+}
+
+uint32_t __wrap_nrf_mesh_keygen_network_secmat(const uint8_t * p_key, nrf_mesh_network_secmat_t * p_secmat)
+{
+    if (p_key == NULL || p_secmat == NULL)
+    {
+        return __real_nrf_mesh_keygen_network_secmat(p_key, p_secmat);
+    }
+    if (lookup(KEY_CACHE_KIND_NETWORK, p_key, p_secmat, sizeof(*p_secmat)))
+    {
+        return NRF_SUCCESS;
+    }
+
+    uint32_t status = __real_nrf_mesh_keygen_network_secmat(p_key, p_secmat);
+    if (status == NRF_SUCCESS)
+    {
+        insert(KEY_CACHE_KIND_NETWORK, p_key, p_secmat, sizeof(*p_secmat));
+    }
+    return status;
+}
+
+uint32_t __wrap_nrf_mesh_keygen_beacon_secmat(const uint8_t * p_key, nrf_mesh_beacon_secmat_t * p_secmat)
+{
+    if (p_key == NULL || p_secmat == NULL)
+    {
+        return __real_nrf_mesh_keygen_beacon_secmat(p_key, p_secmat);
+    }
+    if (lookup(KEY_CACHE_KIND_BEACON, p_key, p_secmat, sizeof(*p_secmat)))
+    {
+        return NRF_SUCCESS;
+    }
+
+    uint32_t status = __real_nrf_mesh_keygen_beacon_secmat(p_key, p_secmat);
+    if (status == NRF_SUCCESS)
+    {
+        insert(KEY_CACHE_KIND_BEACON, p_key, p_secmat, sizeof(*p_secmat));
+    }
+    return status;
+}
+
+uint32_t __wrap_nrf_mesh_keygen_identitykey(const uint8_t * p_key, uint8_t * p_identitykey)
+{
+    if (p_key == NULL || p_identitykey == NULL)
+    {
+        return __real_nrf_mesh_keygen_identitykey(p_key, p_identitykey);
+    }
+    if (lookup(KEY_CACHE_KIND_IDENTITY, p_key, p_identitykey, NRF_MESH_KEY_SIZE))
+    {
+        return NRF_SUCCESS;
+    }
+
+    uint32_t status = __real_nrf_mesh_keygen_identitykey(p_key, p_identitykey);
+    if (status == NRF_SUCCESS)
+    {
+        insert(KEY_CACHE_KIND_IDENTITY, p_key, p_identitykey, NRF_MESH_KEY_SIZE);
+    }
+    return status;
+}
+
+uint32_t __wrap_nrf_mesh_keygen_aid(const uint8_t * p_key, uint8_t * p_aid)
+{
+    if (p_key == NULL || p_aid == NULL)
+    {
+        return __real_nrf_mesh_keygen_aid(p_key, p_aid);
+    }
+    if (lookup(KEY_CACHE_KIND_AID, p_key, p_aid, 1))
+    {
+        return NRF_SUCCESS;
+    }
+
+    uint32_t status = __real_nrf_mesh_keygen_aid(p_key, p_aid);
+    if (status == NRF_SUCCESS)
+    {
+        insert(KEY_CACHE_KIND_AID, p_key, p_aid, 1);
+    }
+    return status;
+}
+
+void key_cache_init(void)
+{
+    memset(m_slots, 0, sizeof(m_slots));
+    m_kinds_used = 0;
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void key_cache_prune(void)
+{
+    for (uint32_t i = 0; i < KEY_CACHE_ENTRIES_MAX; ++i)
+    {
+        slot_t * p_slot = &m_slots[i];
+        /* Only kinds the stack derived at boot are pruned, so that material derived later on
+         * demand is not deleted and stored again at every boot. */
+        if (p_slot->valid && !p_slot->used && (m_kinds_used & (1u << p_slot->entry.kind)))
+        {
+            (void) mesh_config_entry_delete(slot_id(i));
+        }
+    }
+}
+
+uint32_t key_cache_hits_get(void)
+{
+    return m_hits;
+}
+
+uint32_t key_cache_misses_get(void)
+{
+    return m_misses;
+}
@@ -0,0 +1,494 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "latency_probe.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "access.h"
+#include "access_config.h"
+#include "device_state_manager.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_assert.h"
+#include "nrf_mesh_defines.h"
+#include "timer.h"
+#include "log.h"
+
+#define PING_PARAMS_LEN         (6)
+#define ECHO_PARAMS_LEN         (6)
+#define MARK_PARAMS_LEN         (7)
+#define SYNC_PARAMS_LEN         (5)
+#define HIST_GET_PARAMS_LEN     (3)
+#define HIST_STATUS_HEADER_LEN  (3)
+#define HIST_STATUS_PARAMS_LEN  (HIST_STATUS_HEADER_LEN + 2 * LATENCY_PROBE_HIST_VALUES_PER_STATUS)
+
+/* Largest access payload of an unsegmented message with a 4 byte TransMIC. */
+#define UNSEG_ACCESS_PAYLOAD_MAX    (11)
+/* Length of a vendor opcode. */
+#define VENDOR_OPCODE_LEN           (3)
+
+NRF_MESH_STATIC_ASSERT(VENDOR_OPCODE_LEN + HIST_STATUS_PARAMS_LEN <= UNSEG_ACCESS_PAYLOAD_MAX);
+NRF_MESH_STATIC_ASSERT(LATENCY_PROBE_HIST_VALUE_COUNT <= UINT8_MAX);
+
+/* Mark flag: the sender's time base is synchronized. */
+#define MARK_FLAG_SYNCED        (1 << 0)
+
+typedef struct
+{
+    uint16_t buckets[LATENCY_PROBE_BUCKET_COUNT];
+    uint16_t count;
+    uint16_t max_ms;
+    uint32_t sum_ms;
+} histogram_t;
+
+typedef struct
+{
+    bool valid;
+    /* Network time in us. */
+    uint32_t time;
+    uint8_t hops;
+} timestamp_mark_t;
+
+static access_model_handle_t m_model_handle = ACCESS_HANDLE_INVALID;
+static histogram_t m_histograms[LATENCY_PROBE_KIND_COUNT][LATENCY_PROBE_HOPS_MAX + 1];
+
+/* Network time is the local time plus this offset. */
+static uint32_t m_time_offset;
+static bool m_synced;
+/* Local time of the last Sync, the session runs for LATENCY_PROBE_SESSION_TIMEOUT_MS from it. */
+static timestamp_t m_sync_time;
+static uint32_t m_hop_delay_us = LATENCY_PROBE_HOP_DELAY_US_DEFAULT;
+
+static uint8_t m_ping_seq;
+static uint8_t m_mark_seq;
+static bool m_press_pending;
+static uint32_t m_press_time;
+static timestamp_mark_t m_press;
+static timestamp_mark_t m_light;
+
+/*****************************************************************************
+ * Helpers
+ *****************************************************************************/
+
+static void le32_put(uint8_t * p_out, uint32_t value)
+{
+    p_out[0] = (uint8_t) value;
+    p_out[1] = (uint8_t) (value >> 8);
+    p_out[2] = (uint8_t) (value >> 16);
+    p_out[3] = (uint8_t) (value >> 24);
+}
+
+static uint32_t le32_get(const uint8_t * p_in)
+{
+    return ((uint32_t) p_in[0] | ((uint32_t) p_in[1] << 8) |
+            ((uint32_t) p_in[2] << 16) | ((uint32_t) p_in[3] << 24));
+}
+
+static void le16_put(uint8_t * p_out, uint16_t value)
+{
+    p_out[0] = (uint8_t) value;
+    p_out[1] = (uint8_t) (value >> 8);
+}
+
+static uint32_t network_time_now(void)
+{
+    return timer_now() + m_time_offset;
+}
+
+static bool session_active(void)
+{
+    if (m_synced && (timer_now() - m_sync_time) / 1000 > LATENCY_PROBE_SESSION_TIMEOUT_MS)
+    {
+        m_synced = false;
+        m_press.valid = false;
+        m_light.valid = false;
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Latency probe session ended\n");
+    }
+    return m_synced;
+}
+
+static void session_start(void)
+{
+    m_synced = true;
+    m_sync_time = timer_now();
+    m_press.valid = false;
+    m_light.valid = false;
+}
+
+static uint8_t publish_ttl_get(void)
+{
+    uint8_t ttl;
+    if (access_model_publish_ttl_get(m_model_handle, &ttl) != NRF_SUCCESS ||
+        ttl == ACCESS_TTL_USE_DEFAULT)
+    {
+        ttl = access_default_ttl_get();
+    }
+    return ttl;
+}
+
+static uint8_t relay_hops(uint8_t ttl_sent, uint8_t ttl_received)
+{
+    uint8_t hops = (ttl_sent > ttl_received) ? (ttl_sent - ttl_received) : 0;
+    return (hops > LATENCY_PROBE_HOPS_MAX) ? LATENCY_PROBE_HOPS_MAX : hops;
+}
+
+static bool is_local_address(uint16_t address)
+{
+    dsm_local_unicast_address_t local;
+    dsm_local_unicast_addresses_get(&local);
+    return (address >= local.address_start && address < local.address_start + local.count);
+}
+
+static void histogram_add(latency_probe_kind_t kind, uint8_t hops, uint32_t latency_us)
+{
+    histogram_t * p_hist = &m_histograms[kind][hops];
+    uint32_t latency_ms = latency_us / 1000;
+
+    uint32_t bucket = 0;
+    for (uint32_t limit_ms = 8; bucket < LATENCY_PROBE_BUCKET_COUNT - 1 && latency_ms >= limit_ms; limit_ms <<= 1)
+    {
+        bucket++;
+    }
+
+    if (p_hist->buckets[bucket] < UINT16_MAX)
+    {
+        p_hist->buckets[bucket]++;
+    }
+    if (p_hist->count < UINT16_MAX)
+    {
+        p_hist->count++;
+        p_hist->sum_ms += latency_ms;
+    }
+    if (latency_ms > p_hist->max_ms)
+    {
+        p_hist->max_ms = (latency_ms > UINT16_MAX) ? UINT16_MAX : latency_ms;
+    }
+}
+
+static uint32_t publish(uint8_t opcode, const uint8_t * p_params, uint16_t length)
+{
+    access_message_tx_t message =
+    {
+        .opcode = ACCESS_OPCODE_VENDOR(opcode, ACCESS_COMPANY_ID_NORDIC),
+        .p_buffer = p_params,
+        .length = length,
+        .force_segmented = false,
+        .transmic_size = NRF_MESH_TRANSMIC_SIZE_SMALL,
+        .access_token = nrf_mesh_unique_token_get()
+    };
+    return access_model_publish(m_model_handle, &message);
+}
+
+/* Pairs a press with a light change once both are known. The older one is dropped if they do not
+ * belong together. */
+static void pair_try(void)
+{
+    if (!m_press.valid || !m_light.valid)
+    {
+        return;
+    }
+
+    int32_t latency_us = (int32_t) (m_light.time - m_press.time);
+    if (latency_us < 0)
+    {
+        m_light.valid = false;
+    }
+    else if (latency_us > LATENCY_PROBE_PAIR_WINDOW_MS * 1000)
+    {
+        m_press.valid = false;
+    }
+    else
+    {
+        histogram_add(LATENCY_PROBE_KIND_PRESS, m_press.hops, (uint32_t) latency_us);
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Press-to-light: %u ms, %u relay hops\n",
+              (unsigned) (latency_us / 1000), m_press.hops);
+        m_press.valid = false;
+        m_light.valid = false;
+    }
+}
+
+/*****************************************************************************
+ * Opcode handlers
+ *****************************************************************************/
+
+static void handle_ping(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length != PING_PARAMS_LEN || is_local_address(p_message->meta_data.src.value))
+    {
+        return;
+    }
+
+    uint8_t params[ECHO_PARAMS_LEN];
+    memcpy(params, p_message->p_data, 5);
+    params[5] = relay_hops(p_message->p_data[5], p_message->meta_data.ttl);
+
+    access_message_tx_t reply =
+    {
+        .opcode = ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_ECHO, ACCESS_COMPANY_ID_NORDIC),
+        .p_buffer = params,
+        .length = sizeof(params),
+        .force_segmented = false,
+        .transmic_size = NRF_MESH_TRANSMIC_SIZE_SMALL,
+        .access_token = nrf_mesh_unique_token_get()
+    };
+    (void) access_model_reply(handle, p_message, &reply);
+}
+
+static void handle_echo(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length != ECHO_PARAMS_LEN || p_message->p_data[0] != m_ping_seq)
+    {
+        return;
+    }
+
+    uint32_t one_way_us = (timer_now() - le32_get(&p_message->p_data[1])) / 2;
+    uint8_t hops = p_message->p_data[5];
+    if (hops > LATENCY_PROBE_HOPS_MAX)
+    {
+        hops = LATENCY_PROBE_HOPS_MAX;
+    }
+    histogram_add(LATENCY_PROBE_KIND_PING, hops, one_way_us);
+
+    /* Each relay hop is one more transmission. */
+    m_hop_delay_us = (3 * m_hop_delay_us + one_way_us / (hops + 1)) / 4;
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Echo from 0x%04x: %u ms one-way, %u relay hops\n",
+          p_message->meta_data.src.value, (unsigned) (one_way_us / 1000), hops);
+}
+
+static void handle_mark(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length != MARK_PARAMS_LEN || !session_active() ||
+        (p_message->p_data[6] & MARK_FLAG_SYNCED) == 0 ||
+        is_local_address(p_message->meta_data.src.value))
+    {
+        return;
+    }
+
+    m_press.valid = true;
+    m_press.time = le32_get(&p_message->p_data[1]);
+    m_press.hops = relay_hops(p_message->p_data[5], p_message->meta_data.ttl);
+    pair_try();
+}
+
+static void handle_sync(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length != SYNC_PARAMS_LEN || is_local_address(p_message->meta_data.src.value))
+    {
+        return;
+    }
+
+    uint8_t hops = relay_hops(p_message->p_data[4], p_message->meta_data.ttl);
+    uint32_t transit_us = (hops + 1) * m_hop_delay_us;
+    m_time_offset = le32_get(&p_message->p_data[0]) + transit_us - timer_now();
+    session_start();
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Time synced to 0x%04x, %u relay hops\n",
+          p_message->meta_data.src.value, hops);
+}
+
+static uint16_t hist_value_get(const histogram_t * p_hist, uint32_t index)
+{
+    switch (index)
+    {
+        case 0:
+            return p_hist->count;
+        case 1:
+            return (p_hist->count > 0) ? (uint16_t) (p_hist->sum_ms / p_hist->count) : 0;
+        case 2:
+            return p_hist->max_ms;
+        default:
+            return p_hist->buckets[index - 3];
+    }
+}
+
+static void handle_hist_get(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length != HIST_GET_PARAMS_LEN ||
+        p_message->p_data[0] >= LATENCY_PROBE_KIND_COUNT ||
+        p_message->p_data[1] > LATENCY_PROBE_HOPS_MAX)
+    {
+        return;
+    }
+
+    const histogram_t * p_hist = &m_histograms[p_message->p_data[0]][p_message->p_data[1]];
+    uint32_t start = p_message->p_data[2];
+    uint8_t params[HIST_STATUS_PARAMS_LEN];
+    uint16_t length = HIST_STATUS_HEADER_LEN;
+    memcpy(params, p_message->p_data, HIST_STATUS_HEADER_LEN);
+    for (uint32_t i = start; i < LATENCY_PROBE_HIST_VALUE_COUNT && length < sizeof(params); ++i)
+    {
+        le16_put(&params[length], hist_value_get(p_hist, i));
+        length += 2;
+    }
+
+    access_message_tx_t reply =
+    {
+        .opcode = ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_HIST_STATUS, ACCESS_COMPANY_ID_NORDIC),
+        .p_buffer = params,
+        .length = length,
+        .force_segmented = false,
+        .transmic_size = NRF_MESH_TRANSMIC_SIZE_SMALL,
+        .access_token = nrf_mesh_unique_token_get()
+    };
+
+    uint32_t status = access_model_reply(handle, p_message, &reply);
+    if (status != NRF_SUCCESS)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "Latency histogram reply failed: %d\n", status);
+    }
+}
+
+static const access_opcode_handler_t m_opcode_handlers[] =
+{
+    {ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_PING, ACCESS_COMPANY_ID_NORDIC), handle_ping},
+    {ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_ECHO, ACCESS_COMPANY_ID_NORDIC), handle_echo},
+    {ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_MARK, ACCESS_COMPANY_ID_NORDIC), handle_mark},
+    {ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_SYNC, ACCESS_COMPANY_ID_NORDIC), handle_sync},
+    {ACCESS_OPCODE_VENDOR(LATENCY_PROBE_OPCODE_HIST_GET, ACCESS_COMPANY_ID_NORDIC), handle_hist_get},
+};
+
+/*****************************************************************************
+ * Public API
+ *****************************************************************************/
+
+uint32_t latency_probe_init(uint16_t element_index)
+{
+    if (m_model_handle != ACCESS_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    access_model_add_params_t add_params =
+    {
+        .model_id = ACCESS_MODEL_VENDOR(LATENCY_PROBE_MODEL_ID, ACCESS_COMPANY_ID_NORDIC),
+        .element_index = element_index,
+        .p_opcode_handlers = &m_opcode_handlers[0],
+        .opcode_count = sizeof(m_opcode_handlers) / sizeof(m_opcode_handlers[0]),
+        .p_args = NULL,
+        .publish_timeout_cb = NULL
+    };
+
+    return access_model_add(&add_params, &m_model_handle);
+}
+
+uint32_t latency_probe_ping_send(void)
+{
+    uint8_t params[PING_PARAMS_LEN];
+    params[0] = ++m_ping_seq;
+    le32_put(&params[1], timer_now());
+    params[5] = publish_ttl_get();
+    return publish(LATENCY_PROBE_OPCODE_PING, params, sizeof(params));
+}
+
+uint32_t latency_probe_sync_send(void)
+{
+    /* The reference keeps its own time base. */
+    session_start();
+
+    uint8_t params[SYNC_PARAMS_LEN];
+    le32_put(&params[0], network_time_now());
+    params[4] = publish_ttl_get();
+    return publish(LATENCY_PROBE_OPCODE_SYNC, params, sizeof(params));
+}
+
+void latency_probe_press_begin(void)
+{
+    m_press_pending = session_active();
+    m_press_time = network_time_now();
+}
+
+void latency_probe_press_mark(void)
+{
+    if (!m_press_pending)
+    {
+        return;
+    }
+    m_press_pending = false;
+
+    uint8_t params[MARK_PARAMS_LEN];
+    params[0] = ++m_mark_seq;
+    le32_put(&params[1], m_press_time);
+    params[5] = publish_ttl_get();
+    params[6] = MARK_FLAG_SYNCED;
+
+    uint32_t status = publish(LATENCY_PROBE_OPCODE_MARK, params, sizeof(params));
+    if (status != NRF_SUCCESS)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Latency mark not sent: %d\n", status);
+    }
+}
+
+void latency_probe_light_mark(void)
+{
+    if (!session_active())
+    {
+        return;
+    }
+
+    m_light.valid = true;
+    m_light.time = network_time_now();
+    pair_try();
+}
+
+void latency_probe_report_log(void)
+{
+    static const char * const kind_names[LATENCY_PROBE_KIND_COUNT] = {"ping", "press"};
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Latency report (session: %u, hop delay: %u us)\n",
+          session_active(), (unsigned) m_hop_delay_us);
+    for (uint32_t kind = 0; kind < LATENCY_PROBE_KIND_COUNT; ++kind)
+    {
+        for (uint32_t hops = 0; hops <= LATENCY_PROBE_HOPS_MAX; ++hops)
+        {
+            const histogram_t * p_hist = &m_histograms[kind][hops];
+            if (p_hist->count == 0)
+            {
+                continue;
+            }
+
+            __LOG(LOG_SRC_APP, LOG_LEVEL_INFO,
+                  "%s, %u hops: n=%u mean=%u ms max=%u ms buckets=[%u %u %u %u %u %u %u %u]\n",
+                  kind_names[kind], hops, p_hist->count, (unsigned) (p_hist->sum_ms / p_hist->count),
+                  p_hist->max_ms, p_hist->buckets[0], p_hist->buckets[1], p_hist->buckets[2],
+                  p_hist->buckets[3], p_hist->buckets[4], p_hist->buckets[5], p_hist->buckets[6],
+                  p_hist->buckets[7]);
+        }
+    }
+}
@@ -0,0 +1,285 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "light_state.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf_error.h"
+#include "app_error.h"
+#include "mesh_flash.h"
+#include "mesh_stack.h"
+#include "timer_service.h"
+#include "config_persist.h"
+#include "diag_model.h"
+#include "app_config.h"
+#include "log.h"
+
+/* Record layout: sequence number (16 bits), marker (8 bits), OnPowerUp (4 bits), OnOff (4 bits).
+ * The marker tells records from erased flash. */
+#define RECORD_MARKER               (0xA5)
+#define RECORD_SEQNUM_POS           (16)
+#define RECORD_MARKER_POS           (8)
+#define RECORD_ON_POWER_UP_POS      (4)
+#define RECORD_ERASED               (0xFFFFFFFF)
+#define RECORDS_PER_PAGE            (LIGHT_STATE_FLASH_PAGE_SIZE / sizeof(uint32_t))
+
+typedef struct
+{
+    bool onoff;
+    light_state_on_power_up_t on_power_up;
+} state_t;
+
+/* Placed by the linker directly below the mesh persistent storage, outside the application image
+ * (see flash_placement.xml and linker/nrf52832_xxAA_s132_6.1.1.ld). Volatile, as the contents
+ * change at run time. */
+static const volatile uint32_t m_pages[LIGHT_STATE_FLASH_PAGE_COUNT][RECORDS_PER_PAGE]
+    __attribute__((section(".light_state_flash"), aligned(LIGHT_STATE_FLASH_PAGE_SIZE), used));
+
+TIMER_SERVICE_DEF(m_holdoff_timer);
+static config_persist_record_t m_record;
+
+static state_t m_state;
+static state_t m_stored;
+static uint32_t m_page;
+static uint32_t m_next_index;
+static uint16_t m_seqnum;
+static bool m_holdoff;
+static bool m_deferred;
+/* Must stay untouched until the mesh flash module has written it. This is guaranteed by the
+ * minimum write interval. */
+static uint32_t m_write_word;
+
+static bool record_decode(uint32_t word, state_t * p_state, uint16_t * p_seqnum)
+{
+    uint32_t on_power_up = (word >> RECORD_ON_POWER_UP_POS) & 0x0F;
+    uint32_t onoff = word & 0x0F;
+    if (((word >> RECORD_MARKER_POS) & 0xFF) != RECORD_MARKER ||
+        on_power_up >= LIGHT_STATE_ON_POWER_UP_COUNT ||
+        onoff > 1)
+    {
+        return false;
+    }
+    p_state->onoff = (onoff != 0);
+    p_state->on_power_up = (light_state_on_power_up_t) on_power_up;
+    *p_seqnum = (uint16_t) (word >> RECORD_SEQNUM_POS);
+    return true;
+}
+
+static uint32_t record_encode(const state_t * p_state, uint16_t seqnum)
+{
+    return ((uint32_t) seqnum << RECORD_SEQNUM_POS) |
+           (RECORD_MARKER << RECORD_MARKER_POS) |
+           ((uint32_t) p_state->on_power_up << RECORD_ON_POWER_UP_POS) |
+           (p_state->onoff ? 1 : 0);
+}
+
+static void flash_op_cb(mesh_flash_user_t user, const flash_operation_t * p_op, uint16_t token)
+{
+    if (p_op->type == FLASH_OP_TYPE_WRITE)
+    {
+        diag_counter_add(DIAG_COUNTER_LIGHT_STATE_FLASH_WRITES, 1);
+    }
+}
+
+static void holdoff_timeout_handler(void * p_context)
+{
+    m_holdoff = false;
+    if (m_deferred)
+    {
+        m_deferred = false;
+        config_persist_mark_dirty(&m_record);
+    }
+}
+
+static void record_flush(void)
+{
+    if (m_state.onoff == m_stored.onoff && m_state.on_power_up == m_stored.on_power_up)
+    {
+        return;
+    }
+    if (m_holdoff)
+    {
+        diag_counter_add(DIAG_COUNTER_LIGHT_STATE_WRITES_DEFERRED, 1);
+        m_deferred = true;
+        return;
+    }
+
+    uint16_t token;
+    if (m_next_index == RECORDS_PER_PAGE)
+    {
+        /* The current page is full, continue on the other page. Its records are older. */
+        m_page = (m_page + 1) % LIGHT_STATE_FLASH_PAGE_COUNT;
+        m_next_index = 0;
+
+        flash_operation_t erase;
+        erase.type = FLASH_OP_TYPE_ERASE;
+        erase.params.erase.p_start_addr = (uint32_t *) &m_pages[m_page][0];
+        erase.params.erase.length = LIGHT_STATE_FLASH_PAGE_SIZE;
+        APP_ERROR_CHECK(mesh_flash_op_push(MESH_FLASH_USER_APP, &erase, &token));
+    }
+
+    m_seqnum++;
+    m_write_word = record_encode(&m_state, m_seqnum);
+
+    flash_operation_t write;
+    write.type = FLASH_OP_TYPE_WRITE;
+    write.params.write.p_start_addr = (uint32_t *) &m_pages[m_page][m_next_index];
+    write.params.write.p_data = &m_write_word;
+    write.params.write.length = sizeof(m_write_word);
+    APP_ERROR_CHECK(mesh_flash_op_push(MESH_FLASH_USER_APP, &write, &token));
+
+    m_next_index++;
+    m_stored = m_state;
+    m_holdoff = true;
+    APP_ERROR_CHECK(timer_service_start(&m_holdoff_timer, LIGHT_STATE_WRITE_INTERVAL_MIN_MS, NULL));
+}
+
+void light_state_init(void)
+{
+    bool found = false;
+
+    m_state.onoff = APP_CONFIG_LIGHT_POWER_UP_ONOFF;
+    m_state.on_power_up = LIGHT_STATE_ON_POWER_UP_INITIAL;
+
+    for (uint32_t page = 0; page < LIGHT_STATE_FLASH_PAGE_COUNT; ++page)
+    {
+        /* Records are appended in order, the first erased word ends the page. */
+        uint32_t count = 0;
+        state_t state;
+        uint16_t seqnum = 0;
+        while (count < RECORDS_PER_PAGE && m_pages[page][count] != RECORD_ERASED)
+        {
+            count++;
+        }
+        /* Skip a record corrupted by a power loss during the write. */
+        uint32_t last = count;
+        while (last > 0 && !record_decode(m_pages[page][last - 1], &state, &seqnum))
+        {
+            last--;
+        }
+        if (last == 0)
+        {
+            continue;
+        }
+
+        if (!found || (int16_t) (seqnum - m_seqnum) > 0)
+        {
+            found = true;
+            m_state = state;
+            m_seqnum = seqnum;
+            m_page = page;
+            m_next_index = count;
+        }
+    }
+
+    if (!found)
+    {
+        /* Start from a fresh page, in case the first one was partly written. */
+        m_page = LIGHT_STATE_FLASH_PAGE_COUNT - 1;
+        m_next_index = RECORDS_PER_PAGE;
+    }
+    m_stored = m_state;
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Light state: %s, on power up %u (%s)\n",
+          m_state.onoff ? "on" : "off", m_state.on_power_up, found ? "stored" : "initial");
+
+    APP_ERROR_CHECK(timer_service_create(&m_holdoff_timer, APP_TIMER_MODE_SINGLE_SHOT, holdoff_timeout_handler));
+    config_persist_record_register(&m_record, record_flush);
+}
+
+void light_state_flash_init(void)
+{
+    /* The linker places the pages below a reservation sized from the sizing profile, while the
+     * mesh stack places its areas down from its recovery page. Stop here rather than let either
+     * erase the other's pages if the two ever disagree. */
+    const uint32_t * p_mesh_start;
+    uint32_t mesh_length;
+    mesh_stack_persistence_flash_usage(&p_mesh_start, &mesh_length);
+    uint32_t pages_end = (uint32_t) m_pages + sizeof(m_pages);
+    if ((uint32_t) p_mesh_start < pages_end)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_ERROR, "Mesh storage at 0x%08x overlaps light state pages ending at 0x%08x\n",
+              (uint32_t) p_mesh_start, pages_end);
+        APP_ERROR_CHECK(NRF_ERROR_NO_MEM);
+    }
+
+    mesh_flash_user_callback_set(MESH_FLASH_USER_APP, flash_op_cb);
+}
+
+bool light_state_power_up_onoff_get(void)
+{
+    switch (m_state.on_power_up)
+    {
+        case LIGHT_STATE_ON_POWER_UP_OFF:
+            return false;
+        case LIGHT_STATE_ON_POWER_UP_DEFAULT:
+            return true;
+        case LIGHT_STATE_ON_POWER_UP_RESTORE:
+        default:
+            return m_state.onoff;
+    }
+}
+
+void light_state_onoff_set(bool onoff)
+{
+    if (m_state.onoff != onoff)
+    {
+        m_state.onoff = onoff;
+        config_persist_mark_dirty(&m_record);
+    }
+}
+
+light_state_on_power_up_t light_state_on_power_up_get(void)
+{
+    return m_state.on_power_up;
+}
+
+uint32_t light_state_on_power_up_set(light_state_on_power_up_t on_power_up)
+{
+    if (on_power_up >= LIGHT_STATE_ON_POWER_UP_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (m_state.on_power_up != on_power_up)
+    {
+        m_state.on_power_up = on_power_up;
+        config_persist_mark_dirty(&m_record);
+    }
+    return NRF_SUCCESS;
+}
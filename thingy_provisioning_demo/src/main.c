@@ -60,13 +60,32 @@
 /* Models */
 #include "generic_onoff_server.h"
 #include "generic_onoff_client.h"
+#include "diag_model.h"
+#include "latency_probe.h"
+#include "ponoff_server.h"
+#include "light_state.h"
+#include "factory_oob.h"
+#include "oob_color.h"
+#include "tx_priority.h"
+#include "scan_filter.h"
+#include "relay_policy.h"
+#include "ccm_backend.h"
+#include "crypto_bench.h"
+#include "config_persist.h"
+#include "ram_overlay.h"
+#include "mesh_mem_pool.h"
+#include "key_cache.h"
+#include "sub_index.h"
 
 /* Logging and RTT */
 #include "log.h"
-#include "rtt_input.h"
+#include "debug_console.h"
 
 /* Example specific includes */
 #include "app_config.h"
+#include "mesh_app_sizing.h"
+#include "cycle_counter.h"
+#include "boot_timeline.h"
 #include "example_common.h"
 #include "nrf_mesh_config_examples.h"
 #include "light_switch_example_common.h"
@@ -123,6 +142,8 @@ static void app_onoff_server_set_cb(const app_onoff_server_t * p_server, bool on
 
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Setting GPIO value: %d\n", onoff)
     hal_led_pin_set(onoff);
+    light_state_onoff_set(onoff);
+    latency_probe_light_mark();
     
 }
 
@@ -204,6 +225,10 @@ static void node_reset(void)
 
 static void config_server_evt_cb(const config_server_evt_t * p_evt)
 {
+    config_persist_config_server_evt(p_evt);
+    relay_policy_config_server_evt(p_evt);
+    sub_index_config_server_evt(p_evt);
+
     if (p_evt->type == CONFIG_SERVER_EVT_NODE_RESET)
     {
         node_reset();
@@ -213,6 +238,11 @@ static void config_server_evt_cb(const config_server_evt_t * p_evt)
 static void button_event_handler(uint32_t button_number)
 {
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Button %u pressed\n", button_number);
+    if (!mesh_stack_is_device_provisioned())
+    {
+        mesh_provisionee_prov_boost();
+        return;
+    }
     uint32_t status = NRF_SUCCESS;
     generic_onoff_set_params_t set_params;
     model_transition_t transition_params;
@@ -228,17 +258,22 @@ static void button_event_handler(uint32_t button_number)
         case 0:
         case 1:
         {
+             tx_priority_interactive_begin();
+             latency_probe_press_begin();
              m_on_off_button_flag=!m_on_off_button_flag; 
              set_params.on_off=m_on_off_button_flag;
             __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Sending msg: ONOFF SET %d\n", set_params.on_off);
             status = generic_onoff_client_set_unack(&m_client, &set_params,
                                                     &transition_params, APP_UNACK_MSG_REPEAT_COUNT);
+            tx_priority_interactive_end();
+            latency_probe_press_mark();
         }
         default:
             break;
     }
 }
 
+#if DEBUG_CONSOLE_ENABLED
 static void app_rtt_input_handler(int key)
 {
     if (key >= '0' && key <= '4')
@@ -246,7 +281,31 @@ static void app_rtt_input_handler(int key)
         uint32_t button_number = key - '0';
         button_event_handler(button_number);
     }
+    else if (key == 'p')
+    {
+        (void) latency_probe_ping_send();
+    }
+    else if (key == 's')
+    {
+        (void) latency_probe_sync_send();
+    }
+    else if (key == 'r')
+    {
+        latency_probe_report_log();
+    }
+    else if (key == 'd')
+    {
+        relay_policy_enable(!relay_policy_is_enabled());
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Relay policy %s\n", relay_policy_is_enabled() ? "enabled" : "disabled");
+    }
+#if CRYPTO_BENCH_ENABLED
+    else if (key == 'b')
+    {
+        crypto_bench_run();
+    }
+#endif
 }
+#endif
 
 static void device_identification_start_cb(uint8_t attention_duration_s)
 {
@@ -258,6 +317,9 @@ static void device_identification_start_cb(uint8_t attention_duration_s)
 
 static void provisioning_aborted_cb(void)
 {
+#if APP_CONFIG_OUTPUT_OOB_COLOR
+    oob_color_stop();
+#endif
     hal_led_blink_stop();
 }
 
@@ -276,6 +338,11 @@ static void provisioning_complete_cb(void)
     dsm_local_unicast_addresses_get(&node_address);
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Node Address: 0x%04x \n", node_address.address_start);
 
+    scan_filter_pb_adv_set(false);
+
+#if APP_CONFIG_OUTPUT_OOB_COLOR
+    oob_color_stop();
+#endif
     hal_led_blink_stop();
     hal_led_pin_set(0);
     hal_led_blink_ms(LED_BLINK_INTERVAL_MS, LED_BLINK_CNT_PROV);
@@ -291,6 +358,10 @@ static void models_init_cb(void)
     m_client.settings.force_segmented = APP_CONFIG_FORCE_SEGMENTATION;
     m_client.settings.transmic_size = APP_CONFIG_MIC_SIZE;
     ERROR_CHECK(generic_onoff_client_init(&m_client,  APP_ONOFF_ELEMENT_INDEX+1));
+
+    ERROR_CHECK(diag_model_init(APP_ONOFF_ELEMENT_INDEX));
+    ERROR_CHECK(latency_probe_init(APP_ONOFF_ELEMENT_INDEX));
+    ERROR_CHECK(ponoff_server_init(APP_ONOFF_ELEMENT_INDEX));
 }
 static void board_init(void)
 {
@@ -349,37 +420,44 @@ void GPIOTE_IRQHandler(void)
     
 }
 
-uint32_t m_my_ui_init( void)
+/* Brings up the light driver. Only the lightwell is needed to restore the light state, the
+ * rest of the UI is set up by ui_deferred_init() once the mesh is running. */
+static void light_init(void)
 {
-    uint32_t                        err_code;
     static drv_sx1509_cfg_t         sx1509_cfg;
     drv_ext_light_init_t            led_init;
     //lint --e{651} Potentially confusing initializer
     static const drv_ext_light_conf_t led_conf[DRV_EXT_LIGHT_NUM] = DRV_EXT_LIGHT_CFG;
 
+    /* Same bus speed as board_init(), every light update is a TWI transaction. */
     static const nrf_drv_twi_config_t twi_config =
     {
         .scl                = TWI_SCL,
         .sda                = TWI_SDA,
-        .frequency          = NRF_TWI_FREQ_100K,
+        .frequency          = NRF_TWI_FREQ_400K,
         .interrupt_priority = APP_IRQ_PRIORITY_LOW
     };
     sx1509_cfg.twi_addr       = SX1509_ADDR;
     sx1509_cfg.p_twi_instance = &m_twi_sensors;
     sx1509_cfg.p_twi_cfg      = &twi_config;
 
-
-
     led_init.p_light_conf        = led_conf;
     led_init.num_lights          = DRV_EXT_LIGHT_NUM;
     led_init.clkx_div            = DRV_EXT_LIGHT_CLKX_DIV_8;
     led_init.p_twi_conf          = &sx1509_cfg;
     led_init.resync_pin          = SX_RESET;
 
-    err_code = drv_ext_light_init(&led_init, false);
-    APP_ERROR_CHECK(err_code);
+    APP_ERROR_CHECK(drv_ext_light_init(&led_init, false));
+}
+
+static void light_restore(void)
+{
+    hal_led_pin_set(light_state_power_up_onoff_get());
+}
+
+static void ui_deferred_init(void)
+{
     ERROR_CHECK(drv_ext_light_off(DRV_EXT_RGB_LED_SENSE));
-    ERROR_CHECK(drv_ext_light_off(DRV_EXT_RGB_LED_LIGHTWELL));
     nrf_gpio_cfg_output(MOS_1);
     nrf_gpio_cfg_output(MOS_2);
     nrf_gpio_cfg_output(MOS_3);
@@ -388,12 +466,19 @@ uint32_t m_my_ui_init( void)
     nrf_gpio_pin_clear(MOS_2);
     nrf_gpio_pin_clear(MOS_3);
     nrf_gpio_pin_clear(MOS_4);
-    
- 
-
+}
+#if APP_CONFIG_OUTPUT_OOB_COLOR
+static void provisioning_color_output_cb(uint8_t * number)
+{
+    /* The Output Numeric value is big endian at the end of the 16 byte authentication value. */
+    uint32_t value = ((uint32_t) number[12] << 24) | ((uint32_t) number[13] << 16) |
+                     ((uint32_t) number[14] << 8) | number[15];
 
-    return NRF_SUCCESS;
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Color OOB %u\n", value);
+    hal_led_blink_stop();
+    oob_color_show(value);
 }
+#else
 static void provisioning_blink_output_cb(uint8_t * number)
 
 {   uint32_t err_code;
@@ -407,6 +492,7 @@ static void provisioning_blink_output_cb(uint8_t * number)
     hal_led_blink_ms(500,number[15]);
     APP_ERROR_CHECK(err_code);
 }
+#endif
 static void mesh_init(void)
 {
     mesh_stack_init_params_t init_params =
@@ -417,45 +503,138 @@ static void mesh_init(void)
         .models.models_init_cb   = models_init_cb,
         .models.config_server_cb = config_server_evt_cb
     };
+
+    key_cache_init();
+    cycle_counter_enable();
+    uint32_t start = cycle_counter_get();
     ERROR_CHECK(mesh_stack_init(&init_params, &m_device_provisioned));
+    uint32_t stack_init_us = cycle_counter_to_us(cycle_counter_get() - start);
+    diag_counter_set(DIAG_COUNTER_BOOT_STACK_INIT_US, stack_init_us);
+    key_cache_prune();
+    /* The access layer dispatches group messages through the index, build it from the loaded
+     * subscriptions before the first message can arrive. */
+    sub_index_rebuild();
+
+    /* The stack derives the network, beacon and identity keys of every subnet and the AID of
+     * every application key while loading them, so report the time with the key counts and how
+     * many of the derivations the key cache answered. */
+    mesh_key_index_t net_key_indexes[DSM_SUBNET_MAX];
+    uint32_t subnet_count = sizeof(net_key_indexes) / sizeof(net_key_indexes[0]);
+    uint32_t appkey_count = 0;
+    if (dsm_subnet_get_all(net_key_indexes, &subnet_count) != NRF_SUCCESS)
+    {
+        subnet_count = 0;
+    }
+    for (uint32_t i = 0; i < subnet_count; ++i)
+    {
+        mesh_key_index_t app_key_indexes[DSM_APP_MAX];
+        uint32_t count = sizeof(app_key_indexes) / sizeof(app_key_indexes[0]);
+        if (dsm_appkey_get_all(dsm_net_key_index_to_subnet_handle(net_key_indexes[i]),
+                               app_key_indexes, &count) == NRF_SUCCESS)
+        {
+            appkey_count += count;
+        }
+    }
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Stack init: %u us (%u subnets, %u app keys, key cache %u hits, %u misses)\n",
+          stack_init_us, subnet_count, appkey_count, key_cache_hits_get(), key_cache_misses_get());
+}
+
+static void ram_overlay_handover(void)
+{
+    /* Provisioning does not run again before the next reset, give its RAM to the mesh allocator. */
+    ram_overlay_release();
+    uint32_t size = ram_overlay_free_get();
+    mesh_mem_pool_region_add(ram_overlay_alloc(size), size);
 }
 
 static void initialize(void)
 {
+    boot_timeline_mark("main");
     __LOG_INIT(LOG_SRC_APP | LOG_SRC_FRIEND, LOG_LEVEL_DBG1, LOG_CALLBACK_DEFAULT);
     __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "----- Thingy Provisioning Demo -----\n");
+    mesh_app_sizing_log();
+    ram_overlay_init();
 
     ERROR_CHECK(app_timer_init());
     hal_leds_init();
+    config_persist_init();
+    light_state_init();
+    boot_timeline_mark("timers");
+
+    /* Fast start: the light only needs the I/O expander, so restore it before the SoftDevice
+     * and the mesh stack (which loads its flash configuration) are brought up. */
+    board_init();
+    light_init();
+    light_restore();
+    diag_counter_set(DIAG_COUNTER_BOOT_LIGHT_RESTORE_US, boot_timeline_elapsed_us());
+    boot_timeline_mark("light_restore");
+
     ble_stack_init();
 #if MESH_FEATURE_GATT_ENABLED
     gap_params_init();
     conn_params_init();
 #endif
-    board_init();
+    boot_timeline_mark("ble_stack_init");
     mesh_init();
-    m_my_ui_init();
+    light_state_flash_init();
+    boot_timeline_mark("mesh_init");
+#if CCM_BACKEND_SELFTEST_ENABLED
+    if (!ccm_backend_selftest())
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_ERROR, "AES-CCM self test failed\n");
+        APP_ERROR_CHECK(NRF_ERROR_INTERNAL);
+    }
+#endif
+    tx_priority_init();
+    scan_filter_init();
+    relay_policy_init();
+    if (m_device_provisioned)
+    {
+        scan_filter_pb_adv_set(false);
+        ram_overlay_handover();
+    }
+    boot_timeline_mark("app_modules");
+#if CRYPTO_BENCH_ENABLED
+    crypto_bench_run();
+#endif
 
     
 }
 
 static void start(void)
 {
-    rtt_input_enable(app_rtt_input_handler, RTT_INPUT_POLL_PERIOD_MS);
+#if DEBUG_CONSOLE_ENABLED
+    debug_console_init(app_rtt_input_handler);
+#endif
     nrf_gpio_cfg_input(THINGY_BUTTON,GPIO_PIN_CNF_PULL_Pullup);
     if (!m_device_provisioned)
     {
-        static const uint8_t static_auth_data[NRF_MESH_KEY_SIZE] = STATIC_AUTH_DATA;
+        static uint8_t static_auth_data[NRF_MESH_KEY_SIZE] = STATIC_AUTH_DATA;
+        bool factory_mode = (factory_oob_static_data_get(static_auth_data) == NRF_SUCCESS);
+#if APP_CONFIG_OUTPUT_OOB_COLOR
+        oob_color_init();
+#endif
         mesh_provisionee_start_params_t prov_start_params =
         {
             .p_static_data    = static_auth_data,
+            .static_oob_only  = factory_mode,
             .prov_complete_cb = provisioning_complete_cb,
             .prov_device_identification_start_cb = device_identification_start_cb,
             .prov_device_identification_stop_cb = NULL,
-            .auth_output_cb = provisioning_blink_output_cb, 
+#if APP_CONFIG_OUTPUT_OOB_COLOR
+            .auth_output_cb = factory_mode ? NULL : provisioning_color_output_cb,
+            .oob_output_actions = NRF_MESH_PROV_OOB_OUTPUT_ACTION_NUMERIC,
+            .oob_output_size = OOB_COLOR_OUTPUT_SIZE,
+#else
+            .auth_output_cb = factory_mode ? NULL : provisioning_blink_output_cb,
+            .oob_output_actions = NRF_MESH_PROV_OOB_OUTPUT_ACTION_BLINK,
+            .oob_output_size = 5,
+#endif
             .prov_abort_cb = provisioning_aborted_cb,
             .p_device_uri = EX_URI_LS_SERVER
         };
+        __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Provisioning with %s\n",
+              factory_mode ? "factory static OOB" : "shared static OOB or output OOB");
         ERROR_CHECK(mesh_provisionee_prov_start(&prov_start_params));
         led_breath_red();
 
@@ -481,6 +660,12 @@ static void start(void)
     mesh_app_uuid_print(nrf_mesh_configure_device_uuid_get());
 
     ERROR_CHECK(mesh_stack_start());
+    diag_counter_set(DIAG_COUNTER_BOOT_MESH_START_US, boot_timeline_elapsed_us());
+    boot_timeline_mark("mesh_stack_start");
+
+    ui_deferred_init();
+    boot_timeline_mark("ui_deferred_init");
+    boot_timeline_log();
 
    /* hal_led_pin_set(0);
     hal_led_blink_ms(LEDS_MASK, LED_BLINK_INTERVAL_MS, LED_BLINK_CNT_START);*/
@@ -496,5 +681,6 @@ int main(void)
     for (;;)
     {
         (void)sd_app_evt_wait();
+        diag_counter_add(DIAG_COUNTER_IDLE_WAKEUPS, 1);
     }
 }
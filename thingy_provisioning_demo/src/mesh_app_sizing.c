@@ -0,0 +1,71 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mesh_app_sizing.h"
+
+#include <stdint.h>
+
+#include "nrf_mesh_config_core.h"
+#include "mesh_mem_pool.h"
+#include "key_cache.h"
+#include "sub_index.h"
+#include "nrf_mesh_defines.h"
+#include "log.h"
+
+NRF_MESH_STATIC_ASSERT(sizeof(sub_index_entry_t) == MESH_APP_SIZING_SUB_INDEX_RAM);
+
+/* Reservation for the mesh persistent storage pages. The section is never loaded; it is placed at
+ * the end of the FLASH region, with the light state pages below it, so that the link fails when the
+ * image and the storage selected by the sizing profile do not fit in the FLASH region together. */
+static const uint8_t m_persistent_storage_reserve[MESH_APP_SIZING_FLASH_BYTES]
+    __attribute__((section(".mesh_persistent_reserve"), used));
+
+void mesh_app_sizing_log(void)
+{
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Sizing profile %u: %u nodes, %u groups\n",
+          MESH_APP_SIZING_PROFILE, MESH_APP_TARGET_NODE_COUNT, MESH_APP_TARGET_GROUP_COUNT);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Sizing RAM: about %u bytes, flash: %u pages (DSM %u, access %u, key cache %u)\n",
+          MESH_APP_SIZING_RAM_BYTES, MESH_APP_SIZING_FLASH_PAGES,
+          DSM_FLASH_PAGE_COUNT, ACCESS_FLASH_PAGE_COUNT, MESH_APP_SIZING_KEY_CACHE_FLASH_PAGES);
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Subscription index: %u entries of %u bytes, %u bytes, %u in use\n",
+          SUB_INDEX_ENTRIES_MAX, sizeof(sub_index_entry_t), SUB_INDEX_ENTRIES_MAX * sizeof(sub_index_entry_t),
+          sub_index_count_get());
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Sequence number block: %u, %u.%02u flash writes per 10k messages\n",
+          NETWORK_SEQNUM_FLASH_BLOCK_SIZE, MESH_APP_SEQNUM_FLASH_WRITES_PER_10K_X100 / 100,
+          MESH_APP_SEQNUM_FLASH_WRITES_PER_10K_X100 % 100);
+    (void) m_persistent_storage_reserve;
+}
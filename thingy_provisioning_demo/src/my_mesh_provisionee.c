@@ -43,6 +43,12 @@
 #include "nrf_mesh_prov_bearer_adv.h"
 #include "app_error.h"
 #include "mesh_opt_core.h"
+#include "timer.h"
+#include "diag_model.h"
+#include "config_persist.h"
+#include "ram_overlay.h"
+#include "prov_cadence.h"
+#include "p256_comb.h"
 
 #include "nrf_mesh_config_examples.h"
 #include "nrf_mesh_config_prov.h"
@@ -62,11 +68,11 @@
 
 static bool                        m_doing_gatt_reset;
 
-static nrf_mesh_prov_bearer_gatt_t m_prov_bearer_gatt;
+static nrf_mesh_prov_bearer_gatt_t m_prov_bearer_gatt RAM_OVERLAY;
 #endif  /* MESH_FEATURE_PB_GATT_ENABLED */
 
 #if MESH_FEATURE_PB_ADV_ENABLED
-static nrf_mesh_prov_bearer_adv_t m_prov_bearer_adv;
+static nrf_mesh_prov_bearer_adv_t m_prov_bearer_adv RAM_OVERLAY;
 #endif
 
 #if !MESH_FEATURE_PB_ADV_ENABLED && !MESH_FEATURE_PB_GATT_ENABLED
@@ -74,13 +80,27 @@ static nrf_mesh_prov_bearer_adv_t m_prov_bearer_adv;
 #endif
 
 static mesh_provisionee_start_params_t m_params;
-static nrf_mesh_prov_ctx_t             m_prov_ctx;
-static uint8_t                         m_public_key[NRF_MESH_PROV_PUBKEY_SIZE];
-static uint8_t                         m_private_key[NRF_MESH_PROV_PRIVKEY_SIZE];
+/* Provisioning-only state, handed over to runtime consumers once the device is provisioned. */
+static nrf_mesh_prov_ctx_t             m_prov_ctx RAM_OVERLAY;
+static uint8_t                         m_public_key[NRF_MESH_PROV_PUBKEY_SIZE] RAM_OVERLAY;
+static uint8_t                         m_private_key[NRF_MESH_PROV_PRIVKEY_SIZE] RAM_OVERLAY;
 static bool                            m_device_provisioned;
 static bool                            m_device_identification_started;
+/* Start of the current provisioning phase, used for the diagnostics phase timings. */
+static timestamp_t                     m_phase_start;
+/* Set while a provisioning link or the following GATT database reset is in progress. */
+static bool                            m_radio_critical;
 
 
+static void radio_critical_set(bool active)
+{
+    if (m_radio_critical != active)
+    {
+        m_radio_critical = active;
+        config_persist_radio_critical_set(active);
+    }
+}
+
 #if MESH_FEATURE_PB_GATT_ENABLED
 
 static void mesh_evt_handler(const nrf_mesh_evt_t * p_evt);
@@ -142,6 +162,7 @@ static void sd_state_evt_handler(nrf_sdh_state_evt_t state, void * p_context)
             APP_ERROR_CHECK(err_code);
 
             m_doing_gatt_reset = false;
+            radio_critical_set(false);
 
             if (m_params.prov_complete_cb != NULL)
             {
@@ -176,7 +197,14 @@ static void gatt_database_reset(void)
 }
 #endif /* MESH_FEATURE_PB_GATT_ENABLED */
 
-static uint32_t provisionee_start(void)
+static void phase_time_record(diag_counter_t counter)
+{
+    timestamp_t now = timer_now();
+    diag_counter_set(counter, (now - m_phase_start) / 1000);
+    m_phase_start = now;
+}
+
+static uint32_t prov_listen(void)
 {
     uint32_t bearers = 0;
 
@@ -187,16 +215,45 @@ static uint32_t provisionee_start(void)
 #if MESH_FEATURE_PB_GATT_ENABLED
     bearers |= NRF_MESH_PROV_BEARER_GATT;
 #endif
-    /* Re-generate the keys each round. */
-    RETURN_ON_ERROR(nrf_mesh_prov_generate_keys(m_public_key, m_private_key));
-    return nrf_mesh_prov_listen(&m_prov_ctx, m_params.p_device_uri, 0, bearers);
+    /* In static OOB only mode the provisioner derives the OOB data itself, flag it as "other". */
+    uint16_t oob_info_sources = m_params.static_oob_only ? NRF_MESH_PROV_OOB_INFO_SOURCE_OTHER : 0;
+    return nrf_mesh_prov_listen(&m_prov_ctx, m_params.p_device_uri, oob_info_sources, bearers);
+}
+
+static void cadence_listen_cb(bool listen)
+{
+    uint32_t status = listen ? prov_listen() : nrf_mesh_prov_listen_stop(&m_prov_ctx);
+
+    /* A link being opened makes the bearers leave the listening state before the link is
+     * reported, the cadence is stopped when it is. */
+    if (status != NRF_ERROR_INVALID_STATE)
+    {
+        APP_ERROR_CHECK(status);
+    }
+}
+
+static uint32_t provisionee_start(void)
+{
+    /* Re-generate the keys each round, with the fixed-base comb instead of the micro-ecc ladder of
+     * nrf_mesh_prov_generate_keys(). */
+    p256_comb_key_pair_generate(m_public_key, m_private_key);
+    m_phase_start = timer_now();
+    RETURN_ON_ERROR(prov_listen());
+    prov_cadence_start();
+    return NRF_SUCCESS;
 }
 
 static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
 {
     switch (p_evt->type)
     {
+        case NRF_MESH_PROV_EVT_LINK_ESTABLISHED:
+            prov_cadence_stop();
+            break;
+
         case NRF_MESH_PROV_EVT_INVITE_RECEIVED:
+            phase_time_record(DIAG_COUNTER_PROV_INVITE_MS);
+            radio_critical_set(true);
             if (m_params.prov_device_identification_start_cb != NULL
                 && p_evt->params.invite_received.attention_duration_s > 0)
             {
@@ -207,6 +264,7 @@ static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
             break;
 
         case NRF_MESH_PROV_EVT_START_RECEIVED:
+            phase_time_record(DIAG_COUNTER_PROV_START_MS);
             if (m_params.prov_device_identification_stop_cb != NULL
                 && m_device_identification_started)
             {
@@ -225,6 +283,7 @@ static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
                     m_params.prov_abort_cb();
                 }
 
+                radio_critical_set(false);
                 (void) provisionee_start();
             }
             else
@@ -233,6 +292,7 @@ static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
                 /* it requires switching GATT service before provisioning complete */
                 gatt_database_reset();
 #else
+                radio_critical_set(false);
                 if (m_params.prov_complete_cb != NULL)
                 {
                     m_params.prov_complete_cb();
@@ -249,6 +309,7 @@ static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
 
         case NRF_MESH_PROV_EVT_COMPLETE:
         {
+            phase_time_record(DIAG_COUNTER_PROV_COMPLETE_MS);
             APP_ERROR_CHECK(mesh_stack_provisioning_data_store(
                                     p_evt->params.complete.p_prov_data,
                                     p_evt->params.complete.p_devkey));
@@ -256,7 +317,10 @@ static void prov_evt_handler(const nrf_mesh_prov_evt_t * p_evt)
             break;
         }
         case  NRF_MESH_PROV_EVT_OUTPUT_REQUEST:
-            m_params.auth_output_cb(p_evt->params.output_request.p_data);
+            if (m_params.auth_output_cb != NULL)
+            {
+                m_params.auth_output_cb(p_evt->params.output_request.p_data);
+            }
          
             break;
 
@@ -273,17 +337,27 @@ uint32_t mesh_provisionee_prov_start(const mesh_provisionee_start_params_t * p_s
         NRF_MESH_PROV_ALGORITHM_FIPS_P256EC,
         0,
         NRF_MESH_PROV_OOB_STATIC_TYPE_SUPPORTED,
-        5,
-        NRF_MESH_PROV_OOB_OUTPUT_ACTION_BLINK,
+        0,
+        0,
         0,
         0
     };
 
+    if (ram_overlay_is_released())
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
     m_params = *p_start_params;
     if (m_params.p_static_data == NULL)
     {
         return NRF_ERROR_INVALID_PARAM;
     }
+    if (!m_params.static_oob_only)
+    {
+        prov_caps.oob_output_size = m_params.oob_output_size;
+        prov_caps.oob_output_actions = m_params.oob_output_actions;
+    }
 
     /* Public/private keys are (re-)generated in provisionee_start(). */
     RETURN_ON_ERROR(nrf_mesh_prov_init(&m_prov_ctx,
@@ -303,10 +377,17 @@ uint32_t mesh_provisionee_prov_start(const mesh_provisionee_start_params_t * p_s
                         &m_prov_ctx,
                         nrf_mesh_prov_bearer_gatt_interface_get(&m_prov_bearer_gatt)));
 #endif
+    prov_cadence_init(cadence_listen_cb);
     return provisionee_start();
 }
 
 uint32_t mesh_provisionee_prov_listen_stop(void)
 {
+    prov_cadence_stop();
     return nrf_mesh_prov_listen_stop(&m_prov_ctx);
 }
+
+void mesh_provisionee_prov_boost(void)
+{
+    prov_cadence_boost();
+}
@@ -0,0 +1,143 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "oob_color.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_error.h"
+#include "drv_ext_light.h"
+#include "timer_service.h"
+
+/* Every channel fully on or off. Mixed intensities (orange, purple, pink) are too easily taken for
+ * red, blue or magenta on the lightwell. */
+static const drv_ext_light_color_mix_t m_digit_colors[OOB_COLOR_COUNT] =
+{
+    DRV_EXT_LIGHT_COLOR_WHITE,          /* 0 and 5 */
+    DRV_EXT_LIGHT_COLOR_RED,            /* 1 and 6 */
+    DRV_EXT_LIGHT_COLOR_GREEN,          /* 2 and 7 */
+    DRV_EXT_LIGHT_COLOR_BLUE,           /* 3 and 8 */
+    DRV_EXT_LIGHT_COLOR_YELLOW,         /* 4 and 9 */
+};
+
+TIMER_SERVICE_DEF(m_step_timer);
+static uint8_t m_digits[OOB_COLOR_OUTPUT_SIZE];
+/* Even steps show digit step / 2, odd steps are dark. */
+static uint32_t m_step;
+
+static void digit_show(uint8_t digit)
+{
+    drv_ext_light_color_mix_t color = m_digit_colors[digit % OOB_COLOR_COUNT];
+
+    if (digit < OOB_COLOR_COUNT)
+    {
+        drv_ext_light_rgb_intensity_t intensity =
+        {
+            .r = (color & DRV_EXT_LIGHT_COLOR_RED) ? 0xFF : 0,
+            .g = (color & DRV_EXT_LIGHT_COLOR_GREEN) ? 0xFF : 0,
+            .b = (color & DRV_EXT_LIGHT_COLOR_BLUE) ? 0xFF : 0,
+        };
+        APP_ERROR_CHECK(drv_ext_light_rgb_intensity_set(DRV_EXT_RGB_LED_LIGHTWELL, &intensity));
+    }
+    else
+    {
+        /* Flashed by the SX1509 LED engine, without fading. */
+        drv_ext_light_rgb_sequence_t seq = SEQUENCE_DEFAULT_VALUES;
+        seq.color = color;
+        seq.sequence_vals.on_time_ms = OOB_COLOR_FLASH_MS;
+        seq.sequence_vals.on_intensity = 0xFF;
+        seq.sequence_vals.off_time_ms = OOB_COLOR_FLASH_MS;
+        seq.sequence_vals.off_intensity = 0;
+        seq.sequence_vals.fade_in_time_ms = 0;
+        seq.sequence_vals.fade_out_time_ms = 0;
+        APP_ERROR_CHECK(drv_ext_light_rgb_sequence(DRV_EXT_RGB_LED_LIGHTWELL, &seq));
+    }
+}
+
+static void step_run(void)
+{
+    uint32_t timeout_ms;
+
+    if ((m_step & 1) == 0)
+    {
+        digit_show(m_digits[m_step / 2]);
+        timeout_ms = OOB_COLOR_DIGIT_MS;
+    }
+    else
+    {
+        APP_ERROR_CHECK(drv_ext_light_off(DRV_EXT_RGB_LED_LIGHTWELL));
+        timeout_ms = OOB_COLOR_GAP_MS;
+    }
+
+    m_step++;
+    if (m_step == OOB_COLOR_OUTPUT_SIZE * 2)
+    {
+        m_step = 0;
+        timeout_ms += OOB_COLOR_REPEAT_GAP_MS;
+    }
+    APP_ERROR_CHECK(timer_service_start(&m_step_timer, timeout_ms, NULL));
+}
+
+static void step_timeout_handler(void * p_context)
+{
+    (void) p_context;
+    step_run();
+}
+
+void oob_color_init(void)
+{
+    APP_ERROR_CHECK(timer_service_create(&m_step_timer, APP_TIMER_MODE_SINGLE_SHOT, step_timeout_handler));
+}
+
+void oob_color_show(uint32_t value)
+{
+    for (uint32_t i = OOB_COLOR_OUTPUT_SIZE; i > 0; --i)
+    {
+        m_digits[i - 1] = (uint8_t) (value % 10);
+        value /= 10;
+    }
+    m_step = 0;
+    step_run();
+}
+
+void oob_color_stop(void)
+{
+    timer_service_stop(&m_step_timer);
+    APP_ERROR_CHECK(drv_ext_light_off(DRV_EXT_RGB_LED_LIGHTWELL));
+}
@@ -0,0 +1,356 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "p256_comb.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "rand.h"
+
+/* Field elements are 8 little-endian 32 bit words. Point coordinates are kept in the Montgomery
+ * domain, a R mod p with R = 2^256. */
+#define FE_WORDS (8)
+
+typedef uint32_t fe_t[FE_WORDS];
+
+/** Projective point (X : Y : Z), the point at infinity is (0 : 1 : 0). */
+typedef struct
+{
+    fe_t x;
+    fe_t y;
+    fe_t z;
+} point_t;
+
+static const fe_t m_p =
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF};
+static const fe_t m_n =
+    {0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
+/* 1 and the curve coefficient b in the Montgomery domain. */
+static const fe_t m_one =
+    {0x00000001, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFE, 0x00000000};
+static const fe_t m_b =
+    {0x29C4BDDF, 0xD89CDF62, 0x78843090, 0xACF005CD, 0xF7212ED6, 0xE5A220AB, 0x04874834, 0xDC30061D};
+/* p - 2, the inversion exponent. */
+static const fe_t m_p_minus_2 =
+    {0xFFFFFFFD, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0xFFFFFFFF};
+
+/** Sets r to a if mask is all ones, and to b if it is zero. */
+static void fe_select(fe_t r, const fe_t a, const fe_t b, uint32_t mask)
+{
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        r[i] = (a[i] & mask) | (b[i] & ~mask);
+    }
+}
+
+/** Sets r to a - p if carry is set or a >= p, otherwise to a. */
+static void fe_reduce_once(fe_t r, const fe_t a, uint32_t carry)
+{
+    fe_t d;
+    uint32_t borrow = 0;
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t diff = (uint64_t) a[i] - m_p[i] - borrow;
+        d[i] = (uint32_t) diff;
+        borrow = (uint32_t) (diff >> 32) & 1;
+    }
+    fe_select(r, d, a, 0 - (carry | (borrow ^ 1)));
+}
+
+static void fe_add(fe_t r, const fe_t a, const fe_t b)
+{
+    fe_t sum;
+    uint32_t carry = 0;
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t s = (uint64_t) a[i] + b[i] + carry;
+        sum[i] = (uint32_t) s;
+        carry = (uint32_t) (s >> 32);
+    }
+    fe_reduce_once(r, sum, carry);
+}
+
+static void fe_sub(fe_t r, const fe_t a, const fe_t b)
+{
+    uint32_t borrow = 0;
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t diff = (uint64_t) a[i] - b[i] - borrow;
+        r[i] = (uint32_t) diff;
+        borrow = (uint32_t) (diff >> 32) & 1;
+    }
+
+    /* Add p back on underflow. */
+    uint32_t mask = 0 - borrow;
+    uint32_t carry = 0;
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t s = (uint64_t) r[i] + (m_p[i] & mask) + carry;
+        r[i] = (uint32_t) s;
+        carry = (uint32_t) (s >> 32);
+    }
+}
+
+/**
+ * Montgomery multiplication, r = a b / R mod p, word by word (CIOS). -p^-1 mod 2^32 is 1, so the
+ * reduction factor of each round is the lowest word itself.
+ */
+static void fe_mul(fe_t r, const fe_t a, const fe_t b)
+{
+    uint32_t t[FE_WORDS + 2] = {0};
+
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t acc;
+        uint32_t carry = 0;
+        for (uint32_t j = 0; j < FE_WORDS; ++j)
+        {
+            acc = (uint64_t) a[j] * b[i] + t[j] + carry;
+            t[j] = (uint32_t) acc;
+            carry = (uint32_t) (acc >> 32);
+        }
+        acc = (uint64_t) t[FE_WORDS] + carry;
+        t[FE_WORDS] = (uint32_t) acc;
+        t[FE_WORDS + 1] = (uint32_t) (acc >> 32);
+
+        uint32_t m = t[0];
+        acc = (uint64_t) m * m_p[0] + t[0];
+        carry = (uint32_t) (acc >> 32);
+        for (uint32_t j = 1; j < FE_WORDS; ++j)
+        {
+            acc = (uint64_t) m * m_p[j] + t[j] + carry;
+            t[j - 1] = (uint32_t) acc;
+            carry = (uint32_t) (acc >> 32);
+        }
+        acc = (uint64_t) t[FE_WORDS] + carry;
+        t[FE_WORDS - 1] = (uint32_t) acc;
+        t[FE_WORDS] = t[FE_WORDS + 1] + (uint32_t) (acc >> 32);
+    }
+
+    fe_reduce_once(r, t, t[FE_WORDS]);
+}
+
+/** r = a^-1 by Fermat's little theorem. The exponent is public, so branching on it is fine. */
+static void fe_inv(fe_t r, const fe_t a)
+{
+    fe_t acc;
+    memcpy(acc, m_one, sizeof(acc));
+    for (int32_t bit = 255; bit >= 0; --bit)
+    {
+        fe_mul(acc, acc, acc);
+        if ((m_p_minus_2[bit / 32] >> (bit % 32)) & 1)
+        {
+            fe_mul(acc, acc, a);
+        }
+    }
+    memcpy(r, acc, sizeof(acc));
+}
+
+/**
+ * Complete projective addition for a = -3, algorithm 4 of Renes, Costello and Batina, "Complete
+ * addition formulas for prime order elliptic curves". Valid for all inputs, including P == Q and
+ * the point at infinity. p_r may alias either input.
+ */
+static void point_add(point_t * p_r, const point_t * p_p, const point_t * p_q)
+{
+    fe_t t0, t1, t2, t3, t4, x3, y3, z3;
+
+    fe_mul(t0, p_p->x, p_q->x);
+    fe_mul(t1, p_p->y, p_q->y);
+    fe_mul(t2, p_p->z, p_q->z);
+    fe_add(t3, p_p->x, p_p->y);
+    fe_add(t4, p_q->x, p_q->y);
+    fe_mul(t3, t3, t4);
+    fe_add(t4, t0, t1);
+    fe_sub(t3, t3, t4);
+    fe_add(t4, p_p->y, p_p->z);
+    fe_add(x3, p_q->y, p_q->z);
+    fe_mul(t4, t4, x3);
+    fe_add(x3, t1, t2);
+    fe_sub(t4, t4, x3);
+    fe_add(x3, p_p->x, p_p->z);
+    fe_add(y3, p_q->x, p_q->z);
+    fe_mul(x3, x3, y3);
+    fe_add(y3, t0, t2);
+    fe_sub(y3, x3, y3);
+    fe_mul(z3, m_b, t2);
+    fe_sub(x3, y3, z3);
+    fe_add(z3, x3, x3);
+    fe_add(x3, x3, z3);
+    fe_sub(z3, t1, x3);
+    fe_add(x3, t1, x3);
+    fe_mul(y3, m_b, y3);
+    fe_add(t1, t2, t2);
+    fe_add(t2, t1, t2);
+    fe_sub(y3, y3, t2);
+    fe_sub(y3, y3, t0);
+    fe_add(t1, y3, y3);
+    fe_add(y3, t1, y3);
+    fe_add(t1, t0, t0);
+    fe_add(t0, t1, t0);
+    fe_sub(t0, t0, t2);
+    fe_mul(t1, t4, y3);
+    fe_mul(t2, t0, y3);
+    fe_mul(y3, x3, z3);
+    fe_add(y3, y3, t2);
+    fe_mul(x3, t3, x3);
+    fe_sub(x3, x3, t1);
+    fe_mul(z3, t4, z3);
+    fe_mul(t1, t3, t0);
+    fe_add(z3, z3, t1);
+
+    memcpy(p_r->x, x3, sizeof(x3));
+    memcpy(p_r->y, y3, sizeof(y3));
+    memcpy(p_r->z, z3, sizeof(z3));
+}
+
+/** Reads table entry index, touching every entry. Entry 0 becomes the point at infinity. */
+static void table_select(point_t * p_point, uint32_t index)
+{
+    memset(p_point, 0, sizeof(*p_point));
+    for (uint32_t i = 0; i < P256_COMB_TABLE_SIZE; ++i)
+    {
+        /* All ones if i == index. */
+        uint32_t mask = ((i ^ index) - 1) >> 31;
+        mask = 0 - mask;
+        for (uint32_t w = 0; w < FE_WORDS; ++w)
+        {
+            p_point->x[w] |= p256_comb_table[i][0][w] & mask;
+            p_point->y[w] |= p256_comb_table[i][1][w] & mask;
+        }
+    }
+
+    /* All ones if index != 0. */
+    uint32_t nonzero = 0 - ((index | (0 - index)) >> 31);
+    for (uint32_t w = 0; w < FE_WORDS; ++w)
+    {
+        p_point->z[w] = m_one[w] & nonzero;
+    }
+}
+
+/** Reads a big-endian 256 bit value. */
+static void words_from_bytes(uint32_t * p_words, const uint8_t * p_bytes)
+{
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        const uint8_t * p_word = &p_bytes[(FE_WORDS - 1 - i) * 4];
+        p_words[i] = ((uint32_t) p_word[0] << 24) | ((uint32_t) p_word[1] << 16) |
+                     ((uint32_t) p_word[2] << 8) | p_word[3];
+    }
+}
+
+/** Writes a big-endian 256 bit value. */
+static void words_to_bytes(uint8_t * p_bytes, const uint32_t * p_words)
+{
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint8_t * p_word = &p_bytes[(FE_WORDS - 1 - i) * 4];
+        p_word[0] = (uint8_t) (p_words[i] >> 24);
+        p_word[1] = (uint8_t) (p_words[i] >> 16);
+        p_word[2] = (uint8_t) (p_words[i] >> 8);
+        p_word[3] = (uint8_t) p_words[i];
+    }
+}
+
+/** Checks 0 < k < n without branching on k. */
+static bool scalar_valid(const uint32_t * p_k)
+{
+    uint32_t borrow = 0;
+    uint32_t nonzero = 0;
+    for (uint32_t i = 0; i < FE_WORDS; ++i)
+    {
+        uint64_t diff = (uint64_t) p_k[i] - m_n[i] - borrow;
+        borrow = (uint32_t) (diff >> 32) & 1;
+        nonzero |= p_k[i];
+    }
+    return (borrow & (uint32_t) (nonzero != 0)) != 0;
+}
+
+bool p256_comb_public_key_compute(const uint8_t * p_private, uint8_t * p_public)
+{
+    uint32_t k[FE_WORDS];
+    words_from_bytes(k, p_private);
+    if (!scalar_valid(k))
+    {
+        return false;
+    }
+
+    point_t acc = {.y = {0}};
+    memcpy(acc.y, m_one, sizeof(acc.y));
+    point_t entry;
+
+    /* Column i holds bit i of each 64 bit slice of k. */
+    for (int32_t i = 63; i >= 0; --i)
+    {
+        uint32_t index = 0;
+        for (uint32_t tooth = 0; tooth < P256_COMB_TEETH; ++tooth)
+        {
+            uint32_t bit = (uint32_t) i + tooth * 64;
+            index |= ((k[bit / 32] >> (bit % 32)) & 1) << tooth;
+        }
+
+        point_add(&acc, &acc, &acc);
+        table_select(&entry, index);
+        point_add(&acc, &acc, &entry);
+    }
+
+    /* Back to affine coordinates and out of the Montgomery domain. Z is not zero since 0 < k < n. */
+    static const fe_t s_unity = {1};
+    fe_t z_inv, coordinate;
+    fe_inv(z_inv, acc.z);
+    fe_mul(coordinate, acc.x, z_inv);
+    fe_mul(coordinate, coordinate, s_unity);
+    words_to_bytes(&p_public[0], coordinate);
+    fe_mul(coordinate, acc.y, z_inv);
+    fe_mul(coordinate, coordinate, s_unity);
+    words_to_bytes(&p_public[P256_COMB_PRIVATE_KEY_SIZE], coordinate);
+
+    memset(k, 0, sizeof(k));
+    memset(&acc, 0, sizeof(acc));
+    memset(&entry, 0, sizeof(entry));
+    return true;
+}
+
+void p256_comb_key_pair_generate(uint8_t * p_public, uint8_t * p_private)
+{
+    do
+    {
+        rand_hw_rng_get(p_private, P256_COMB_PRIVATE_KEY_SIZE);
+    } while (!p256_comb_public_key_compute(p_private, p_public));
+}
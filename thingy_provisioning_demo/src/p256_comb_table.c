@@ -0,0 +1,81 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Fixed-base comb table of src/p256_comb.c. Generated by test/gen_p256_comb_table.py, do not
+ * edit. Entry i is the sum of 2^(64 j) G over the set bits j of i, in affine coordinates in the
+ * Montgomery domain (x 2^256 mod p), as little-endian 32-bit words. Entry 0 stands for the
+ * point at infinity. */
+
+#include "p256_comb.h"
+
+#include <stdint.h>
+
+const uint32_t p256_comb_table[P256_COMB_TABLE_SIZE][2][8] =
+{
+    {{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+     {0x00000001, 0x00000000, 0x00000000, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFE, 0x00000000}},
+    {{0x18A9143C, 0x79E730D4, 0x5FEDB601, 0x75BA95FC, 0x77622510, 0x79FB732B, 0xA53755C6, 0x18905F76},
+     {0xCE95560A, 0xDDF25357, 0xBA19E45C, 0x8B4AB8E4, 0xDD21F325, 0xD2E88688, 0x25885D85, 0x8571FF18}},
+    {{0x16A0D2BB, 0x4F922FC5, 0x1A623499, 0x0D5CC16C, 0x57C62C8B, 0x9241CF3A, 0xFD1B667F, 0x2F5E6961},
+     {0xF5A01797, 0x5C15C70B, 0x60956192, 0x3D20B44D, 0x071FDB52, 0x04911B37, 0x8D6F0F7B, 0xF648F916}},
+    {{0xE137BBBC, 0x9E566847, 0x8A6A0BEC, 0xE434469E, 0x79D73463, 0xB1C42761, 0x133D0015, 0x5ABE0285},
+     {0xC04C7DAB, 0x92AA837C, 0x43260C07, 0x573D9F4C, 0x78E6CC37, 0x0C931562, 0x6B6F7383, 0x94BB725B}},
+    {{0xBFE20925, 0x62A8C244, 0x8FDCE867, 0x91C19AC3, 0xDD387063, 0x5A96A5D5, 0x21D324F6, 0x61D587D4},
+     {0xA37173EA, 0xE87673A2, 0x53778B65, 0x23848008, 0x05BAB43E, 0x10F8441E, 0x4621EFBE, 0xFA11FE12}},
+    {{0x2CB19FFD, 0x1C891F2B, 0xB1923C23, 0x01BA8D5B, 0x8AC5CA8E, 0xB6D03D67, 0x1F13BEDC, 0x586EB04C},
+     {0x27E8ED09, 0x0C35C6E5, 0x1819EDE2, 0x1E81A33C, 0x56C652FA, 0x278FD6C0, 0x70864F11, 0x19D5AC08}},
+    {{0xD2B533D5, 0x62577734, 0xA1BDDDC0, 0x673B8AF6, 0xA79EC293, 0x577E7C9A, 0xC3B266B1, 0xBB6DE651},
+     {0xB65259B3, 0xE7E9303A, 0xD03A7480, 0xD6A0AFD3, 0x9B3CFC27, 0xC5AC83D1, 0x5D18B99B, 0x60B4619A}},
+    {{0x1AE5AA1C, 0xBD6A38E1, 0x49E73658, 0xB8B7652B, 0xEE5F87ED, 0x0B130014, 0xAEEBFFCD, 0x9D0F27B2},
+     {0x7A730A55, 0xCA924631, 0xDDBBC83A, 0x9C955B2F, 0xAC019A71, 0x07C1DFE0, 0x356EC48D, 0x244A566D}},
+    {{0xF4F8B16A, 0x56F8410E, 0xC47B266A, 0x97241AFE, 0x6D9C87C1, 0x0A406B8E, 0xCD42AB1B, 0x803F3E02},
+     {0x04DBEC69, 0x7F0309A8, 0x3BBAD05F, 0xA83B85F7, 0xAD8E197F, 0xC6097273, 0x5067ADC1, 0xC097440E}},
+    {{0xC379AB34, 0x846A56F2, 0x841DF8D1, 0xA8EE068B, 0x176C68EF, 0x20314459, 0x915F1F30, 0xF1AF32D5},
+     {0x5D75BD50, 0x99C37531, 0xF72F67BC, 0x837CFFBA, 0x48D7723F, 0x0613A418, 0xE2D41C8B, 0x23D0F130}},
+    {{0xD5BE5A2B, 0xED93E225, 0x5934F3C6, 0x6FE79983, 0x22626FFC, 0x43140926, 0x7990216A, 0x50BBB4D9},
+     {0xE57EC63E, 0x378191C6, 0x181DCDB2, 0x65422C40, 0x0236E0F6, 0x41A8099B, 0x01FE49C3, 0x2B100118}},
+    {{0x9B391593, 0xFC68B5C5, 0x598270FC, 0xC385F5A2, 0xD19ADCBB, 0x7144F3AA, 0x83FBAE0C, 0xDD558999},
+     {0x74B82FF4, 0x93B88B8E, 0x71E734C9, 0xD2E03C40, 0x43C0322A, 0x9A7A9EAF, 0x149D6041, 0xE6E4C551}},
+    {{0x80EC21FE, 0x5FE14BFE, 0xC255BE82, 0xF6CE116A, 0x2F4A5D67, 0x98BC5A07, 0xDB7E63AF, 0xFAD27148},
+     {0x29AB05B3, 0x90C0B6AC, 0x4E251AE6, 0x37A9A83C, 0xC2AADE7D, 0x0A7DC875, 0x9F0E1A84, 0x77387DE3}},
+    {{0xA56C0DD7, 0x1E9ECC49, 0x46086C74, 0xA5CFFCD8, 0xF505AECE, 0x8F7A1408, 0xBEF0C47E, 0xB37B85C0},
+     {0xCC0E6A8F, 0x3596B6E4, 0x6B388F23, 0xFD6D4BBF, 0xC39CEF4E, 0xABA453FA, 0xF9F628D5, 0x9C135AC8}},
+    {{0x95C8F8BE, 0x0A1C7294, 0x3BF362BF, 0x2961C480, 0xDF63D4AC, 0x9E418403, 0x91ECE900, 0xC109F9CB},
+     {0x58945705, 0xC2D095D0, 0xDDEB85C0, 0xB9083D96, 0x7A40449B, 0x84692B8D, 0x2EEE1EE1, 0x9BC3344F}},
+    {{0x42913074, 0x0D5AE356, 0x48A542B1, 0x55491B27, 0xB310732A, 0x469CA665, 0x5F1A4CC1, 0x29591D52},
+     {0xB84F983F, 0xE76F5B6B, 0x9F5F84E1, 0xBE7EEF41, 0x80BAA189, 0x1200D496, 0x18EF332C, 0x6376551F}},
+};
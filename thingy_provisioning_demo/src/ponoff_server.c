@@ -0,0 +1,172 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ponoff_server.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "access.h"
+#include "access_config.h"
+#include "nrf_mesh.h"
+#include "light_state.h"
+#include "log.h"
+
+static access_model_handle_t m_server_handle = ACCESS_HANDLE_INVALID;
+static access_model_handle_t m_setup_server_handle = ACCESS_HANDLE_INVALID;
+
+static void status_message_make(access_message_tx_t * p_message, uint8_t * p_on_power_up)
+{
+    *p_on_power_up = (uint8_t) light_state_on_power_up_get();
+
+    p_message->opcode.opcode = PONOFF_OPCODE_STATUS;
+    p_message->opcode.company_id = ACCESS_COMPANY_ID_NONE;
+    p_message->p_buffer = p_on_power_up;
+    p_message->length = sizeof(*p_on_power_up);
+    p_message->force_segmented = false;
+    p_message->transmic_size = NRF_MESH_TRANSMIC_SIZE_SMALL;
+    p_message->access_token = nrf_mesh_unique_token_get();
+}
+
+static void status_reply(access_model_handle_t handle, const access_message_rx_t * p_message)
+{
+    uint8_t on_power_up;
+    access_message_tx_t reply;
+    status_message_make(&reply, &on_power_up);
+
+    uint32_t status = access_model_reply(handle, p_message, &reply);
+    if (status != NRF_SUCCESS)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_WARN, "OnPowerUp reply failed: %d\n", status);
+    }
+}
+
+static void status_publish(void)
+{
+    uint8_t on_power_up;
+    access_message_tx_t message;
+    status_message_make(&message, &on_power_up);
+
+    /* Fails without a publication address, which is fine. */
+    (void) access_model_publish(m_server_handle, &message);
+}
+
+static void handle_get(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    if (p_message->length == 0)
+    {
+        status_reply(handle, p_message);
+    }
+}
+
+static void set_handle(access_model_handle_t handle, const access_message_rx_t * p_message, bool reliable)
+{
+    if (p_message->length != 1 || p_message->p_data[0] >= LIGHT_STATE_ON_POWER_UP_COUNT)
+    {
+        return;
+    }
+
+    light_state_on_power_up_t previous = light_state_on_power_up_get();
+    (void) light_state_on_power_up_set((light_state_on_power_up_t) p_message->p_data[0]);
+
+    if (reliable)
+    {
+        status_reply(handle, p_message);
+    }
+    if (light_state_on_power_up_get() != previous)
+    {
+        status_publish();
+    }
+}
+
+static void handle_set(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    set_handle(handle, p_message, true);
+}
+
+static void handle_set_unacknowledged(access_model_handle_t handle, const access_message_rx_t * p_message, void * p_args)
+{
+    set_handle(handle, p_message, false);
+}
+
+static const access_opcode_handler_t m_server_opcode_handlers[] =
+{
+    {ACCESS_OPCODE_SIG(PONOFF_OPCODE_GET), handle_get},
+};
+
+static const access_opcode_handler_t m_setup_server_opcode_handlers[] =
+{
+    {ACCESS_OPCODE_SIG(PONOFF_OPCODE_SET), handle_set},
+    {ACCESS_OPCODE_SIG(PONOFF_OPCODE_SET_UNACKNOWLEDGED), handle_set_unacknowledged},
+};
+
+uint32_t ponoff_server_init(uint16_t element_index)
+{
+    if (m_server_handle != ACCESS_HANDLE_INVALID)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    access_model_add_params_t add_params =
+    {
+        .model_id = ACCESS_MODEL_SIG(PONOFF_SERVER_MODEL_ID),
+        .element_index = element_index,
+        .p_opcode_handlers = &m_server_opcode_handlers[0],
+        .opcode_count = sizeof(m_server_opcode_handlers) / sizeof(m_server_opcode_handlers[0]),
+        .p_args = NULL,
+        .publish_timeout_cb = NULL
+    };
+    uint32_t status = access_model_add(&add_params, &m_server_handle);
+    if (status == NRF_SUCCESS)
+    {
+        status = access_model_subscription_list_alloc(m_server_handle);
+    }
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    add_params.model_id = ACCESS_MODEL_SIG(PONOFF_SETUP_SERVER_MODEL_ID);
+    add_params.p_opcode_handlers = &m_setup_server_opcode_handlers[0];
+    add_params.opcode_count = sizeof(m_setup_server_opcode_handlers) / sizeof(m_setup_server_opcode_handlers[0]);
+    status = access_model_add(&add_params, &m_setup_server_handle);
+    if (status == NRF_SUCCESS)
+    {
+        status = access_model_subscription_lists_share(m_server_handle, m_setup_server_handle);
+    }
+    return status;
+}
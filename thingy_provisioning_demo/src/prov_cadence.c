@@ -0,0 +1,159 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "prov_cadence.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_error.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "rand.h"
+#include "diag_model.h"
+#include "log.h"
+
+TIMER_SERVICE_DEF(m_step_timer);
+static prov_cadence_listen_cb_t m_listen_cb;
+static bool m_active;
+static bool m_listening;
+/* Gap after the current listening period, 0 in the fast phase. */
+static uint32_t m_gap_ms;
+static timestamp_t m_listen_start;
+
+static void listen_set(bool listen)
+{
+    if (listen == m_listening)
+    {
+        return;
+    }
+
+    m_listening = listen;
+    if (listen)
+    {
+        m_listen_start = timer_now();
+        diag_counter_add(DIAG_COUNTER_PROV_LISTEN_WINDOWS, 1);
+    }
+    else
+    {
+        diag_counter_add(DIAG_COUNTER_PROV_LISTEN_MS, (timer_now() - m_listen_start) / 1000);
+    }
+    m_listen_cb(listen);
+}
+
+static void fast_phase_start(void)
+{
+    m_gap_ms = 0;
+    diag_counter_set(DIAG_COUNTER_PROV_CADENCE_GAP_MS, 0);
+    listen_set(true);
+    APP_ERROR_CHECK(timer_service_start(&m_step_timer, PROV_CADENCE_FAST_MS, NULL));
+}
+
+static void step_timeout_handler(void * p_context)
+{
+    if (!m_active)
+    {
+        return;
+    }
+
+    if (m_listening)
+    {
+        m_gap_ms = (m_gap_ms == 0) ? PROV_CADENCE_GAP_MIN_MS : m_gap_ms * 2;
+        if (m_gap_ms > PROV_CADENCE_GAP_MAX_MS)
+        {
+            m_gap_ms = PROV_CADENCE_GAP_MAX_MS;
+        }
+        diag_counter_set(DIAG_COUNTER_PROV_CADENCE_GAP_MS, m_gap_ms);
+
+        uint16_t jitter;
+        rand_hw_rng_get((uint8_t *) &jitter, sizeof(jitter));
+        listen_set(false);
+        APP_ERROR_CHECK(timer_service_start(&m_step_timer,
+                                            m_gap_ms + jitter % (m_gap_ms / 4 + 1),
+                                            NULL));
+    }
+    else
+    {
+        listen_set(true);
+        APP_ERROR_CHECK(timer_service_start(&m_step_timer, PROV_CADENCE_WINDOW_MS, NULL));
+    }
+}
+
+void prov_cadence_init(prov_cadence_listen_cb_t listen_cb)
+{
+    m_listen_cb = listen_cb;
+    APP_ERROR_CHECK(timer_service_create(&m_step_timer, APP_TIMER_MODE_SINGLE_SHOT, step_timeout_handler));
+}
+
+void prov_cadence_start(void)
+{
+    m_active = true;
+    /* Listening was started by the caller. */
+    m_listening = true;
+    m_listen_start = timer_now();
+    diag_counter_add(DIAG_COUNTER_PROV_LISTEN_WINDOWS, 1);
+    fast_phase_start();
+}
+
+void prov_cadence_boost(void)
+{
+    if (!m_active)
+    {
+        return;
+    }
+
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Provisioning advertising boosted\n");
+    diag_counter_add(DIAG_COUNTER_PROV_CADENCE_BOOSTS, 1);
+    fast_phase_start();
+}
+
+void prov_cadence_stop(void)
+{
+    if (!m_active)
+    {
+        return;
+    }
+
+    m_active = false;
+    timer_service_stop(&m_step_timer);
+    if (m_listening)
+    {
+        m_listening = false;
+        diag_counter_add(DIAG_COUNTER_PROV_LISTEN_MS, (timer_now() - m_listen_start) / 1000);
+    }
+}
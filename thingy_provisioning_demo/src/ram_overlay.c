@@ -0,0 +1,93 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ram_overlay.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "log.h"
+#include "nrf_mesh_assert.h"
+
+/* Provided by the linker script / flash placement file. */
+extern uint8_t __start_ram_overlay[];
+extern uint8_t __stop_ram_overlay[];
+
+static bool m_released;
+static uint32_t m_offset;
+
+void ram_overlay_init(void)
+{
+    memset(__start_ram_overlay, 0, __stop_ram_overlay - __start_ram_overlay);
+    m_released = false;
+    m_offset = 0;
+}
+
+void ram_overlay_release(void)
+{
+    NRF_MESH_ASSERT(!m_released);
+    m_released = true;
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "RAM overlay: %u bytes reclaimed from provisioning\n",
+          (unsigned) (__stop_ram_overlay - __start_ram_overlay));
+}
+
+bool ram_overlay_is_released(void)
+{
+    return m_released;
+}
+
+uint32_t ram_overlay_free_get(void)
+{
+    if (!m_released)
+    {
+        return 0;
+    }
+    return ((__stop_ram_overlay - __start_ram_overlay) - m_offset) & ~3u;
+}
+
+void * ram_overlay_alloc(uint32_t size)
+{
+    size = (size + 3) & ~3u;
+    if (size == 0 || size > ram_overlay_free_get())
+    {
+        return NULL;
+    }
+
+    void * p_block = &__start_ram_overlay[m_offset];
+    m_offset += size;
+    return p_block;
+}
@@ -0,0 +1,181 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "relay_policy.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "app_error.h"
+#include "core_tx.h"
+#include "mesh_opt_core.h"
+#include "msg_cache_stats.h"
+#include "rand.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "diag_model.h"
+#include "log.h"
+
+TIMER_SERVICE_DEF(m_window_timer);
+
+static bool m_enabled = RELAY_POLICY_ENABLED_DEFAULT;
+static bool m_suppressing;
+static bool m_changed_before;
+static timestamp_t m_last_change;
+static msg_cache_stats_t m_cache_stats;
+static relay_policy_stats_t m_stats;
+
+static void window_start(void)
+{
+    uint16_t jitter;
+    rand_hw_rng_get((uint8_t *) &jitter, sizeof(jitter));
+    APP_ERROR_CHECK(timer_service_start(&m_window_timer,
+                                        RELAY_POLICY_WINDOW_MS + jitter % RELAY_POLICY_JITTER_MS,
+                                        NULL));
+}
+
+static bool relay_enabled_get(void)
+{
+    mesh_opt_core_adv_t opt;
+    return (mesh_opt_core_adv_get(CORE_TX_ROLE_RELAY, &opt) == NRF_SUCCESS && opt.enabled);
+}
+
+static void suppress_set(bool suppress)
+{
+    m_suppressing = suppress;
+    m_changed_before = true;
+    m_last_change = timer_now();
+    m_stats.state_changes++;
+    __LOG(LOG_SRC_APP, LOG_LEVEL_INFO, "Relay policy: relaying %s\n", suppress ? "suppressed" : "resumed");
+}
+
+/* Decides whether to suppress relaying in the next window, given the average number of copies
+ * heard per PDU (times 16). */
+static bool suppress_decide(uint32_t copies_x16)
+{
+    if (copies_x16 < RELAY_POLICY_COPY_THRESHOLD * 16)
+    {
+        return false;
+    }
+
+    /* Suppress with probability 1 - threshold / copies, scaled to 0..255. */
+    uint32_t keep = (RELAY_POLICY_COPY_THRESHOLD * 16 * 256) / copies_x16;
+    uint8_t random;
+    rand_hw_rng_get(&random, sizeof(random));
+    return (random >= keep);
+}
+
+static void window_timeout_handler(void * p_context)
+{
+    msg_cache_stats_t cache_stats;
+    msg_cache_stats_get(&cache_stats);
+    uint32_t lookups = cache_stats.lookups - m_cache_stats.lookups;
+    uint32_t copies = cache_stats.hits - m_cache_stats.hits;
+    uint32_t fresh = lookups - copies;
+    m_cache_stats = cache_stats;
+
+    /* Relaying disabled by configuration is left alone. */
+    if (m_suppressing && !relay_enabled_get())
+    {
+        m_suppressing = false;
+    }
+    if (m_enabled && relay_enabled_get() && fresh >= RELAY_POLICY_MIN_PDUS)
+    {
+        bool suppress = suppress_decide((lookups * 16) / fresh);
+        if (suppress != m_suppressing &&
+            (!m_changed_before || (timer_now() - m_last_change) >= RELAY_POLICY_HOLD_MS * 1000))
+        {
+            suppress_set(suppress);
+        }
+    }
+
+    window_start();
+}
+
+void relay_policy_init(void)
+{
+    APP_ERROR_CHECK(timer_service_create(&m_window_timer, APP_TIMER_MODE_SINGLE_SHOT, window_timeout_handler));
+    msg_cache_stats_get(&m_cache_stats);
+    window_start();
+}
+
+void relay_policy_enable(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled && m_suppressing)
+    {
+        suppress_set(false);
+    }
+}
+
+bool relay_policy_is_enabled(void)
+{
+    return m_enabled;
+}
+
+bool relay_policy_relay_allowed(void)
+{
+    return !m_suppressing;
+}
+
+void relay_policy_relay_count(bool forwarded)
+{
+    if (forwarded)
+    {
+        m_stats.forwarded++;
+        diag_counter_add(DIAG_COUNTER_RELAY_FORWARDED, 1);
+    }
+    else
+    {
+        m_stats.suppressed++;
+        diag_counter_add(DIAG_COUNTER_RELAY_SUPPRESSED, 1);
+    }
+}
+
+void relay_policy_stats_get(relay_policy_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+void relay_policy_config_server_evt(const config_server_evt_t * p_evt)
+{
+    if (p_evt->type == CONFIG_SERVER_EVT_RELAY_SET)
+    {
+        /* The configured state now applies, start over from it. */
+        m_suppressing = false;
+    }
+}
@@ -0,0 +1,291 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "scan_filter.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ad_type_filter.h"
+#include "rssi_filter.h"
+#include "gap_address_filter.h"
+#include "ad_listener.h"
+#include "packet.h"
+#include "app_error.h"
+#include "nrf_error.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "diag_model.h"
+#include "log.h"
+
+typedef struct
+{
+    ble_gap_addr_t addr;
+    /* Average RSSI in 1/16 dBm. */
+    int16_t rssi_x16;
+    timestamp_t last_seen;
+} neighbor_t;
+
+TIMER_SERVICE_DEF(m_adapt_timer);
+
+static ble_gap_addr_t m_deny_list[SCAN_FILTER_DENY_LIST_SIZE];
+static uint32_t m_deny_count;
+static bool m_adaptive;
+static int8_t m_rssi_floor = SCAN_FILTER_RSSI_FLOOR_MIN;
+static uint32_t m_accepted;
+static uint32_t m_heard_last;
+static neighbor_t m_neighbors[SCAN_FILTER_NEIGHBORS_MAX];
+static uint32_t m_neighbor_count;
+
+static void neighbor_update(const ble_gap_addr_t * p_addr, int8_t rssi)
+{
+    neighbor_t * p_neighbor = NULL;
+    neighbor_t * p_oldest = NULL;
+    for (uint32_t i = 0; i < m_neighbor_count; ++i)
+    {
+        if (m_neighbors[i].addr.addr_type == p_addr->addr_type &&
+            memcmp(m_neighbors[i].addr.addr, p_addr->addr, BLE_GAP_ADDR_LEN) == 0)
+        {
+            p_neighbor = &m_neighbors[i];
+            break;
+        }
+        if (p_oldest == NULL || (int32_t) (m_neighbors[i].last_seen - p_oldest->last_seen) < 0)
+        {
+            p_oldest = &m_neighbors[i];
+        }
+    }
+
+    if (p_neighbor != NULL)
+    {
+        p_neighbor->rssi_x16 += (rssi * 16 - p_neighbor->rssi_x16) / 8;
+    }
+    else
+    {
+        /* A full table replaces the neighbor heard least recently. */
+        p_neighbor = (m_neighbor_count < SCAN_FILTER_NEIGHBORS_MAX) ? &m_neighbors[m_neighbor_count++] : p_oldest;
+        p_neighbor->addr = *p_addr;
+        p_neighbor->rssi_x16 = rssi * 16;
+    }
+    p_neighbor->last_seen = timer_now();
+}
+
+/* Drops the neighbors that went silent and returns the RSSI of the weakest remaining one. Neighbors
+ * that are strong enough not to limit the floor are not told apart. Sets *p_lost if a neighbor was
+ * dropped. */
+static int8_t neighbors_age(bool * p_lost)
+{
+    timestamp_t now = timer_now();
+    int16_t rssi_min_x16 = (SCAN_FILTER_RSSI_FLOOR_MAX + SCAN_FILTER_NEIGHBOR_MARGIN_DB) * 16;
+
+    *p_lost = false;
+    for (uint32_t i = 0; i < m_neighbor_count;)
+    {
+        if ((now - m_neighbors[i].last_seen) / 1000 > SCAN_FILTER_NEIGHBOR_TIMEOUT_MS)
+        {
+            m_neighbors[i] = m_neighbors[--m_neighbor_count];
+            *p_lost = true;
+            continue;
+        }
+        if (m_neighbors[i].rssi_x16 < rssi_min_x16)
+        {
+            rssi_min_x16 = m_neighbors[i].rssi_x16;
+        }
+        ++i;
+    }
+    return (int8_t) (rssi_min_x16 / 16);
+}
+
+static void mesh_packet_handler(const uint8_t * p_packet, uint32_t ad_packet_length, const nrf_mesh_rx_metadata_t * p_metadata)
+{
+    m_accepted++;
+    if (p_metadata->source == NRF_MESH_RX_SOURCE_SCANNER)
+    {
+        neighbor_update(&p_metadata->params.scanner.adv_addr, p_metadata->params.scanner.rssi);
+    }
+}
+
+/* Counts mesh packets that made it through the filters and tracks the neighbors sending them. */
+static ad_listener_t m_mesh_listener =
+{
+    .ad_type = AD_TYPE_MESH,
+    .adv_packet_type = ADL_WILDCARD_ADV_TYPE,
+    .handler = mesh_packet_handler,
+};
+
+static void rssi_floor_apply(int8_t rssi_floor)
+{
+    m_rssi_floor = rssi_floor;
+    if (rssi_floor > SCAN_FILTER_RSSI_FLOOR_MIN)
+    {
+        bearer_filter_rssi_set(rssi_floor);
+        bearer_rssi_filtering_set(true);
+    }
+    else
+    {
+        bearer_rssi_filtering_set(false);
+    }
+    diag_counter_set(DIAG_COUNTER_SCAN_RSSI_FLOOR_NEG_DBM, (uint32_t) -rssi_floor);
+}
+
+static void adapt_timeout_handler(void * p_context)
+{
+    /* Packets dropped by the RSSI filter were heard as well, the rate is measured in front of it. */
+    uint32_t heard = m_accepted + bearer_rssi_filtered_amount_get();
+    uint32_t rate = (heard - m_heard_last) * 1000 / SCAN_FILTER_ADAPT_INTERVAL_MS;
+    m_heard_last = heard;
+
+    bool neighbor_lost;
+    int8_t neighbor_rssi_min = neighbors_age(&neighbor_lost);
+
+    diag_counter_set(DIAG_COUNTER_SCAN_DROPPED_ADTYPE, bearer_adtype_filtered_amount_get());
+    diag_counter_set(DIAG_COUNTER_SCAN_DROPPED_RSSI, bearer_rssi_filtered_amount_get());
+    diag_counter_set(DIAG_COUNTER_SCAN_DROPPED_ADDRESS, bearer_gap_addr_filtered_amount_get());
+
+    if (!m_adaptive)
+    {
+        return;
+    }
+
+    /* Never filter out the weakest neighbor still sending to this node. */
+    int8_t rssi_floor_max = neighbor_rssi_min - SCAN_FILTER_NEIGHBOR_MARGIN_DB;
+    if (rssi_floor_max > SCAN_FILTER_RSSI_FLOOR_MAX)
+    {
+        rssi_floor_max = SCAN_FILTER_RSSI_FLOOR_MAX;
+    }
+
+    int8_t rssi_floor = m_rssi_floor;
+    if (rate > SCAN_FILTER_RATE_HIGH && !neighbor_lost)
+    {
+        rssi_floor += SCAN_FILTER_RSSI_STEP_DB;
+    }
+    else if (rate < SCAN_FILTER_RATE_LOW || neighbor_lost)
+    {
+        rssi_floor -= SCAN_FILTER_RSSI_STEP_DB;
+    }
+    if (rssi_floor > rssi_floor_max)
+    {
+        rssi_floor = rssi_floor_max;
+    }
+    if (rssi_floor < SCAN_FILTER_RSSI_FLOOR_MIN)
+    {
+        rssi_floor = SCAN_FILTER_RSSI_FLOOR_MIN;
+    }
+
+    if (rssi_floor != m_rssi_floor)
+    {
+        __LOG(LOG_SRC_APP, LOG_LEVEL_DBG1, "Mesh packet rate %u/s, weakest neighbor %d dBm, RSSI floor %d dBm\n",
+              rate, neighbor_rssi_min, rssi_floor);
+        rssi_floor_apply(rssi_floor);
+    }
+}
+
+void scan_filter_init(void)
+{
+    bearer_adtype_clear();
+    bearer_adtype_add(AD_TYPE_MESH);
+    bearer_adtype_add(AD_TYPE_BEACON);
+    bearer_adtype_add(AD_TYPE_PB_ADV);
+    bearer_adtype_filtering_set(true);
+
+    APP_ERROR_CHECK(ad_listener_subscribe(&m_mesh_listener));
+    APP_ERROR_CHECK(timer_service_create(&m_adapt_timer, APP_TIMER_MODE_REPEATED, adapt_timeout_handler));
+    APP_ERROR_CHECK(timer_service_start(&m_adapt_timer, SCAN_FILTER_ADAPT_INTERVAL_MS, NULL));
+
+    m_adaptive = true;
+    rssi_floor_apply(SCAN_FILTER_RSSI_FLOOR_MIN);
+}
+
+void scan_filter_pb_adv_set(bool allowed)
+{
+    if (allowed)
+    {
+        bearer_adtype_add(AD_TYPE_PB_ADV);
+    }
+    else
+    {
+        bearer_adtype_remove(AD_TYPE_PB_ADV);
+    }
+}
+
+void scan_filter_rssi_adaptive_set(bool enabled)
+{
+    m_adaptive = enabled;
+}
+
+void scan_filter_rssi_floor_set(int8_t rssi_floor)
+{
+    m_adaptive = false;
+    rssi_floor_apply(rssi_floor);
+}
+
+uint32_t scan_filter_deny_add(const ble_gap_addr_t * p_addr)
+{
+    if (m_deny_count == SCAN_FILTER_DENY_LIST_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_deny_list[m_deny_count++] = *p_addr;
+    bearer_filter_gap_addr_blacklist_set(m_deny_list, m_deny_count);
+    return NRF_SUCCESS;
+}
+
+void scan_filter_deny_clear(void)
+{
+    m_deny_count = 0;
+    bearer_filter_gap_addr_clear();
+}
+
+void scan_filter_stats_get(scan_filter_stats_t * p_stats)
+{
+    p_stats->adtype_dropped = bearer_adtype_filtered_amount_get();
+    p_stats->rssi_dropped = bearer_rssi_filtered_amount_get();
+    p_stats->address_dropped = bearer_gap_addr_filtered_amount_get();
+    p_stats->accepted = m_accepted;
+    p_stats->neighbor_count = (uint8_t) m_neighbor_count;
+    p_stats->neighbor_rssi_min = 0;
+    for (uint32_t i = 0; i < m_neighbor_count; ++i)
+    {
+        int8_t rssi = (int8_t) (m_neighbors[i].rssi_x16 / 16);
+        if (i == 0 || rssi < p_stats->neighbor_rssi_min)
+        {
+            p_stats->neighbor_rssi_min = rssi;
+        }
+    }
+    p_stats->rssi_floor = m_rssi_floor;
+}
@@ -54,6 +54,9 @@
 #include "drv_ext_light.h"
 #include "drv_ext_gpio.h"
 #include "m_ui.h"
+#include "nrf_drv_twi.h"
+#include "diag_model.h"
+#include "timer_service.h"
 /*****************************************************************************
  * Definitions
  *****************************************************************************/
@@ -71,7 +74,7 @@
  *****************************************************************************/
 
 
-APP_TIMER_DEF(m_blink_timer);
+TIMER_SERVICE_DEF(m_blink_timer);
 static uint32_t m_blink_count;
 static uint32_t m_blink_mask;
 static uint32_t m_prev_state;
@@ -81,27 +84,41 @@ static led_state=0;
  * Public API
  *****************************************************************************/
 
+static void light_set(bool value)
+{
+    if (value)
+    {
+        APP_ERROR_CHECK(drv_ext_light_on(1));
+    }
+    else
+    {
+        APP_ERROR_CHECK(drv_ext_light_off(1));
+    }
+}
 
 static void led_timeout_handler(void * p_context)
 {
     APP_ERROR_CHECK_BOOL(m_blink_count > 0);
         if (led_state)
         {
-            APP_ERROR_CHECK(drv_ext_light_off(1));
+            light_set(false);
             led_state=0;
         }
         else
         {
-            APP_ERROR_CHECK(drv_ext_light_on(1));
+            light_set(true);
             led_state=1;
         }
 
 
     m_blink_count--;
+    diag_counter_set(DIAG_COUNTER_LED_QUEUE_DEPTH, m_blink_count);
     if (m_blink_count == 0)
     {
-        (void) app_timer_stop(m_blink_timer);
-         APP_ERROR_CHECK(drv_ext_light_off(1));
+        timer_service_stop(&m_blink_timer);
+        /* Return to the state last set with hal_led_pin_set(), e.g. the one restored at boot. */
+        light_set(m_prev_state);
+        led_state = m_prev_state;
     }
 }
 
@@ -115,17 +132,21 @@ void hal_led_blink_ms( uint32_t delay_ms, uint32_t blink_count)
 
 
     m_blink_count = blink_count * 2 - 1;
-    if (app_timer_start(m_blink_timer, APP_TIMER_TICKS(delay_ms), NULL) == NRF_SUCCESS)
+    if (timer_service_start(&m_blink_timer, delay_ms, NULL) == NRF_SUCCESS)
     {
-          APP_ERROR_CHECK(drv_ext_light_on(1));
+          diag_counter_set(DIAG_COUNTER_LED_QUEUE_DEPTH, m_blink_count);
+          light_set(true);
           led_state=1;
     }
 }
 
 void hal_led_blink_stop(void)
 {
-    (void) app_timer_stop(m_blink_timer);
-    APP_ERROR_CHECK(drv_ext_light_off(1));
+    timer_service_stop(&m_blink_timer);
+    diag_counter_set(DIAG_COUNTER_LED_QUEUE_DEPTH, 0);
+    light_set(false);
+    led_state = 0;
+    m_prev_state = 0;
 }
 bool hal_led_pin_get(void)
 {
@@ -140,19 +161,14 @@ void hal_leds_init(void)
         NRF_GPIO->OUTSET = 1UL << i;
     }*/
 
-    APP_ERROR_CHECK(app_timer_create(&m_blink_timer, APP_TIMER_MODE_REPEATED, led_timeout_handler));
+    APP_ERROR_CHECK(timer_service_create(&m_blink_timer, APP_TIMER_MODE_REPEATED, led_timeout_handler));
 }
 
 void hal_led_pin_set(bool value)
 {
-    if (value)
-    {
-        APP_ERROR_CHECK(drv_ext_light_on(1));
-    }
-    else
-    {
-        APP_ERROR_CHECK(drv_ext_light_off(1));
-    }
+    light_set(value);
+    led_state = value;
+    m_prev_state = value;
 }
 void led_breath_red(void)
 {
@@ -167,3 +183,29 @@ void led_breath_red(void)
     APP_ERROR_CHECK(drv_ext_light_rgb_sequence(1, &seq));
         
 }
+
+/*****************************************************************************
+ * TWI driver wrappers
+ *****************************************************************************/
+
+/* The Thingy drivers reach the SX1509 through the TWI driver only. These wrappers are linked in
+ * with --wrap=nrf_drv_twi_tx and --wrap=nrf_drv_twi_rx (see the project linker options), so every
+ * transfer is counted, including the register reads and writes done inside the light driver. */
+ret_code_t __real_nrf_drv_twi_tx(nrf_drv_twi_t const * p_instance, uint8_t address,
+                                 uint8_t const * p_data, uint8_t length, bool no_stop);
+ret_code_t __real_nrf_drv_twi_rx(nrf_drv_twi_t const * p_instance, uint8_t address,
+                                 uint8_t * p_data, uint8_t length);
+
+ret_code_t __wrap_nrf_drv_twi_tx(nrf_drv_twi_t const * p_instance, uint8_t address,
+                                 uint8_t const * p_data, uint8_t length, bool no_stop)
+{
+    diag_counter_add(DIAG_COUNTER_TWI_TRANSACTIONS, 1);
+    return __real_nrf_drv_twi_tx(p_instance, address, p_data, length, no_stop);
+}
+
+ret_code_t __wrap_nrf_drv_twi_rx(nrf_drv_twi_t const * p_instance, uint8_t address,
+                                 uint8_t * p_data, uint8_t length)
+{
+    diag_counter_add(DIAG_COUNTER_TWI_TRANSACTIONS, 1);
+    return __real_nrf_drv_twi_rx(p_instance, address, p_data, length);
+}
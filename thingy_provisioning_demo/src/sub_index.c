@@ -0,0 +1,152 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sub_index.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "access.h"
+#include "access_config.h"
+#include "device_state_manager.h"
+#include "nrf_mesh_defines.h"
+#include "nrf_mesh_assert.h"
+
+NRF_MESH_STATIC_ASSERT(ACCESS_MODEL_COUNT <= sizeof(sub_index_model_mask_t) * 8);
+
+static sub_index_entry_t m_entries[SUB_INDEX_ENTRIES_MAX];
+static uint32_t m_count;
+
+/* Returns the position of the address if present, or the position where it would be inserted. */
+static uint32_t position_find(uint16_t address, bool * p_found)
+{
+    uint32_t low = 0;
+    uint32_t high = m_count;
+    while (low < high)
+    {
+        uint32_t mid = (low + high) / 2;
+        if (m_entries[mid].address < address)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    *p_found = (low < m_count && m_entries[low].address == address);
+    return low;
+}
+
+static void model_add(access_model_handle_t model_handle, uint16_t address)
+{
+    bool found;
+    uint32_t pos = position_find(address, &found);
+    if (!found)
+    {
+        /* Every entry holds a distinct DSM address, so the pool bounds the index. */
+        NRF_MESH_ASSERT(m_count < SUB_INDEX_ENTRIES_MAX);
+        memmove(&m_entries[pos + 1], &m_entries[pos], (m_count - pos) * sizeof(m_entries[0]));
+        m_entries[pos].address = address;
+        m_entries[pos].models = 0;
+        m_count++;
+    }
+    m_entries[pos].models |= (sub_index_model_mask_t) (1u << model_handle);
+}
+
+void sub_index_rebuild(void)
+{
+    m_count = 0;
+    for (access_model_handle_t model_handle = 0; model_handle < ACCESS_MODEL_COUNT; ++model_handle)
+    {
+        dsm_handle_t address_handles[SUB_INDEX_ENTRIES_MAX];
+        uint16_t count = SUB_INDEX_ENTRIES_MAX;
+        if (access_model_subscriptions_get(model_handle, address_handles, &count) != NRF_SUCCESS)
+        {
+            continue;
+        }
+
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            nrf_mesh_address_t address;
+            if (dsm_address_get(address_handles[i], &address) == NRF_SUCCESS)
+            {
+                model_add(model_handle, address.value);
+            }
+        }
+    }
+}
+
+void sub_index_config_server_evt(const config_server_evt_t * p_evt)
+{
+    switch (p_evt->type)
+    {
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_ADD:
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE:
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE_ALL:
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_OVERWRITE:
+            sub_index_rebuild();
+            break;
+
+        case CONFIG_SERVER_EVT_NODE_RESET:
+            m_count = 0;
+            break;
+
+        default:
+            break;
+    }
+}
+
+sub_index_model_mask_t sub_index_lookup(uint16_t address)
+{
+    bool found;
+    uint32_t pos = position_find(address, &found);
+    return found ? m_entries[pos].models : 0;
+}
+
+bool sub_index_is_subscribed(access_model_handle_t model_handle, uint16_t address)
+{
+    return (model_handle < ACCESS_MODEL_COUNT &&
+            (sub_index_lookup(address) & (1u << model_handle)) != 0);
+}
+
+uint32_t sub_index_count_get(void)
+{
+    return m_count;
+}
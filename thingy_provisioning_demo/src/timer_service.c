@@ -0,0 +1,149 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "timer_service.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_timer.h"
+#include "nrf_error.h"
+#include "timer.h"
+#include "diag_model.h"
+#include "log.h"
+
+static timer_service_stats_t m_stats;
+
+static void active_set(timer_service_t * p_timer, bool active)
+{
+    if (p_timer->active == active)
+    {
+        return;
+    }
+
+    p_timer->active = active;
+    if (active)
+    {
+        m_stats.active++;
+        if (m_stats.active > m_stats.active_hwm)
+        {
+            m_stats.active_hwm = m_stats.active;
+            diag_counter_set(DIAG_COUNTER_TIMER_ACTIVE_HWM, m_stats.active_hwm);
+        }
+    }
+    else
+    {
+        m_stats.active--;
+    }
+}
+
+static void timeout_handler(void * p_context)
+{
+    timer_service_t * p_timer = p_context;
+    timestamp_t now = timer_now();
+
+    /* Unsigned difference: a timeout never fires early, anything else is lateness. */
+    uint32_t skew_us = now - p_timer->expected;
+    if (skew_us > m_stats.skew_max_us && skew_us < INT32_MAX)
+    {
+        m_stats.skew_max_us = skew_us;
+        diag_counter_set(DIAG_COUNTER_TIMER_SKEW_MAX_US, m_stats.skew_max_us);
+    }
+
+    if (p_timer->mode == APP_TIMER_MODE_REPEATED)
+    {
+        p_timer->expected += p_timer->interval_us;
+    }
+    else
+    {
+        active_set(p_timer, false);
+    }
+
+    p_timer->handler(p_timer->p_context);
+}
+
+uint32_t timer_service_create(timer_service_t * p_timer,
+                              app_timer_mode_t mode,
+                              app_timer_timeout_handler_t handler)
+{
+    p_timer->handler = handler;
+    p_timer->mode = mode;
+    p_timer->active = false;
+    return app_timer_create(p_timer->p_id, mode, timeout_handler);
+}
+
+void timer_service_stop(timer_service_t * p_timer)
+{
+    (void) app_timer_stop(*p_timer->p_id);
+    active_set(p_timer, false);
+}
+
+uint32_t timer_service_start(timer_service_t * p_timer, uint32_t timeout_ms, void * p_context)
+{
+    if (p_timer->active)
+    {
+        timer_service_stop(p_timer);
+    }
+
+    p_timer->p_context = p_context;
+    p_timer->interval_us = timeout_ms * 1000;
+    p_timer->expected = timer_now() + p_timer->interval_us;
+
+    uint32_t status = app_timer_start(*p_timer->p_id, APP_TIMER_TICKS(timeout_ms), p_timer);
+    if (status == NRF_SUCCESS)
+    {
+        active_set(p_timer, true);
+    }
+    else
+    {
+        m_stats.start_failures++;
+        diag_counter_add(DIAG_COUNTER_TIMER_START_FAILURES, 1);
+        __LOG(LOG_SRC_APP, LOG_LEVEL_ERROR, "Timer start failed: %d\n", status);
+    }
+    return status;
+}
+
+bool timer_service_is_active(const timer_service_t * p_timer)
+{
+    return p_timer->active;
+}
+
+const timer_service_stats_t * timer_service_stats_get(void)
+{
+    return &m_stats;
+}
@@ -0,0 +1,339 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tx_priority.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "app_error.h"
+#include "nrf_error.h"
+#include "core_tx.h"
+#include "core_tx_adv.h"
+#include "advertiser.h"
+#include "mesh_opt_core.h"
+#include "nrf_mesh_config_core.h"
+#include "nrf_mesh_assert.h"
+#include "toolchain.h"
+#include "timer.h"
+#include "timer_service.h"
+#include "diag_model.h"
+#include "relay_policy.h"
+
+typedef enum
+{
+    ADV_USER_ORIGINATOR,
+    ADV_USER_RELAY,
+    ADV_USER_BACKGROUND
+} adv_user_t;
+
+typedef struct
+{
+    timestamp_t send_time;
+    bool interactive;
+} queued_packet_t;
+
+typedef struct
+{
+    advertiser_t * p_adv;
+    advertiser_tx_complete_cb_t tx_complete_cb;
+    adv_user_t user;
+    uint8_t head;
+    uint8_t count;
+    queued_packet_t queue[TX_PRIORITY_DELAY_QUEUE_SIZE];
+} adv_slot_t;
+
+TIMER_SERVICE_DEF(m_yield_timer);
+
+static tx_priority_stats_t m_stats;
+static timestamp_t m_request_time;
+static bool m_interactive_pending;
+static bool m_yielding;
+static bool m_yielded_before;
+static timestamp_t m_yield_start;
+static timestamp_t m_yield_end;
+static uint32_t m_relay_interval_ms;
+
+static adv_slot_t m_adv_slots[TX_PRIORITY_ADVERTISERS_MAX];
+static uint32_t m_adv_slot_count;
+static core_tx_role_t m_alloc_role;
+static core_tx_role_t m_send_role;
+static bool m_core_tx_sending;
+
+static const diag_counter_t m_delay_counters[TX_PRIORITY_CLASS_COUNT] =
+{
+    DIAG_COUNTER_TX_INTERACTIVE_DELAY_MAX_US,
+    DIAG_COUNTER_TX_RELAY_DELAY_MAX_US,
+    DIAG_COUNTER_TX_BACKGROUND_DELAY_MAX_US,
+};
+
+core_tx_bearer_bitmask_t __real_core_tx_packet_alloc(const core_tx_alloc_params_t * p_params, uint8_t ** pp_data);
+void __real_core_tx_packet_send(void);
+void __real_advertiser_instance_init(advertiser_t * p_adv, advertiser_tx_complete_cb_t tx_complete_cb,
+                                     uint8_t * p_buffer, uint32_t buffer_size);
+void __real_advertiser_packet_send(advertiser_t * p_adv, adv_packet_t * p_packet);
+
+static void delay_add(tx_priority_class_t tx_class, uint32_t delay_us)
+{
+    tx_priority_delay_stats_t * p_delay = &m_stats.delay[tx_class];
+    p_delay->count++;
+    p_delay->delay_sum_us += delay_us;
+    if (delay_us > p_delay->delay_max_us)
+    {
+        p_delay->delay_max_us = delay_us;
+        diag_counter_max(m_delay_counters[tx_class], delay_us);
+    }
+}
+
+static adv_slot_t * adv_slot_find(const advertiser_t * p_adv)
+{
+    for (uint32_t i = 0; i < m_adv_slot_count; ++i)
+    {
+        if (m_adv_slots[i].p_adv == p_adv)
+        {
+            return &m_adv_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void adv_tx_complete(advertiser_t * p_adv, nrf_mesh_tx_token_t token, timestamp_t timestamp)
+{
+    adv_slot_t * p_slot = adv_slot_find(p_adv);
+    NRF_MESH_ASSERT(p_slot != NULL);
+
+    uint32_t was_masked;
+    _DISABLE_IRQS(was_masked);
+    if (p_slot->count > 0)
+    {
+        queued_packet_t packet = p_slot->queue[p_slot->head];
+        p_slot->head = (p_slot->head + 1) % TX_PRIORITY_DELAY_QUEUE_SIZE;
+        p_slot->count--;
+
+        if (packet.interactive)
+        {
+            delay_add(TX_PRIORITY_CLASS_INTERACTIVE, timestamp - m_request_time);
+        }
+        else if (p_slot->user == ADV_USER_RELAY)
+        {
+            delay_add(TX_PRIORITY_CLASS_RELAY, timestamp - packet.send_time);
+        }
+        else if (p_slot->user == ADV_USER_BACKGROUND)
+        {
+            delay_add(TX_PRIORITY_CLASS_BACKGROUND, timestamp - packet.send_time);
+        }
+    }
+    _ENABLE_IRQS(was_masked);
+
+    if (p_slot->tx_complete_cb != NULL)
+    {
+        p_slot->tx_complete_cb(p_adv, token, timestamp);
+    }
+}
+
+static uint32_t relay_interval_configured_get(void)
+{
+    mesh_opt_core_adv_t adv;
+    if (mesh_opt_core_adv_get(CORE_TX_ROLE_RELAY, &adv) == NRF_SUCCESS)
+    {
+        return adv.tx_interval_ms;
+    }
+    return m_relay_interval_ms;
+}
+
+static void yield_timeout_handler(void * p_context)
+{
+#if MESH_FEATURE_RELAY_ENABLED
+    /* Config Server may have changed the relay interval during the yield. */
+    core_tx_adv_interval_set(CORE_TX_ROLE_RELAY, relay_interval_configured_get());
+#endif
+    m_yielding = false;
+    m_yield_end = timer_now();
+    m_stats.relay_yield_time_ms += (m_yield_end - m_yield_start) / 1000;
+}
+
+/*****************************************************************************
+ * Link-time wrappers
+ *****************************************************************************/
+
+core_tx_bearer_bitmask_t __wrap_core_tx_packet_alloc(const core_tx_alloc_params_t * p_params, uint8_t ** pp_data)
+{
+    if (p_params->role == CORE_TX_ROLE_RELAY)
+    {
+        bool allowed = relay_policy_relay_allowed();
+        relay_policy_relay_count(allowed);
+        if (!allowed)
+        {
+            /* No bearer allocated: the network layer drops the relayed PDU. */
+            return 0;
+        }
+    }
+
+    core_tx_bearer_bitmask_t bearers = __real_core_tx_packet_alloc(p_params, pp_data);
+    if (bearers != 0)
+    {
+        /* The next core_tx_packet_send() sends this packet. */
+        m_alloc_role = p_params->role;
+        if (p_params->role == CORE_TX_ROLE_RELAY)
+        {
+            diag_counter_add(DIAG_COUNTER_RELAY, 1);
+        }
+    }
+    return bearers;
+}
+
+void __wrap_core_tx_packet_send(void)
+{
+    m_send_role = m_alloc_role;
+    m_core_tx_sending = true;
+    __real_core_tx_packet_send();
+    m_core_tx_sending = false;
+}
+
+void __wrap_advertiser_instance_init(advertiser_t * p_adv, advertiser_tx_complete_cb_t tx_complete_cb,
+                                     uint8_t * p_buffer, uint32_t buffer_size)
+{
+    adv_slot_t * p_slot = adv_slot_find(p_adv);
+    if (p_slot == NULL && m_adv_slot_count < TX_PRIORITY_ADVERTISERS_MAX)
+    {
+        p_slot = &m_adv_slots[m_adv_slot_count++];
+        p_slot->p_adv = p_adv;
+    }
+
+    if (p_slot == NULL)
+    {
+        __real_advertiser_instance_init(p_adv, tx_complete_cb, p_buffer, buffer_size);
+        return;
+    }
+
+    p_slot->tx_complete_cb = tx_complete_cb;
+    p_slot->user = ADV_USER_BACKGROUND;
+    p_slot->head = 0;
+    p_slot->count = 0;
+    __real_advertiser_instance_init(p_adv, adv_tx_complete, p_buffer, buffer_size);
+}
+
+void __wrap_advertiser_packet_send(advertiser_t * p_adv, adv_packet_t * p_packet)
+{
+    adv_slot_t * p_slot = adv_slot_find(p_adv);
+    if (p_slot != NULL)
+    {
+        uint32_t was_masked;
+        _DISABLE_IRQS(was_masked);
+        if (!m_core_tx_sending)
+        {
+            p_slot->user = ADV_USER_BACKGROUND;
+        }
+        else
+        {
+            p_slot->user = (m_send_role == CORE_TX_ROLE_RELAY) ? ADV_USER_RELAY : ADV_USER_ORIGINATOR;
+        }
+
+        if (p_slot->count == TX_PRIORITY_DELAY_QUEUE_SIZE)
+        {
+            p_slot->head = (p_slot->head + 1) % TX_PRIORITY_DELAY_QUEUE_SIZE;
+            p_slot->count--;
+            m_stats.unmeasured++;
+        }
+        queued_packet_t * p_queued = &p_slot->queue[(p_slot->head + p_slot->count) % TX_PRIORITY_DELAY_QUEUE_SIZE];
+        p_queued->send_time = timer_now();
+        p_queued->interactive = (m_interactive_pending && p_slot->user == ADV_USER_ORIGINATOR);
+        if (p_queued->interactive)
+        {
+            m_interactive_pending = false;
+        }
+        p_slot->count++;
+        _ENABLE_IRQS(was_masked);
+    }
+    __real_advertiser_packet_send(p_adv, p_packet);
+}
+
+/*****************************************************************************
+ * Public API
+ *****************************************************************************/
+
+void tx_priority_init(void)
+{
+    APP_ERROR_CHECK(timer_service_create(&m_yield_timer, APP_TIMER_MODE_SINGLE_SHOT, yield_timeout_handler));
+}
+
+void tx_priority_interactive_begin(void)
+{
+    m_request_time = timer_now();
+    m_interactive_pending = true;
+
+    /* A running yield is not extended, so it stays bounded. */
+    if (m_yielding)
+    {
+        return;
+    }
+
+    if (m_yielded_before && (m_request_time - m_yield_end) < TX_PRIORITY_RELAY_GUARD_MS * 1000)
+    {
+        m_stats.relay_yields_refused++;
+        diag_counter_add(DIAG_COUNTER_TX_RELAY_YIELDS_REFUSED, 1);
+        return;
+    }
+
+#if MESH_FEATURE_RELAY_ENABLED
+    m_relay_interval_ms = core_tx_adv_interval_get(CORE_TX_ROLE_RELAY);
+    if (relay_interval_configured_get() >= TX_PRIORITY_RELAY_YIELD_INTERVAL_MS)
+    {
+        return;
+    }
+    core_tx_adv_interval_set(CORE_TX_ROLE_RELAY, TX_PRIORITY_RELAY_YIELD_INTERVAL_MS);
+#endif
+
+    m_yielding = true;
+    m_yielded_before = true;
+    m_yield_start = m_request_time;
+    m_stats.relay_yields++;
+    diag_counter_add(DIAG_COUNTER_TX_RELAY_YIELDS, 1);
+    APP_ERROR_CHECK(timer_service_start(&m_yield_timer, TX_PRIORITY_YIELD_MAX_MS, NULL));
+}
+
+void tx_priority_interactive_end(void)
+{
+    /* Only a packet originated by the send call itself is measured. */
+    m_interactive_pending = false;
+}
+
+void tx_priority_stats_get(tx_priority_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
@@ -0,0 +1,144 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host benchmark of the AES-CCM backends of SDKPatch/ccm_soft.c.
+ *
+ * - net: network PDU, DST and an unsegmented transport PDU (18 bytes), no additional data,
+ *   32-bit NetMIC.
+ * - net_control: the same with the 64-bit NetMIC of control messages.
+ * - access: largest segmented access payload (380 bytes), 32-bit TransMIC.
+ *
+ * AES runs in software on the host (stubs/aes_stub.c), so the times show the cost of the CCM
+ * code around it, not the SoftDevice. The aes_calls and ecb_calls per operation are the number
+ * of SoftDevice calls each backend makes on target, where every call costs a supervisor call;
+ * the on-target times come from the Benchmark configuration, see crypto_bench.h.
+ *
+ * Results are printed as one JSON object per backend and case. */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "ccm_soft.h"
+extern "C" {
+#include "ccm_backend.h"
+}
+#include "aes.h"
+#include "nrf_soc.h"
+
+namespace
+{
+
+const uint32_t ITERATIONS = 20000;
+
+struct bench_case
+{
+    const char * name;
+    uint16_t m_len;
+    uint8_t mic_len;
+};
+
+const uint8_t KEY[NRF_MESH_KEY_SIZE] =
+    {0x32, 0x16, 0xD1, 0x50, 0x98, 0x84, 0xB5, 0x33, 0x24, 0x85, 0x41, 0x79, 0x2B, 0x87, 0x7F, 0x98};
+const uint8_t NONCE[13] = {0x00, 0x04, 0x00, 0x00, 0x01, 0x12, 0x01, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78};
+
+uint8_t m_message[384];
+uint8_t m_out[384];
+uint8_t m_mic[8];
+volatile uint32_t m_sink;
+
+double run(const bench_case & c, bool decrypt, uint32_t * p_aes_calls, uint32_t * p_ecb_calls)
+{
+    ccm_soft_data_t data = {KEY, NONCE, m_message, c.m_len, nullptr, 0, m_out, m_mic, c.mic_len};
+    uint32_t aes_before = aes_stub_calls_get();
+    uint32_t ecb_before = nrf_soc_stub_ecb_calls_get();
+    uint32_t passed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; ++i)
+    {
+        if (decrypt)
+        {
+            bool mic_passed;
+            ccm_soft_decrypt(&data, &mic_passed);
+            passed += mic_passed;
+        }
+        else
+        {
+            ccm_soft_encrypt(&data);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_sink = passed;
+
+    *p_aes_calls = (aes_stub_calls_get() - aes_before) / ITERATIONS;
+    *p_ecb_calls = (nrf_soc_stub_ecb_calls_get() - ecb_before) / ITERATIONS;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / ITERATIONS;
+}
+
+} // namespace
+
+int main()
+{
+    const bench_case cases[] = {{"net", 18, 4}, {"net_control", 18, 8}, {"access", 380, 4}};
+    const struct
+    {
+        const char * name;
+        ccm_backend_t backend;
+    } backends[] = {{"soft", CCM_BACKEND_SOFT}, {"batched", CCM_BACKEND_BATCHED}};
+
+    for (uint32_t i = 0; i < sizeof(m_message); ++i)
+    {
+        m_message[i] = static_cast<uint8_t>(i);
+    }
+
+    for (const auto & backend : backends)
+    {
+        ccm_backend_set(backend.backend);
+        for (const bench_case & c : cases)
+        {
+            uint32_t aes_calls;
+            uint32_t ecb_calls;
+            double encrypt_us = run(c, false, &aes_calls, &ecb_calls);
+            double decrypt_us = run(c, true, &aes_calls, &ecb_calls);
+            std::printf("{\"bench\": \"ccm_soft\", \"backend\": \"%s\", \"case\": \"%s\", \"bytes\": %u, "
+                        "\"mic_len\": %u, \"encrypt_us\": %.2f, \"decrypt_us\": %.2f, \"aes_calls\": %u, "
+                        "\"ecb_calls\": %u}\n",
+                        backend.name, c.name, c.m_len, c.mic_len, encrypt_us, decrypt_us, aes_calls, ecb_calls);
+        }
+    }
+    return 0;
+}
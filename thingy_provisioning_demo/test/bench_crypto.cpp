@@ -0,0 +1,265 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host counterpart of the firmware crypto benchmarks in src/crypto_bench.c, timed with
+ * std::chrono instead of the DWT cycle counter.
+ *
+ * The cases have the names and sizes of the firmware cases, for the primitives that build on the
+ * host: the AES-CCM backends of SDKPatch/ccm_soft.c, the fixed-base comb of src/p256_comb.c, and
+ * P-256 key generation and ECDH when micro-ecc is found in the SDK (MICRO_ECC_DIR in the
+ * Makefile). ecc_public_key and ecc_public_key_comb compute the public key of the same private key
+ * with micro-ecc and with the comb. micro-ecc is built with the
+ * defines of uECC.c in the project file, so a change of uECC_OPTIMIZATION_LEVEL or of the compiler
+ * settings can be tracked on the host before it is measured on target. AES runs in software on
+ * the host, see stubs/aes_stub.c.
+ *
+ * Results are printed as one JSON object per case, labelled with CRYPTO_BENCH_TAG:
+ * {"bench": "crypto", "tag": ..., "name": ..., "bytes": ..., "iterations": ..., "ns_min": ...,
+ *  "ns_avg": ..., "bytes_per_s": ...} */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "ccm_soft.h"
+extern "C" {
+#include "ccm_backend.h"
+#include "crypto_bench.h"
+#include "p256_comb.h"
+#include "rand.h"
+}
+#if BENCH_UECC
+#include "uECC.h"
+#endif
+
+namespace
+{
+
+/* The sizes of src/crypto_bench.c, with more iterations as host timings are noisier. */
+const uint32_t ITERATIONS_SYMMETRIC = 2000;
+const uint32_t ITERATIONS_ECC = 20;
+const uint16_t ACCESS_PAYLOAD_SIZE = 380;
+const uint16_t NETWORK_PAYLOAD_SIZE = 16;
+const uint16_t ECC_KEY_SIZE = 32;
+
+struct bench_case
+{
+    const char * name;
+    uint16_t bytes;
+    uint32_t iterations;
+    void (*run)(void);
+};
+
+const uint8_t KEY[NRF_MESH_KEY_SIZE] =
+    {0x32, 0x16, 0xD1, 0x50, 0x98, 0x84, 0xB5, 0x33, 0x24, 0x85, 0x41, 0x79, 0x2B, 0x87, 0x7F, 0x98};
+const uint8_t NONCE[13] = {0x01, 0x00, 0x00, 0x00, 0x07, 0x12, 0x01, 0xFF, 0xFF, 0x12, 0x34, 0x56, 0x78};
+
+uint8_t m_buffer[ACCESS_PAYLOAD_SIZE];
+uint8_t m_mic[8];
+
+void ccm_run(uint16_t length, uint8_t mic_len, bool decrypt)
+{
+    ccm_soft_data_t data = {KEY, NONCE, m_buffer, length, nullptr, 0, m_buffer, m_mic, mic_len};
+    if (decrypt)
+    {
+        bool mic_passed;
+        ccm_soft_decrypt(&data, &mic_passed);
+    }
+    else
+    {
+        ccm_soft_encrypt(&data);
+    }
+}
+
+void bench_ccm_net_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(NETWORK_PAYLOAD_SIZE, 4, false);
+}
+
+void bench_ccm_net_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(NETWORK_PAYLOAD_SIZE, 4, false);
+}
+
+void bench_ccm_access_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(ACCESS_PAYLOAD_SIZE, 4, false);
+}
+
+void bench_ccm_access_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(ACCESS_PAYLOAD_SIZE, 4, false);
+}
+
+void bench_ccm_net_decrypt_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(NETWORK_PAYLOAD_SIZE, 4, true);
+}
+
+void bench_ccm_net_decrypt_batched(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(NETWORK_PAYLOAD_SIZE, 4, true);
+}
+
+void bench_ccm_access_decrypt_soft(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    ccm_run(ACCESS_PAYLOAD_SIZE, 4, true);
+}
+
+void bench_ccm_access_decrypt(void)
+{
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    ccm_run(ACCESS_PAYLOAD_SIZE, 4, true);
+}
+
+uint8_t m_comb_private[P256_COMB_PRIVATE_KEY_SIZE];
+uint8_t m_comb_public[P256_COMB_PUBLIC_KEY_SIZE];
+
+void bench_ecc_public_key_comb(void)
+{
+    (void) p256_comb_public_key_compute(m_comb_private, m_comb_public);
+}
+
+#if BENCH_UECC
+uint8_t m_ecc_private[ECC_KEY_SIZE];
+uint8_t m_ecc_public[ECC_KEY_SIZE * 2];
+uint8_t m_ecc_peer_private[ECC_KEY_SIZE];
+uint8_t m_ecc_peer_public[ECC_KEY_SIZE * 2];
+uint8_t m_ecc_secret[ECC_KEY_SIZE];
+
+int bench_rng(uint8_t * p_dest, unsigned size)
+{
+    for (unsigned i = 0; i < size; ++i)
+    {
+        p_dest[i] = static_cast<uint8_t>(std::rand());
+    }
+    return 1;
+}
+
+void bench_ecc_make_key(void)
+{
+    (void) uECC_make_key(m_ecc_public, m_ecc_private, uECC_secp256r1());
+}
+
+void bench_ecc_public_key(void)
+{
+    (void) uECC_compute_public_key(m_comb_private, m_comb_public, uECC_secp256r1());
+}
+
+void bench_ecdh_shared_secret(void)
+{
+    (void) uECC_shared_secret(m_ecc_peer_public, m_ecc_private, m_ecc_secret, uECC_secp256r1());
+}
+#endif
+
+const bench_case CASES[] =
+{
+    {"ccm_net_soft",            NETWORK_PAYLOAD_SIZE, ITERATIONS_SYMMETRIC, bench_ccm_net_soft},
+    {"ccm_net_batched",         NETWORK_PAYLOAD_SIZE, ITERATIONS_SYMMETRIC, bench_ccm_net_batched},
+    {"ccm_access_soft",         ACCESS_PAYLOAD_SIZE,  ITERATIONS_SYMMETRIC, bench_ccm_access_soft},
+    {"ccm_access_batched",      ACCESS_PAYLOAD_SIZE,  ITERATIONS_SYMMETRIC, bench_ccm_access_batched},
+    {"ccm_net_decrypt_soft",    NETWORK_PAYLOAD_SIZE, ITERATIONS_SYMMETRIC, bench_ccm_net_decrypt_soft},
+    {"ccm_net_decrypt_batched", NETWORK_PAYLOAD_SIZE, ITERATIONS_SYMMETRIC, bench_ccm_net_decrypt_batched},
+    {"ccm_access_decrypt_soft", ACCESS_PAYLOAD_SIZE,  ITERATIONS_SYMMETRIC, bench_ccm_access_decrypt_soft},
+    {"ccm_access_decrypt",      ACCESS_PAYLOAD_SIZE,  ITERATIONS_SYMMETRIC, bench_ccm_access_decrypt},
+#if BENCH_UECC
+    {"ecc_make_key",            ECC_KEY_SIZE,         ITERATIONS_ECC,       bench_ecc_make_key},
+    {"ecc_public_key",          ECC_KEY_SIZE,         ITERATIONS_ECC,       bench_ecc_public_key},
+    {"ecdh_shared_secret",      ECC_KEY_SIZE,         ITERATIONS_ECC,       bench_ecdh_shared_secret},
+#endif
+    {"ecc_public_key_comb",     ECC_KEY_SIZE,         ITERATIONS_ECC,       bench_ecc_public_key_comb},
+};
+
+void case_run(const bench_case & c)
+{
+    double min_ns = 1e18;
+    double sum_ns = 0;
+    for (uint32_t i = 0; i < c.iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        c.run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        sum_ns += ns;
+        if (ns < min_ns)
+        {
+            min_ns = ns;
+        }
+    }
+
+    double avg_ns = sum_ns / c.iterations;
+    std::printf("{\"bench\": \"crypto\", \"tag\": \"%s\", \"name\": \"%s\", \"bytes\": %u, \"iterations\": %u, "
+                "\"ns_min\": %.0f, \"ns_avg\": %.0f, \"bytes_per_s\": %.0f}\n",
+                CRYPTO_BENCH_TAG, c.name, c.bytes, c.iterations, min_ns, avg_ns, c.bytes * 1e9 / avg_ns);
+}
+
+} // namespace
+
+extern "C" void rand_hw_rng_get(uint8_t * p_result, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; ++i)
+    {
+        p_result[i] = static_cast<uint8_t>(std::rand());
+    }
+}
+
+int main()
+{
+    std::memset(m_buffer, 0xA5, sizeof(m_buffer));
+    std::srand(1);
+    uint8_t public_key[P256_COMB_PUBLIC_KEY_SIZE];
+    p256_comb_key_pair_generate(public_key, m_comb_private);
+#if BENCH_UECC
+    uECC_set_rng(bench_rng);
+    /* The ECDH benchmark needs a peer key. */
+    (void) uECC_make_key(m_ecc_peer_public, m_ecc_peer_private, uECC_secp256r1());
+    (void) uECC_make_key(m_ecc_public, m_ecc_private, uECC_secp256r1());
+#endif
+
+    for (const bench_case & c : CASES)
+    {
+        case_run(c);
+    }
+    return 0;
+}
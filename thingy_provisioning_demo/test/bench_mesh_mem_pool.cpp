@@ -0,0 +1,321 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host benchmark of the size-class pools in SDKPatch/mesh_mem_pool.c against malloc, replaying an
+ * allocation trace.
+ *
+ * The trace is read from the file given as the first argument: the log of a build with
+ * MESH_MEM_POOL_TRACE_ENABLED, where every "mem a <address> <size>" line is an allocation and every
+ * "mem f <address>" line a free. Other lines are ignored. Without an argument a synthetic trace is
+ * generated from the allocation sites of the stack: short lived buffers of unsegmented access
+ * messages, SAR transmit buffers of the message and its MIC, SAR receive buffers of whole segments,
+ * with up to TRANSPORT_SAR_SESSIONS_MAX overlapping SAR sessions.
+ *
+ * Results are printed as one JSON object per implementation: mean time per operation, the 99th
+ * percentile of single operations, and the allocations that failed. */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "mesh_mem.h"
+#include "mesh_mem_pool.h"
+
+namespace
+{
+
+const uint32_t REPEAT = 200;
+const uint32_t SYNTHETIC_MESSAGES = 20000;
+
+struct trace_op
+{
+    bool alloc;
+    uint32_t slot;
+    uint32_t size;
+};
+
+struct trace_t
+{
+    std::vector<trace_op> ops;
+    uint32_t slot_count = 0;
+};
+
+struct allocator_ops
+{
+    const char * name;
+    void (*reset)(void);
+    void * (*alloc)(size_t);
+    void (*free)(void *);
+};
+
+void pool_reset(void)
+{
+    mesh_mem_init();
+}
+
+void malloc_reset(void)
+{
+}
+
+/* Maps trace addresses to slots, reusing the slots of freed addresses. */
+class slot_map
+{
+public:
+    uint32_t alloc(const std::string & address, trace_t & trace)
+    {
+        uint32_t slot;
+        if (m_free.empty())
+        {
+            slot = trace.slot_count++;
+        }
+        else
+        {
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+        m_live[address] = slot;
+        return slot;
+    }
+
+    bool free(const std::string & address, uint32_t * p_slot)
+    {
+        auto it = m_live.find(address);
+        if (it == m_live.end())
+        {
+            return false;
+        }
+        *p_slot = it->second;
+        m_free.push_back(it->second);
+        m_live.erase(it);
+        return true;
+    }
+
+private:
+    std::map<std::string, uint32_t> m_live;
+    std::vector<uint32_t> m_free;
+};
+
+bool trace_load(const char * p_path, trace_t & trace)
+{
+    FILE * p_file = std::fopen(p_path, "r");
+    if (p_file == nullptr)
+    {
+        return false;
+    }
+
+    slot_map slots;
+    char line[256];
+    while (std::fgets(line, sizeof(line), p_file) != nullptr)
+    {
+        char address[32];
+        unsigned size;
+        const char * p_op = std::strstr(line, "mem ");
+        if (p_op == nullptr)
+        {
+            continue;
+        }
+        if (std::sscanf(p_op, "mem a %31s %u", address, &size) == 2)
+        {
+            /* Failed allocations are logged with a null address and never freed. */
+            if (std::strtoul(address, nullptr, 16) != 0)
+            {
+                trace.ops.push_back({true, slots.alloc(address, trace), size});
+            }
+        }
+        else if (std::sscanf(p_op, "mem f %31s", address) == 1)
+        {
+            uint32_t slot;
+            if (slots.free(address, &slot))
+            {
+                trace.ops.push_back({false, slot, 0});
+            }
+        }
+    }
+    std::fclose(p_file);
+    return true;
+}
+
+void trace_synthesize(trace_t & trace)
+{
+    struct session
+    {
+        uint32_t slot;
+        uint32_t messages_left;
+    };
+
+    std::vector<session> sessions;
+    std::vector<uint32_t> free_slots;
+    uint32_t state = 2463534242u;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+    auto slot_alloc = [&]() {
+        if (free_slots.empty())
+        {
+            return trace.slot_count++;
+        }
+        uint32_t slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    };
+
+    for (uint32_t i = 0; i < SYNTHETIC_MESSAGES; ++i)
+    {
+        uint32_t r = next();
+        if (r % 8 != 0 || sessions.size() == TRANSPORT_SAR_SESSIONS_MAX)
+        {
+            /* Unsegmented access message: opcode and parameters, freed once sent. */
+            uint32_t slot = slot_alloc();
+            trace.ops.push_back({true, slot, 3 + (r >> 8) % 9});
+            trace.ops.push_back({false, slot, 0});
+        }
+        else
+        {
+            /* SAR session: a transmit buffer of the message and a 4 byte MIC, or a receive buffer of
+             * SegN + 1 segments. Most segmented messages are short Config Server status messages. */
+            uint32_t segments = ((r >> 8) % 4 == 0) ? 1 + (r >> 12) % 32 : 1 + (r >> 12) % 4;
+            uint32_t size = ((r >> 20) & 1) ? segments * MESH_MEM_POOL_SEGMENT_SIZE
+                                            : segments * MESH_MEM_POOL_SEGMENT_SIZE - (r >> 24) % 8;
+            sessions.push_back({slot_alloc(), 2 + segments});
+            trace.ops.push_back({true, sessions.back().slot, size});
+        }
+
+        /* Sessions end after a number of other messages, in any order. */
+        for (size_t s = 0; s < sessions.size();)
+        {
+            if (--sessions[s].messages_left == 0)
+            {
+                trace.ops.push_back({false, sessions[s].slot, 0});
+                free_slots.push_back(sessions[s].slot);
+                sessions[s] = sessions.back();
+                sessions.pop_back();
+            }
+            else
+            {
+                ++s;
+            }
+        }
+    }
+    for (const session & s : sessions)
+    {
+        trace.ops.push_back({false, s.slot, 0});
+    }
+}
+
+uint32_t replay(const allocator_ops & ops, const trace_t & trace, std::vector<void *> & slots,
+                std::vector<double> * p_op_ns)
+{
+    uint32_t failures = 0;
+    ops.reset();
+    for (const trace_op & op : trace.ops)
+    {
+        auto op_start = std::chrono::steady_clock::now();
+        if (op.alloc)
+        {
+            slots[op.slot] = ops.alloc(op.size);
+            failures += (slots[op.slot] == nullptr);
+        }
+        else
+        {
+            ops.free(slots[op.slot]);
+            slots[op.slot] = nullptr;
+        }
+        if (p_op_ns != nullptr)
+        {
+            p_op_ns->push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - op_start).count());
+        }
+    }
+    return failures;
+}
+
+void run(const allocator_ops & ops, const trace_t & trace, const char * p_trace_name)
+{
+    std::vector<void *> slots(trace.slot_count, nullptr);
+    uint32_t failures = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < REPEAT; ++round)
+    {
+        failures = replay(ops, trace, slots, nullptr);
+    }
+    double total_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    /* One more round timing each operation, including the cost of reading the clock. */
+    std::vector<double> op_ns;
+    op_ns.reserve(trace.ops.size());
+    (void) replay(ops, trace, slots, &op_ns);
+    std::sort(op_ns.begin(), op_ns.end());
+
+    std::printf("{\"bench\": \"mesh_mem_pool\", \"impl\": \"%s\", \"trace\": \"%s\", \"ops\": %zu, "
+                "\"mean_ns\": %.1f, \"p99_ns\": %.0f, \"failures\": %u}\n",
+                ops.name, p_trace_name, trace.ops.size(), total_ns / (REPEAT * trace.ops.size()),
+                op_ns[op_ns.size() * 99 / 100], failures);
+}
+
+} // namespace
+
+int main(int argc, char ** argv)
+{
+    trace_t trace;
+    const char * p_trace_name = "synthetic";
+    if (argc > 1)
+    {
+        if (!trace_load(argv[1], trace))
+        {
+            std::fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 1;
+        }
+        p_trace_name = argv[1];
+    }
+    else
+    {
+        trace_synthesize(trace);
+    }
+
+    run({"pool", pool_reset, mesh_mem_alloc, mesh_mem_free}, trace, p_trace_name);
+    run({"malloc", malloc_reset, std::malloc, std::free}, trace, p_trace_name);
+    return 0;
+}
@@ -0,0 +1,202 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host benchmark of the hashed message cache in SDKPatch/msg_cache.c against the linear ring of
+ * the stock implementation, both with MSG_CACHE_ENTRY_COUNT entries. Built once per cache size,
+ * see the Makefile.
+ *
+ * The trace is the traffic heard by a relay: network PDUs from a few hundred sources, each heard
+ * once directly and up to three more times through other relays, 5 to 400 ms later. Every packet
+ * goes through the network layer sequence: msg_cache_entry_exists(), and msg_cache_entry_add() if
+ * it was not found. The trace is generated at 10,000 packets per minute, the peak rate used to
+ * size the cache (MESH_APP_PEAK_PACKET_RATE), and at twice that rate.
+ *
+ * - packet_ns: mean cost per packet.
+ * - missed_copies: copies that were not found and would be relayed again.
+ * - false_hits: first copies that were found, which would drop a new PDU.
+ *
+ * Results are printed as one JSON object per implementation and rate. */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "msg_cache.h"
+#include "linear_msg_cache.h"
+#include "nrf_mesh_config_core.h"
+#include "timer.h"
+
+namespace
+{
+
+const uint32_t TRACE_DURATION_S = 600;
+const uint32_t SOURCES = 300;
+const uint32_t COPIES_MAX = 3;
+const uint32_t COPY_DELAY_MIN_US = 5000;
+const uint32_t COPY_DELAY_MAX_US = 400000;
+const uint32_t ROUNDS = 20;
+
+struct packet
+{
+    timestamp_t time;
+    uint16_t src;
+    uint32_t seq;
+    bool copy;
+};
+
+struct cache_ops
+{
+    const char * name;
+    void (*clear)(void);
+    bool (*exists)(uint16_t, uint32_t);
+    void (*add)(uint16_t, uint32_t);
+};
+
+timestamp_t m_now;
+volatile uint32_t m_sink;
+
+uint32_t rand_next(uint32_t * p_state)
+{
+    uint32_t x = *p_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+std::vector<packet> trace_generate(uint32_t packets_per_minute)
+{
+    /* Each PDU is heard 1 + COPIES_MAX / 2 times on average. */
+    const double pdu_gap_us = 60e6 / packets_per_minute * (1.0 + COPIES_MAX / 2.0);
+    std::vector<uint32_t> next_seq(SOURCES, 0);
+    std::vector<packet> trace;
+    uint32_t state = 2463534242u;
+    double time_us = 0;
+
+    while (time_us < TRACE_DURATION_S * 1e6)
+    {
+        /* Exponential gaps between new PDUs. */
+        time_us -= std::log((rand_next(&state) + 1.0) / 4294967297.0) * pdu_gap_us;
+        uint32_t source = rand_next(&state) % SOURCES;
+        packet original = {static_cast<timestamp_t>(time_us), static_cast<uint16_t>(0x0100 + source),
+                           next_seq[source]++, false};
+        trace.push_back(original);
+
+        uint32_t copies = rand_next(&state) % (COPIES_MAX + 1);
+        for (uint32_t i = 0; i < copies; ++i)
+        {
+            packet copy = original;
+            copy.time += COPY_DELAY_MIN_US + rand_next(&state) % (COPY_DELAY_MAX_US - COPY_DELAY_MIN_US);
+            copy.copy = true;
+            trace.push_back(copy);
+        }
+    }
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](const packet & a, const packet & b) { return a.time < b.time; });
+    return trace;
+}
+
+void run(const cache_ops & ops, const std::vector<packet> & trace, uint32_t packets_per_minute)
+{
+    uint32_t copies = 0;
+    uint32_t missed_copies = 0;
+    uint32_t false_hits = 0;
+
+    ops.clear();
+    for (const packet & p : trace)
+    {
+        m_now = p.time;
+        bool exists = ops.exists(p.src, p.seq);
+        if (!exists)
+        {
+            ops.add(p.src, p.seq);
+        }
+        copies += p.copy;
+        missed_copies += (p.copy && !exists);
+        false_hits += (!p.copy && exists);
+    }
+
+    uint32_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+        ops.clear();
+        for (const packet & p : trace)
+        {
+            m_now = p.time;
+            if (ops.exists(p.src, p.seq))
+            {
+                found++;
+            }
+            else
+            {
+                ops.add(p.src, p.seq);
+            }
+        }
+    }
+    double packet_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                       (static_cast<double>(ROUNDS) * trace.size());
+    m_sink = found;
+
+    std::printf("{\"bench\": \"msg_cache\", \"impl\": \"%s\", \"entries\": %u, \"packets_per_minute\": %u, "
+                "\"packets\": %zu, \"copies\": %u, \"packet_ns\": %.1f, \"missed_copies\": %u, \"false_hits\": %u}\n",
+                ops.name, MSG_CACHE_ENTRY_COUNT, packets_per_minute, trace.size(), copies, packet_ns,
+                missed_copies, false_hits);
+}
+
+} // namespace
+
+extern "C" timestamp_t timer_now(void)
+{
+    return m_now;
+}
+
+int main()
+{
+    msg_cache_init();
+    for (uint32_t packets_per_minute : {10000u, 20000u})
+    {
+        std::vector<packet> trace = trace_generate(packets_per_minute);
+        run({"hash", msg_cache_clear, msg_cache_entry_exists, msg_cache_entry_add}, trace, packets_per_minute);
+        run({"linear", linear_msg_cache_clear, linear_msg_cache_entry_exists, linear_msg_cache_entry_add},
+            trace, packets_per_minute);
+    }
+    return 0;
+}
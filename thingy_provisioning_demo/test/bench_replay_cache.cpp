@@ -0,0 +1,149 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host microbenchmark of the hashed replay cache in SDKPatch/replay_cache.c against the linear
+ * search of the stock implementation. Built once per cache size, see the Makefile: the number of
+ * sources equals REPLAY_CACHE_ENTRIES.
+ *
+ * - lookup: replay_cache_has_elem() for a random known source, as done for every received message.
+ * - update: replay_cache_has_elem() followed by replay_cache_add() with the next sequence number
+ *   of a random known source, the cost of accepting a message.
+ * - insert: filling the empty cache with all sources, per source.
+ *
+ * Results are printed as one JSON object per implementation. */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "replay_cache.h"
+#include "linear_replay_cache.h"
+#include "nrf_mesh_config_core.h"
+
+extern "C" uint32_t net_state_beacon_iv_index_get(void)
+{
+    return 0;
+}
+
+namespace
+{
+
+const uint32_t SOURCES = REPLAY_CACHE_ENTRIES;
+const uint32_t OPERATIONS = 2000000;
+const uint32_t INSERT_ROUNDS = 20000 / SOURCES + 10;
+
+struct cache_ops
+{
+    const char * name;
+    void (*clear)(void);
+    uint32_t (*add)(uint16_t, uint32_t, uint32_t);
+    bool (*has_elem)(uint16_t, uint32_t, uint32_t);
+};
+
+volatile uint32_t m_sink;
+
+double ns_per_op(std::chrono::steady_clock::duration duration, uint32_t ops)
+{
+    return std::chrono::duration<double, std::nano>(duration).count() / ops;
+}
+
+void run(const cache_ops & ops, const std::vector<uint16_t> & addresses, const std::vector<uint32_t> & picks)
+{
+    std::vector<uint32_t> seqno(SOURCES, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < INSERT_ROUNDS; ++round)
+    {
+        ops.clear();
+        for (uint32_t i = 0; i < SOURCES; ++i)
+        {
+            ops.add(addresses[i], 1, 0);
+        }
+    }
+    double insert_ns = ns_per_op(std::chrono::steady_clock::now() - start, INSERT_ROUNDS * SOURCES);
+
+    uint32_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < OPERATIONS; ++i)
+    {
+        hits += ops.has_elem(addresses[picks[i]], 1, 0);
+    }
+    double lookup_ns = ns_per_op(std::chrono::steady_clock::now() - start, OPERATIONS);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < OPERATIONS; ++i)
+    {
+        uint32_t source = picks[i];
+        uint32_t next = ++seqno[source];
+        if (!ops.has_elem(addresses[source], next, 0))
+        {
+            ops.add(addresses[source], next, 0);
+        }
+    }
+    double update_ns = ns_per_op(std::chrono::steady_clock::now() - start, OPERATIONS);
+    m_sink = hits;
+
+    std::printf("{\"bench\": \"replay_cache\", \"impl\": \"%s\", \"sources\": %u, "
+                "\"lookup_ns\": %.1f, \"update_ns\": %.1f, \"insert_ns\": %.1f}\n",
+                ops.name, SOURCES, lookup_ns, update_ns, insert_ns);
+}
+
+} // namespace
+
+int main()
+{
+    /* Unicast addresses of two-element nodes, handed out in order, visited in random order. */
+    std::vector<uint16_t> addresses(SOURCES);
+    for (uint32_t i = 0; i < SOURCES; ++i)
+    {
+        addresses[i] = static_cast<uint16_t>(0x0100 + 2 * i);
+    }
+    std::vector<uint32_t> picks(OPERATIONS);
+    uint32_t state = 2463534242u;
+    for (uint32_t & pick : picks)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        pick = state % SOURCES;
+    }
+
+    run({"hash", replay_cache_clear, replay_cache_add, replay_cache_has_elem}, addresses, picks);
+    run({"linear", linear_replay_cache_clear, linear_replay_cache_add, linear_replay_cache_has_elem}, addresses, picks);
+    return 0;
+}
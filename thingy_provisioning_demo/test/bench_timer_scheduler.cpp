@@ -0,0 +1,198 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host benchmark of the heap-based timer scheduler in SDKPatch/timer_scheduler.c against the
+ * sorted linked list of the stock implementation, with 8, 32 and TIMER_SCH_EVENTS_MAX events
+ * pending. Timeouts are spread at random over the next 10 s, as the mesh and application timers
+ * of a relay node are.
+ *
+ * - insert_ns: mean cost of timer_sch_schedule(), filling the scheduler from empty.
+ * - cancel_ns: mean cost of timer_sch_abort(), emptying it in random order.
+ * - move_ns: mean cost of an abort and a schedule of a random pending event, with the scheduler
+ *   full, as when a timer is restarted.
+ *
+ * Results are printed as one JSON object per implementation and number of events. */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "timer_scheduler.h"
+#include "linear_timer_scheduler.h"
+#include "nrf_mesh_config_core.h"
+#include "bearer_event.h"
+#include "timer.h"
+
+namespace
+{
+
+const uint32_t TIMEOUT_MAX_US = 10000000;
+const uint32_t OPERATIONS = 2000000;
+
+struct scheduler_ops
+{
+    const char * name;
+    void (*init)(void);
+    void (*schedule)(timer_event_t *);
+    void (*abort)(timer_event_t *);
+};
+
+timestamp_t m_now = 1000;
+volatile uint32_t m_sink;
+
+uint32_t rand_next(uint32_t * p_state)
+{
+    uint32_t x = *p_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+void event_cb(timestamp_t timestamp, void * p_context)
+{
+    (void) p_context;
+    m_sink = timestamp;
+}
+
+void run(const scheduler_ops & ops, uint32_t pending)
+{
+    std::vector<timer_event_t> events(pending);
+    std::vector<timestamp_t> timeouts(OPERATIONS);
+    std::vector<uint32_t> picks(OPERATIONS);
+    uint32_t state = 2463534242u;
+    for (uint32_t i = 0; i < OPERATIONS; ++i)
+    {
+        timeouts[i] = m_now + 1 + rand_next(&state) % TIMEOUT_MAX_US;
+        picks[i] = rand_next(&state) % pending;
+    }
+    for (timer_event_t & evt : events)
+    {
+        evt = timer_event_t();
+        evt.cb = event_cb;
+    }
+
+    /* Fill and drain. */
+    const uint32_t rounds = OPERATIONS / pending;
+    double insert_ns = 0;
+    double cancel_ns = 0;
+    ops.init();
+    for (uint32_t round = 0; round < rounds; ++round)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < pending; ++i)
+        {
+            events[i].timestamp = timeouts[round * pending + i];
+            ops.schedule(&events[i]);
+        }
+        auto filled = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < pending; ++i)
+        {
+            /* Random order, every event once. */
+            ops.abort(&events[(i * 7 + picks[round]) % pending]);
+        }
+        auto drained = std::chrono::steady_clock::now();
+        insert_ns += std::chrono::duration<double, std::nano>(filled - start).count();
+        cancel_ns += std::chrono::duration<double, std::nano>(drained - filled).count();
+    }
+    insert_ns /= static_cast<double>(rounds) * pending;
+    cancel_ns /= static_cast<double>(rounds) * pending;
+
+    /* Restart random events with the scheduler full. */
+    for (uint32_t i = 0; i < pending; ++i)
+    {
+        events[i].timestamp = timeouts[i];
+        ops.schedule(&events[i]);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < OPERATIONS; ++i)
+    {
+        timer_event_t * p_evt = &events[picks[i]];
+        ops.abort(p_evt);
+        p_evt->timestamp = timeouts[i];
+        ops.schedule(p_evt);
+    }
+    double move_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                     OPERATIONS;
+    for (uint32_t i = 0; i < pending; ++i)
+    {
+        ops.abort(&events[i]);
+    }
+
+    std::printf("{\"bench\": \"timer_scheduler\", \"impl\": \"%s\", \"pending\": %u, \"insert_ns\": %.1f, "
+                "\"cancel_ns\": %.1f, \"move_ns\": %.1f}\n",
+                ops.name, pending, insert_ns, cancel_ns, move_ns);
+}
+
+} // namespace
+
+extern "C" timestamp_t timer_now(void)
+{
+    return m_now;
+}
+
+extern "C" void timer_start(timestamp_t timestamp, timer_callback_t cb)
+{
+    (void) cb;
+    m_sink = timestamp;
+}
+
+extern "C" void timer_stop(void)
+{
+}
+
+extern "C" bearer_event_flag_t bearer_event_flag_add(bearer_event_flag_callback_t callback)
+{
+    (void) callback;
+    return 0;
+}
+
+extern "C" void bearer_event_flag_set(bearer_event_flag_t flag)
+{
+    (void) flag;
+}
+
+int main()
+{
+    for (uint32_t pending : {8u, 32u, static_cast<uint32_t>(TIMER_SCH_EVENTS_MAX)})
+    {
+        run({"heap", timer_sch_init, timer_sch_schedule, timer_sch_abort}, pending);
+        run({"linear", linear_timer_sch_init, linear_timer_sch_schedule, linear_timer_sch_abort}, pending);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form, except as embedded into a Nordic
+#    Semiconductor ASA integrated circuit in a product or a software update for
+#    such product, must reproduce the above copyright notice, this list of
+#    conditions and the following disclaimer in the documentation and/or other
+#    materials provided with the distribution.
+#
+# 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+#    contributors may be used to endorse or promote products derived from this
+#    software without specific prior written permission.
+#
+# 4. This software, with or without modification, must only be used with a
+#    Nordic Semiconductor ASA integrated circuit.
+#
+# 5. Any software provided in binary form under this license must not be reverse
+#    engineered, decompiled, modified and/or disassembled.
+#
+# THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+# OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+# OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Generates the fixed-base comb table of src/p256_comb.c, and the known-answer vectors of
+ut_p256_comb.c with --vectors.
+
+The arithmetic here is plain affine P-256 on Python integers, independent of the C code.
+
+    python3 gen_p256_comb_table.py > ../src/p256_comb_table.c
+"""
+
+import random
+import sys
+
+P = 2**256 - 2**224 + 2**192 + 2**96 - 1
+N = 0xFFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551
+B = 0x5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B
+G = (0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296,
+     0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5)
+R = 2**256
+
+TEETH = 4
+SPACING = 64
+
+
+def point_add(p1, p2):
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    if p1[0] == p2[0]:
+        if (p1[1] + p2[1]) % P == 0:
+            return None
+        slope = (3 * p1[0] * p1[0] - 3) * pow(2 * p1[1], -1, P) % P
+    else:
+        slope = (p2[1] - p1[1]) * pow(p2[0] - p1[0], -1, P) % P
+    x = (slope * slope - p1[0] - p2[0]) % P
+    return (x, (slope * (p1[0] - x) - p1[1]) % P)
+
+
+def point_mult(k, point):
+    result = None
+    while k:
+        if k & 1:
+            result = point_add(result, point)
+        point = point_add(point, point)
+        k >>= 1
+    return result
+
+
+def words(value):
+    return ", ".join("0x%08X" % ((value >> (32 * i)) & 0xFFFFFFFF) for i in range(8))
+
+
+def license_comment():
+    """Returns the license header of this script as a C comment."""
+    lines = []
+    for line in open(__file__).read().splitlines()[1:]:
+        if not line.startswith("#"):
+            break
+        lines.append((" *" + line[1:]).rstrip())
+    lines[0] = "/*" + lines[0][2:]
+    lines.append(" */")
+    return "\n".join(lines) + "\n"
+
+
+def table_print(out):
+    assert (G[1] ** 2 - G[0] ** 3 + 3 * G[0] - B) % P == 0
+    assert point_mult(N, G) is None
+
+    out.write(license_comment() + "\n")
+    out.write("/* Fixed-base comb table of src/p256_comb.c. Generated by test/gen_p256_comb_table.py, do not\n"
+              " * edit. Entry i is the sum of 2^(%d j) G over the set bits j of i, in affine coordinates in the\n"
+              " * Montgomery domain (x 2^256 mod p), as little-endian 32-bit words. Entry 0 stands for the\n"
+              " * point at infinity. */\n\n" % SPACING)
+    out.write('#include "p256_comb.h"\n\n#include <stdint.h>\n\n')
+    out.write("const uint32_t p256_comb_table[P256_COMB_TABLE_SIZE][2][8] =\n{\n")
+    for i in range(2 ** TEETH):
+        point = None
+        for j in range(TEETH):
+            if (i >> j) & 1:
+                point = point_add(point, point_mult(2 ** (SPACING * j), G))
+        x, y = (0, 1) if point is None else point
+        out.write("    {{%s},\n     {%s}},\n" % (words(x * R % P), words(y * R % P)))
+    out.write("};\n")
+
+
+def vectors_print(out):
+    rng = random.Random(256)
+    keys = [1, 2, 3, N - 1, N - 2, 2**64, 2**128 + 1, 2**255,
+            0xC9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721]
+    keys += [rng.randrange(1, N) for _ in range(8)]
+    for k in keys:
+        x, y = point_mult(k, G)
+        out.write('    {"%064X",\n     "%064X%064X"},\n' % (k, x, y))
+
+
+if __name__ == "__main__":
+    if "--vectors" in sys.argv:
+        vectors_print(sys.stdout)
+    else:
+        table_print(sys.stdout)
@@ -0,0 +1,94 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "linear_replay_cache.h"
+
+#include <stddef.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh_config_core.h"
+
+typedef struct
+{
+    uint16_t src;
+    uint32_t seqno;
+    uint32_t iv_index;
+} entry_t;
+
+static entry_t m_entries[REPLAY_CACHE_ENTRIES];
+static uint32_t m_count;
+
+static entry_t * entry_find(uint16_t src)
+{
+    for (uint32_t i = 0; i < m_count; ++i)
+    {
+        if (m_entries[i].src == src)
+        {
+            return &m_entries[i];
+        }
+    }
+    return NULL;
+}
+
+void linear_replay_cache_clear(void)
+{
+    m_count = 0;
+}
+
+uint32_t linear_replay_cache_add(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    entry_t * p_entry = entry_find(src);
+    if (p_entry == NULL)
+    {
+        if (m_count == REPLAY_CACHE_ENTRIES)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+        p_entry = &m_entries[m_count++];
+        p_entry->src = src;
+    }
+    p_entry->seqno = seqno;
+    p_entry->iv_index = iv_index;
+    return NRF_SUCCESS;
+}
+
+bool linear_replay_cache_has_elem(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    const entry_t * p_entry = entry_find(src);
+    return (p_entry != NULL &&
+            (iv_index < p_entry->iv_index || (iv_index == p_entry->iv_index && seqno <= p_entry->seqno)));
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "linear_timer_scheduler.h"
+
+#include <stddef.h>
+
+static timer_event_t * mp_head;
+
+void linear_timer_sch_init(void)
+{
+    mp_head = NULL;
+}
+
+void linear_timer_sch_schedule(timer_event_t * p_timer_evt)
+{
+    timer_event_t ** pp_item = &mp_head;
+    while (*pp_item != NULL && (int32_t) ((*pp_item)->timestamp - p_timer_evt->timestamp) <= 0)
+    {
+        pp_item = &(*pp_item)->p_next;
+    }
+    p_timer_evt->p_next = *pp_item;
+    *pp_item = p_timer_evt;
+    p_timer_evt->state = TIMER_EVENT_STATE_QUEUED;
+}
+
+void linear_timer_sch_abort(timer_event_t * p_timer_evt)
+{
+    for (timer_event_t ** pp_item = &mp_head; *pp_item != NULL; pp_item = &(*pp_item)->p_next)
+    {
+        if (*pp_item == p_timer_evt)
+        {
+            *pp_item = p_timer_evt->p_next;
+            break;
+        }
+    }
+    p_timer_evt->state = TIMER_EVENT_STATE_UNUSED;
+}
@@ -0,0 +1,67 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SIM_BEARER_H__
+#define SIM_BEARER_H__
+
+#include <stdint.h>
+
+#include "test_assert.h"
+
+/* Advertising bearer of the host simulations, with the stack defaults. sim_mesh.c schedules every
+ * advertising event with these timings; tests that only need the delay of a message use
+ * sim_bearer_hop_delay_us(). */
+
+/* A full network PDU in an advertising packet is 47 bytes on air at 1 Mbit/s. */
+#define PDU_AIRTIME_US          (376)
+#define CHANNEL_SWITCH_US       (150)
+#define ADV_CHANNELS            (3)
+#define ADV_EVENT_US            (ADV_CHANNELS * PDU_AIRTIME_US + (ADV_CHANNELS - 1) * CHANNEL_SWITCH_US)
+#define ADV_INTERVAL_US         (20000)
+#define ADV_DELAY_MAX_US        (10000)
+#define SCAN_INTERVAL_US        (2000000)
+
+/* Time from queueing a PDU at an idle advertiser until a neighbour has received it: the random
+ * advertising delay, then the packet on the advertising channel the neighbour scans. */
+static inline uint32_t sim_bearer_hop_delay_us(unsigned * p_rand_state)
+{
+    uint32_t channel = test_rand(p_rand_state) % ADV_CHANNELS;
+    return test_rand(p_rand_state) % ADV_DELAY_MAX_US + channel * (PDU_AIRTIME_US + CHANNEL_SWITCH_US) +
+           PDU_AIRTIME_US;
+}
+
+#endif /* SIM_BEARER_H__ */
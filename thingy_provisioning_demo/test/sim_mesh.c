@@ -0,0 +1,987 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host simulation of a network of N nodes running the application of main.c, to see how the
+ * firmware behaves at a scale that cannot be put on a bench.
+ *
+ * Every node has the two elements of the application, a Generic OnOff server and a Generic
+ * OnOff client, and all of them relay. A switch press sends 1 + APP_UNACK_MSG_REPEAT_COUNT
+ * unacknowledged Sets to the group all servers subscribe to, and a server whose state changes
+ * may publish a Status. The mesh core is modelled after the stack as configured in
+ * nrf_mesh_config_app.h: TTL ACCESS_DEFAULT_TTL, a network message cache of
+ * MSG_CACHE_ENTRY_COUNT entries evicted oldest first when it is full, and one transmission per PDU
+ * for originated and relayed packets. It is built with the sizing profile whose cache is checked,
+ * see the Makefile.
+ *
+ * As in the core TX layer, a node has one advertiser for the packets it originates, one for the
+ * packets it relays and one for its secure network beacon, sent every BEACON_INTERVAL_US. Each
+ * has a bounded TX queue and sends every PDU in an advertising event on the three advertising
+ * channels, at least its interval after its previous event plus a random delay. The advertisers
+ * of a node share its radio, one event at a time. Beacons are not relayed. Scanners
+ * listen all the time and hop channel every SCAN_INTERVAL_US. The mesh only gets the radio in
+ * timeslots: the SoftDevice periodically takes it for the BLE advertising of the Thingy, and a
+ * node does not receive while it is transmitting. A reception depends on the distance (log
+ * distance path loss with fixed shadowing per link, soft threshold around the sensitivity) and
+ * on collisions: a packet overlapping another on the same channel at the receiver is lost
+ * unless it is CAPTURE_DB stronger.
+ *
+ * Scenarios, each run for several network sizes and random placements:
+ * - single_press: one switch press, the baseline latency of the network.
+ * - all_press: one node in SWITCH_FRACTION presses its switch within PRESS_SPREAD_US.
+ * - all_press_status: the same, with every server publishing a Status when its state changes.
+ * - periodic_press: the all_press burst every POLICY_ROUND_US, long enough for the relay policy
+ *   of relay_policy.c to decide and hold its state, with the policy disabled as by default.
+ * - periodic_press_policy: the same with the relay policy enabled. Every node evaluates windows of
+ *   RELAY_POLICY_WINDOW_MS plus jitter, counting duplicate checks and hits of its message cache,
+ *   and suppresses relaying with the probability and hold time of relay_policy.c. Suppressed
+ *   relay transmissions are dropped as in the core TX allocation wrapper of tx_priority.c.
+ * - press_under_load: the nodes publish Statuses at LOAD_PDUS_PER_S in total, which keeps the
+ *   relay advertisers busy, while one node in SWITCH_FRACTION presses its switch at a random time,
+ *   without the relay yield of tx_priority.c.
+ * - press_under_load_yield: the same with the relay yield: a press slows the relay advertiser of
+ *   its node to TX_PRIORITY_RELAY_YIELD_INTERVAL_MS for TX_PRIORITY_YIELD_MAX_MS, unless the node
+ *   yielded less than TX_PRIORITY_RELAY_GUARD_MS before. The new interval applies from the next
+ *   relay advertising event.
+ *
+ * One JSON object is printed per scenario and network size:
+ * - delivery: fraction of (press, other node) pairs where the press reached the server.
+ * - latency_*_ms: percentiles of the time from the press to its delivery at a server.
+ * - duration_ms: time from the first press or load Status until the network is quiet again,
+ *   beacons aside.
+ * - app_msgs_per_s: deliveries per second of the duration, the application throughput.
+ * - airtime_pct: share of the duration each advertising channel carries a mesh PDU, summed over
+ *   all transmitters, so it exceeds 100 when packets overlap.
+ * - collisions, half_duplex: receptions lost to another packet on the channel, or because the
+ *   receiver was transmitting itself, counted per receiver.
+ * - relays, queue_drops, cache_misses: relayed PDUs, PDUs dropped on a full TX queue, and copies
+ *   that arrived after their message cache entry was evicted and were relayed again.
+ * - relays_suppressed, policy_changes: relay transmissions dropped by the relay policy, and relay
+ *   state changes made by the policy.
+ * - cache_depth_max: the most PDUs a node cached after a PDU before the last copy of that PDU
+ *   arrived, the message cache size a flood needs. There must be no cache misses for the
+ *   network sizes of the profile, up to MESH_APP_TARGET_NODE_COUNT nodes.
+ * - *_delay_avg_ms, *_delay_max_ms: queue delays per traffic class of tx_priority.h, until the
+ *   end of the advertising event: interactive from the press to the first Set of the press,
+ *   relay and background (beacons) from the time the PDU is queued.
+ * - relay_yields, relay_yields_refused: relay yields, and yields refused by the starvation guard.
+ *
+ * The simulation checks its invariants, so it also runs with the unit tests.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "nrf_mesh_config_app.h"
+#include "relay_policy.h"
+#include "tx_priority.h"
+#include "sim_bearer.h"
+#include "test_assert.h"
+
+/* Radio propagation, indoor. */
+#define TX_POWER_DBM            (0.0)
+#define PATH_LOSS_1M_DB         (40.0)
+#define PATH_LOSS_EXPONENT      (3.0)
+#define SHADOWING_SIGMA_DB      (4.0)
+#define SENSITIVITY_DBM         (-90.0)
+/* Width of the transition from no reception to reception around the sensitivity. */
+#define SENSITIVITY_SLOPE_DB    (1.5)
+#define CAPTURE_DB              (6.0)
+/* Mean distance between neighbouring nodes, the area grows with the number of nodes. */
+#define NODE_SPACING_M          (5.0)
+
+/* Advertising bearer, see sim_bearer.h. */
+#define TX_QUEUE_SIZE           (16)
+/* Secure network beacon interval of the stack, a beacon is 22 bytes of payload. */
+#define BEACON_INTERVAL_US      (10000000)
+#define BEACON_AIRTIME_US       (264)
+/* SoftDevice advertising of the Thingy, APP_ADV_INTERVAL_MS in thingy_config.h, and the radio
+ * time it takes per event including the timeslot overhead. */
+#define SD_INTERVAL_US          (380000)
+#define SD_EVENT_US             (3000)
+
+/* Application, see button_event_handler() in main.c. */
+#define MESSAGES_PER_PRESS      (3)
+#define SWITCH_FRACTION         (4)
+#define PRESS_SPREAD_US         (10000)
+#define PRESS_START_US          (1000000)
+/* Relay policy scenarios. */
+#define POLICY_ROUND_US         (10000000)
+#define POLICY_ROUNDS           (12)
+/* Relay load scenarios: Status publications per second in the network, for LOAD_DURATION_US.
+ * The presses are kept LOAD_RAMP_US away from the start and the end of the load. */
+#define LOAD_PDUS_PER_S         (20)
+#define LOAD_DURATION_US        (10000000)
+#define LOAD_RAMP_US            (2000000)
+
+#define SIM_RUNS                (3)
+#define NODES_MAX               (200)
+/* Presses of all runs of a scenario. */
+#define PRESSES_MAX             (SIM_RUNS * POLICY_ROUNDS * NODES_MAX / SWITCH_FRACTION)
+#define PDUS_MAX                (2048)
+#define TX_LOG_SIZE             (8192)
+#define EVENTS_MAX              (16384)
+#define TIME_NEVER              (UINT64_MAX)
+#define PDU_BEACON              (UINT16_MAX)
+
+typedef enum
+{
+    SCENARIO_SINGLE_PRESS,
+    SCENARIO_ALL_PRESS,
+    SCENARIO_ALL_PRESS_STATUS,
+    SCENARIO_PERIODIC_PRESS,
+    SCENARIO_PERIODIC_PRESS_POLICY,
+    SCENARIO_PRESS_UNDER_LOAD,
+    SCENARIO_PRESS_UNDER_LOAD_YIELD,
+} scenario_t;
+
+typedef enum
+{
+    PDU_SET,
+    PDU_STATUS,
+} pdu_type_t;
+
+typedef struct
+{
+    pdu_type_t type;
+    uint16_t src;
+    uint16_t press;
+    bool value;
+} pdu_t;
+
+/* Advertisers of a node. */
+typedef enum
+{
+    ADV_ORIGINATOR,
+    ADV_RELAY,
+    ADV_BEACON,
+    ADV_COUNT
+} adv_role_t;
+
+typedef struct
+{
+    uint64_t queued_us;
+    uint16_t pdu;
+    uint8_t ttl;
+    /* The first Set of a press, whose delay is the interactive one. */
+    bool interactive;
+} tx_entry_t;
+
+typedef struct
+{
+    tx_entry_t queue[TX_QUEUE_SIZE];
+    uint32_t queue_head;
+    uint32_t queue_count;
+    bool pending;
+    uint64_t last_us;
+    uint32_t interval_us;
+} advertiser_t;
+
+typedef struct
+{
+    double x;
+    double y;
+    uint32_t scan_phase_us;
+    uint32_t sd_phase_us;
+    advertiser_t adv[ADV_COUNT];
+    uint64_t radio_busy_until_us;
+    uint32_t cache_inserts;
+    bool switch_value;
+    bool state;
+    /* Relay policy: message cache lookups and hits in the current window, and the relay state. */
+    uint32_t window_lookups;
+    uint32_t window_hits;
+    bool suppressing;
+    bool changed_before;
+    uint64_t last_change_us;
+    /* Relay yield of tx_priority.c. */
+    bool yielding;
+    bool yielded_before;
+    uint64_t yield_end_us;
+} node_t;
+
+typedef struct
+{
+    uint64_t created_us;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint16_t node;
+    uint16_t pdu;
+    uint8_t ttl;
+    uint8_t channel;
+} tx_t;
+
+typedef enum
+{
+    EVENT_PRESS,
+    EVENT_ADV,
+    EVENT_TX_END,
+    EVENT_POLICY_WINDOW,
+    EVENT_LOAD,
+    EVENT_BEACON,
+    EVENT_YIELD_END,
+} event_type_t;
+
+typedef struct
+{
+    uint64_t time_us;
+    uint32_t order;
+    event_type_t type;
+    uint32_t arg;
+} event_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t max_us;
+} delay_stats_t;
+
+typedef struct
+{
+    uint32_t presses;
+    uint32_t pairs;
+    uint32_t delivered;
+    uint32_t status_pairs;
+    uint32_t status_delivered;
+    uint32_t latency_count;
+    uint64_t duration_us;
+    uint64_t airtime_us;
+    uint32_t pdus;
+    uint32_t relays;
+    uint32_t collisions;
+    uint32_t half_duplex;
+    uint32_t queue_drops;
+    uint32_t cache_misses;
+    uint32_t cache_depth_max;
+    uint32_t relays_suppressed;
+    uint32_t policy_changes;
+    delay_stats_t delay[TX_PRIORITY_CLASS_COUNT];
+    uint32_t relay_yields;
+    uint32_t relay_yields_refused;
+} sim_stats_t;
+
+static const char * const m_scenario_names[] = {"single_press", "all_press", "all_press_status", "periodic_press",
+                                                "periodic_press_policy", "press_under_load", "press_under_load_yield"};
+
+static scenario_t m_scenario;
+static uint32_t m_node_count;
+static node_t m_nodes[NODES_MAX];
+static float m_rssi[NODES_MAX][NODES_MAX];
+static pdu_t m_pdus[PDUS_MAX];
+static uint32_t m_pdu_count;
+/* Message cache of each node: whether a PDU was inserted, and the node's insertion count then. */
+static bool m_seen[NODES_MAX][PDUS_MAX];
+static uint32_t m_seen_insert[NODES_MAX][PDUS_MAX];
+static uint64_t m_press_us[PRESSES_MAX];
+static bool m_press_delivered[PRESSES_MAX][NODES_MAX];
+static tx_t m_tx_log[TX_LOG_SIZE];
+static uint32_t m_tx_count;
+static event_t m_events[EVENTS_MAX];
+static uint32_t m_event_count;
+static uint32_t m_event_order;
+static uint64_t m_now;
+static uint64_t m_run_end_us;
+static uint64_t m_last_traffic_us;
+static unsigned m_rand_state;
+static sim_stats_t m_stats;
+static float m_latencies_ms[PRESSES_MAX * NODES_MAX];
+
+static double rand_uniform(void)
+{
+    return (test_rand(&m_rand_state) + 0.5) / 4294967296.0;
+}
+
+static double rand_normal(void)
+{
+    return sqrt(-2.0 * log(rand_uniform())) * cos(2.0 * M_PI * rand_uniform());
+}
+
+static bool event_before(const event_t * p_a, const event_t * p_b)
+{
+    return (p_a->time_us < p_b->time_us || (p_a->time_us == p_b->time_us && p_a->order < p_b->order));
+}
+
+static void event_push(uint64_t time_us, event_type_t type, uint32_t arg)
+{
+    TEST_ASSERT(m_event_count < EVENTS_MAX);
+    uint32_t i = m_event_count++;
+    event_t event = {time_us, m_event_order++, type, arg};
+    while (i > 0 && event_before(&event, &m_events[(i - 1) / 2]))
+    {
+        m_events[i] = m_events[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    m_events[i] = event;
+}
+
+static event_t event_pop(void)
+{
+    event_t top = m_events[0];
+    event_t last = m_events[--m_event_count];
+    uint32_t i = 0;
+    for (;;)
+    {
+        uint32_t child = 2 * i + 1;
+        if (child >= m_event_count)
+        {
+            break;
+        }
+        if (child + 1 < m_event_count && event_before(&m_events[child + 1], &m_events[child]))
+        {
+            child++;
+        }
+        if (!event_before(&m_events[child], &last))
+        {
+            break;
+        }
+        m_events[i] = m_events[child];
+        i = child;
+    }
+    m_events[i] = last;
+    return top;
+}
+
+static uint32_t scan_channel(const node_t * p_node, uint64_t time_us)
+{
+    return ((time_us + p_node->scan_phase_us) / SCAN_INTERVAL_US) % ADV_CHANNELS;
+}
+
+/* Returns the first time at or after time_us when the node has the radio for duration_us. */
+static uint64_t radio_free_get(const node_t * p_node, uint64_t time_us, uint32_t duration_us)
+{
+    uint32_t offset = (time_us + p_node->sd_phase_us) % SD_INTERVAL_US;
+    if (offset < SD_EVENT_US)
+    {
+        return time_us + (SD_EVENT_US - offset);
+    }
+    if (offset + duration_us > SD_INTERVAL_US)
+    {
+        return time_us + (SD_INTERVAL_US - offset) + SD_EVENT_US;
+    }
+    return time_us;
+}
+
+static void adv_schedule(uint32_t node, adv_role_t role)
+{
+    advertiser_t * p_adv = &m_nodes[node].adv[role];
+    uint64_t time_us = p_adv->last_us + p_adv->interval_us;
+    if (time_us < m_now)
+    {
+        time_us = m_now;
+    }
+    event_push(time_us + test_rand(&m_rand_state) % ADV_DELAY_MAX_US, EVENT_ADV, node * ADV_COUNT + role);
+    p_adv->pending = true;
+}
+
+static void tx_enqueue(uint32_t node, adv_role_t role, uint32_t pdu, uint8_t ttl, bool interactive)
+{
+    advertiser_t * p_adv = &m_nodes[node].adv[role];
+    if (p_adv->queue_count == TX_QUEUE_SIZE)
+    {
+        m_stats.queue_drops++;
+        return;
+    }
+    tx_entry_t * p_entry = &p_adv->queue[(p_adv->queue_head + p_adv->queue_count++) % TX_QUEUE_SIZE];
+    p_entry->queued_us = m_now;
+    p_entry->pdu = (uint16_t) pdu;
+    p_entry->ttl = ttl;
+    p_entry->interactive = interactive;
+    if (!p_adv->pending)
+    {
+        adv_schedule(node, role);
+    }
+}
+
+static void delay_add(tx_priority_class_t tx_class, uint64_t delay_us)
+{
+    delay_stats_t * p_delay = &m_stats.delay[tx_class];
+    p_delay->count++;
+    p_delay->sum_us += delay_us;
+    if (delay_us > p_delay->max_us)
+    {
+        p_delay->max_us = (uint32_t) delay_us;
+    }
+}
+
+static void pdu_originate(uint32_t node, pdu_type_t type, uint32_t press, bool value, bool interactive)
+{
+    TEST_ASSERT(m_pdu_count < PDUS_MAX);
+    pdu_t * p_pdu = &m_pdus[m_pdu_count];
+    p_pdu->type = type;
+    p_pdu->src = (uint16_t) node;
+    p_pdu->press = (uint16_t) press;
+    p_pdu->value = value;
+    m_stats.pdus++;
+    tx_enqueue(node, ADV_ORIGINATOR, m_pdu_count++, ACCESS_DEFAULT_TTL, interactive);
+}
+
+static void server_set_handle(uint32_t node, const pdu_t * p_pdu)
+{
+    /* The server drops the repeats of a press by their TID. */
+    if (m_press_delivered[p_pdu->press][node])
+    {
+        return;
+    }
+    m_press_delivered[p_pdu->press][node] = true;
+    m_stats.delivered++;
+    m_latencies_ms[m_stats.latency_count++] = (float) (m_now - m_press_us[p_pdu->press]) / 1000.0f;
+
+    node_t * p_node = &m_nodes[node];
+    if (p_node->state != p_pdu->value)
+    {
+        p_node->state = p_pdu->value;
+        if (m_scenario == SCENARIO_ALL_PRESS_STATUS)
+        {
+            pdu_originate(node, PDU_STATUS, 0, p_node->state, false);
+            m_stats.status_pairs += m_node_count - 1;
+        }
+    }
+}
+
+static void network_receive(uint32_t node, uint32_t pdu, uint8_t ttl)
+{
+    const pdu_t * p_pdu = &m_pdus[pdu];
+    node_t * p_node = &m_nodes[node];
+    if (p_pdu->src == node)
+    {
+        return;
+    }
+
+    bool seen = m_seen[node][pdu];
+    p_node->window_lookups++;
+    if (seen)
+    {
+        uint32_t depth = p_node->cache_inserts - m_seen_insert[node][pdu];
+        if (depth > m_stats.cache_depth_max)
+        {
+            m_stats.cache_depth_max = depth;
+        }
+        if (depth < MSG_CACHE_ENTRY_COUNT)
+        {
+            p_node->window_hits++;
+            return;
+        }
+    }
+    m_seen[node][pdu] = true;
+    m_seen_insert[node][pdu] = p_node->cache_inserts++;
+
+    if (seen)
+    {
+        /* Relayed again, but dropped by the replay protection before the access layer. */
+        m_stats.cache_misses++;
+    }
+    else if (p_pdu->type == PDU_SET)
+    {
+        server_set_handle(node, p_pdu);
+    }
+    else
+    {
+        m_stats.status_delivered++;
+    }
+
+    if (ttl >= 2)
+    {
+        if (p_node->suppressing)
+        {
+            m_stats.relays_suppressed++;
+        }
+        else
+        {
+            m_stats.relays++;
+            tx_enqueue(node, ADV_RELAY, pdu, ttl - 1, false);
+        }
+    }
+}
+
+static void policy_window_schedule(uint32_t node)
+{
+    uint64_t time_us = m_now + RELAY_POLICY_WINDOW_MS * 1000ull +
+                       test_rand(&m_rand_state) % (RELAY_POLICY_JITTER_MS * 1000);
+    if (time_us < m_run_end_us)
+    {
+        event_push(time_us, EVENT_POLICY_WINDOW, node);
+    }
+}
+
+/* window_timeout_handler() of relay_policy.c. */
+static void policy_window_handle(uint32_t node)
+{
+    node_t * p_node = &m_nodes[node];
+    uint32_t fresh = p_node->window_lookups - p_node->window_hits;
+    if (fresh >= RELAY_POLICY_MIN_PDUS)
+    {
+        uint32_t copies_x16 = (p_node->window_lookups * 16) / fresh;
+        bool suppress = false;
+        if (copies_x16 >= RELAY_POLICY_COPY_THRESHOLD * 16)
+        {
+            uint32_t keep = (RELAY_POLICY_COPY_THRESHOLD * 16 * 256) / copies_x16;
+            suppress = (test_rand(&m_rand_state) % 256 >= keep);
+        }
+        if (suppress != p_node->suppressing &&
+            (!p_node->changed_before || m_now - p_node->last_change_us >= RELAY_POLICY_HOLD_MS * 1000ull))
+        {
+            p_node->suppressing = suppress;
+            p_node->changed_before = true;
+            p_node->last_change_us = m_now;
+            m_stats.policy_changes++;
+        }
+    }
+    p_node->window_lookups = 0;
+    p_node->window_hits = 0;
+    policy_window_schedule(node);
+}
+
+/* tx_priority_interactive_begin() of tx_priority.c, for a relay interval below the yield one. */
+static void interactive_begin(uint32_t node)
+{
+    node_t * p_node = &m_nodes[node];
+    if (p_node->yielding)
+    {
+        return;
+    }
+    if (p_node->yielded_before && m_now - p_node->yield_end_us < TX_PRIORITY_RELAY_GUARD_MS * 1000ull)
+    {
+        m_stats.relay_yields_refused++;
+        return;
+    }
+    p_node->adv[ADV_RELAY].interval_us = TX_PRIORITY_RELAY_YIELD_INTERVAL_MS * 1000;
+    p_node->yielding = true;
+    p_node->yielded_before = true;
+    m_stats.relay_yields++;
+    event_push(m_now + TX_PRIORITY_YIELD_MAX_MS * 1000ull, EVENT_YIELD_END, node);
+}
+
+/* yield_timeout_handler() of tx_priority.c. */
+static void yield_end_handle(uint32_t node)
+{
+    node_t * p_node = &m_nodes[node];
+    p_node->adv[ADV_RELAY].interval_us = ADV_INTERVAL_US;
+    p_node->yielding = false;
+    p_node->yield_end_us = m_now;
+}
+
+static void press_handle(uint32_t node)
+{
+    node_t * p_node = &m_nodes[node];
+    TEST_ASSERT(m_stats.presses < PRESSES_MAX);
+    uint32_t press = m_stats.presses++;
+    m_press_us[press] = m_now;
+    m_stats.pairs += m_node_count - 1;
+    p_node->switch_value = !p_node->switch_value;
+
+    /* The local server element gets the Set through the access layer loopback. */
+    m_press_delivered[press][node] = true;
+    p_node->state = p_node->switch_value;
+    if (m_scenario == SCENARIO_PRESS_UNDER_LOAD_YIELD)
+    {
+        interactive_begin(node);
+    }
+    for (uint32_t i = 0; i < MESSAGES_PER_PRESS; ++i)
+    {
+        pdu_originate(node, PDU_SET, press, p_node->switch_value, i == 0);
+    }
+}
+
+static void load_handle(uint32_t node)
+{
+    node_t * p_node = &m_nodes[node];
+    pdu_originate(node, PDU_STATUS, 0, p_node->state, false);
+    m_stats.status_pairs += m_node_count - 1;
+
+    uint64_t period_us = 1000000ull * m_node_count / LOAD_PDUS_PER_S;
+    uint64_t time_us = m_now + test_rand(&m_rand_state) % (2 * period_us);
+    if (time_us < m_run_end_us)
+    {
+        event_push(time_us, EVENT_LOAD, node);
+    }
+}
+
+static void beacon_handle(uint32_t node)
+{
+    tx_enqueue(node, ADV_BEACON, PDU_BEACON, 0, false);
+    if (m_now + BEACON_INTERVAL_US < m_run_end_us)
+    {
+        event_push(m_now + BEACON_INTERVAL_US, EVENT_BEACON, node);
+    }
+}
+
+static void adv_handle(uint32_t arg)
+{
+    uint32_t node = arg / ADV_COUNT;
+    adv_role_t role = (adv_role_t) (arg % ADV_COUNT);
+    node_t * p_node = &m_nodes[node];
+    advertiser_t * p_adv = &p_node->adv[role];
+    uint32_t airtime_us = (role == ADV_BEACON) ? BEACON_AIRTIME_US : PDU_AIRTIME_US;
+    uint32_t event_us = ADV_CHANNELS * airtime_us + (ADV_CHANNELS - 1) * CHANNEL_SWITCH_US;
+
+    /* Wait for the SoftDevice and for an event of another advertiser of the node. */
+    uint64_t start_us = m_now;
+    if (start_us < p_node->radio_busy_until_us)
+    {
+        start_us = p_node->radio_busy_until_us;
+    }
+    start_us = radio_free_get(p_node, start_us, event_us);
+    if (start_us != m_now)
+    {
+        event_push(start_us, EVENT_ADV, arg);
+        return;
+    }
+
+    tx_entry_t entry = p_adv->queue[p_adv->queue_head];
+    p_adv->queue_head = (p_adv->queue_head + 1) % TX_QUEUE_SIZE;
+    p_adv->queue_count--;
+    for (uint32_t channel = 0; channel < ADV_CHANNELS; ++channel)
+    {
+        tx_t * p_tx = &m_tx_log[m_tx_count % TX_LOG_SIZE];
+        p_tx->created_us = m_now;
+        p_tx->start_us = m_now + channel * (airtime_us + CHANNEL_SWITCH_US);
+        p_tx->end_us = p_tx->start_us + airtime_us;
+        p_tx->node = (uint16_t) node;
+        p_tx->pdu = entry.pdu;
+        p_tx->ttl = entry.ttl;
+        p_tx->channel = (uint8_t) channel;
+        event_push(p_tx->end_us, EVENT_TX_END, m_tx_count++);
+    }
+    p_node->radio_busy_until_us = m_now + event_us;
+
+    /* TX complete at the end of the advertising event. */
+    if (role == ADV_RELAY)
+    {
+        delay_add(TX_PRIORITY_CLASS_RELAY, m_now + event_us - entry.queued_us);
+    }
+    else if (role == ADV_BEACON)
+    {
+        delay_add(TX_PRIORITY_CLASS_BACKGROUND, m_now + event_us - entry.queued_us);
+    }
+    else if (entry.interactive)
+    {
+        delay_add(TX_PRIORITY_CLASS_INTERACTIVE, m_now + event_us - m_press_us[m_pdus[entry.pdu].press]);
+    }
+    if (role != ADV_BEACON)
+    {
+        m_stats.airtime_us += ADV_CHANNELS * airtime_us;
+        m_last_traffic_us = m_now + event_us;
+    }
+
+    p_adv->last_us = m_now;
+    p_adv->pending = false;
+    if (p_adv->queue_count > 0)
+    {
+        adv_schedule(node, role);
+    }
+}
+
+static void tx_end_handle(uint32_t tx_index)
+{
+    TEST_ASSERT(m_tx_count - tx_index <= TX_LOG_SIZE);
+    const tx_t * p_tx = &m_tx_log[tx_index % TX_LOG_SIZE];
+    if (p_tx->pdu == PDU_BEACON)
+    {
+        /* Only interference for the mesh traffic. */
+        return;
+    }
+
+    /* Transmissions overlapping this one. Log entries are in creation order, and an overlapping
+     * transmission was created at most one advertising event before this one started. */
+    static const tx_t * p_overlaps[4 * NODES_MAX];
+    uint32_t overlap_count = 0;
+    for (uint32_t i = m_tx_count; i-- > 0 && m_tx_count - i <= TX_LOG_SIZE;)
+    {
+        const tx_t * p_other = &m_tx_log[i % TX_LOG_SIZE];
+        if (p_other->created_us + ADV_EVENT_US + PDU_AIRTIME_US < p_tx->start_us)
+        {
+            break;
+        }
+        if (i != tx_index && p_other->start_us < p_tx->end_us && p_other->end_us > p_tx->start_us)
+        {
+            TEST_ASSERT(overlap_count < sizeof(p_overlaps) / sizeof(p_overlaps[0]));
+            p_overlaps[overlap_count++] = p_other;
+        }
+    }
+
+    for (uint32_t node = 0; node < m_node_count; ++node)
+    {
+        const node_t * p_node = &m_nodes[node];
+        double rssi = m_rssi[p_tx->node][node];
+        if (node == p_tx->node || rssi < SENSITIVITY_DBM - 6 * SENSITIVITY_SLOPE_DB ||
+            scan_channel(p_node, p_tx->start_us) != p_tx->channel ||
+            scan_channel(p_node, p_tx->end_us) != p_tx->channel ||
+            radio_free_get(p_node, p_tx->start_us, PDU_AIRTIME_US) != p_tx->start_us)
+        {
+            continue;
+        }
+        if (rand_uniform() * (1.0 + exp(-(rssi - SENSITIVITY_DBM) / SENSITIVITY_SLOPE_DB)) > 1.0)
+        {
+            continue;
+        }
+
+        bool lost = false;
+        for (uint32_t i = 0; i < overlap_count && !lost; ++i)
+        {
+            if (p_overlaps[i]->node == node)
+            {
+                m_stats.half_duplex++;
+                lost = true;
+            }
+            else if (p_overlaps[i]->channel == p_tx->channel &&
+                     rssi - m_rssi[p_overlaps[i]->node][node] < CAPTURE_DB)
+            {
+                m_stats.collisions++;
+                lost = true;
+            }
+        }
+        if (!lost)
+        {
+            network_receive(node, p_tx->pdu, p_tx->ttl);
+        }
+    }
+}
+
+static void network_setup(uint32_t node_count)
+{
+    double side_m = NODE_SPACING_M * sqrt((double) node_count);
+    m_node_count = node_count;
+    memset(m_nodes, 0, sizeof(m_nodes));
+    TEST_ASSERT(node_count <= NODES_MAX);
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        m_nodes[i].x = rand_uniform() * side_m;
+        m_nodes[i].y = rand_uniform() * side_m;
+        m_nodes[i].scan_phase_us = test_rand(&m_rand_state) % (ADV_CHANNELS * SCAN_INTERVAL_US);
+        m_nodes[i].sd_phase_us = test_rand(&m_rand_state) % SD_INTERVAL_US;
+        for (uint32_t role = 0; role < ADV_COUNT; ++role)
+        {
+            m_nodes[i].adv[role].interval_us = ADV_INTERVAL_US;
+        }
+    }
+    for (uint32_t i = 0; i < node_count; ++i)
+    {
+        for (uint32_t j = i + 1; j < node_count; ++j)
+        {
+            double distance_m = hypot(m_nodes[i].x - m_nodes[j].x, m_nodes[i].y - m_nodes[j].y);
+            if (distance_m < 1.0)
+            {
+                distance_m = 1.0;
+            }
+            double rssi = TX_POWER_DBM - PATH_LOSS_1M_DB - 10.0 * PATH_LOSS_EXPONENT * log10(distance_m) +
+                          SHADOWING_SIGMA_DB * rand_normal();
+            m_rssi[i][j] = (float) rssi;
+            m_rssi[j][i] = (float) rssi;
+        }
+    }
+
+    m_pdu_count = 0;
+    memset(m_seen, 0, sizeof(m_seen));
+    memset(m_press_delivered, 0, sizeof(m_press_delivered));
+    m_tx_count = 0;
+    m_event_count = 0;
+    m_now = 0;
+    m_last_traffic_us = 0;
+}
+
+static void run(scenario_t scenario, uint32_t node_count)
+{
+    m_scenario = scenario;
+    network_setup(node_count);
+
+    bool periodic = (scenario == SCENARIO_PERIODIC_PRESS || scenario == SCENARIO_PERIODIC_PRESS_POLICY);
+    bool load = (scenario == SCENARIO_PRESS_UNDER_LOAD || scenario == SCENARIO_PRESS_UNDER_LOAD_YIELD);
+    uint32_t rounds = periodic ? POLICY_ROUNDS : 1;
+    m_run_end_us = PRESS_START_US + (load ? LOAD_DURATION_US : rounds * POLICY_ROUND_US);
+    if (load)
+    {
+        uint64_t period_us = 1000000ull * node_count / LOAD_PDUS_PER_S;
+        for (uint32_t node = 0; node < node_count; ++node)
+        {
+            event_push(PRESS_START_US + test_rand(&m_rand_state) % period_us, EVENT_LOAD, node);
+            if (node % SWITCH_FRACTION == 0)
+            {
+                event_push(PRESS_START_US + LOAD_RAMP_US +
+                           test_rand(&m_rand_state) % (LOAD_DURATION_US - 2 * LOAD_RAMP_US),
+                           EVENT_PRESS, node);
+            }
+        }
+    }
+    else
+    {
+        for (uint32_t round = 0; round < rounds; ++round)
+        {
+            for (uint32_t node = 0; node < node_count; node += SWITCH_FRACTION)
+            {
+                event_push(PRESS_START_US + round * POLICY_ROUND_US + test_rand(&m_rand_state) % PRESS_SPREAD_US,
+                           EVENT_PRESS, node);
+                if (scenario == SCENARIO_SINGLE_PRESS)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    for (uint32_t node = 0; node < node_count; ++node)
+    {
+        event_push(test_rand(&m_rand_state) % BEACON_INTERVAL_US, EVENT_BEACON, node);
+    }
+    if (scenario == SCENARIO_PERIODIC_PRESS_POLICY)
+    {
+        for (uint32_t node = 0; node < node_count; ++node)
+        {
+            policy_window_schedule(node);
+        }
+    }
+
+    uint64_t first_us = TIME_NEVER;
+    while (m_event_count > 0)
+    {
+        event_t event = event_pop();
+        TEST_ASSERT(event.time_us >= m_now);
+        m_now = event.time_us;
+        switch (event.type)
+        {
+            case EVENT_PRESS:
+                if (first_us == TIME_NEVER)
+                {
+                    first_us = m_now;
+                }
+                press_handle(event.arg);
+                break;
+            case EVENT_ADV:
+                adv_handle(event.arg);
+                break;
+            case EVENT_TX_END:
+                tx_end_handle(event.arg);
+                break;
+            case EVENT_POLICY_WINDOW:
+                policy_window_handle(event.arg);
+                break;
+            case EVENT_LOAD:
+                if (first_us == TIME_NEVER)
+                {
+                    first_us = m_now;
+                }
+                load_handle(event.arg);
+                break;
+            case EVENT_BEACON:
+                beacon_handle(event.arg);
+                break;
+            case EVENT_YIELD_END:
+                yield_end_handle(event.arg);
+                break;
+        }
+    }
+    /* Until the network is quiet again, beacons aside. */
+    m_stats.duration_us += m_last_traffic_us - first_us;
+}
+
+static int latency_compare(const void * p_a, const void * p_b)
+{
+    float a = *(const float *) p_a;
+    float b = *(const float *) p_b;
+    return (a > b) - (a < b);
+}
+
+static float latency_percentile(uint32_t percent)
+{
+    if (m_stats.latency_count == 0)
+    {
+        return 0.0f;
+    }
+    return m_latencies_ms[(m_stats.latency_count - 1) * percent / 100];
+}
+
+static double delay_avg_ms(tx_priority_class_t tx_class)
+{
+    const delay_stats_t * p_delay = &m_stats.delay[tx_class];
+    return p_delay->count ? p_delay->sum_us / 1000.0 / p_delay->count : 0.0;
+}
+
+static void scenario_run(scenario_t scenario, uint32_t node_count)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_rand_state = 2463534242u + node_count;
+    for (uint32_t i = 0; i < SIM_RUNS; ++i)
+    {
+        run(scenario, node_count);
+    }
+
+    /* Every PDU is relayed at most once per node, or again after it left the message cache. */
+    TEST_ASSERT(m_stats.relays <= m_stats.pdus * (node_count - 1) + m_stats.cache_misses);
+    TEST_ASSERT(m_stats.delivered <= m_stats.pairs);
+    TEST_ASSERT(m_stats.status_delivered <= m_stats.status_pairs);
+    /* The message cache of the profile holds every flood of its network size. */
+    TEST_ASSERT(node_count > MESH_APP_TARGET_NODE_COUNT || m_stats.cache_misses == 0);
+
+    qsort(m_latencies_ms, m_stats.latency_count, sizeof(m_latencies_ms[0]), latency_compare);
+    double duration_s = m_stats.duration_us / 1e6;
+    printf("{\"sim\": \"mesh\", \"scenario\": \"%s\", \"nodes\": %u, \"runs\": %u, \"presses\": %u, "
+           "\"delivery\": %.3f, \"status_delivery\": %.3f, \"latency_p50_ms\": %.1f, \"latency_p90_ms\": %.1f, "
+           "\"latency_p99_ms\": %.1f, \"latency_max_ms\": %.1f, \"duration_ms\": %.0f, \"app_msgs_per_s\": %.0f, "
+           "\"airtime_pct\": %.1f, \"pdus\": %u, \"relays\": %u, \"collisions\": %u, \"half_duplex\": %u, "
+           "\"queue_drops\": %u, \"cache_entries\": %u, \"cache_misses\": %u, \"cache_depth_max\": %u, "
+           "\"relays_suppressed\": %u, \"policy_changes\": %u, \"interactive_delay_avg_ms\": %.1f, "
+           "\"interactive_delay_max_ms\": %.1f, \"relay_delay_avg_ms\": %.1f, \"relay_delay_max_ms\": %.1f, "
+           "\"background_delay_avg_ms\": %.1f, \"background_delay_max_ms\": %.1f, \"relay_yields\": %u, "
+           "\"relay_yields_refused\": %u}\n",
+           m_scenario_names[scenario], node_count, SIM_RUNS, m_stats.presses,
+           (double) m_stats.delivered / m_stats.pairs,
+           m_stats.status_pairs ? (double) m_stats.status_delivered / m_stats.status_pairs : 0.0,
+           latency_percentile(50), latency_percentile(90), latency_percentile(99), latency_percentile(100),
+           duration_s * 1000.0 / SIM_RUNS, m_stats.delivered / duration_s,
+           100.0 * m_stats.airtime_us / ADV_CHANNELS / m_stats.duration_us,
+           m_stats.pdus, m_stats.relays, m_stats.collisions, m_stats.half_duplex,
+           m_stats.queue_drops, MSG_CACHE_ENTRY_COUNT, m_stats.cache_misses, m_stats.cache_depth_max,
+           m_stats.relays_suppressed, m_stats.policy_changes,
+           delay_avg_ms(TX_PRIORITY_CLASS_INTERACTIVE), m_stats.delay[TX_PRIORITY_CLASS_INTERACTIVE].max_us / 1000.0,
+           delay_avg_ms(TX_PRIORITY_CLASS_RELAY), m_stats.delay[TX_PRIORITY_CLASS_RELAY].max_us / 1000.0,
+           delay_avg_ms(TX_PRIORITY_CLASS_BACKGROUND), m_stats.delay[TX_PRIORITY_CLASS_BACKGROUND].max_us / 1000.0,
+           m_stats.relay_yields, m_stats.relay_yields_refused);
+}
+
+int main(void)
+{
+    static const uint32_t node_counts[] = {50, 100, 200};
+    for (uint32_t scenario = SCENARIO_SINGLE_PRESS; scenario <= SCENARIO_PRESS_UNDER_LOAD_YIELD; ++scenario)
+    {
+        for (uint32_t i = 0; i < sizeof(node_counts) / sizeof(node_counts[0]); ++i)
+        {
+            scenario_run((scenario_t) scenario, node_counts[i]);
+        }
+    }
+    return 0;
+}
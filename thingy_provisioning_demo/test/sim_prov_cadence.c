@@ -0,0 +1,382 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host simulation of the unprovisioned advertising cadence of prov_cadence.h, to see what it costs
+ * in discovery time and what it saves in channel load as the number of unprovisioned devices
+ * grows.
+ *
+ * A cart of devices is powered up within POWER_UP_SPREAD_US and waits for a provisioner that
+ * starts scanning some time later. Every device follows one of two schedules:
+ * - stock: listening all the time, as the mesh stack does on its own.
+ * - cadence: the schedule of prov_cadence.c, continuous listening for PROV_CADENCE_FAST_MS, then
+ *   windows of PROV_CADENCE_WINDOW_MS separated by gaps that start at PROV_CADENCE_GAP_MIN_MS and
+ *   double up to PROV_CADENCE_GAP_MAX_MS, with up to a quarter of the gap of random jitter.
+ *
+ * While listening, a device sends an unprovisioned beacon (PB-ADV) every BEACON_INTERVAL_US and a
+ * connectable PB-GATT advertisement every GATT_ADV_INTERVAL_US, each as an advertising event on
+ * the three advertising channels with a random delay of up to ADV_DELAY_MAX_US. Both restart with
+ * a random phase when a listening window opens. The provisioner scans all the time and hops
+ * channel every SCAN_INTERVAL_US. A packet it scans is lost when it overlaps another packet on
+ * the same channel, and otherwise with a probability of LOSS_PER_MILLE. Times and air times are
+ * model assumptions, not measurements.
+ *
+ * One JSON object is printed per schedule, number of devices and scan start:
+ * - channel_load: share of time each advertising channel carries a packet over the
+ *   LOAD_WINDOW_US after the scan start, summed over all devices.
+ * - pb_adv_ms_avg, pb_adv_ms_all: time from the scan start until the provisioner hears a beacon
+ *   of a device, on average over the devices heard, and until every device has been heard (null
+ *   if some were not heard within HORIZON_US).
+ * - pb_adv_unheard: share of the devices whose beacons were not heard within HORIZON_US.
+ * - pb_gatt_ms_avg, pb_gatt_ms_all, pb_gatt_unheard: the same for the PB-GATT advertisements, as a
+ *   phone sees them.
+ * - collisions: share of the scanned packets lost to collisions.
+ *
+ * The simulation checks that every device is heard on both bearers within HORIZON_US, and that the
+ * cadence lowers the channel load once the devices have left the fast phase, so it also runs with
+ * the unit tests.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prov_cadence.h"
+#include "test_assert.h"
+
+/* Advertising bearer. The beacon interval is the unprovisioned beacon interval of the stack, the
+ * PB-GATT interval the default advertising interval of the GATT bearer. Air times at 1 Mbps: a 21
+ * byte beacon and a 29 byte PB-GATT advertisement, with the header, address, preamble, access
+ * address and CRC. */
+#define BEACON_INTERVAL_US      (2000000)
+#define GATT_ADV_INTERVAL_US    (100000)
+#define ADV_DELAY_MAX_US        (10000)
+#define BEACON_AIR_US           (296)
+#define GATT_ADV_AIR_US         (360)
+/* Time from the start of a packet on one channel to the start of the packet on the next. */
+#define CHANNEL_SWITCH_US       (150)
+#define CHANNEL_COUNT           (3)
+
+#define SCAN_INTERVAL_US        (100000)
+/* Probability that a packet is lost without a collision, out of 1000. */
+#define LOSS_PER_MILLE          (100)
+
+#define POWER_UP_SPREAD_US      (500000)
+#define LOAD_WINDOW_US          (30000000)
+/* Time simulated after the scan start. Long enough for the largest gap to pass several times. */
+#define HORIZON_US              (120000000)
+
+#define SIM_RUNS                (20)
+#define DEVICES_MAX             (200)
+#define TIME_NEVER              (UINT64_MAX)
+
+typedef enum
+{
+    SCHEDULE_STOCK,
+    SCHEDULE_CADENCE,
+} schedule_t;
+
+typedef enum
+{
+    PACKET_BEACON,
+    PACKET_GATT,
+} packet_kind_t;
+
+typedef struct
+{
+    uint64_t start_us;
+    uint16_t device;
+    uint8_t kind;
+    bool collided;
+} packet_t;
+
+typedef struct
+{
+    packet_t * p_packets;
+    uint32_t count;
+    uint32_t size;
+} channel_t;
+
+typedef struct
+{
+    uint64_t sum_us;
+    uint64_t all_us;
+    uint32_t heard;
+    uint32_t unheard;
+} discovery_t;
+
+typedef struct
+{
+    double channel_load;
+    discovery_t discovery[2];
+    uint64_t scanned;
+    uint64_t collisions;
+} stats_t;
+
+static channel_t m_channels[CHANNEL_COUNT];
+static unsigned m_rng;
+
+static uint32_t air_us(uint8_t kind)
+{
+    return kind == PACKET_BEACON ? BEACON_AIR_US : GATT_ADV_AIR_US;
+}
+
+static void packet_add(uint32_t channel, uint64_t start_us, uint16_t device, packet_kind_t kind)
+{
+    channel_t * p_channel = &m_channels[channel];
+    if (p_channel->count == p_channel->size)
+    {
+        p_channel->size = p_channel->size ? p_channel->size * 2 : 4096;
+        p_channel->p_packets = realloc(p_channel->p_packets, p_channel->size * sizeof(packet_t));
+        TEST_ASSERT(p_channel->p_packets != NULL);
+    }
+    p_channel->p_packets[p_channel->count++] = (packet_t) {.start_us = start_us, .device = device, .kind = (uint8_t) kind};
+}
+
+/** Sends the advertising events of one kind for a device listening from start_us to end_us. */
+static void events_add(uint16_t device, packet_kind_t kind, uint64_t start_us, uint64_t end_us)
+{
+    uint32_t interval = kind == PACKET_BEACON ? BEACON_INTERVAL_US : GATT_ADV_INTERVAL_US;
+    uint64_t t = start_us + test_rand(&m_rng) % interval;
+    while (t < end_us)
+    {
+        for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+        {
+            packet_add(channel, t + channel * (air_us(kind) + CHANNEL_SWITCH_US), device, kind);
+        }
+        t += interval + test_rand(&m_rng) % (ADV_DELAY_MAX_US + 1);
+    }
+}
+
+/** Listening of a device from power_up_us to end_us, following the schedule. */
+static void device_add(uint16_t device, schedule_t schedule, uint64_t power_up_us, uint64_t end_us)
+{
+    if (schedule == SCHEDULE_STOCK)
+    {
+        events_add(device, PACKET_BEACON, power_up_us, end_us);
+        events_add(device, PACKET_GATT, power_up_us, end_us);
+        return;
+    }
+
+    /* Replays the steps of prov_cadence.c. */
+    uint64_t window_start = power_up_us;
+    uint64_t window_end = power_up_us + PROV_CADENCE_FAST_MS * 1000ull;
+    uint32_t gap_ms = 0;
+    while (window_start < end_us)
+    {
+        uint64_t listen_end = window_end < end_us ? window_end : end_us;
+        events_add(device, PACKET_BEACON, window_start, listen_end);
+        events_add(device, PACKET_GATT, window_start, listen_end);
+
+        gap_ms = (gap_ms == 0) ? PROV_CADENCE_GAP_MIN_MS : gap_ms * 2;
+        if (gap_ms > PROV_CADENCE_GAP_MAX_MS)
+        {
+            gap_ms = PROV_CADENCE_GAP_MAX_MS;
+        }
+        uint16_t jitter = (uint16_t) test_rand(&m_rng);
+        window_start = window_end + (gap_ms + jitter % (gap_ms / 4 + 1)) * 1000ull;
+        window_end = window_start + PROV_CADENCE_WINDOW_MS * 1000ull;
+    }
+}
+
+static int compare_packets(const void * p_a, const void * p_b)
+{
+    uint64_t a = ((const packet_t *) p_a)->start_us;
+    uint64_t b = ((const packet_t *) p_b)->start_us;
+    return (a > b) - (a < b);
+}
+
+/** Marks every packet that overlaps another on its channel. */
+static void collisions_mark(channel_t * p_channel)
+{
+    qsort(p_channel->p_packets, p_channel->count, sizeof(packet_t), compare_packets);
+
+    uint64_t busy_until = 0;
+    uint32_t busy_index = 0;
+    for (uint32_t i = 0; i < p_channel->count; ++i)
+    {
+        packet_t * p_packet = &p_channel->p_packets[i];
+        if (i > 0 && p_packet->start_us < busy_until)
+        {
+            p_packet->collided = true;
+            p_channel->p_packets[busy_index].collided = true;
+        }
+        uint64_t end = p_packet->start_us + air_us(p_packet->kind);
+        if (end > busy_until)
+        {
+            busy_until = end;
+            busy_index = i;
+        }
+    }
+}
+
+static void run(schedule_t schedule, uint32_t device_count, uint64_t scan_start_us, stats_t * p_stats)
+{
+    static uint64_t heard_us[DEVICES_MAX][2];
+    uint64_t end_us = scan_start_us + HORIZON_US;
+
+    for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+    {
+        m_channels[channel].count = 0;
+    }
+    for (uint16_t device = 0; device < device_count; ++device)
+    {
+        device_add(device, schedule, test_rand(&m_rng) % POWER_UP_SPREAD_US, end_us);
+        heard_us[device][PACKET_BEACON] = TIME_NEVER;
+        heard_us[device][PACKET_GATT] = TIME_NEVER;
+    }
+
+    uint64_t busy_us = 0;
+    for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+    {
+        channel_t * p_channel = &m_channels[channel];
+        collisions_mark(p_channel);
+
+        for (uint32_t i = 0; i < p_channel->count; ++i)
+        {
+            const packet_t * p_packet = &p_channel->p_packets[i];
+            if (p_packet->start_us >= scan_start_us && p_packet->start_us < scan_start_us + LOAD_WINDOW_US)
+            {
+                busy_us += air_us(p_packet->kind);
+            }
+            if (p_packet->start_us < scan_start_us ||
+                (p_packet->start_us / SCAN_INTERVAL_US) % CHANNEL_COUNT != channel)
+            {
+                continue;
+            }
+
+            p_stats->scanned++;
+            if (p_packet->collided)
+            {
+                p_stats->collisions++;
+                continue;
+            }
+            if (test_rand(&m_rng) % 1000 < LOSS_PER_MILLE)
+            {
+                continue;
+            }
+            uint64_t * p_heard = &heard_us[p_packet->device][p_packet->kind];
+            if (p_packet->start_us < *p_heard)
+            {
+                *p_heard = p_packet->start_us;
+            }
+        }
+    }
+    p_stats->channel_load += (double) busy_us / CHANNEL_COUNT / LOAD_WINDOW_US;
+
+    for (uint32_t kind = PACKET_BEACON; kind <= PACKET_GATT; ++kind)
+    {
+        discovery_t * p_discovery = &p_stats->discovery[kind];
+        uint64_t all = 0;
+        for (uint32_t device = 0; device < device_count; ++device)
+        {
+            if (heard_us[device][kind] == TIME_NEVER)
+            {
+                p_discovery->unheard++;
+                continue;
+            }
+            uint64_t delay = heard_us[device][kind] - scan_start_us;
+            p_discovery->sum_us += delay;
+            p_discovery->heard++;
+            all = delay > all ? delay : all;
+        }
+        p_discovery->all_us += all;
+        TEST_ASSERT_EQUAL(0, p_discovery->unheard);
+    }
+}
+
+/** Prints the discovery fields of a bearer. */
+static void discovery_print(const char * p_name, const discovery_t * p_discovery)
+{
+    printf("\"%s_ms_avg\": %.0f, ", p_name, p_discovery->heard ? p_discovery->sum_us / (p_discovery->heard * 1000.0) : 0.0);
+    if (p_discovery->unheard == 0)
+    {
+        printf("\"%s_ms_all\": %.0f, ", p_name, p_discovery->all_us / (SIM_RUNS * 1000.0));
+    }
+    else
+    {
+        printf("\"%s_ms_all\": null, ", p_name);
+    }
+    printf("\"%s_unheard\": %.3f, ", p_name,
+           (double) p_discovery->unheard / (p_discovery->heard + p_discovery->unheard));
+}
+
+static double config_run(schedule_t schedule, uint32_t device_count, uint32_t scan_start_s)
+{
+    stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    m_rng = 0xCADE0000u + device_count * 7 + scan_start_s;
+    for (uint32_t r = 0; r < SIM_RUNS; ++r)
+    {
+        run(schedule, device_count, scan_start_s * 1000000ull, &stats);
+    }
+
+    printf("{\"sim\": \"prov_cadence\", \"schedule\": \"%s\", \"nodes\": %u, \"scan_start_s\": %u, \"runs\": %u, "
+           "\"channel_load\": %.3f, ",
+           schedule == SCHEDULE_STOCK ? "stock" : "cadence", device_count, scan_start_s, SIM_RUNS,
+           stats.channel_load / SIM_RUNS);
+    discovery_print("pb_adv", &stats.discovery[PACKET_BEACON]);
+    discovery_print("pb_gatt", &stats.discovery[PACKET_GATT]);
+    printf("\"collisions\": %.3f}\n", (double) stats.collisions / stats.scanned);
+    return stats.channel_load / SIM_RUNS;
+}
+
+int main(void)
+{
+    static const uint32_t device_counts[] = {10, 25, 50, 100, 200};
+    /* Scanning together with the power-up, and a minute later, when the cadence is in its gaps. */
+    static const uint32_t scan_starts_s[] = {0, 60};
+
+    for (uint32_t s = 0; s < sizeof(scan_starts_s) / sizeof(scan_starts_s[0]); ++s)
+    {
+        for (uint32_t d = 0; d < sizeof(device_counts) / sizeof(device_counts[0]); ++d)
+        {
+            double stock = config_run(SCHEDULE_STOCK, device_counts[d], scan_starts_s[s]);
+            double cadence = config_run(SCHEDULE_CADENCE, device_counts[d], scan_starts_s[s]);
+            if (scan_starts_s[s] * 1000 > PROV_CADENCE_FAST_MS)
+            {
+                TEST_ASSERT(cadence < stock);
+            }
+        }
+    }
+
+    for (uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+    {
+        free(m_channels[channel].p_packets);
+    }
+    return 0;
+}
@@ -0,0 +1,425 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host stand-in for a factory provisioner, to measure how many nodes per minute can be provisioned
+ * with the factory static OOB of src/factory_oob.c compared to the blink output OOB, which needs
+ * an operator to count the blinks of every node.
+ *
+ * The devices on a cart are powered up together. Each one derives its static OOB data with
+ * factory_oob_static_data_get() from a UICR secret and its device UUID, and follows the listening
+ * cadence of prov_cadence.h: continuous listening for PROV_CADENCE_FAST_MS, then windows of
+ * PROV_CADENCE_WINDOW_MS separated by growing gaps. While listening it sends an unprovisioned
+ * beacon every BEACON_INTERVAL_MS. The provisioner has a number of PB-ADV links. A free link
+ * takes the next device it hears, derives the device's static OOB data from the secret and the
+ * UUID of the beacon, and runs the provisioning protocol:
+ *
+ *   link open, invite, capabilities, start, public keys, ECDH, [output OOB], confirmations,
+ *   randoms, provisioning data, complete
+ *
+ * Every PDU is sent as a PB-ADV transaction of one or more segments, acknowledged by the peer,
+ * and retransmitted after TRANSACTION_RETRY_MS when a segment or the acknowledgement is lost.
+ * With output OOB the device blinks a number of 1 to 9 (output size 1; larger sizes only make the
+ * step longer), and the single operator counts the blinks and types the number, one device at a
+ * time: a link holds its Start PDU until the operator is free, so the blinks are not missed. Times are model assumptions, not measurements; the point is the ratio between the modes
+ * and how it scales with the number of links.
+ *
+ * One JSON object is printed per OOB method, number of links and number of devices:
+ * - nodes_per_min: devices provisioned per minute, from power-up until the last one is done.
+ * - node_ms_p50, node_ms_max: time from link open to provisioning complete per device.
+ * - discovery_ms_avg: time a free link waited to hear a device.
+ * - operator_wait_ms_avg: time a link waited for the operator to be free (output OOB only).
+ * - retransmissions: PB-ADV transactions sent again, per device.
+ *
+ * The simulation checks that every device is provisioned once and that the static OOB data the
+ * provisioner derives matches the device's own and differs between devices, so it also runs with
+ * the unit tests.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "factory_oob.h"
+#include "prov_cadence.h"
+#include "aes_cmac.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_mesh_configure.h"
+#include "nrf_mesh_defines.h"
+#include "test_assert.h"
+
+/* PB-ADV bearer. Unprovisioned beacon interval of the stack, airtime of one advertising event of
+ * a segment including the advertiser interval, and the transaction retransmission timeout. */
+#define BEACON_INTERVAL_MS      (2000)
+#define SEGMENT_MS              (30)
+#define TRANSACTION_RETRY_MS    (500)
+/* Probability that a packet is lost, out of 1000, on a cart of devices in a factory. */
+#define LOSS_PER_MILLE          (100)
+/* Payload of the first and following segments of a PB-ADV transaction. */
+#define SEGMENT_FIRST_BYTES     (20)
+#define SEGMENT_NEXT_BYTES      (23)
+
+/* Processing. The device only computes the ECDH shared secret, its key pair is generated before
+ * it listens. The provisioner is a phone or PC. */
+#define DEVICE_ECDH_MS          (120)
+#define PROVISIONER_ECDH_MS     (10)
+#define DEVICE_DATA_STORE_MS    (50)
+
+/* Blink output OOB, see provisioning_blink_output_cb() in main.c: a pause, then one blink of 500
+ * ms on and 500 ms off per count. The operator reads the count and types it in. */
+#define BLINK_START_MS          (300)
+#define BLINK_MS                (1000)
+#define BLINK_COUNT_MAX         (9)
+#define OPERATOR_ENTRY_MS       (3000)
+
+#define SIM_RUNS                (3)
+#define DEVICES_MAX             (100)
+#define LINKS_MAX               (8)
+#define TIME_NEVER              (UINT32_MAX)
+
+typedef enum
+{
+    OOB_BLINK,
+    OOB_FACTORY_STATIC,
+} oob_method_t;
+
+typedef struct
+{
+    uint8_t uuid[NRF_MESH_UUID_SIZE];
+    uint8_t static_data[NRF_MESH_KEY_SIZE];
+    uint32_t beacon_phase_ms;
+    uint32_t jitter_seed;
+    bool claimed;
+    bool provisioned;
+} device_t;
+
+typedef struct
+{
+    uint32_t retransmissions;
+    uint64_t discovery_ms;
+    uint64_t operator_wait_ms;
+    uint32_t node_ms[DEVICES_MAX * SIM_RUNS];
+    uint32_t node_count;
+} stats_t;
+
+NRF_UICR_Type nrf_uicr_stub;
+
+static const uint8_t m_factory_secret[NRF_MESH_KEY_SIZE] =
+    {0x4E, 0x6F, 0x72, 0x64, 0x69, 0x63, 0x20, 0x66, 0x61, 0x63, 0x74, 0x6F, 0x72, 0x79, 0x21, 0x00};
+
+static device_t m_devices[DEVICES_MAX];
+static const device_t * mp_current_device;
+static unsigned m_rng;
+
+const uint8_t * nrf_mesh_configure_device_uuid_get(void)
+{
+    return mp_current_device->uuid;
+}
+
+static bool packet_lost(void)
+{
+    return test_rand(&m_rng) % 1000 < LOSS_PER_MILLE;
+}
+
+/** Start of the listening window of device that contains t or follows it, TIME_NEVER if none. */
+static uint32_t window_find(const device_t * p_device, uint32_t t, uint32_t * p_end)
+{
+    if (t < PROV_CADENCE_FAST_MS)
+    {
+        *p_end = PROV_CADENCE_FAST_MS;
+        return 0;
+    }
+
+    /* Replays the backoff of prov_cadence.c with the device's own jitter sequence. */
+    unsigned jitter_state = p_device->jitter_seed;
+    uint32_t window_start = PROV_CADENCE_FAST_MS;
+    uint32_t gap = PROV_CADENCE_GAP_MIN_MS;
+    for (;;)
+    {
+        uint32_t jitter = test_rand(&jitter_state) % (gap / 4 + 1);
+        window_start += gap + jitter;
+        uint32_t window_end = window_start + PROV_CADENCE_WINDOW_MS;
+        if (t < window_end)
+        {
+            *p_end = window_end;
+            return window_start;
+        }
+        if (window_start > UINT32_MAX / 2)
+        {
+            return TIME_NEVER;
+        }
+        gap = (gap * 2 > PROV_CADENCE_GAP_MAX_MS) ? PROV_CADENCE_GAP_MAX_MS : gap * 2;
+    }
+}
+
+/** Time the provisioner first hears a beacon of the device at or after t. */
+static uint32_t device_heard(const device_t * p_device, uint32_t t)
+{
+    for (;;)
+    {
+        uint32_t end;
+        uint32_t start = window_find(p_device, t, &end);
+        TEST_ASSERT(start != TIME_NEVER);
+
+        /* Beacons restart with listening, offset by the device's phase. */
+        uint32_t beacon = start + p_device->beacon_phase_ms;
+        if (beacon < t)
+        {
+            beacon += ((t - beacon + BEACON_INTERVAL_MS - 1) / BEACON_INTERVAL_MS) * BEACON_INTERVAL_MS;
+        }
+        for (; beacon < end; beacon += BEACON_INTERVAL_MS)
+        {
+            if (!packet_lost())
+            {
+                return beacon;
+            }
+        }
+        t = end;
+    }
+}
+
+/** Duration of one acknowledged PB-ADV transaction of length bytes, with retransmissions. */
+static uint32_t transaction_ms(uint32_t length, stats_t * p_stats)
+{
+    uint32_t segments = 1;
+    if (length > SEGMENT_FIRST_BYTES)
+    {
+        segments += (length - SEGMENT_FIRST_BYTES + SEGMENT_NEXT_BYTES - 1) / SEGMENT_NEXT_BYTES;
+    }
+
+    uint32_t elapsed = 0;
+    for (;;)
+    {
+        bool lost = false;
+        for (uint32_t i = 0; i < segments + 1; ++i)
+        {
+            lost |= packet_lost();
+        }
+        if (!lost)
+        {
+            return elapsed + (segments + 1) * SEGMENT_MS;
+        }
+        elapsed += TRANSACTION_RETRY_MS;
+        p_stats->retransmissions++;
+    }
+}
+
+static int compare_u32(const void * p_a, const void * p_b)
+{
+    uint32_t a = *(const uint32_t *) p_a;
+    uint32_t b = *(const uint32_t *) p_b;
+    return (a > b) - (a < b);
+}
+
+static void devices_create(uint32_t count)
+{
+    memset(m_devices, 0, sizeof(m_devices));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        device_t * p_device = &m_devices[i];
+        for (uint32_t j = 0; j < NRF_MESH_UUID_SIZE; ++j)
+        {
+            p_device->uuid[j] = (uint8_t) test_rand(&m_rng);
+        }
+        p_device->beacon_phase_ms = test_rand(&m_rng) % BEACON_INTERVAL_MS;
+        p_device->jitter_seed = test_rand(&m_rng) | 1;
+
+        /* The device side: the secret is in UICR, the UUID comes from the stack. */
+        memcpy(nrf_uicr_stub.CUSTOMER, m_factory_secret, sizeof(m_factory_secret));
+        mp_current_device = p_device;
+        TEST_ASSERT(factory_oob_available());
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, factory_oob_static_data_get(p_device->static_data));
+    }
+}
+
+/** Provisions device, starting at t on a link. Returns the time it is done. */
+static uint32_t provision(const device_t * p_device, oob_method_t oob, uint32_t t, uint32_t * p_operator_free,
+                          stats_t * p_stats)
+{
+    /* The provisioner side: derive the static OOB data from the beacon UUID. */
+    uint8_t static_data[NRF_MESH_KEY_SIZE];
+    aes_cmac(m_factory_secret, p_device->uuid, NRF_MESH_UUID_SIZE, static_data);
+    TEST_ASSERT(memcmp(static_data, p_device->static_data, sizeof(static_data)) == 0);
+
+    uint32_t start = t;
+    t += transaction_ms(16, p_stats);     /* Link open, UUID. */
+    t += transaction_ms(2, p_stats);      /* Invite. */
+    t += transaction_ms(12, p_stats);     /* Capabilities. */
+    if (oob == OOB_BLINK && *p_operator_free > t)
+    {
+        p_stats->operator_wait_ms += *p_operator_free - t;
+        t = *p_operator_free;
+    }
+    t += transaction_ms(6, p_stats);      /* Start. */
+    t += transaction_ms(65, p_stats);     /* Provisioner public key. */
+    t += transaction_ms(65, p_stats);     /* Device public key. */
+    t += DEVICE_ECDH_MS + PROVISIONER_ECDH_MS;
+
+    if (oob == OOB_BLINK)
+    {
+        uint32_t count = 1 + test_rand(&m_rng) % BLINK_COUNT_MAX;
+        t += BLINK_START_MS + count * BLINK_MS + OPERATOR_ENTRY_MS;
+        *p_operator_free = t;
+    }
+
+    t += transaction_ms(17, p_stats);     /* Provisioner confirmation. */
+    t += transaction_ms(17, p_stats);     /* Device confirmation. */
+    t += transaction_ms(17, p_stats);     /* Provisioner random. */
+    t += transaction_ms(17, p_stats);     /* Device random. */
+    t += transaction_ms(34, p_stats);     /* Provisioning data. */
+    t += DEVICE_DATA_STORE_MS;
+    t += transaction_ms(1, p_stats);      /* Complete. */
+
+    p_stats->node_ms[p_stats->node_count++] = t - start;
+    return t;
+}
+
+/** Provisions all devices, returns the time the last one is done. */
+static uint32_t run(oob_method_t oob, uint32_t links, uint32_t device_count, stats_t * p_stats)
+{
+    uint32_t link_free[LINKS_MAX] = {0};
+    uint32_t operator_free = 0;
+    uint32_t end = 0;
+
+    devices_create(device_count);
+    for (uint32_t done = 0; done < device_count; ++done)
+    {
+        /* The link that becomes free first takes the first unclaimed device it hears. */
+        uint32_t link = 0;
+        for (uint32_t l = 1; l < links; ++l)
+        {
+            if (link_free[l] < link_free[link])
+            {
+                link = l;
+            }
+        }
+
+        uint32_t t = link_free[link];
+        device_t * p_next = NULL;
+        uint32_t heard_at = TIME_NEVER;
+        for (uint32_t i = 0; i < device_count; ++i)
+        {
+            if (!m_devices[i].claimed)
+            {
+                uint32_t heard = device_heard(&m_devices[i], t);
+                if (heard < heard_at)
+                {
+                    heard_at = heard;
+                    p_next = &m_devices[i];
+                }
+            }
+        }
+        TEST_ASSERT(p_next != NULL);
+
+        p_next->claimed = true;
+        p_stats->discovery_ms += heard_at - t;
+        link_free[link] = provision(p_next, oob, heard_at, &operator_free, p_stats);
+        TEST_ASSERT(!p_next->provisioned);
+        p_next->provisioned = true;
+        if (link_free[link] > end)
+        {
+            end = link_free[link];
+        }
+    }
+
+    for (uint32_t i = 0; i < device_count; ++i)
+    {
+        TEST_ASSERT(m_devices[i].provisioned);
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            TEST_ASSERT(memcmp(m_devices[i].static_data, m_devices[j].static_data, NRF_MESH_KEY_SIZE) != 0);
+        }
+    }
+    return end;
+}
+
+/* RFC 4493 example 2, so the derivation the provisioner and the devices share is AES-CMAC. */
+static void cmac_check(void)
+{
+    static const uint8_t key[16] =
+        {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+    static const uint8_t msg[16] =
+        {0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A};
+    static const uint8_t expected[16] =
+        {0x07, 0x0A, 0x16, 0xB4, 0x6B, 0x4D, 0x41, 0x44, 0xF7, 0x9B, 0xDD, 0x9D, 0xD0, 0x4A, 0x28, 0x7C};
+    uint8_t mac[16];
+    aes_cmac(key, msg, sizeof(msg), mac);
+    TEST_ASSERT(memcmp(expected, mac, sizeof(mac)) == 0);
+}
+
+static void config_run(oob_method_t oob, uint32_t links, uint32_t device_count)
+{
+    static stats_t stats;
+    uint64_t end_sum = 0;
+
+    memset(&stats, 0, sizeof(stats));
+    m_rng = 0x5EED0000u + links * 131 + device_count;
+    for (uint32_t r = 0; r < SIM_RUNS; ++r)
+    {
+        end_sum += run(oob, links, device_count, &stats);
+    }
+    TEST_ASSERT_EQUAL(device_count * SIM_RUNS, stats.node_count);
+
+    qsort(stats.node_ms, stats.node_count, sizeof(stats.node_ms[0]), compare_u32);
+    uint32_t provisioned = device_count * SIM_RUNS;
+    printf("{\"sim\": \"provisioning\", \"oob\": \"%s\", \"links\": %u, \"nodes\": %u, \"runs\": %u, "
+           "\"nodes_per_min\": %.1f, \"node_ms_p50\": %u, \"node_ms_max\": %u, \"discovery_ms_avg\": %.0f, "
+           "\"operator_wait_ms_avg\": %.0f, \"retransmissions\": %.2f}\n",
+           oob == OOB_BLINK ? "blink" : "factory_static", links, device_count, SIM_RUNS,
+           provisioned * 60000.0 / end_sum, stats.node_ms[stats.node_count / 2], stats.node_ms[stats.node_count - 1],
+           (double) stats.discovery_ms / provisioned, (double) stats.operator_wait_ms / provisioned,
+           (double) stats.retransmissions / provisioned);
+}
+
+int main(void)
+{
+    static const uint32_t device_counts[] = {20, 50, 100};
+    static const uint32_t link_counts[] = {1, 4, 8};
+
+    cmac_check();
+    for (uint32_t d = 0; d < sizeof(device_counts) / sizeof(device_counts[0]); ++d)
+    {
+        for (uint32_t l = 0; l < sizeof(link_counts) / sizeof(link_counts[0]); ++l)
+        {
+            config_run(OOB_BLINK, link_counts[l], device_counts[d]);
+            config_run(OOB_FACTORY_STATIC, link_counts[l], device_counts[d]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,232 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host simulation of the network layer sequence number reservation on a fake flash.
+ *
+ * The model follows net_state.c: sequence numbers are handed out from a reserved block, and when
+ * fewer than NETWORK_SEQNUM_FLASH_BLOCK_THRESHOLD remain, the start of the next block is written
+ * to flash. The block is only used once the write has completed. After a power loss the node
+ * resumes from the last stored block start.
+ *
+ * The fake flash is the mesh_config seqnum file: 8 byte records appended to a page, and a full
+ * page is compacted into the other page and erased.
+ *
+ * The switch press traffic, the flash write latency and the power losses are random. The
+ * simulation fails if a sequence number is ever used twice, and prints one JSON object per
+ * configuration with the flash writes and erases per 10,000 messages.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "nrf_mesh_config_app.h"
+#include "test_assert.h"
+
+/* Stack defaults in nrf_mesh_config_core.h, for comparison. */
+#define STACK_SEQNUM_FLASH_BLOCK_SIZE       (8192)
+#define STACK_SEQNUM_FLASH_BLOCK_THRESHOLD  (64)
+/* Block size for a build of switch only nodes, see SEQNUM_CONFIG in nrf_mesh_config_app.h. */
+#define SWITCH_SEQNUM_FLASH_BLOCK_SIZE      (16384)
+
+#define FLASH_PAGE_SIZE         (4096)
+#define FLASH_RECORD_SIZE       (8)
+#define FLASH_RECORDS_PER_PAGE  (FLASH_PAGE_SIZE / FLASH_RECORD_SIZE)
+
+/* Messages per switch press, 1 + APP_UNACK_MSG_REPEAT_COUNT in main.c. */
+#define MESSAGES_PER_PRESS      (3)
+/* Time between the messages of one press, in milliseconds. */
+#define MESSAGE_INTERVAL_MS     (20)
+/* Flash write latency, waiting for a timeslot, in milliseconds. */
+#define FLASH_LATENCY_MS_MIN    (5)
+#define FLASH_LATENCY_MS_MAX    (300)
+
+#define SIM_MESSAGES            (20 * 1000 * 1000)
+/* On average one power loss every this many presses. */
+#define POWER_LOSS_INTERVAL     (50000)
+
+typedef struct
+{
+    uint32_t block_size;
+    uint32_t threshold;
+    const char * p_name;
+} config_t;
+
+typedef struct
+{
+    /* Fake flash */
+    uint32_t stored;
+    uint32_t page_records;
+    uint32_t flash_writes;
+    uint32_t flash_erases;
+
+    /* Network state */
+    uint32_t seqnum;
+    uint32_t max_available;
+    bool write_pending;
+    uint32_t write_value;
+    uint64_t write_done_ms;
+
+    /* Results */
+    uint64_t now_ms;
+    uint32_t messages;
+    uint32_t stalls;
+    uint32_t reboots;
+    uint64_t lost_total;
+    uint32_t lost_max;
+} sim_t;
+
+static unsigned m_rand_state = 0x5eed1234;
+
+static void flash_store(sim_t * p_sim, uint32_t value)
+{
+    if (p_sim->page_records == FLASH_RECORDS_PER_PAGE)
+    {
+        /* Compact the latest record into the other page and erase the full one. */
+        p_sim->flash_writes++;
+        p_sim->flash_erases++;
+        p_sim->page_records = 1;
+    }
+    p_sim->flash_writes++;
+    p_sim->page_records++;
+    p_sim->stored = value;
+}
+
+static void block_request(sim_t * p_sim, const config_t * p_config)
+{
+    p_sim->write_pending = true;
+    p_sim->write_value = p_sim->max_available + p_config->block_size;
+    p_sim->write_done_ms = p_sim->now_ms + FLASH_LATENCY_MS_MIN +
+                           test_rand(&m_rand_state) % (FLASH_LATENCY_MS_MAX - FLASH_LATENCY_MS_MIN);
+}
+
+static void flash_process(sim_t * p_sim)
+{
+    if (p_sim->write_pending && p_sim->now_ms >= p_sim->write_done_ms)
+    {
+        flash_store(p_sim, p_sim->write_value);
+        p_sim->max_available = p_sim->write_value;
+        p_sim->write_pending = false;
+    }
+}
+
+static void power_loss(sim_t * p_sim, const config_t * p_config, uint32_t last_used)
+{
+    /* A write that has not completed is lost with the power. */
+    p_sim->write_pending = false;
+    p_sim->seqnum = p_sim->stored;
+    p_sim->max_available = p_sim->stored;
+    p_sim->reboots++;
+
+    uint32_t lost = p_sim->seqnum - (last_used + 1);
+    p_sim->lost_total += lost;
+    if (lost > p_sim->lost_max)
+    {
+        p_sim->lost_max = lost;
+    }
+    block_request(p_sim, p_config);
+}
+
+static void run(const config_t * p_config)
+{
+    sim_t sim = {0};
+    uint32_t last_used = 0;
+    bool any_used = false;
+
+    /* Provisioning stores the first block. */
+    flash_store(&sim, 0);
+    block_request(&sim, p_config);
+
+    while (sim.messages < SIM_MESSAGES)
+    {
+        /* Idle time between presses, from rapid toggling to a few seconds. */
+        sim.now_ms += 100 + test_rand(&m_rand_state) % 3000;
+
+        for (uint32_t i = 0; i < MESSAGES_PER_PRESS; ++i)
+        {
+            flash_process(&sim);
+            while (sim.seqnum >= sim.max_available)
+            {
+                /* Out of sequence numbers: the message waits for the flash write. */
+                sim.stalls++;
+                sim.now_ms = sim.write_done_ms;
+                flash_process(&sim);
+            }
+
+            TEST_ASSERT(!any_used || sim.seqnum > last_used);
+            last_used = sim.seqnum++;
+            any_used = true;
+            sim.messages++;
+
+            if (!sim.write_pending && sim.max_available - sim.seqnum < p_config->threshold)
+            {
+                block_request(&sim, p_config);
+            }
+            sim.now_ms += MESSAGE_INTERVAL_MS;
+        }
+
+        if (test_rand(&m_rand_state) % POWER_LOSS_INTERVAL == 0)
+        {
+            power_loss(&sim, p_config, last_used);
+        }
+    }
+
+    printf("{\"sim\": \"seqnum\", \"config\": \"%s\", \"block_size\": %u, \"threshold\": %u, "
+           "\"messages\": %u, \"flash_writes_per_10k\": %.3f, \"flash_erases_per_10k\": %.4f, "
+           "\"stalls\": %u, \"reboots\": %u, \"lost_per_reboot_avg\": %.0f, \"lost_per_reboot_max\": %u, "
+           "\"reboots_per_iv_index\": %u}\n",
+           p_config->p_name, p_config->block_size, p_config->threshold, sim.messages,
+           sim.flash_writes * 10000.0 / sim.messages, sim.flash_erases * 10000.0 / sim.messages,
+           sim.stalls, sim.reboots, sim.reboots ? (double) sim.lost_total / sim.reboots : 0.0,
+           sim.lost_max, (1u << 24) / p_config->block_size);
+}
+
+int main(void)
+{
+    static const config_t configs[] =
+    {
+        {STACK_SEQNUM_FLASH_BLOCK_SIZE, STACK_SEQNUM_FLASH_BLOCK_THRESHOLD, "stack_default"},
+        {NETWORK_SEQNUM_FLASH_BLOCK_SIZE, NETWORK_SEQNUM_FLASH_BLOCK_THRESHOLD, "app"},
+        {SWITCH_SEQNUM_FLASH_BLOCK_SIZE, NETWORK_SEQNUM_FLASH_BLOCK_THRESHOLD, "switch_only"},
+    };
+
+    for (uint32_t i = 0; i < sizeof(configs) / sizeof(configs[0]); ++i)
+    {
+        run(&configs[i]);
+    }
+    return 0;
+}
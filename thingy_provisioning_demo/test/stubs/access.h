@@ -0,0 +1,140 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for mesh/access/api/access.h, with the model count of the application
+ * configuration. The functions are defined by the tests. */
+
+#ifndef ACCESS_H__
+#define ACCESS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf_mesh.h"
+#include "nrf_mesh_config_access.h"
+
+/** Access layer handle type. */
+typedef uint16_t access_model_handle_t;
+
+/** Invalid access model handle value. */
+#define ACCESS_HANDLE_INVALID (0xFFFF)
+
+/** Company ID value for Nordic Semiconductor. */
+#define ACCESS_COMPANY_ID_NORDIC (0x0059)
+/** Company ID value for SIG models and opcodes. */
+#define ACCESS_COMPANY_ID_NONE   (0xFFFF)
+
+/** Use the default TTL for a publication. */
+#define ACCESS_TTL_USE_DEFAULT  (0xFF)
+
+/** Access layer opcode. */
+typedef struct
+{
+    uint16_t opcode;
+    uint16_t company_id;
+} access_opcode_t;
+
+/** Access layer model ID. */
+typedef struct
+{
+    uint16_t company_id;
+    uint16_t model_id;
+} access_model_id_t;
+
+#define ACCESS_OPCODE_VENDOR(opcode, company) {(opcode), (company)}
+#define ACCESS_MODEL_VENDOR(id, company) {.company_id = (company), .model_id = (id)}
+
+/** Metadata of a received message. */
+typedef struct
+{
+    nrf_mesh_address_t src;
+    nrf_mesh_address_t dst;
+    uint8_t ttl;
+    uint16_t appkey_handle;
+    uint16_t subnet_handle;
+} access_message_rx_meta_t;
+
+/** Received message. */
+typedef struct
+{
+    access_opcode_t opcode;
+    const uint8_t * p_data;
+    uint16_t length;
+    access_message_rx_meta_t meta_data;
+} access_message_rx_t;
+
+/** Message to send. */
+typedef struct
+{
+    access_opcode_t opcode;
+    const uint8_t * p_buffer;
+    uint16_t length;
+    bool force_segmented;
+    nrf_mesh_transmic_size_t transmic_size;
+    nrf_mesh_tx_token_t access_token;
+} access_message_tx_t;
+
+typedef void (*access_opcode_handler_cb_t)(access_model_handle_t handle,
+                                           const access_message_rx_t * p_message,
+                                           void * p_args);
+
+typedef struct
+{
+    access_opcode_t opcode;
+    access_opcode_handler_cb_t handler;
+} access_opcode_handler_t;
+
+typedef void (*access_publish_timeout_cb_t)(access_model_handle_t handle, void * p_args);
+
+typedef struct
+{
+    access_model_id_t model_id;
+    uint16_t element_index;
+    const access_opcode_handler_t * p_opcode_handlers;
+    uint32_t opcode_count;
+    void * p_args;
+    access_publish_timeout_cb_t publish_timeout_cb;
+} access_model_add_params_t;
+
+uint32_t access_model_add(const access_model_add_params_t * p_model_params,
+                          access_model_handle_t * p_model_handle);
+uint32_t access_model_publish(access_model_handle_t handle, const access_message_tx_t * p_message);
+uint32_t access_model_reply(access_model_handle_t handle,
+                            const access_message_rx_t * p_message,
+                            const access_message_tx_t * p_reply);
+
+#endif /* ACCESS_H__ */
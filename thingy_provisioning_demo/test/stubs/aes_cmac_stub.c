@@ -0,0 +1,109 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* AES-CMAC (RFC 4493) for the host build, on top of aes_encrypt() of aes_stub.c. */
+
+#include "aes_cmac.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "aes.h"
+
+#define BLOCK_SIZE  (16)
+
+/* Doubling in GF(2^128), the subkey derivation of RFC 4493. */
+static void subkey_shift(uint8_t * p_out, const uint8_t * p_in)
+{
+    uint8_t msb = p_in[0] & 0x80;
+    for (uint32_t i = 0; i < BLOCK_SIZE - 1; ++i)
+    {
+        p_out[i] = (uint8_t) ((p_in[i] << 1) | (p_in[i + 1] >> 7));
+    }
+    p_out[BLOCK_SIZE - 1] = (uint8_t) (p_in[BLOCK_SIZE - 1] << 1);
+    if (msb)
+    {
+        p_out[BLOCK_SIZE - 1] ^= 0x87;
+    }
+}
+
+void aes_cmac(const uint8_t * const key, const uint8_t * const msg, uint16_t msg_len, uint8_t * const out)
+{
+    uint8_t l[BLOCK_SIZE] = {0};
+    uint8_t k1[BLOCK_SIZE];
+    uint8_t k2[BLOCK_SIZE];
+    aes_encrypt(key, l, l);
+    subkey_shift(k1, l);
+    subkey_shift(k2, k1);
+
+    uint32_t blocks = (msg_len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    bool complete = (msg_len != 0) && (msg_len % BLOCK_SIZE == 0);
+    if (blocks == 0)
+    {
+        blocks = 1;
+    }
+
+    uint8_t x[BLOCK_SIZE] = {0};
+    for (uint32_t b = 0; b < blocks; ++b)
+    {
+        uint8_t block[BLOCK_SIZE] = {0};
+        uint32_t offset = b * BLOCK_SIZE;
+        uint32_t length = (msg_len - offset < BLOCK_SIZE) ? (msg_len - offset) : BLOCK_SIZE;
+        memcpy(block, &msg[offset], length);
+
+        if (b + 1 == blocks)
+        {
+            const uint8_t * p_subkey = complete ? k1 : k2;
+            if (!complete)
+            {
+                block[length] = 0x80;
+            }
+            for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+            {
+                block[i] ^= p_subkey[i];
+            }
+        }
+
+        for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            x[i] ^= block[i];
+        }
+        aes_encrypt(key, x, x);
+    }
+    memcpy(out, x, BLOCK_SIZE);
+}
@@ -0,0 +1,193 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host build stand-in for mesh/core/src/aes.c: a portable byte-oriented AES-128 (FIPS-197), and
+ * the SoftDevice ECB call of nrf_soc.h on top of it. Written for clarity, not speed; the S-box is
+ * computed on first use. */
+
+#include "aes.h"
+#include "nrf_soc.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "nrf_error.h"
+
+#define AES_ROUNDS  (10)
+
+static uint8_t m_sbox[256];
+static bool m_sbox_ready;
+static uint32_t m_aes_calls;
+static uint32_t m_ecb_calls;
+static bool m_ecb_fail;
+
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t) ((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+}
+
+static uint8_t rotl8(uint8_t x, uint32_t shift)
+{
+    return (uint8_t) ((x << shift) | (x >> (8 - shift)));
+}
+
+/* S(x) is the affine transform of the multiplicative inverse of x in GF(2^8). p runs through
+ * the powers of the generator 3 and q through those of its inverse, so q = 1 / p. */
+static void sbox_init(void)
+{
+    uint8_t p = 1;
+    uint8_t q = 1;
+    do
+    {
+        p = (uint8_t) (p ^ xtime(p));
+        q ^= (uint8_t) (q << 1);
+        q ^= (uint8_t) (q << 2);
+        q ^= (uint8_t) (q << 4);
+        if (q & 0x80)
+        {
+            q ^= 0x09;
+        }
+        m_sbox[p] = (uint8_t) (q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4) ^ 0x63);
+    } while (p != 1);
+    m_sbox[0] = 0x63;
+    m_sbox_ready = true;
+}
+
+static void key_expand(const uint8_t * p_key, uint8_t p_round_keys[AES_ROUNDS + 1][16])
+{
+    uint8_t rcon = 1;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        p_round_keys[0][i] = p_key[i];
+    }
+    for (uint32_t round = 1; round <= AES_ROUNDS; ++round)
+    {
+        const uint8_t * p_prev = p_round_keys[round - 1];
+        uint8_t * p_next = p_round_keys[round];
+        p_next[0] = (uint8_t) (p_prev[0] ^ m_sbox[p_prev[13]] ^ rcon);
+        p_next[1] = (uint8_t) (p_prev[1] ^ m_sbox[p_prev[14]]);
+        p_next[2] = (uint8_t) (p_prev[2] ^ m_sbox[p_prev[15]]);
+        p_next[3] = (uint8_t) (p_prev[3] ^ m_sbox[p_prev[12]]);
+        for (uint32_t i = 4; i < 16; ++i)
+        {
+            p_next[i] = (uint8_t) (p_prev[i] ^ p_next[i - 4]);
+        }
+        rcon = xtime(rcon);
+    }
+}
+
+static void block_encrypt(const uint8_t * p_key, const uint8_t * p_in, uint8_t * p_out)
+{
+    uint8_t round_keys[AES_ROUNDS + 1][16];
+    uint8_t state[16];
+
+    if (!m_sbox_ready)
+    {
+        sbox_init();
+    }
+    key_expand(p_key, round_keys);
+
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        state[i] = (uint8_t) (p_in[i] ^ round_keys[0][i]);
+    }
+    for (uint32_t round = 1; round <= AES_ROUNDS; ++round)
+    {
+        /* SubBytes and ShiftRows: row r of column c moves to column c - r. */
+        uint8_t shifted[16];
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            shifted[i] = m_sbox[state[(i + 4 * (i % 4)) % 16]];
+        }
+        /* MixColumns, skipped in the last round. */
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            uint8_t * p_col = &shifted[4 * c];
+            if (round < AES_ROUNDS)
+            {
+                uint8_t all = (uint8_t) (p_col[0] ^ p_col[1] ^ p_col[2] ^ p_col[3]);
+                uint8_t first = p_col[0];
+                p_col[0] ^= (uint8_t) (all ^ xtime((uint8_t) (p_col[0] ^ p_col[1])));
+                p_col[1] ^= (uint8_t) (all ^ xtime((uint8_t) (p_col[1] ^ p_col[2])));
+                p_col[2] ^= (uint8_t) (all ^ xtime((uint8_t) (p_col[2] ^ p_col[3])));
+                p_col[3] ^= (uint8_t) (all ^ xtime((uint8_t) (p_col[3] ^ first)));
+            }
+            for (uint32_t r = 0; r < 4; ++r)
+            {
+                state[4 * c + r] = (uint8_t) (p_col[r] ^ round_keys[round][4 * c + r]);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        p_out[i] = state[i];
+    }
+}
+
+void aes_encrypt(const uint8_t * const key, const uint8_t * const clear_text, uint8_t * const cipher_text)
+{
+    m_aes_calls++;
+    block_encrypt(key, clear_text, cipher_text);
+}
+
+uint32_t aes_stub_calls_get(void)
+{
+    return m_aes_calls;
+}
+
+uint32_t sd_ecb_blocks_encrypt(uint8_t block_count, nrf_ecb_hal_data_block_t * p_data_blocks)
+{
+    m_ecb_calls++;
+    if (m_ecb_fail)
+    {
+        return NRF_ERROR_INTERNAL;
+    }
+    for (uint32_t i = 0; i < block_count; ++i)
+    {
+        block_encrypt(*p_data_blocks[i].p_key, *p_data_blocks[i].p_cleartext, *p_data_blocks[i].p_ciphertext);
+    }
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_soc_stub_ecb_calls_get(void)
+{
+    return m_ecb_calls;
+}
+
+void nrf_soc_stub_ecb_fail_set(bool fail)
+{
+    m_ecb_fail = fail;
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for models/foundation/config/include/config_server_events.h, with the
+ * subscription and node reset events. */
+
+#ifndef CONFIG_SERVER_EVENTS_H__
+#define CONFIG_SERVER_EVENTS_H__
+
+#include <stdint.h>
+
+#include "access.h"
+#include "device_state_manager.h"
+
+typedef enum
+{
+    CONFIG_SERVER_EVT_APPKEY_ADD,
+    CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_ADD,
+    CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE,
+    CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE_ALL,
+    CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_OVERWRITE,
+    CONFIG_SERVER_EVT_NODE_RESET,
+} config_server_evt_type_t;
+
+typedef struct
+{
+    dsm_handle_t appkey_handle;
+} config_server_evt_appkey_add_t;
+
+typedef struct
+{
+    access_model_handle_t model_handle;
+    dsm_handle_t address_handle;
+} config_server_evt_model_subscription_add_t;
+
+typedef struct
+{
+    access_model_handle_t model_handle;
+    dsm_handle_t address_handle;
+} config_server_evt_model_subscription_delete_t;
+
+typedef struct
+{
+    access_model_handle_t model_handle;
+} config_server_evt_model_subscription_delete_all_t;
+
+typedef struct
+{
+    access_model_handle_t model_handle;
+    dsm_handle_t address_handle;
+} config_server_evt_model_subscription_overwrite_t;
+
+typedef struct
+{
+    config_server_evt_type_t type;
+    union
+    {
+        config_server_evt_appkey_add_t appkey_add;
+        config_server_evt_model_subscription_add_t model_subscription_add;
+        config_server_evt_model_subscription_delete_t model_subscription_delete;
+        config_server_evt_model_subscription_delete_all_t model_subscription_delete_all;
+        config_server_evt_model_subscription_overwrite_t model_subscription_overwrite;
+    } params;
+} config_server_evt_t;
+
+#endif /* CONFIG_SERVER_EVENTS_H__ */
@@ -0,0 +1,103 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for the RGB part of the Thingy SDK drv_ext_light.h. The functions are
+ * defined by the tests. */
+
+#ifndef DRV_EXT_LIGHT_H__
+#define DRV_EXT_LIGHT_H__
+
+#include <stdint.h>
+
+#include "sdk_errors.h"
+
+#define DRV_EXT_RGB_LED_SENSE       (0)
+#define DRV_EXT_RGB_LED_LIGHTWELL   (1)
+
+/** Colors with every channel fully on or off, one bit per channel. */
+typedef enum
+{
+    DRV_EXT_LIGHT_COLOR_BLACK   = 0x00,
+    DRV_EXT_LIGHT_COLOR_RED     = 0x01,
+    DRV_EXT_LIGHT_COLOR_GREEN   = 0x02,
+    DRV_EXT_LIGHT_COLOR_YELLOW  = 0x03,
+    DRV_EXT_LIGHT_COLOR_BLUE    = 0x04,
+    DRV_EXT_LIGHT_COLOR_PURPLE  = 0x05,
+    DRV_EXT_LIGHT_COLOR_CYAN    = 0x06,
+    DRV_EXT_LIGHT_COLOR_WHITE   = 0x07,
+} drv_ext_light_color_mix_t;
+
+typedef struct
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} drv_ext_light_rgb_intensity_t;
+
+/** Blink and breathe settings of the SX1509 LED engine. */
+typedef struct
+{
+    uint16_t on_time_ms;
+    uint8_t on_intensity;
+    uint16_t off_time_ms;
+    uint8_t off_intensity;
+    uint16_t fade_in_time_ms;
+    uint16_t fade_out_time_ms;
+} drv_ext_light_sequence_t;
+
+typedef struct
+{
+    drv_ext_light_color_mix_t color;
+    drv_ext_light_sequence_t sequence_vals;
+} drv_ext_light_rgb_sequence_t;
+
+#define SEQUENCE_DEFAULT_VALUES                         \
+{                                                       \
+    .color = DRV_EXT_LIGHT_COLOR_WHITE,                 \
+    .sequence_vals.on_time_ms = 1000,                   \
+    .sequence_vals.on_intensity = 0xFF,                 \
+    .sequence_vals.off_time_ms = 1000,                  \
+    .sequence_vals.off_intensity = 0,                   \
+    .sequence_vals.fade_in_time_ms = 500,               \
+    .sequence_vals.fade_out_time_ms = 500,              \
+}
+
+ret_code_t drv_ext_light_rgb_intensity_set(uint32_t id, drv_ext_light_rgb_intensity_t const * const p_intensity);
+ret_code_t drv_ext_light_rgb_sequence(uint32_t id, drv_ext_light_rgb_sequence_t const * const p_sequence);
+ret_code_t drv_ext_light_off(uint32_t id);
+
+#endif /* DRV_EXT_LIGHT_H__ */
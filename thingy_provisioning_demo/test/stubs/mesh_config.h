@@ -0,0 +1,64 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for mesh/core/include/mesh_config.h, backed by the fake flash of
+ * mesh_config_stub.c. Stores are written immediately. */
+
+#ifndef MESH_CONFIG_H__
+#define MESH_CONFIG_H__
+
+#include <stdint.h>
+
+#include "mesh_config_entry.h"
+
+uint32_t mesh_config_entry_set(mesh_config_entry_id_t id, const void * p_entry);
+uint32_t mesh_config_entry_get(mesh_config_entry_id_t id, void * p_entry);
+uint32_t mesh_config_entry_delete(mesh_config_entry_id_t id);
+
+/** Host only: calls the setters with the stored entries, as mesh_config_load() at boot. */
+void mesh_config_stub_load(void);
+/** Host only: erases the fake flash and the counters. */
+void mesh_config_stub_clear(void);
+/** Host only: stored copy of an entry, NULL if it is not stored. */
+uint8_t * mesh_config_stub_stored_get(mesh_config_entry_id_t id);
+/** Host only: number of entries stored in a file. */
+uint32_t mesh_config_stub_stored_count(uint16_t file);
+/** Host only: number of entry writes and deletes. */
+uint32_t mesh_config_stub_writes_get(void);
+uint32_t mesh_config_stub_deletes_get(void);
+
+#endif /* MESH_CONFIG_H__ */
@@ -0,0 +1,90 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for mesh/core/include/mesh_config_entry.h. Entries register themselves with
+ * the fake mesh configuration of mesh_config_stub.c before main() runs. */
+
+#ifndef MESH_CONFIG_ENTRY_H__
+#define MESH_CONFIG_ENTRY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    uint16_t file;
+    uint16_t record;
+} mesh_config_entry_id_t;
+
+#define MESH_CONFIG_ENTRY_ID(FILE, RECORD) ((mesh_config_entry_id_t) {(FILE), (RECORD)})
+
+typedef enum
+{
+    MESH_CONFIG_STRATEGY_NON_PERSISTENT,
+    MESH_CONFIG_STRATEGY_CONTINUOUS,
+    MESH_CONFIG_STRATEGY_ON_POWER_DOWN,
+} mesh_config_strategy_t;
+
+typedef uint32_t (*mesh_config_entry_set_t)(mesh_config_entry_id_t id, const void * p_entry);
+typedef void (*mesh_config_entry_get_t)(mesh_config_entry_id_t id, void * p_entry);
+typedef void (*mesh_config_entry_delete_t)(mesh_config_entry_id_t id);
+
+typedef struct
+{
+    mesh_config_entry_id_t id;
+    uint16_t max_count;
+    uint16_t entry_size;
+    mesh_config_entry_set_t setter;
+    mesh_config_entry_get_t getter;
+    mesh_config_entry_delete_t deleter;
+    bool has_default_value;
+} mesh_config_entry_params_t;
+
+void mesh_config_stub_entry_register(const mesh_config_entry_params_t * p_params);
+
+#define MESH_CONFIG_FILE(NAME, FILE_ID, STRATEGY)                                               \
+    static const mesh_config_strategy_t NAME##_strategy __attribute__((used)) = (STRATEGY)
+
+#define MESH_CONFIG_ENTRY(NAME, ID, MAX_COUNT, ENTRY_SIZE, SET_CB, GET_CB, DELETE_CB, HAS_DEFAULT_VALUE) \
+    static const mesh_config_entry_params_t NAME =                                              \
+        {(ID), (MAX_COUNT), (ENTRY_SIZE), (SET_CB), (GET_CB), (DELETE_CB), (HAS_DEFAULT_VALUE)};  \
+    static void __attribute__((constructor)) NAME##_register(void)                             \
+    {                                                                                           \
+        mesh_config_stub_entry_register(&NAME);                                                 \
+    }
+
+#endif /* MESH_CONFIG_ENTRY_H__ */
@@ -0,0 +1,211 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Fake mesh configuration for the host build: a table of stored entries in place of the flash
+ * manager, and the registered entry descriptors. */
+
+#include "mesh_config.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+
+#define STUB_ENTRY_TYPES_MAX    (8)
+#define STUB_RECORDS_MAX        (256)
+#define STUB_ENTRY_SIZE_MAX     (64)
+
+typedef struct
+{
+    mesh_config_entry_id_t id;
+    uint8_t data[STUB_ENTRY_SIZE_MAX];
+    bool present;
+} stored_t;
+
+static const mesh_config_entry_params_t * mp_entries[STUB_ENTRY_TYPES_MAX];
+static uint32_t m_entry_count;
+static stored_t m_stored[STUB_RECORDS_MAX];
+static uint32_t m_writes;
+static uint32_t m_deletes;
+
+void mesh_config_stub_entry_register(const mesh_config_entry_params_t * p_params)
+{
+    if (m_entry_count < STUB_ENTRY_TYPES_MAX && p_params->entry_size <= STUB_ENTRY_SIZE_MAX)
+    {
+        mp_entries[m_entry_count++] = p_params;
+    }
+}
+
+static const mesh_config_entry_params_t * params_find(mesh_config_entry_id_t id)
+{
+    for (uint32_t i = 0; i < m_entry_count; ++i)
+    {
+        const mesh_config_entry_params_t * p_params = mp_entries[i];
+        if (p_params->id.file == id.file && id.record >= p_params->id.record &&
+            id.record < p_params->id.record + p_params->max_count)
+        {
+            return p_params;
+        }
+    }
+    return NULL;
+}
+
+static stored_t * stored_find(mesh_config_entry_id_t id)
+{
+    for (uint32_t i = 0; i < STUB_RECORDS_MAX; ++i)
+    {
+        if (m_stored[i].present && m_stored[i].id.file == id.file && m_stored[i].id.record == id.record)
+        {
+            return &m_stored[i];
+        }
+    }
+    return NULL;
+}
+
+uint32_t mesh_config_entry_set(mesh_config_entry_id_t id, const void * p_entry)
+{
+    const mesh_config_entry_params_t * p_params = params_find(id);
+    if (p_params == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+
+    uint32_t status = p_params->setter(id, p_entry);
+    if (status != NRF_SUCCESS)
+    {
+        return status;
+    }
+
+    stored_t * p_stored = stored_find(id);
+    for (uint32_t i = 0; i < STUB_RECORDS_MAX && p_stored == NULL; ++i)
+    {
+        if (!m_stored[i].present)
+        {
+            p_stored = &m_stored[i];
+        }
+    }
+    if (p_stored == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    p_stored->id = id;
+    p_stored->present = true;
+    p_params->getter(id, p_stored->data);
+    m_writes++;
+    return NRF_SUCCESS;
+}
+
+uint32_t mesh_config_entry_get(mesh_config_entry_id_t id, void * p_entry)
+{
+    const mesh_config_entry_params_t * p_params = params_find(id);
+    if (p_params == NULL || stored_find(id) == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    p_params->getter(id, p_entry);
+    return NRF_SUCCESS;
+}
+
+uint32_t mesh_config_entry_delete(mesh_config_entry_id_t id)
+{
+    const mesh_config_entry_params_t * p_params = params_find(id);
+    stored_t * p_stored = stored_find(id);
+    if (p_params == NULL || p_stored == NULL)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    p_stored->present = false;
+    if (p_params->deleter != NULL)
+    {
+        p_params->deleter(id);
+    }
+    m_deletes++;
+    return NRF_SUCCESS;
+}
+
+void mesh_config_stub_load(void)
+{
+    for (uint32_t i = 0; i < STUB_RECORDS_MAX; ++i)
+    {
+        if (m_stored[i].present)
+        {
+            const mesh_config_entry_params_t * p_params = params_find(m_stored[i].id);
+            if (p_params != NULL)
+            {
+                (void) p_params->setter(m_stored[i].id, m_stored[i].data);
+            }
+        }
+    }
+}
+
+void mesh_config_stub_clear(void)
+{
+    memset(m_stored, 0, sizeof(m_stored));
+    m_writes = 0;
+    m_deletes = 0;
+}
+
+uint8_t * mesh_config_stub_stored_get(mesh_config_entry_id_t id)
+{
+    stored_t * p_stored = stored_find(id);
+    return (p_stored == NULL) ? NULL : p_stored->data;
+}
+
+uint32_t mesh_config_stub_stored_count(uint16_t file)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < STUB_RECORDS_MAX; ++i)
+    {
+        if (m_stored[i].present && m_stored[i].id.file == file)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t mesh_config_stub_writes_get(void)
+{
+    return m_writes;
+}
+
+uint32_t mesh_config_stub_deletes_get(void)
+{
+    return m_deletes;
+}
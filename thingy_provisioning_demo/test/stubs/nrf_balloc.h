@@ -0,0 +1,87 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for the nRF5 SDK nrf_balloc.h: same API and the same free-list-of-indexes
+ * design, without the debug features. */
+
+#ifndef NRF_BALLOC_H__
+#define NRF_BALLOC_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint8_t * p_stack_pointer;
+} nrf_balloc_cb_t;
+
+typedef struct
+{
+    nrf_balloc_cb_t * p_cb;
+    uint8_t * p_stack_base;
+    uint8_t * p_stack_limit;
+    void * p_memory_begin;
+    uint16_t block_size;
+} nrf_balloc_t;
+
+#define NRF_BALLOC_BLOCK_SIZE(size) (((size) + 3) & ~3u)
+
+#define NRF_BALLOC_DEF(_name, _element_size, _pool_size)                                        \
+    static uint32_t _name##_nrf_balloc_pool_mem[NRF_BALLOC_BLOCK_SIZE(_element_size) * (_pool_size) / 4]; \
+    static uint8_t _name##_nrf_balloc_pool_stack[(_pool_size)];                                \
+    static nrf_balloc_cb_t _name##_nrf_balloc_cb;                                               \
+    static const nrf_balloc_t _name =                                                           \
+    {                                                                                           \
+        &_name##_nrf_balloc_cb,                                                                 \
+        _name##_nrf_balloc_pool_stack,                                                          \
+        _name##_nrf_balloc_pool_stack + (_pool_size),                                           \
+        _name##_nrf_balloc_pool_mem,                                                            \
+        NRF_BALLOC_BLOCK_SIZE(_element_size),                                                   \
+    }
+
+uint32_t nrf_balloc_init(const nrf_balloc_t * p_pool);
+void * nrf_balloc_alloc(const nrf_balloc_t * p_pool);
+void nrf_balloc_free(const nrf_balloc_t * p_pool, void * p_element);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_BALLOC_H__ */
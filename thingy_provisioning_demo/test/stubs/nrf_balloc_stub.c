@@ -0,0 +1,74 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for the nRF5 SDK nrf_balloc.c. */
+
+#include "nrf_balloc.h"
+
+#include <stddef.h>
+#include <assert.h>
+
+#include "nrf_error.h"
+
+uint32_t nrf_balloc_init(const nrf_balloc_t * p_pool)
+{
+    uint8_t pool_size = (uint8_t) (p_pool->p_stack_limit - p_pool->p_stack_base);
+    p_pool->p_cb->p_stack_pointer = p_pool->p_stack_base;
+    while (pool_size--)
+    {
+        *(p_pool->p_cb->p_stack_pointer)++ = pool_size;
+    }
+    return NRF_SUCCESS;
+}
+
+void * nrf_balloc_alloc(const nrf_balloc_t * p_pool)
+{
+    if (p_pool->p_cb->p_stack_pointer <= p_pool->p_stack_base)
+    {
+        return NULL;
+    }
+    uint8_t index = *(--p_pool->p_cb->p_stack_pointer);
+    return (uint8_t *) p_pool->p_memory_begin + (uint32_t) index * p_pool->block_size;
+}
+
+void nrf_balloc_free(const nrf_balloc_t * p_pool, void * p_element)
+{
+    uint32_t offset = (uint32_t) ((uint8_t *) p_element - (uint8_t *) p_pool->p_memory_begin);
+    assert(offset % p_pool->block_size == 0);
+    assert(p_pool->p_cb->p_stack_pointer < p_pool->p_stack_limit);
+    *(p_pool->p_cb->p_stack_pointer)++ = (uint8_t) (offset / p_pool->block_size);
+}
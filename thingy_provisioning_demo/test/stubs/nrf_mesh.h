@@ -0,0 +1,96 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Host build stand-in for the parts of mesh/core/api/nrf_mesh.h used by the host build. */
+
+#ifndef NRF_MESH_H__
+#define NRF_MESH_H__
+
+#include <stdint.h>
+
+#include "nrf_error.h"
+
+/** Size (in octets) of an encryption key. */
+#define NRF_MESH_KEY_SIZE   (16)
+/** Size (in octets) of a network ID. */
+#define NRF_MESH_NETID_SIZE (8)
+
+/** Network security material, derived with k2. */
+typedef struct
+{
+    uint8_t nid;
+    uint8_t encryption_key[NRF_MESH_KEY_SIZE];
+    uint8_t privacy_key[NRF_MESH_KEY_SIZE];
+} nrf_mesh_network_secmat_t;
+
+/** Secure network beacon security material, derived with k3 and k1. */
+typedef struct
+{
+    uint8_t key[NRF_MESH_KEY_SIZE];
+    uint8_t net_id[NRF_MESH_NETID_SIZE];
+} nrf_mesh_beacon_secmat_t;
+
+/** Size of the TransMIC of an access message. */
+typedef enum
+{
+    NRF_MESH_TRANSMIC_SIZE_SMALL,
+    NRF_MESH_TRANSMIC_SIZE_LARGE,
+    NRF_MESH_TRANSMIC_SIZE_DEFAULT,
+} nrf_mesh_transmic_size_t;
+
+/** Token identifying a message in its TX complete event. */
+typedef uint32_t nrf_mesh_tx_token_t;
+
+/** Types of mesh addresses. */
+typedef enum
+{
+    NRF_MESH_ADDRESS_TYPE_INVALID,
+    NRF_MESH_ADDRESS_TYPE_UNICAST,
+    NRF_MESH_ADDRESS_TYPE_VIRTUAL,
+    NRF_MESH_ADDRESS_TYPE_GROUP,
+} nrf_mesh_address_type_t;
+
+/** Mesh address, for virtual addresses @c value is the hash. */
+typedef struct
+{
+    nrf_mesh_address_type_t type;
+    uint16_t value;
+    const uint8_t * p_virtual_uuid;
+} nrf_mesh_address_t;
+
+nrf_mesh_tx_token_t nrf_mesh_unique_token_get(void);
+
+#endif /* NRF_MESH_H__ */
@@ -0,0 +1,72 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for mesh/core/api/nrf_mesh_config_core.h. The sizes are given on the
+ * compiler command line, so one source builds at several sizes; the derived values use the same
+ * expressions as include/nrf_mesh_config_app.h. */
+
+#ifndef NRF_MESH_CONFIG_CORE_H__
+#define NRF_MESH_CONFIG_CORE_H__
+
+#include "mesh_app_sizing.h"
+
+#ifndef REPLAY_CACHE_ENTRIES
+#define REPLAY_CACHE_ENTRIES    (64)
+#endif
+#define REPLAY_CACHE_HASH_BITS  MESH_APP_SIZING_HASH_BITS(REPLAY_CACHE_ENTRIES * 2)
+
+#ifndef MSG_CACHE_ENTRY_COUNT
+#define MSG_CACHE_ENTRY_COUNT   (167)
+#endif
+#define MSG_CACHE_MAX_AGE_MS    (1000)
+#define MSG_CACHE_HASH_BITS     MESH_APP_SIZING_HASH_BITS(MSG_CACHE_ENTRY_COUNT)
+
+#ifndef TIMER_SCH_EVENTS_MAX
+#define TIMER_SCH_EVENTS_MAX    (64)
+#endif
+
+/* Used by the mesh memory pools: the application value of ACCESS_RELIABLE_TRANSFER_COUNT and the
+ * stack defaults. */
+#ifndef ACCESS_RELIABLE_TRANSFER_COUNT
+#define ACCESS_RELIABLE_TRANSFER_COUNT          (8)
+#endif
+#ifndef TRANSPORT_SAR_SESSIONS_MAX
+#define TRANSPORT_SAR_SESSIONS_MAX              (4)
+#endif
+#define NRF_MESH_UPPER_TRANSPORT_PDU_SIZE_MAX   (384)
+
+#endif /* NRF_MESH_CONFIG_CORE_H__ */
@@ -0,0 +1,72 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for the Thingy SDK sx150x_led_drv_calc.h, the LED timing calculations of
+ * SDKPatch/sx150x_led_drv_calc.c. */
+
+#ifndef SX150X_LED_DRV_CALC_H__
+#define SX150X_LED_DRV_CALC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdk_errors.h"
+#include "drv_ext_light.h"
+
+#define SX150x_LED_DRC_CALC_STATUS_CODE_SUCCESS         (0)
+#define SX150x_LED_DRV_CALC_STATUS_CODE_INACCURATE      (1)
+#define SX150x_LED_DRV_CALC_STATUS_CODE_NOT_INIT        (2)
+#define SX150x_LED_DRV_CALC_STATUS_CODE_INVALID_PARAM   (3)
+
+/** Register values of one LED driver pin. */
+typedef struct
+{
+    uint8_t on_time;
+    uint8_t on_intensity;
+    uint8_t off_time;
+    uint8_t off_intensity;
+    uint8_t fade_in_time;
+    uint8_t fade_out_time;
+} sx150x_led_drv_regs_vals_t;
+
+bool sx150x_led_drv_calc_fade_supp(uint16_t port_mask);
+ret_code_t sx150x_led_drv_calc_convert(uint16_t port_mask,
+                                       drv_ext_light_sequence_t * const real_vals,
+                                       sx150x_led_drv_regs_vals_t * const reg_vals);
+void sx150x_led_drv_calc_init(uint16_t fade_supported_port_mask, uint32_t clkx_tics_pr_sec);
+
+#endif /* SX150X_LED_DRV_CALC_H__ */
@@ -0,0 +1,86 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Host build stand-in for mesh/core/include/timer_scheduler.h. */
+
+#ifndef TIMER_SCHEDULER_H__
+#define TIMER_SCHEDULER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Timer event callback. */
+typedef void (*timer_sch_callback_t)(timestamp_t timestamp, void * p_context);
+
+/** Timer event states. */
+typedef enum
+{
+    TIMER_EVENT_STATE_UNUSED,
+    TIMER_EVENT_STATE_ADDED,
+    TIMER_EVENT_STATE_QUEUED,
+    TIMER_EVENT_STATE_RESCHEDULED,
+    TIMER_EVENT_STATE_IN_CALLBACK
+} timer_event_state_t;
+
+/** Timer event. */
+typedef struct timer_event
+{
+    volatile timer_event_state_t state;
+    timestamp_t timestamp;
+    timer_sch_callback_t cb;
+    uint32_t interval;
+    void * p_context;
+    struct timer_event * p_next;
+} timer_event_t;
+
+void timer_sch_init(void);
+void timer_sch_schedule(timer_event_t * p_timer_evt);
+void timer_sch_abort(timer_event_t * p_timer_evt);
+void timer_sch_reschedule(timer_event_t * p_timer_evt, timestamp_t new_timeout);
+bool timer_sch_is_scheduled(const timer_event_t * p_timer_evt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMER_SCHEDULER_H__ */
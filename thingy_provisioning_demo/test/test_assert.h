@@ -0,0 +1,88 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TEST_ASSERT_H__
+#define TEST_ASSERT_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Minimal assertions for the host unit tests. A failing check prints its location and ends the
+ * test program with a non-zero exit code. */
+
+#define TEST_ASSERT(cond)                                                               \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL(expected, actual)                                             \
+    do                                                                                  \
+    {                                                                                   \
+        long long expected_ = (long long) (expected);                                   \
+        long long actual_ = (long long) (actual);                                       \
+        if (expected_ != actual_)                                                       \
+        {                                                                               \
+            fprintf(stderr, "%s:%d: expected %s == %lld, got %lld\n",                   \
+                    __FILE__, __LINE__, #actual, expected_, actual_);                   \
+            exit(1);                                                                    \
+        }                                                                               \
+    } while (0)
+
+#define TEST_RUN(test)                                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        test();                                                                         \
+        printf("PASS %s\n", #test);                                                     \
+    } while (0)
+
+/* Deterministic pseudo random numbers (xorshift32), so failures are reproducible. */
+static inline unsigned test_rand(unsigned * p_state)
+{
+    unsigned x = *p_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *p_state = x;
+    return x;
+}
+
+#endif /* TEST_ASSERT_H__ */
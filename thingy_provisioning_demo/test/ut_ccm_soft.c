@@ -0,0 +1,253 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Unit tests for SDKPatch/ccm_soft.c: known-answer vectors and equivalence of the software and
+ * batched backends, with the SoftDevice ECB call of stubs/nrf_soc.h. */
+
+#include "ccm_soft.h"
+#include "ccm_backend.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "aes.h"
+#include "nrf_soc.h"
+#include "nrf_mesh.h"
+#include "test_assert.h"
+
+#define NONCE_SIZE  (13)
+#define MESSAGE_MAX (384)
+
+static const uint8_t m_key[NRF_MESH_KEY_SIZE] =
+    {0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF};
+
+static void hex_decode(const char * p_hex, uint8_t * p_out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        unsigned value;
+        TEST_ASSERT(sscanf(&p_hex[2 * i], "%2x", &value) == 1);
+        p_out[i] = (uint8_t) value;
+    }
+}
+
+static void encrypt(const uint8_t * p_nonce, const uint8_t * p_a, uint16_t a_len, const uint8_t * p_m,
+                    uint16_t m_len, uint8_t * p_out, uint8_t * p_mic, uint8_t mic_len)
+{
+    ccm_soft_data_t data =
+    {
+        .p_key = m_key,
+        .p_nonce = p_nonce,
+        .p_m = p_m,
+        .m_len = m_len,
+        .p_a = p_a,
+        .a_len = a_len,
+        .p_out = p_out,
+        .p_mic = p_mic,
+        .mic_len = mic_len
+    };
+    ccm_soft_encrypt(&data);
+}
+
+static bool decrypt(const uint8_t * p_nonce, const uint8_t * p_a, uint16_t a_len, const uint8_t * p_c,
+                    uint16_t m_len, uint8_t * p_out, uint8_t * p_mic, uint8_t mic_len)
+{
+    bool mic_passed = false;
+    ccm_soft_data_t data =
+    {
+        .p_key = m_key,
+        .p_nonce = p_nonce,
+        .p_m = p_c,
+        .m_len = m_len,
+        .p_a = p_a,
+        .a_len = a_len,
+        .p_out = p_out,
+        .p_mic = p_mic,
+        .mic_len = mic_len
+    };
+    ccm_soft_decrypt(&data, &mic_passed);
+    return mic_passed;
+}
+
+static void test_selftest_vectors(void)
+{
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    TEST_ASSERT(ccm_backend_selftest());
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    TEST_ASSERT(ccm_backend_selftest());
+}
+
+/* 200 byte message with additional data and a 64-bit MIC, spanning two keystream batches.
+ * Reference output computed with an independent CCM on top of OpenSSL AES-128-ECB. */
+static void test_long_vector(void)
+{
+    static const char c_hex[] =
+        "5f49eb2b07f886a9b50b3ecf74eec9b11973724c26cb8d9dc35fff0ce786ad1f294a7fb8c5487995b9b57f89e40e5358"
+        "2979eb88acddb9a8f1e735edfdcd7ce9c74668775fb79be340fab25af66c0cef48251cce06e50e45b547b89b505e47fd"
+        "cc8e9961ac75beadcebf3bdaba530b9ee52b63b4b1e872f0b25d69434fd35ea167f1a3b81834ac76f2e46790472f45f8"
+        "6733294e9ac2066704f90a2feaf305e23ef9eceefcc5b9276c2e77368282045d9665329e2b3264bbfde96f8b08df44e7"
+        "791ba9a620da56c8";
+    static const char mic_hex[] = "f67ae8c69720307b";
+    uint8_t nonce[NONCE_SIZE];
+    uint8_t a[16];
+    uint8_t m[200];
+    uint8_t c[200];
+    uint8_t expected_mic[8];
+    hex_decode("01020304050607080910111213", nonce, sizeof(nonce));
+    hex_decode(c_hex, c, sizeof(c));
+    hex_decode(mic_hex, expected_mic, sizeof(expected_mic));
+    for (uint32_t i = 0; i < sizeof(a); ++i)
+    {
+        a[i] = (uint8_t) (0x20 + i);
+    }
+    for (uint32_t i = 0; i < sizeof(m); ++i)
+    {
+        m[i] = (uint8_t) (i * 7 + 3);
+    }
+
+    for (uint32_t backend = CCM_BACKEND_SOFT; backend <= CCM_BACKEND_BATCHED; ++backend)
+    {
+        uint8_t out[200];
+        uint8_t mic[8];
+        ccm_backend_set((ccm_backend_t) backend);
+        encrypt(nonce, a, sizeof(a), m, sizeof(m), out, mic, sizeof(mic));
+        TEST_ASSERT(memcmp(out, c, sizeof(c)) == 0);
+        TEST_ASSERT(memcmp(mic, expected_mic, sizeof(mic)) == 0);
+
+        TEST_ASSERT(decrypt(nonce, a, sizeof(a), c, sizeof(c), out, expected_mic, sizeof(expected_mic)));
+        TEST_ASSERT(memcmp(out, m, sizeof(m)) == 0);
+
+        /* The additional data is authenticated. */
+        a[3] ^= 0x80;
+        TEST_ASSERT(!decrypt(nonce, a, sizeof(a), c, sizeof(c), out, expected_mic, sizeof(expected_mic)));
+        a[3] ^= 0x80;
+    }
+}
+
+/* One batched ECB call per CCM_BATCH_BLOCKS keystream blocks, including the MIC block, and the
+ * same number of CBC-MAC AES calls as the software backend. */
+static void test_batching(void)
+{
+    uint8_t nonce[NONCE_SIZE] = {0};
+    uint8_t m[MESSAGE_MAX] = {0};
+    uint8_t out[MESSAGE_MAX];
+    uint8_t mic[4];
+    static const struct
+    {
+        uint16_t m_len;
+        uint32_t ecb_calls;
+    } cases[] = {{1, 1}, {16, 1}, {112, 1}, {113, 2}, {240, 2}, {380, 4}};
+
+    ccm_backend_set(CCM_BACKEND_BATCHED);
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        uint32_t m_len = cases[i].m_len;
+        uint32_t ecb_before = nrf_soc_stub_ecb_calls_get();
+        uint32_t aes_before = aes_stub_calls_get();
+        encrypt(nonce, NULL, 0, m, (uint16_t) m_len, out, mic, sizeof(mic));
+        TEST_ASSERT_EQUAL(cases[i].ecb_calls, nrf_soc_stub_ecb_calls_get() - ecb_before);
+        TEST_ASSERT_EQUAL(1 + (m_len + 15) / 16, aes_stub_calls_get() - aes_before);
+    }
+
+    ccm_backend_set(CCM_BACKEND_SOFT);
+    uint32_t ecb_before = nrf_soc_stub_ecb_calls_get();
+    encrypt(nonce, NULL, 0, m, 380, out, mic, sizeof(mic));
+    TEST_ASSERT_EQUAL(0, nrf_soc_stub_ecb_calls_get() - ecb_before);
+}
+
+/* Random messages give the same output with both backends and with a failing ECB call, and
+ * decrypt in place. */
+static void test_backends_equivalent(void)
+{
+    unsigned rand_state = 7;
+    for (uint32_t round = 0; round < 500; ++round)
+    {
+        uint8_t nonce[NONCE_SIZE];
+        uint8_t a[20];
+        uint8_t m[MESSAGE_MAX];
+        uint8_t out_soft[MESSAGE_MAX];
+        uint8_t out_batched[MESSAGE_MAX];
+        uint8_t out_fallback[MESSAGE_MAX];
+        uint8_t mic_soft[16];
+        uint8_t mic_batched[16];
+        uint8_t mic_fallback[16];
+        uint16_t m_len = (uint16_t) (test_rand(&rand_state) % (MESSAGE_MAX + 1));
+        uint16_t a_len = (uint16_t) ((round % 3 == 0) ? test_rand(&rand_state) % (sizeof(a) + 1) : 0);
+        uint8_t mic_len = (uint8_t) (4 + 2 * (test_rand(&rand_state) % 7));
+        for (uint32_t i = 0; i < sizeof(nonce); ++i)
+        {
+            nonce[i] = (uint8_t) test_rand(&rand_state);
+        }
+        for (uint32_t i = 0; i < sizeof(a); ++i)
+        {
+            a[i] = (uint8_t) test_rand(&rand_state);
+        }
+        for (uint32_t i = 0; i < m_len; ++i)
+        {
+            m[i] = (uint8_t) test_rand(&rand_state);
+        }
+
+        ccm_backend_set(CCM_BACKEND_SOFT);
+        encrypt(nonce, a, a_len, m, m_len, out_soft, mic_soft, mic_len);
+        ccm_backend_set(CCM_BACKEND_BATCHED);
+        encrypt(nonce, a, a_len, m, m_len, out_batched, mic_batched, mic_len);
+        nrf_soc_stub_ecb_fail_set(true);
+        encrypt(nonce, a, a_len, m, m_len, out_fallback, mic_fallback, mic_len);
+        nrf_soc_stub_ecb_fail_set(false);
+
+        TEST_ASSERT(memcmp(out_soft, out_batched, m_len) == 0);
+        TEST_ASSERT(memcmp(mic_soft, mic_batched, mic_len) == 0);
+        TEST_ASSERT(memcmp(out_soft, out_fallback, m_len) == 0);
+        TEST_ASSERT(memcmp(mic_soft, mic_fallback, mic_len) == 0);
+
+        TEST_ASSERT(decrypt(nonce, a, a_len, out_batched, m_len, out_batched, mic_batched, mic_len));
+        TEST_ASSERT(memcmp(out_batched, m, m_len) == 0);
+
+        mic_soft[test_rand(&rand_state) % mic_len] ^= (uint8_t) (1u << (test_rand(&rand_state) % 8));
+        TEST_ASSERT(!decrypt(nonce, a, a_len, out_soft, m_len, out_fallback, mic_soft, mic_len));
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_selftest_vectors);
+    TEST_RUN(test_long_vector);
+    TEST_RUN(test_batching);
+    TEST_RUN(test_backends_equivalent);
+    return 0;
+}
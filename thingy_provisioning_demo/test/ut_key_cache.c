@@ -0,0 +1,320 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for src/key_cache.c, with the mesh configuration of stubs/mesh_config_stub.c and
+ * stand-ins for the key derivations of the stack that count their calls. A reboot is a
+ * key_cache_init() followed by loading the stored entries. */
+
+#include "key_cache.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_keygen.h"
+#include "mesh_config.h"
+#include "diag_model.h"
+#include "test_assert.h"
+
+/* Called by the stack in place of the real derivations, see the --wrap options of the project. */
+uint32_t __wrap_nrf_mesh_keygen_network_secmat(const uint8_t * p_key, nrf_mesh_network_secmat_t * p_secmat);
+uint32_t __wrap_nrf_mesh_keygen_beacon_secmat(const uint8_t * p_key, nrf_mesh_beacon_secmat_t * p_secmat);
+uint32_t __wrap_nrf_mesh_keygen_identitykey(const uint8_t * p_key, uint8_t * p_identitykey);
+uint32_t __wrap_nrf_mesh_keygen_aid(const uint8_t * p_key, uint8_t * p_aid);
+
+static uint32_t m_derivations;
+
+/* Material depending on every key byte and on the kind of derivation. */
+static void material_fill(const uint8_t * p_key, uint8_t salt, uint8_t * p_out, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        p_out[i] = (uint8_t) (p_key[i % NRF_MESH_KEY_SIZE] * 31 + p_key[(i + 7) % NRF_MESH_KEY_SIZE] + salt + i);
+    }
+}
+
+uint32_t __real_nrf_mesh_keygen_network_secmat(const uint8_t * p_key, nrf_mesh_network_secmat_t * p_secmat)
+{
+    if (p_key == NULL || p_secmat == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    m_derivations++;
+    material_fill(p_key, 1, (uint8_t *) p_secmat, sizeof(*p_secmat));
+    return NRF_SUCCESS;
+}
+
+uint32_t __real_nrf_mesh_keygen_beacon_secmat(const uint8_t * p_key, nrf_mesh_beacon_secmat_t * p_secmat)
+{
+    if (p_key == NULL || p_secmat == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    m_derivations++;
+    material_fill(p_key, 2, (uint8_t *) p_secmat, sizeof(*p_secmat));
+    return NRF_SUCCESS;
+}
+
+uint32_t __real_nrf_mesh_keygen_identitykey(const uint8_t * p_key, uint8_t * p_identitykey)
+{
+    if (p_key == NULL || p_identitykey == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    m_derivations++;
+    material_fill(p_key, 3, p_identitykey, NRF_MESH_KEY_SIZE);
+    return NRF_SUCCESS;
+}
+
+uint32_t __real_nrf_mesh_keygen_aid(const uint8_t * p_key, uint8_t * p_aid)
+{
+    if (p_key == NULL || p_aid == NULL)
+    {
+        return NRF_ERROR_NULL;
+    }
+    m_derivations++;
+    material_fill(p_key, 4, p_aid, 1);
+    return NRF_SUCCESS;
+}
+
+static void key_make(uint32_t seed, uint8_t * p_key)
+{
+    unsigned state = 0x9E3779B9u ^ (seed * 2654435761u);
+    for (uint32_t i = 0; i < NRF_MESH_KEY_SIZE; ++i)
+    {
+        p_key[i] = (uint8_t) test_rand(&state);
+    }
+}
+
+/* Derives everything the DSM derives for a subnet, checking the result against the stand-in. */
+static void subnet_derive(const uint8_t * p_netkey)
+{
+    nrf_mesh_network_secmat_t net;
+    nrf_mesh_network_secmat_t net_expected;
+    nrf_mesh_beacon_secmat_t beacon;
+    nrf_mesh_beacon_secmat_t beacon_expected;
+    uint8_t identity[NRF_MESH_KEY_SIZE];
+    uint8_t identity_expected[NRF_MESH_KEY_SIZE];
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, __wrap_nrf_mesh_keygen_network_secmat(p_netkey, &net));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, __wrap_nrf_mesh_keygen_beacon_secmat(p_netkey, &beacon));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, __wrap_nrf_mesh_keygen_identitykey(p_netkey, identity));
+
+    uint32_t derivations = m_derivations;
+    material_fill(p_netkey, 1, (uint8_t *) &net_expected, sizeof(net_expected));
+    material_fill(p_netkey, 2, (uint8_t *) &beacon_expected, sizeof(beacon_expected));
+    material_fill(p_netkey, 3, identity_expected, sizeof(identity_expected));
+    TEST_ASSERT(memcmp(&net_expected, &net, sizeof(net)) == 0);
+    TEST_ASSERT(memcmp(&beacon_expected, &beacon, sizeof(beacon)) == 0);
+    TEST_ASSERT(memcmp(identity_expected, identity, sizeof(identity)) == 0);
+    TEST_ASSERT_EQUAL(derivations, m_derivations);
+}
+
+static void appkey_derive(const uint8_t * p_appkey)
+{
+    uint8_t aid;
+    uint8_t aid_expected;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, __wrap_nrf_mesh_keygen_aid(p_appkey, &aid));
+    material_fill(p_appkey, 4, &aid_expected, 1);
+    TEST_ASSERT_EQUAL(aid_expected, aid);
+}
+
+/* Applies a configuration of subnets and application keys, as mesh_stack_init() does. */
+static void config_apply(uint32_t first_subnet, uint32_t subnets, uint32_t first_appkey, uint32_t appkeys)
+{
+    uint8_t key[NRF_MESH_KEY_SIZE];
+    for (uint32_t i = 0; i < subnets; ++i)
+    {
+        key_make(100 + first_subnet + i, key);
+        subnet_derive(key);
+    }
+    for (uint32_t i = 0; i < appkeys; ++i)
+    {
+        key_make(200 + first_appkey + i, key);
+        appkey_derive(key);
+    }
+}
+
+static void reboot(void)
+{
+    key_cache_init();
+    mesh_config_stub_load();
+    m_derivations = 0;
+}
+
+static void setup(void)
+{
+    mesh_config_stub_clear();
+    reboot();
+}
+
+static void test_miss_then_hit(void)
+{
+    setup();
+    config_apply(0, 1, 0, 1);
+    TEST_ASSERT_EQUAL(4, m_derivations);
+    TEST_ASSERT_EQUAL(4, key_cache_misses_get());
+    TEST_ASSERT_EQUAL(4, mesh_config_stub_writes_get());
+
+    config_apply(0, 1, 0, 1);
+    TEST_ASSERT_EQUAL(4, m_derivations);
+    TEST_ASSERT_EQUAL(4, key_cache_hits_get());
+    TEST_ASSERT_EQUAL(4, mesh_config_stub_writes_get());
+}
+
+/* The default profile: 4 subnets and 8 application keys derive nothing after the first boot. */
+static void test_reboot_full_profile(void)
+{
+    setup();
+    config_apply(0, DSM_SUBNET_MAX, 0, DSM_APP_MAX);
+    TEST_ASSERT_EQUAL(3 * DSM_SUBNET_MAX + DSM_APP_MAX, m_derivations);
+    TEST_ASSERT_EQUAL(3 * DSM_SUBNET_MAX + DSM_APP_MAX, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+
+    for (uint32_t boot = 0; boot < 3; ++boot)
+    {
+        uint32_t writes = mesh_config_stub_writes_get();
+        reboot();
+        config_apply(0, DSM_SUBNET_MAX, 0, DSM_APP_MAX);
+        key_cache_prune();
+        TEST_ASSERT_EQUAL(0, m_derivations);
+        TEST_ASSERT_EQUAL(3 * DSM_SUBNET_MAX + DSM_APP_MAX, key_cache_hits_get());
+        TEST_ASSERT_EQUAL(0, key_cache_misses_get());
+        TEST_ASSERT_EQUAL(writes, mesh_config_stub_writes_get());
+        TEST_ASSERT_EQUAL(0, mesh_config_stub_deletes_get());
+    }
+}
+
+/* An entry whose hash does not match is ignored and the material derived again. */
+static void test_corrupt_entry_rederived(void)
+{
+    setup();
+    config_apply(0, 1, 0, 0);
+
+    uint8_t * p_stored = mesh_config_stub_stored_get(MESH_CONFIG_ENTRY_ID(KEY_CACHE_FILE_ID, 1));
+    TEST_ASSERT(p_stored != NULL);
+    p_stored[20] ^= 0x01;
+
+    reboot();
+    config_apply(0, 1, 0, 0);
+    TEST_ASSERT_EQUAL(1, m_derivations);
+    TEST_ASSERT_EQUAL(2, key_cache_hits_get());
+
+    reboot();
+    config_apply(0, 1, 0, 0);
+    TEST_ASSERT_EQUAL(0, m_derivations);
+}
+
+/* Deleted keys are pruned at boot, kinds not derived at boot are left alone. */
+static void test_prune(void)
+{
+    setup();
+    config_apply(0, 3, 0, 2);
+    uint8_t key[NRF_MESH_KEY_SIZE];
+    key_make(999, key);
+    uint8_t aid;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, __wrap_nrf_mesh_keygen_aid(key, &aid));
+    TEST_ASSERT_EQUAL(3 * 3 + 3, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+
+    /* Subnet 2 and application key 1 were deleted. No application key is derived at this boot. */
+    reboot();
+    config_apply(0, 2, 0, 0);
+    key_cache_prune();
+    TEST_ASSERT_EQUAL(3, mesh_config_stub_deletes_get());
+    TEST_ASSERT_EQUAL(2 * 3 + 3, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+
+    /* Now the application keys are derived at boot, the unused ones go. */
+    reboot();
+    config_apply(0, 2, 0, 1);
+    key_cache_prune();
+    TEST_ASSERT_EQUAL(0, m_derivations);
+    TEST_ASSERT_EQUAL(2 * 3 + 1, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+}
+
+/* During a key refresh the old and new keys of every subnet are cached. */
+static void test_key_refresh(void)
+{
+    setup();
+    config_apply(0, DSM_SUBNET_MAX, 0, DSM_APP_MAX);
+    config_apply(DSM_SUBNET_MAX, DSM_SUBNET_MAX, DSM_APP_MAX, DSM_APP_MAX);
+    TEST_ASSERT_EQUAL(KEY_CACHE_ENTRIES_MAX, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+
+    reboot();
+    config_apply(0, 2 * DSM_SUBNET_MAX, 0, 2 * DSM_APP_MAX);
+    TEST_ASSERT_EQUAL(0, m_derivations);
+}
+
+/* Beyond capacity the material is still correct, only derived every time. */
+static void test_full(void)
+{
+    setup();
+    config_apply(0, 2 * DSM_SUBNET_MAX, 0, 2 * DSM_APP_MAX + 4);
+    TEST_ASSERT_EQUAL(KEY_CACHE_ENTRIES_MAX, mesh_config_stub_stored_count(KEY_CACHE_FILE_ID));
+
+    uint32_t derivations = m_derivations;
+    config_apply(0, 2 * DSM_SUBNET_MAX, 0, 2 * DSM_APP_MAX + 4);
+    TEST_ASSERT_EQUAL(derivations + 4, m_derivations);
+
+    /* After a reboot the entries not used are replaced first. */
+    reboot();
+    config_apply(2 * DSM_SUBNET_MAX, 1, 0, 0);
+    TEST_ASSERT_EQUAL(3, m_derivations);
+    config_apply(2 * DSM_SUBNET_MAX, 1, 0, 0);
+    TEST_ASSERT_EQUAL(3, m_derivations);
+}
+
+static void test_null_passed_through(void)
+{
+    setup();
+    uint8_t aid;
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL, __wrap_nrf_mesh_keygen_aid(NULL, &aid));
+    TEST_ASSERT_EQUAL(NRF_ERROR_NULL, __wrap_nrf_mesh_keygen_network_secmat(NULL, NULL));
+    TEST_ASSERT_EQUAL(0, mesh_config_stub_writes_get());
+}
+
+int main(void)
+{
+    TEST_RUN(test_miss_then_hit);
+    TEST_RUN(test_reboot_full_profile);
+    TEST_RUN(test_corrupt_entry_rederived);
+    TEST_RUN(test_prune);
+    TEST_RUN(test_key_refresh);
+    TEST_RUN(test_full);
+    TEST_RUN(test_null_passed_through);
+    return 0;
+}
@@ -0,0 +1,535 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for src/latency_probe.c. The node under test talks to peers 0 to
+ * LATENCY_PROBE_HOPS_MAX relay hops away, played by the test, over the advertising bearer of the
+ * simulations: every transmission of a message takes sim_bearer_hop_delay_us(). The test keeps a
+ * reference of every latency the probe should record and reads the per-hop histograms back with
+ * Histogram Get. */
+
+#include "latency_probe.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "access.h"
+#include "access_config.h"
+#include "device_state_manager.h"
+#include "nrf_mesh.h"
+#include "timer.h"
+#include "sim_bearer.h"
+#include "test_assert.h"
+
+#define LOCAL_ADDRESS       (0x0010)
+#define PEER_ADDRESS        (0x0100)
+#define SENT_TTL            (ACCESS_DEFAULT_TTL)
+/* Network time of the peers, against the local clock of the node under test. */
+#define PEER_CLOCK_OFFSET   (123456789u)
+#define ROUNDS              (400)
+#define ROUND_GAP_US        (3000000)
+#define PARAMS_MAX          (16)
+
+typedef struct
+{
+    uint32_t count;
+    access_opcode_t opcode;
+    uint8_t params[PARAMS_MAX];
+    uint16_t length;
+} sent_message_t;
+
+typedef struct
+{
+    uint32_t buckets[LATENCY_PROBE_BUCKET_COUNT];
+    uint32_t count;
+    uint32_t max_ms;
+    uint32_t sum_ms;
+} reference_hist_t;
+
+static timestamp_t m_now;
+static unsigned m_rand_state = 2463534242u;
+static const access_opcode_handler_t * mp_handlers;
+static uint32_t m_handler_count;
+static uint8_t m_publish_ttl = ACCESS_TTL_USE_DEFAULT;
+static sent_message_t m_published;
+static sent_message_t m_reply;
+static reference_hist_t m_reference[LATENCY_PROBE_KIND_COUNT][LATENCY_PROBE_HOPS_MAX + 1];
+
+timestamp_t timer_now(void)
+{
+    return m_now;
+}
+
+uint32_t access_model_add(const access_model_add_params_t * p_model_params,
+                          access_model_handle_t * p_model_handle)
+{
+    TEST_ASSERT_EQUAL(LATENCY_PROBE_MODEL_ID, p_model_params->model_id.model_id);
+    TEST_ASSERT_EQUAL(ACCESS_COMPANY_ID_NORDIC, p_model_params->model_id.company_id);
+    mp_handlers = p_model_params->p_opcode_handlers;
+    m_handler_count = p_model_params->opcode_count;
+    *p_model_handle = 0;
+    return NRF_SUCCESS;
+}
+
+static void message_record(sent_message_t * p_sent, const access_message_tx_t * p_message)
+{
+    TEST_ASSERT(p_message->length <= PARAMS_MAX);
+    TEST_ASSERT(!p_message->force_segmented);
+    p_sent->count++;
+    p_sent->opcode = p_message->opcode;
+    memcpy(p_sent->params, p_message->p_buffer, p_message->length);
+    p_sent->length = p_message->length;
+}
+
+uint32_t access_model_publish(access_model_handle_t handle, const access_message_tx_t * p_message)
+{
+    TEST_ASSERT_EQUAL(0, handle);
+    message_record(&m_published, p_message);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_reply(access_model_handle_t handle,
+                            const access_message_rx_t * p_message,
+                            const access_message_tx_t * p_reply)
+{
+    TEST_ASSERT_EQUAL(0, handle);
+    TEST_ASSERT(p_message != NULL);
+    message_record(&m_reply, p_reply);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_publish_ttl_get(access_model_handle_t handle, uint8_t * p_ttl)
+{
+    TEST_ASSERT_EQUAL(0, handle);
+    *p_ttl = m_publish_ttl;
+    return NRF_SUCCESS;
+}
+
+uint8_t access_default_ttl_get(void)
+{
+    return SENT_TTL;
+}
+
+void dsm_local_unicast_addresses_get(dsm_local_unicast_address_t * p_address)
+{
+    p_address->address_start = LOCAL_ADDRESS;
+    p_address->count = ACCESS_ELEMENT_COUNT;
+}
+
+nrf_mesh_tx_token_t nrf_mesh_unique_token_get(void)
+{
+    static nrf_mesh_tx_token_t token;
+    return ++token;
+}
+
+static uint32_t le32_get(const uint8_t * p_in)
+{
+    return ((uint32_t) p_in[0] | ((uint32_t) p_in[1] << 8) |
+            ((uint32_t) p_in[2] << 16) | ((uint32_t) p_in[3] << 24));
+}
+
+static void le32_put(uint8_t * p_out, uint32_t value)
+{
+    p_out[0] = (uint8_t) value;
+    p_out[1] = (uint8_t) (value >> 8);
+    p_out[2] = (uint8_t) (value >> 16);
+    p_out[3] = (uint8_t) (value >> 24);
+}
+
+/* Time for a message over the given number of relay hops, one transmission more than hops. */
+static uint32_t transit_us(uint8_t hops)
+{
+    uint32_t delay_us = 0;
+    for (uint32_t i = 0; i <= hops; ++i)
+    {
+        delay_us += sim_bearer_hop_delay_us(&m_rand_state);
+    }
+    return delay_us;
+}
+
+/* Hands a message from the given address to the model, received with the given TTL. */
+static void receive(uint8_t opcode, const uint8_t * p_params, uint16_t length, uint16_t src, uint8_t ttl)
+{
+    access_message_rx_t message;
+    memset(&message, 0, sizeof(message));
+    message.opcode.opcode = opcode;
+    message.opcode.company_id = ACCESS_COMPANY_ID_NORDIC;
+    message.p_data = p_params;
+    message.length = length;
+    message.meta_data.src.type = NRF_MESH_ADDRESS_TYPE_UNICAST;
+    message.meta_data.src.value = src;
+    message.meta_data.ttl = ttl;
+
+    for (uint32_t i = 0; i < m_handler_count; ++i)
+    {
+        if (mp_handlers[i].opcode.opcode == opcode && mp_handlers[i].opcode.company_id == ACCESS_COMPANY_ID_NORDIC)
+        {
+            mp_handlers[i].handler(0, &message, NULL);
+            return;
+        }
+    }
+    TEST_ASSERT(false);
+}
+
+static void receive_from_peer(uint8_t opcode, const uint8_t * p_params, uint16_t length, uint8_t hops)
+{
+    receive(opcode, p_params, length, PEER_ADDRESS + hops, SENT_TTL - hops);
+}
+
+/* Bucket bounds of latency_probe.h. */
+static void reference_add(latency_probe_kind_t kind, uint8_t hops, uint32_t latency_us)
+{
+    reference_hist_t * p_hist = &m_reference[kind][hops];
+    uint32_t latency_ms = latency_us / 1000;
+    uint32_t bucket = 0;
+    while (bucket < LATENCY_PROBE_BUCKET_COUNT - 1 && latency_ms >= (8u << bucket))
+    {
+        bucket++;
+    }
+    p_hist->buckets[bucket]++;
+    p_hist->count++;
+    p_hist->sum_ms += latency_ms;
+    if (latency_ms > p_hist->max_ms)
+    {
+        p_hist->max_ms = latency_ms;
+    }
+}
+
+/* Reads a histogram page by page, as a client would. Returns the number of values read. */
+static uint32_t histogram_read(latency_probe_kind_t kind, uint8_t hops, uint16_t * p_values)
+{
+    uint32_t count = 0;
+    for (;;)
+    {
+        uint8_t get[3] = {(uint8_t) kind, hops, (uint8_t) count};
+        uint32_t replies = m_reply.count;
+        receive(LATENCY_PROBE_OPCODE_HIST_GET, get, sizeof(get), PEER_ADDRESS, SENT_TTL);
+        TEST_ASSERT_EQUAL(replies + 1, m_reply.count);
+        TEST_ASSERT_EQUAL(LATENCY_PROBE_OPCODE_HIST_STATUS, m_reply.opcode.opcode);
+        TEST_ASSERT_EQUAL(ACCESS_COMPANY_ID_NORDIC, m_reply.opcode.company_id);
+        TEST_ASSERT(memcmp(m_reply.params, get, sizeof(get)) == 0);
+        TEST_ASSERT((m_reply.length - 3) % 2 == 0);
+
+        uint32_t values = (m_reply.length - 3u) / 2;
+        TEST_ASSERT(values <= LATENCY_PROBE_HIST_VALUES_PER_STATUS);
+        if (values == 0)
+        {
+            return count;
+        }
+        for (uint32_t i = 0; i < values; ++i)
+        {
+            TEST_ASSERT(count < LATENCY_PROBE_HIST_VALUE_COUNT);
+            p_values[count++] = (uint16_t) (m_reply.params[3 + 2 * i] | (m_reply.params[4 + 2 * i] << 8));
+        }
+    }
+}
+
+static void histogram_check(latency_probe_kind_t kind, uint8_t hops)
+{
+    const reference_hist_t * p_ref = &m_reference[kind][hops];
+    uint16_t values[LATENCY_PROBE_HIST_VALUE_COUNT];
+
+    TEST_ASSERT_EQUAL(LATENCY_PROBE_HIST_VALUE_COUNT, histogram_read(kind, hops, values));
+    TEST_ASSERT_EQUAL(p_ref->count, values[0]);
+    TEST_ASSERT_EQUAL(p_ref->count ? p_ref->sum_ms / p_ref->count : 0, values[1]);
+    TEST_ASSERT_EQUAL(p_ref->max_ms, values[2]);
+    for (uint32_t i = 0; i < LATENCY_PROBE_BUCKET_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL(p_ref->buckets[i], values[3 + i]);
+    }
+}
+
+static uint8_t random_hops(void)
+{
+    return (uint8_t) (test_rand(&m_rand_state) % (LATENCY_PROBE_HOPS_MAX + 1));
+}
+
+/* A peer makes itself the time reference. Returns the sync error of the node under test, its
+ * network time minus the one of the peers. */
+static int32_t peer_sync(uint8_t hops)
+{
+    uint8_t sync[5];
+    le32_put(&sync[0], m_now + PEER_CLOCK_OFFSET);
+    sync[4] = SENT_TTL;
+    uint32_t delay_us = transit_us(hops);
+    m_now += delay_us;
+    receive_from_peer(LATENCY_PROBE_OPCODE_SYNC, sync, sizeof(sync), hops);
+
+    /* Until pings have been answered the probe assumes the default delay per transmission. */
+    return (int32_t) ((hops + 1) * LATENCY_PROBE_HOP_DELAY_US_DEFAULT - delay_us);
+}
+
+/* A synced peer presses its switch. The OnOff Set and the Mark travel independently, the light
+ * changes when the Set arrives. Returns the time from the press to the light change. */
+static uint32_t peer_press(uint8_t hops, uint8_t seq)
+{
+    uint8_t mark[7];
+    mark[0] = seq;
+    le32_put(&mark[1], m_now + PEER_CLOCK_OFFSET);
+    mark[5] = SENT_TTL;
+    mark[6] = 1;
+
+    timestamp_t press_us = m_now;
+    uint32_t set_us = transit_us(hops);
+    uint32_t mark_us = transit_us(hops);
+    if (mark_us < set_us)
+    {
+        m_now = press_us + mark_us;
+        receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), hops);
+        m_now = press_us + set_us;
+        latency_probe_light_mark();
+    }
+    else
+    {
+        m_now = press_us + set_us;
+        latency_probe_light_mark();
+        m_now = press_us + mark_us;
+        receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), hops);
+    }
+    return set_us;
+}
+
+static void test_press_outside_session(void)
+{
+    uint8_t mark[7] = {1, 0, 0, 0, 0, SENT_TTL, 1};
+
+    le32_put(&mark[1], m_now + PEER_CLOCK_OFFSET);
+    receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), 0);
+    m_now += 10000;
+    latency_probe_light_mark();
+
+    /* No session, so no Mark of its own either. */
+    latency_probe_press_begin();
+    latency_probe_press_mark();
+    TEST_ASSERT_EQUAL(0, m_published.count);
+    m_now += ROUND_GAP_US;
+}
+
+static void test_press_latency(void)
+{
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+        /* Sync to a reference at a random distance, then a press on another node. */
+        int32_t sync_error_us = peer_sync(random_hops());
+        m_now += ROUND_GAP_US;
+
+        uint8_t hops = random_hops();
+        uint32_t light_us = peer_press(hops, (uint8_t) round);
+        reference_add(LATENCY_PROBE_KIND_PRESS, hops, (uint32_t) ((int32_t) light_us + sync_error_us));
+        m_now += ROUND_GAP_US;
+    }
+}
+
+static void test_press_unpaired(void)
+{
+    (void) peer_sync(0);
+
+    /* A Mark whose light change comes after the pairing window. */
+    uint8_t mark[7] = {0, 0, 0, 0, 0, SENT_TTL, 1};
+    le32_put(&mark[1], m_now + PEER_CLOCK_OFFSET);
+    receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), 0);
+    m_now += (LATENCY_PROBE_PAIR_WINDOW_MS + 500) * 1000;
+    latency_probe_light_mark();
+
+    /* Marks of unsynced senders, with a wrong length and from the node itself are ignored. */
+    mark[6] = 0;
+    le32_put(&mark[1], m_now + PEER_CLOCK_OFFSET);
+    receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), 0);
+    mark[6] = 1;
+    receive_from_peer(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark) - 1, 0);
+    receive(LATENCY_PROBE_OPCODE_MARK, mark, sizeof(mark), LOCAL_ADDRESS + 1, SENT_TTL);
+    m_now += ROUND_GAP_US;
+
+    /* The light change stays unpaired until a later press replaces it. */
+    int32_t sync_error_us = peer_sync(1);
+    uint32_t light_us = peer_press(2, 0);
+    reference_add(LATENCY_PROBE_KIND_PRESS, 2, (uint32_t) ((int32_t) light_us + sync_error_us));
+
+    /* After the session, nothing is paired. */
+    m_now += LATENCY_PROBE_SESSION_TIMEOUT_MS * 1000u + 1000;
+    (void) peer_press(1, 1);
+    m_now += ROUND_GAP_US;
+}
+
+static void test_ping_echo(void)
+{
+    uint8_t last_echo[6];
+    bool last_valid = false;
+
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+        uint8_t hops = random_hops();
+        uint32_t published = m_published.count;
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, latency_probe_ping_send());
+        TEST_ASSERT_EQUAL(published + 1, m_published.count);
+        TEST_ASSERT_EQUAL(LATENCY_PROBE_OPCODE_PING, m_published.opcode.opcode);
+        TEST_ASSERT_EQUAL(6, m_published.length);
+        TEST_ASSERT_EQUAL(m_now, le32_get(&m_published.params[1]));
+        TEST_ASSERT_EQUAL(SENT_TTL, m_published.params[5]);
+
+        /* The peer echoes with the hops the ping took, the echo takes as many. */
+        uint8_t echo[6];
+        memcpy(echo, m_published.params, 5);
+        echo[5] = hops;
+        uint32_t round_trip_us = transit_us(hops) + transit_us(hops);
+        m_now += round_trip_us;
+
+        /* A late echo of the previous ping is ignored. */
+        if (last_valid)
+        {
+            receive_from_peer(LATENCY_PROBE_OPCODE_ECHO, last_echo, sizeof(last_echo), hops);
+        }
+        receive_from_peer(LATENCY_PROBE_OPCODE_ECHO, echo, sizeof(echo), hops);
+        reference_add(LATENCY_PROBE_KIND_PING, hops, round_trip_us / 2);
+        memcpy(last_echo, echo, sizeof(echo));
+        last_valid = true;
+        m_now += ROUND_GAP_US;
+    }
+}
+
+static void test_ping_reply(void)
+{
+    for (uint8_t hops = 0; hops <= LATENCY_PROBE_HOPS_MAX; ++hops)
+    {
+        uint8_t ping[6] = {hops, 0, 0, 0, 0, SENT_TTL};
+        le32_put(&ping[1], m_now + PEER_CLOCK_OFFSET);
+        uint32_t replies = m_reply.count;
+        receive_from_peer(LATENCY_PROBE_OPCODE_PING, ping, sizeof(ping), hops);
+        TEST_ASSERT_EQUAL(replies + 1, m_reply.count);
+        TEST_ASSERT_EQUAL(LATENCY_PROBE_OPCODE_ECHO, m_reply.opcode.opcode);
+        TEST_ASSERT_EQUAL(6, m_reply.length);
+        TEST_ASSERT(memcmp(m_reply.params, ping, 5) == 0);
+        TEST_ASSERT_EQUAL(hops, m_reply.params[5]);
+    }
+
+    /* Pings of the node itself and with a wrong length are not answered. */
+    uint8_t ping[6] = {0, 0, 0, 0, 0, SENT_TTL};
+    uint32_t replies = m_reply.count;
+    receive(LATENCY_PROBE_OPCODE_PING, ping, sizeof(ping), LOCAL_ADDRESS, SENT_TTL);
+    receive_from_peer(LATENCY_PROBE_OPCODE_PING, ping, sizeof(ping) - 1, 0);
+    TEST_ASSERT_EQUAL(replies, m_reply.count);
+}
+
+static void test_sync_and_mark_send(void)
+{
+    uint32_t published = m_published.count;
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, latency_probe_sync_send());
+    TEST_ASSERT_EQUAL(published + 1, m_published.count);
+    TEST_ASSERT_EQUAL(LATENCY_PROBE_OPCODE_SYNC, m_published.opcode.opcode);
+    TEST_ASSERT_EQUAL(5, m_published.length);
+    TEST_ASSERT_EQUAL(SENT_TTL, m_published.params[4]);
+    uint32_t sync_time = le32_get(&m_published.params[0]);
+
+    /* Marks carry the press time in the network time of the Sync, and the publish TTL. */
+    m_publish_ttl = 7;
+    m_now += 1234567;
+    latency_probe_press_begin();
+    m_now += 800;
+    latency_probe_press_mark();
+    TEST_ASSERT_EQUAL(published + 2, m_published.count);
+    TEST_ASSERT_EQUAL(LATENCY_PROBE_OPCODE_MARK, m_published.opcode.opcode);
+    TEST_ASSERT_EQUAL(7, m_published.length);
+    TEST_ASSERT_EQUAL(sync_time + 1234567, le32_get(&m_published.params[1]));
+    TEST_ASSERT_EQUAL(7, m_published.params[5]);
+    TEST_ASSERT_EQUAL(1, m_published.params[6]);
+    uint8_t seq = m_published.params[0];
+
+    /* A press is marked once. */
+    latency_probe_press_mark();
+    TEST_ASSERT_EQUAL(published + 2, m_published.count);
+    latency_probe_press_begin();
+    latency_probe_press_mark();
+    TEST_ASSERT_EQUAL(published + 3, m_published.count);
+    TEST_ASSERT_EQUAL((uint8_t) (seq + 1), m_published.params[0]);
+
+    /* The session of the reference ends as well. */
+    m_now += LATENCY_PROBE_SESSION_TIMEOUT_MS * 1000u + 1000;
+    latency_probe_press_begin();
+    latency_probe_press_mark();
+    TEST_ASSERT_EQUAL(published + 3, m_published.count);
+    m_publish_ttl = ACCESS_TTL_USE_DEFAULT;
+}
+
+static void test_histograms(void)
+{
+    for (uint32_t kind = 0; kind < LATENCY_PROBE_KIND_COUNT; ++kind)
+    {
+        for (uint8_t hops = 0; hops <= LATENCY_PROBE_HOPS_MAX; ++hops)
+        {
+            TEST_ASSERT(m_reference[kind][hops].count > 0);
+            histogram_check((latency_probe_kind_t) kind, hops);
+        }
+    }
+
+    /* Every relay hop adds a transmission, so the one-way latency grows with the hops. */
+    for (uint8_t hops = 1; hops <= LATENCY_PROBE_HOPS_MAX; ++hops)
+    {
+        const reference_hist_t * p_ref = &m_reference[LATENCY_PROBE_KIND_PING][hops];
+        const reference_hist_t * p_closer = &m_reference[LATENCY_PROBE_KIND_PING][hops - 1];
+        TEST_ASSERT(p_ref->sum_ms / p_ref->count > p_closer->sum_ms / p_closer->count);
+    }
+
+    /* Requests for unknown histograms and with a wrong length are not answered. */
+    uint32_t replies = m_reply.count;
+    uint8_t get[3] = {LATENCY_PROBE_KIND_COUNT, 0, 0};
+    receive(LATENCY_PROBE_OPCODE_HIST_GET, get, sizeof(get), PEER_ADDRESS, SENT_TTL);
+    get[0] = LATENCY_PROBE_KIND_PING;
+    get[1] = LATENCY_PROBE_HOPS_MAX + 1;
+    receive(LATENCY_PROBE_OPCODE_HIST_GET, get, sizeof(get), PEER_ADDRESS, SENT_TTL);
+    get[1] = 0;
+    receive(LATENCY_PROBE_OPCODE_HIST_GET, get, sizeof(get) - 1, PEER_ADDRESS, SENT_TTL);
+    TEST_ASSERT_EQUAL(replies, m_reply.count);
+
+    latency_probe_report_log();
+}
+
+int main(void)
+{
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, latency_probe_init(0));
+    TEST_ASSERT_EQUAL(NRF_ERROR_INVALID_STATE, latency_probe_init(0));
+
+    /* The press tests rely on the default hop delay, before any echo updates it. */
+    TEST_RUN(test_press_outside_session);
+    TEST_RUN(test_press_latency);
+    TEST_RUN(test_press_unpaired);
+    TEST_RUN(test_ping_echo);
+    TEST_RUN(test_ping_reply);
+    TEST_RUN(test_sync_and_mark_send);
+    TEST_RUN(test_histograms);
+    return 0;
+}
@@ -0,0 +1,240 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mesh_mem_pool.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "mesh_mem.h"
+#include "diag_model.h"
+#include "test_assert.h"
+
+static const mesh_mem_pool_class_t CLASS_NONE = MESH_MEM_POOL_CLASS_COUNT;
+
+static uint16_t in_use_get(mesh_mem_pool_class_t size_class)
+{
+    mesh_mem_pool_stats_t stats;
+    mesh_mem_pool_stats_get(size_class, &stats);
+    return stats.in_use;
+}
+
+/* Allocates and returns the class that served the request, by the change of its in_use count. */
+static mesh_mem_pool_class_t alloc_class(size_t size, void ** pp_block)
+{
+    uint16_t before[MESH_MEM_POOL_CLASS_COUNT];
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        before[i] = in_use_get((mesh_mem_pool_class_t) i);
+    }
+    *pp_block = mesh_mem_alloc(size);
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        if (in_use_get((mesh_mem_pool_class_t) i) != before[i])
+        {
+            TEST_ASSERT(*pp_block != NULL);
+            return (mesh_mem_pool_class_t) i;
+        }
+    }
+    TEST_ASSERT(*pp_block == NULL);
+    return CLASS_NONE;
+}
+
+static void test_smallest_fitting_class(void)
+{
+    mesh_mem_init();
+    void * p_small;
+    void * p_medium;
+    void * p_large;
+    void * p_none;
+
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_SMALL, alloc_class(MESH_MEM_POOL_SMALL_SIZE, &p_small));
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_MEDIUM, alloc_class(MESH_MEM_POOL_SMALL_SIZE + 1, &p_medium));
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_LARGE, alloc_class(MESH_MEM_POOL_MEDIUM_SIZE + 1, &p_large));
+
+    uint32_t failures = mesh_mem_pool_failures_get();
+    TEST_ASSERT_EQUAL(CLASS_NONE, alloc_class(MESH_MEM_POOL_LARGE_SIZE + 1, &p_none));
+    TEST_ASSERT_EQUAL(failures + 1, mesh_mem_pool_failures_get());
+
+    mesh_mem_free(p_small);
+    mesh_mem_free(p_medium);
+    mesh_mem_free(p_large);
+    mesh_mem_free(NULL);
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL(0, in_use_get((mesh_mem_pool_class_t) i));
+    }
+}
+
+static void test_exhausted_class_falls_through(void)
+{
+    mesh_mem_init();
+    void * blocks[MESH_MEM_POOL_SMALL_COUNT + 1];
+
+    for (uint32_t i = 0; i < MESH_MEM_POOL_SMALL_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_SMALL, alloc_class(1, &blocks[i]));
+    }
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_MEDIUM, alloc_class(1, &blocks[MESH_MEM_POOL_SMALL_COUNT]));
+
+    mesh_mem_pool_stats_t stats;
+    mesh_mem_pool_stats_get(MESH_MEM_POOL_CLASS_SMALL, &stats);
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_SMALL_COUNT, stats.hwm);
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_SMALL_COUNT, diag_counter_get(DIAG_COUNTER_MEM_SMALL_HWM));
+
+    for (uint32_t i = 0; i <= MESH_MEM_POOL_SMALL_COUNT; ++i)
+    {
+        mesh_mem_free(blocks[i]);
+    }
+    mesh_mem_pool_stats_get(MESH_MEM_POOL_CLASS_SMALL, &stats);
+    TEST_ASSERT_EQUAL(0, stats.in_use);
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_SMALL_COUNT, stats.hwm);
+    TEST_ASSERT_EQUAL(1, stats.request_max);
+}
+
+static void test_size_histogram(void)
+{
+    mesh_mem_init();
+    static const size_t sizes[] = {0, 1, 12, 13, 24, MESH_MEM_POOL_LARGE_SIZE, MESH_MEM_POOL_LARGE_SIZE + 1};
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        mesh_mem_free(mesh_mem_alloc(sizes[i]));
+    }
+
+    uint16_t counts[MESH_MEM_POOL_SIZE_BUCKET_COUNT];
+    mesh_mem_pool_size_histogram_get(counts);
+    TEST_ASSERT_EQUAL(1, counts[0]);
+    TEST_ASSERT_EQUAL(2, counts[1]);
+    TEST_ASSERT_EQUAL(2, counts[2]);
+    TEST_ASSERT_EQUAL(1, counts[MESH_MEM_POOL_SEGMENTS_MAX]);
+    TEST_ASSERT_EQUAL(1, counts[MESH_MEM_POOL_SEGMENTS_MAX + 1]);
+}
+
+static void test_random_blocks_do_not_overlap(void)
+{
+    enum { LIVE_MAX = 32 };
+    struct
+    {
+        uint8_t * p_block;
+        size_t size;
+        uint8_t fill;
+    } live[LIVE_MAX];
+    uint32_t live_count = 0;
+    unsigned rand_state = 0x1234567;
+
+    mesh_mem_init();
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        unsigned r = test_rand(&rand_state);
+        if (live_count < LIVE_MAX && (r & 1))
+        {
+            size_t size = 1 + (r >> 8) % MESH_MEM_POOL_LARGE_SIZE;
+            uint8_t * p_block = mesh_mem_alloc(size);
+            if (p_block != NULL)
+            {
+                live[live_count].p_block = p_block;
+                live[live_count].size = size;
+                live[live_count].fill = (uint8_t) (r >> 24);
+                memset(p_block, live[live_count].fill, size);
+                live_count++;
+            }
+        }
+        else if (live_count > 0)
+        {
+            uint32_t index = (r >> 8) % live_count;
+            for (size_t j = 0; j < live[index].size; ++j)
+            {
+                TEST_ASSERT_EQUAL(live[index].fill, live[index].p_block[j]);
+            }
+            mesh_mem_free(live[index].p_block);
+            live[index] = live[--live_count];
+        }
+    }
+    while (live_count > 0)
+    {
+        mesh_mem_free(live[--live_count].p_block);
+    }
+    for (uint32_t i = 0; i < MESH_MEM_POOL_CLASS_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL(0, in_use_get((mesh_mem_pool_class_t) i));
+    }
+}
+
+/* Runs last: a region can only be donated once. */
+static void test_donated_region(void)
+{
+    static uint32_t region[3 * ((MESH_MEM_POOL_LARGE_SIZE + 3) / 4) + 1];
+    void * large[MESH_MEM_POOL_LARGE_COUNT];
+    void * p_block;
+
+    mesh_mem_init();
+    for (uint32_t i = 0; i < MESH_MEM_POOL_LARGE_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_LARGE, alloc_class(MESH_MEM_POOL_LARGE_SIZE, &large[i]));
+    }
+    TEST_ASSERT_EQUAL(CLASS_NONE, alloc_class(MESH_MEM_POOL_LARGE_SIZE, &p_block));
+
+    mesh_mem_pool_region_add(region, sizeof(region));
+    mesh_mem_pool_stats_t stats;
+    mesh_mem_pool_stats_get(MESH_MEM_POOL_CLASS_REGION, &stats);
+    TEST_ASSERT_EQUAL(3, stats.block_count);
+
+    void * region_blocks[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_REGION, alloc_class(MESH_MEM_POOL_LARGE_SIZE, &region_blocks[i]));
+        TEST_ASSERT((uint8_t *) region_blocks[i] >= (uint8_t *) region &&
+                    (uint8_t *) region_blocks[i] + MESH_MEM_POOL_LARGE_SIZE <= (uint8_t *) region + sizeof(region));
+    }
+    TEST_ASSERT_EQUAL(CLASS_NONE, alloc_class(MESH_MEM_POOL_LARGE_SIZE, &p_block));
+
+    mesh_mem_free(region_blocks[1]);
+    TEST_ASSERT_EQUAL(MESH_MEM_POOL_CLASS_REGION, alloc_class(MESH_MEM_POOL_LARGE_SIZE, &p_block));
+    TEST_ASSERT(p_block == region_blocks[1]);
+    TEST_ASSERT_EQUAL(3, diag_counter_get(DIAG_COUNTER_MEM_REGION_HWM));
+}
+
+int main(void)
+{
+    TEST_RUN(test_smallest_fitting_class);
+    TEST_RUN(test_exhausted_class_falls_through);
+    TEST_RUN(test_size_histogram);
+    TEST_RUN(test_random_blocks_do_not_overlap);
+    TEST_RUN(test_donated_region);
+    return 0;
+}
@@ -0,0 +1,262 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/* Unit tests for SDKPatch/msg_cache.c. */
+
+#include "msg_cache.h"
+#include "msg_cache_stats.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_mesh_config_core.h"
+#include "timer.h"
+#include "diag_model.h"
+#include "test_assert.h"
+
+/* The cache keeps arrival times in units of 2^16 us, so an evicted entry counts as aged from one
+ * unit after MSG_CACHE_MAX_AGE_MS. */
+#define TIME_UNIT_US        (1u << 16)
+#define YOUNG_AGE_US        ((MSG_CACHE_MAX_AGE_MS * 1000u / TIME_UNIT_US) * TIME_UNIT_US - 1)
+#define AGED_AGE_US         ((MSG_CACHE_MAX_AGE_MS * 1000u / TIME_UNIT_US + 1) * TIME_UNIT_US)
+
+static timestamp_t m_now;
+
+timestamp_t timer_now(void)
+{
+    return m_now;
+}
+
+static void setup(timestamp_t now)
+{
+    m_now = now;
+    msg_cache_init();
+}
+
+static void test_duplicate(void)
+{
+    setup(0);
+    TEST_ASSERT(!msg_cache_entry_exists(0x0001, 10));
+    msg_cache_entry_add(0x0001, 10);
+
+    TEST_ASSERT(msg_cache_entry_exists(0x0001, 10));
+    TEST_ASSERT(!msg_cache_entry_exists(0x0001, 11));
+    TEST_ASSERT(!msg_cache_entry_exists(0x0002, 10));
+
+    /* Sequence numbers are 24 bits. */
+    msg_cache_entry_add(0x0002, 0xFFFFFF);
+    TEST_ASSERT(msg_cache_entry_exists(0x0002, 0xFFFFFF));
+
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(5, stats.lookups);
+    TEST_ASSERT_EQUAL(2, stats.hits);
+    TEST_ASSERT_EQUAL(2, stats.entries);
+}
+
+static void cache_fill(uint16_t src, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        msg_cache_entry_add(src, i);
+    }
+}
+
+/* Entries are never dropped for their age alone, and an eviction is classified by the age of the
+ * evicted entry. */
+static void test_ageing(void)
+{
+    setup(1000);
+    msg_cache_entry_add(0x0001, 1);
+
+    m_now += 10 * AGED_AGE_US;
+    TEST_ASSERT(msg_cache_entry_exists(0x0001, 1));
+
+    /* Filling the cache evicts the aged entry. */
+    cache_fill(0x0002, MSG_CACHE_ENTRY_COUNT);
+    TEST_ASSERT(!msg_cache_entry_exists(0x0001, 1));
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.age_evictions);
+    TEST_ASSERT_EQUAL(0, stats.capacity_evictions);
+    TEST_ASSERT_EQUAL(MSG_CACHE_ENTRY_COUNT, stats.entries);
+
+    /* The entries of the fill are younger than the maximum age when they are evicted. */
+    m_now += YOUNG_AGE_US;
+    cache_fill(0x0003, 2);
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.age_evictions);
+    TEST_ASSERT_EQUAL(2, stats.capacity_evictions);
+
+    /* and older after it. */
+    m_now += AGED_AGE_US - YOUNG_AGE_US;
+    cache_fill(0x0004, 2);
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(3, stats.age_evictions);
+    TEST_ASSERT_EQUAL(2, stats.capacity_evictions);
+}
+
+/* An idle period longer than the wrap of the 8-bit entry times does not make old entries look
+ * young. */
+static void test_idle(void)
+{
+    setup(0);
+    cache_fill(0x0001, MSG_CACHE_ENTRY_COUNT);
+    m_now += 256 * TIME_UNIT_US;
+    msg_cache_entry_add(0x0002, 1);
+    TEST_ASSERT(msg_cache_entry_exists(0x0001, 1));
+
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.age_evictions);
+    TEST_ASSERT_EQUAL(0, stats.capacity_evictions);
+}
+
+static void test_capacity(void)
+{
+    setup(0);
+    uint32_t evictions = diag_counter_get(DIAG_COUNTER_MSG_CACHE_CAPACITY_EVICTIONS);
+    for (uint32_t i = 0; i <= MSG_CACHE_ENTRY_COUNT; ++i)
+    {
+        msg_cache_entry_add(0x0001, i);
+    }
+
+    /* The oldest entry made room for the last one. */
+    TEST_ASSERT(!msg_cache_entry_exists(0x0001, 0));
+    for (uint32_t i = 1; i <= MSG_CACHE_ENTRY_COUNT; ++i)
+    {
+        TEST_ASSERT(msg_cache_entry_exists(0x0001, i));
+    }
+
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.capacity_evictions);
+    TEST_ASSERT_EQUAL(MSG_CACHE_ENTRY_COUNT, stats.entries);
+    TEST_ASSERT_EQUAL(evictions + 1, diag_counter_get(DIAG_COUNTER_MSG_CACHE_CAPACITY_EVICTIONS));
+}
+
+static void test_timer_wrap(void)
+{
+    setup(UINT32_MAX - TIME_UNIT_US);
+    msg_cache_entry_add(0x0001, 1);
+
+    m_now += 2 * TIME_UNIT_US;
+    TEST_ASSERT(msg_cache_entry_exists(0x0001, 1));
+
+    /* Aged across the wrap of the timer. */
+    m_now = UINT32_MAX - TIME_UNIT_US + AGED_AGE_US;
+    cache_fill(0x0002, MSG_CACHE_ENTRY_COUNT);
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.age_evictions);
+}
+
+static void test_clear(void)
+{
+    setup(0);
+    msg_cache_entry_add(0x0001, 1);
+    msg_cache_clear();
+    TEST_ASSERT(!msg_cache_entry_exists(0x0001, 1));
+    msg_cache_entry_add(0x0001, 1);
+    TEST_ASSERT(msg_cache_entry_exists(0x0001, 1));
+}
+
+/* Random traffic against a reference log of every insertion: a PDU is found while it is among
+ * the last MSG_CACHE_ENTRY_COUNT insertions, whatever its age, and a PDU that was never inserted
+ * is never found. The gaps alternate between the peak rate and slower traffic, and every
+ * eviction is counted as aged or capacity by the age of the evicted entry. */
+static void test_random_traffic(void)
+{
+    enum { INSERTIONS = 20000, SOURCES = 64 };
+    static uint16_t src[INSERTIONS];
+    static uint32_t seq[INSERTIONS];
+    static timestamp_t time[INSERTIONS];
+    uint32_t next_seq[SOURCES] = {0};
+    uint32_t young_evictions = 0;
+    uint32_t aged_evictions = 0;
+    unsigned rand_state = 12345;
+
+    setup(UINT32_MAX - 5000000);
+    for (uint32_t i = 0; i < INSERTIONS; ++i)
+    {
+        /* Mean gap of about 6 ms, the 10,000 packets per minute of the sizing, or ten times that. */
+        uint32_t gap_max_us = ((i / 1000) % 2) ? 120000 : 12000;
+        m_now += test_rand(&rand_state) % gap_max_us;
+
+        uint32_t source = test_rand(&rand_state) % SOURCES;
+        src[i] = (uint16_t) (0x0100 + source);
+        seq[i] = next_seq[source]++;
+        time[i] = m_now;
+        TEST_ASSERT(!msg_cache_entry_exists(src[i], seq[i]));
+        msg_cache_entry_add(src[i], seq[i]);
+        if (i >= MSG_CACHE_ENTRY_COUNT)
+        {
+            timestamp_t age = m_now - time[i - MSG_CACHE_ENTRY_COUNT];
+            young_evictions += (age <= YOUNG_AGE_US);
+            aged_evictions += (age >= AGED_AGE_US);
+        }
+
+        uint32_t back = test_rand(&rand_state) % (2 * MSG_CACHE_ENTRY_COUNT);
+        if (back <= i)
+        {
+            uint32_t j = i - back;
+            TEST_ASSERT_EQUAL(back < MSG_CACHE_ENTRY_COUNT, msg_cache_entry_exists(src[j], seq[j]));
+        }
+
+        /* A future sequence number of the same source. */
+        TEST_ASSERT(!msg_cache_entry_exists(src[i], next_seq[source] + 1000));
+    }
+
+    msg_cache_stats_t stats;
+    msg_cache_stats_get(&stats);
+    TEST_ASSERT_EQUAL(INSERTIONS - MSG_CACHE_ENTRY_COUNT, stats.age_evictions + stats.capacity_evictions);
+    TEST_ASSERT(stats.capacity_evictions >= young_evictions);
+    TEST_ASSERT(stats.age_evictions >= aged_evictions);
+    TEST_ASSERT(aged_evictions > 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_duplicate);
+    TEST_RUN(test_ageing);
+    TEST_RUN(test_idle);
+    TEST_RUN(test_capacity);
+    TEST_RUN(test_timer_wrap);
+    TEST_RUN(test_clear);
+    TEST_RUN(test_random_traffic);
+    return 0;
+}
@@ -0,0 +1,270 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for src/oob_color.c. The flash settings are converted to SX1509 register values by
+ * SDKPatch/sx150x_led_drv_calc.c at the ClkX set in main.c, as drv_ext_light does, and the
+ * stand-ins below record what the lightwell shows at every step of the application timer. */
+
+#include "oob_color.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "nrf_error.h"
+#include "drv_ext_light.h"
+#include "sx150x_led_drv_calc.h"
+#include "timer_service.h"
+#include "test_assert.h"
+
+/* 2 MHz internal oscillator divided by 8, DRV_EXT_LIGHT_CLKX_DIV_8 in main.c. */
+#define CLKX_TICS_PR_SEC    (250000)
+#define LIGHTWELL_PORT_MASK (0x0007)
+
+typedef enum
+{
+    LIGHT_OFF,
+    LIGHT_STEADY,
+    LIGHT_FLASHING,
+} light_mode_t;
+
+static light_mode_t m_mode;
+static drv_ext_light_color_mix_t m_color;
+/* Flash timing after the conversion to register values. */
+static drv_ext_light_sequence_t m_flash;
+
+static app_timer_timeout_handler_t m_timeout_handler;
+static uint32_t m_timeout_ms;
+static bool m_timer_running;
+
+uint32_t timer_service_create(timer_service_t * p_timer,
+                              app_timer_mode_t mode,
+                              app_timer_timeout_handler_t handler)
+{
+    TEST_ASSERT(p_timer != NULL);
+    TEST_ASSERT(mode == APP_TIMER_MODE_SINGLE_SHOT);
+    m_timeout_handler = handler;
+    return NRF_SUCCESS;
+}
+
+uint32_t timer_service_start(timer_service_t * p_timer, uint32_t timeout_ms, void * p_context)
+{
+    TEST_ASSERT(p_timer != NULL);
+    (void) p_context;
+    m_timeout_ms = timeout_ms;
+    m_timer_running = true;
+    return NRF_SUCCESS;
+}
+
+void timer_service_stop(timer_service_t * p_timer)
+{
+    (void) p_timer;
+    m_timer_running = false;
+}
+
+ret_code_t drv_ext_light_rgb_intensity_set(uint32_t id, drv_ext_light_rgb_intensity_t const * const p_intensity)
+{
+    TEST_ASSERT_EQUAL(DRV_EXT_RGB_LED_LIGHTWELL, id);
+    /* Every channel fully on or off. */
+    TEST_ASSERT(p_intensity->r == 0 || p_intensity->r == 0xFF);
+    TEST_ASSERT(p_intensity->g == 0 || p_intensity->g == 0xFF);
+    TEST_ASSERT(p_intensity->b == 0 || p_intensity->b == 0xFF);
+    m_color = (drv_ext_light_color_mix_t) ((p_intensity->r ? DRV_EXT_LIGHT_COLOR_RED : 0) |
+                                           (p_intensity->g ? DRV_EXT_LIGHT_COLOR_GREEN : 0) |
+                                           (p_intensity->b ? DRV_EXT_LIGHT_COLOR_BLUE : 0));
+    m_mode = LIGHT_STEADY;
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_ext_light_rgb_sequence(uint32_t id, drv_ext_light_rgb_sequence_t const * const p_sequence)
+{
+    sx150x_led_drv_regs_vals_t regs;
+
+    TEST_ASSERT_EQUAL(DRV_EXT_RGB_LED_LIGHTWELL, id);
+    m_flash = p_sequence->sequence_vals;
+    TEST_ASSERT_EQUAL(SX150x_LED_DRC_CALC_STATUS_CODE_SUCCESS,
+                      sx150x_led_drv_calc_convert(LIGHTWELL_PORT_MASK, &m_flash, &regs));
+    /* The shortest on and off time steps of the LED engine. */
+    TEST_ASSERT_EQUAL(1, regs.on_time);
+    TEST_ASSERT_EQUAL(1, regs.off_time);
+    TEST_ASSERT_EQUAL(0, regs.off_intensity);
+    m_color = p_sequence->color;
+    m_mode = LIGHT_FLASHING;
+    return NRF_SUCCESS;
+}
+
+ret_code_t drv_ext_light_off(uint32_t id)
+{
+    TEST_ASSERT_EQUAL(DRV_EXT_RGB_LED_LIGHTWELL, id);
+    m_mode = LIGHT_OFF;
+    return NRF_SUCCESS;
+}
+
+/* Reads a digit off the table of oob_color.h. */
+static uint32_t digit_read(void)
+{
+    uint32_t row;
+
+    switch (m_color)
+    {
+        case DRV_EXT_LIGHT_COLOR_WHITE:  row = 0; break;
+        case DRV_EXT_LIGHT_COLOR_RED:    row = 1; break;
+        case DRV_EXT_LIGHT_COLOR_GREEN:  row = 2; break;
+        case DRV_EXT_LIGHT_COLOR_BLUE:   row = 3; break;
+        case DRV_EXT_LIGHT_COLOR_YELLOW: row = 4; break;
+        default:
+            TEST_ASSERT(false);
+            return 0;
+    }
+    TEST_ASSERT(m_mode != LIGHT_OFF);
+    return (m_mode == LIGHT_FLASHING) ? row + OOB_COLOR_COUNT : row;
+}
+
+/* Reads one sequence from the lightwell, starting at the first digit, and returns its length. */
+static uint32_t sequence_read(uint32_t * p_value)
+{
+    uint32_t total_ms = 0;
+
+    *p_value = 0;
+    for (uint32_t i = 0; i < OOB_COLOR_OUTPUT_SIZE; ++i)
+    {
+        TEST_ASSERT(m_timer_running);
+        *p_value = *p_value * 10 + digit_read();
+        TEST_ASSERT_EQUAL(OOB_COLOR_DIGIT_MS, m_timeout_ms);
+        total_ms += m_timeout_ms;
+        m_timeout_handler(NULL);
+
+        TEST_ASSERT_EQUAL(LIGHT_OFF, m_mode);
+        total_ms += m_timeout_ms;
+        m_timeout_handler(NULL);
+    }
+    return total_ms;
+}
+
+static void test_flash_timing(void)
+{
+    oob_color_show(50000);
+    TEST_ASSERT_EQUAL(LIGHT_FLASHING, m_mode);
+    /* The engine runs the requested times exactly, a digit is two full flash periods. */
+    TEST_ASSERT_EQUAL(OOB_COLOR_FLASH_MS, m_flash.on_time_ms);
+    TEST_ASSERT_EQUAL(OOB_COLOR_FLASH_MS, m_flash.off_time_ms);
+    TEST_ASSERT_EQUAL(0, m_flash.fade_in_time_ms);
+    TEST_ASSERT_EQUAL(0, m_flash.fade_out_time_ms);
+    TEST_ASSERT_EQUAL(2 * (m_flash.on_time_ms + m_flash.off_time_ms), OOB_COLOR_DIGIT_MS);
+    oob_color_stop();
+}
+
+static void test_example(void)
+{
+    uint32_t value;
+
+    oob_color_show(18054);
+    /* Steady red, flashing blue, steady white, flashing white, steady yellow. */
+    TEST_ASSERT_EQUAL(LIGHT_STEADY, m_mode);
+    TEST_ASSERT_EQUAL(DRV_EXT_LIGHT_COLOR_RED, m_color);
+    m_timeout_handler(NULL);
+    m_timeout_handler(NULL);
+    TEST_ASSERT_EQUAL(LIGHT_FLASHING, m_mode);
+    TEST_ASSERT_EQUAL(DRV_EXT_LIGHT_COLOR_BLUE, m_color);
+    oob_color_stop();
+
+    oob_color_show(18054);
+    (void) sequence_read(&value);
+    TEST_ASSERT_EQUAL(18054, value);
+    oob_color_stop();
+}
+
+static void test_every_value(void)
+{
+    uint32_t value;
+
+    for (uint32_t expected = 0; expected < 100000; ++expected)
+    {
+        oob_color_show(expected);
+        (void) sequence_read(&value);
+        TEST_ASSERT_EQUAL(expected, value);
+    }
+    oob_color_stop();
+}
+
+static void test_repeat(void)
+{
+    uint32_t value;
+    uint32_t total_ms;
+
+    oob_color_show(97531);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        total_ms = sequence_read(&value);
+        TEST_ASSERT_EQUAL(97531, value);
+        TEST_ASSERT_EQUAL(OOB_COLOR_SEQUENCE_MS + OOB_COLOR_REPEAT_GAP_MS, total_ms);
+    }
+    /* 1.95 s to read the value, see oob_color.h for why it is not below 1 s. */
+    TEST_ASSERT_EQUAL(1950, OOB_COLOR_SEQUENCE_MS);
+    oob_color_stop();
+}
+
+static void test_stop(void)
+{
+    uint32_t value;
+
+    oob_color_show(55555);
+    m_timeout_handler(NULL);
+    m_timeout_handler(NULL);
+    oob_color_stop();
+    TEST_ASSERT(!m_timer_running);
+    TEST_ASSERT_EQUAL(LIGHT_OFF, m_mode);
+
+    /* A new value starts from its first digit. */
+    oob_color_show(12345);
+    (void) sequence_read(&value);
+    TEST_ASSERT_EQUAL(12345, value);
+    oob_color_stop();
+}
+
+int main(void)
+{
+    sx150x_led_drv_calc_init(0, CLKX_TICS_PR_SEC);
+    oob_color_init();
+
+    TEST_RUN(test_flash_timing);
+    TEST_RUN(test_example);
+    TEST_RUN(test_every_value);
+    TEST_RUN(test_repeat);
+    TEST_RUN(test_stop);
+    return 0;
+}
@@ -0,0 +1,226 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for src/p256_comb.c: known-answer vectors computed with the independent affine
+ * arithmetic of gen_p256_comb_table.py, range checks of the private key and the retries of key
+ * pair generation. With TEST_UECC the results are also compared with uECC_compute_public_key()
+ * of micro-ecc for random keys. */
+
+#include "p256_comb.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rand.h"
+#include "test_assert.h"
+
+#if TEST_UECC
+#include "uECC.h"
+#endif
+
+#define UECC_COMPARISONS (200)
+
+typedef struct
+{
+    const char * p_private;
+    const char * p_public;
+} vector_t;
+
+/* python3 gen_p256_comb_table.py --vectors */
+static const vector_t m_vectors[] =
+{
+    {"0000000000000000000000000000000000000000000000000000000000000001",
+     "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C2964FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5"},
+    {"0000000000000000000000000000000000000000000000000000000000000002",
+     "7CF27B188D034F7E8A52380304B51AC3C08969E277F21B35A60B48FC4766997807775510DB8ED040293D9AC69F7430DBBA7DADE63CE982299E04B79D227873D1"},
+    {"0000000000000000000000000000000000000000000000000000000000000003",
+     "5ECBE4D1A6330A44C8F7EF951D4BF165E6C6B721EFADA985FB41661BC6E7FD6C8734640C4998FF7E374B06CE1A64A2ECD82AB036384FB83D9A79B127A27D5032"},
+    {"FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632550",
+     "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296B01CBD1C01E58065711814B583F061E9D431CCA994CEA1313449BF97C840AE0A"},
+    {"FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC63254F",
+     "7CF27B188D034F7E8A52380304B51AC3C08969E277F21B35A60B48FC47669978F888AAEE24712FC0D6C26539608BCF244582521AC3167DD661FB4862DD878C2E"},
+    {"0000000000000000000000000000000000000000000000010000000000000000",
+     "0FA822BC2811AAA58492592E326E25DE29493BAAAD651F7E90E75CB48E14DB63BFF44AE8F5DBA80D6F4AD4BCB3DF188B34B1A65050FE82F5E41124545F462EE7"},
+    {"0000000000000000000000000000000100000000000000000000000000000001",
+     "EF9519328A9C72FFDDC6068BB91DFC60EF7FBD2B1A0A11B713949C932A1D367F611E9FC37DBB2C9BC1EE9807022C219C23183B0895CA1740196035A77376D8A8"},
+    {"8000000000000000000000000000000000000000000000000000000000000000",
+     "77B20A912E6B23135066E911891524BC4EFE3560E3E92350B52DEC8F375F2B54A3DC291825CEA3F7F7B10BFCDD038A72DF623DA1E850E0F1CAA801FCD6CC67FF"},
+    {"C9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721",
+     "60FED4BA255A9D31C961EB74C6356D68C049B8923B61FA6CE669622E60F29FB67903FE1008B8BC99A41AE9E95628BC64F2F1B20C2D7E9F5177A3C294D4462299"},
+    {"750B79840A35E888CEA8684B60033CD65DB233956EA88F4B4F72FD3F7D254DB9",
+     "B0A1F58FE3E991C56FB54053DED00CBA1F1CAEF91B1009F2B37DCF58BCA519359D240905A3E6EB0B75BB669C3A2238D24487258E4DCA0196CA1917A60AB603FC"},
+    {"AACDABBB49C9C6072C54A01283037CADFDE8EC5E3E1544596EBBEC4CC598E828",
+     "46ECCBE9FA9B957F1A338C341E529480453F04F742BF4AF271C2819731389A786212760B85334C16CA8D8D36031B726385A7B2E872156D0FB76406A49606B397"},
+    {"D2AEEAF914C7D3FD9A1AC067541B8EE6F0969FE15284B2BF8E56916A518A4445",
+     "4E44C477E8811F72009C089EA65F3C681787DB692D440F9E31B9001DD4AE7841AF182E2B55132AD5E5DBD9F7B1CBDAB3792BA61EF84486C4385FC5FE38EFEC76"},
+    {"F09B30460CCE5B3445FFF12FB4D7A20D294B97D08E7981664997082C8B7E20C0",
+     "A8456063CE46558F17D782609D65EEA2825C35C090762C581C89FA9A35959D4C8A8564D84105DAED2478419F2F7577755B608868472376D0BABEE06126465A96"},
+    {"FDE9C7E9675BE2B6DA6F2974BEEB65D108C25300FECF0C9277EEB71D894A472C",
+     "9D11D28B1AC56E4C3E8614FC7E956BA98A286DB12A3E94806D00CE33F94F7AB73BD7DBDD3DDDCB7C242BC8234BE10CF46CE9547D4B8000845C686C55C5A1FF81"},
+    {"D7A7836FCAF25F54C66F555C240A97759009EB69B50F9CA5376F3052C49915F6",
+     "467D9ADC23CFFE297B5743B6A8F6A38154C3E9EFCC5BF3477004E9987753706961F34C1C7F637519378CB5076F8285F714F4DEB6338550B43785FF38CB1FD056"},
+    {"5E0466A76C3472AD2271615630CE9BA502F93EB042E9C091A7D0BA3F0605FCA3",
+     "5D2F90B6ED4388CB7F5449737072DE4507B58BC49CAE4A48ABC5FE669843E62A2B022FDAE2D569DFB6F4670AA2F889E8DA5B177D1EF40D84F3673B6DF738DC5F"},
+    {"7A0E0583F37151C4D7BEA6CD4808EBB5723BDD10F425233BFF64E5945D64F7D7",
+     "7AAEB00B480FBD3965A16DD9D0391213AB3E09B929C32684435B01AB054F5F4755A407C2D7A0E171255CE4807196C02C3652C8DA44DB075EEBB6E1C1603D8E91"},
+};
+
+/* Private keys the RNG stand-in returns, in order. */
+static const uint8_t * mp_rng_keys[4];
+static uint32_t m_rng_calls;
+
+void rand_hw_rng_get(uint8_t * p_result, uint16_t len)
+{
+    TEST_ASSERT_EQUAL(P256_COMB_PRIVATE_KEY_SIZE, len);
+    TEST_ASSERT(m_rng_calls < sizeof(mp_rng_keys) / sizeof(mp_rng_keys[0]));
+    memcpy(p_result, mp_rng_keys[m_rng_calls++], len);
+}
+
+static void hex_decode(const char * p_hex, uint8_t * p_out, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        unsigned value;
+        TEST_ASSERT(sscanf(&p_hex[2 * i], "%2x", &value) == 1);
+        p_out[i] = (uint8_t) value;
+    }
+}
+
+static void test_vectors(void)
+{
+    for (uint32_t i = 0; i < sizeof(m_vectors) / sizeof(m_vectors[0]); ++i)
+    {
+        uint8_t private_key[P256_COMB_PRIVATE_KEY_SIZE];
+        uint8_t expected[P256_COMB_PUBLIC_KEY_SIZE];
+        uint8_t public_key[P256_COMB_PUBLIC_KEY_SIZE];
+
+        hex_decode(m_vectors[i].p_private, private_key, sizeof(private_key));
+        hex_decode(m_vectors[i].p_public, expected, sizeof(expected));
+        TEST_ASSERT(p256_comb_public_key_compute(private_key, public_key));
+        TEST_ASSERT(memcmp(expected, public_key, sizeof(expected)) == 0);
+    }
+}
+
+static void test_invalid_keys(void)
+{
+    static const char * const invalid[] =
+    {
+        "0000000000000000000000000000000000000000000000000000000000000000",
+        "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551", /* n */
+        "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632552",
+        "FFFFFFFF00000001000000000000000000000000000000000000000000000000",
+        "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+    };
+
+    for (uint32_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+    {
+        uint8_t private_key[P256_COMB_PRIVATE_KEY_SIZE];
+        uint8_t public_key[P256_COMB_PUBLIC_KEY_SIZE];
+
+        hex_decode(invalid[i], private_key, sizeof(private_key));
+        memset(public_key, 0x5A, sizeof(public_key));
+        TEST_ASSERT(!p256_comb_public_key_compute(private_key, public_key));
+        for (uint32_t j = 0; j < sizeof(public_key); ++j)
+        {
+            TEST_ASSERT_EQUAL(0x5A, public_key[j]);
+        }
+    }
+}
+
+static void test_key_pair_generate_retries(void)
+{
+    uint8_t zero[P256_COMB_PRIVATE_KEY_SIZE];
+    uint8_t order[P256_COMB_PRIVATE_KEY_SIZE];
+    uint8_t valid[P256_COMB_PRIVATE_KEY_SIZE];
+    uint8_t expected[P256_COMB_PUBLIC_KEY_SIZE];
+
+    memset(zero, 0, sizeof(zero));
+    hex_decode("FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551", order, sizeof(order));
+    hex_decode(m_vectors[8].p_private, valid, sizeof(valid));
+    hex_decode(m_vectors[8].p_public, expected, sizeof(expected));
+    mp_rng_keys[0] = zero;
+    mp_rng_keys[1] = order;
+    mp_rng_keys[2] = valid;
+    m_rng_calls = 0;
+
+    uint8_t private_key[P256_COMB_PRIVATE_KEY_SIZE];
+    uint8_t public_key[P256_COMB_PUBLIC_KEY_SIZE];
+    p256_comb_key_pair_generate(public_key, private_key);
+
+    TEST_ASSERT_EQUAL(3, m_rng_calls);
+    TEST_ASSERT(memcmp(valid, private_key, sizeof(valid)) == 0);
+    TEST_ASSERT(memcmp(expected, public_key, sizeof(expected)) == 0);
+}
+
+#if TEST_UECC
+static void test_uecc_equivalence(void)
+{
+    unsigned state = 0x1E7A5EED;
+
+    for (uint32_t i = 0; i < UECC_COMPARISONS; ++i)
+    {
+        uint8_t private_key[P256_COMB_PRIVATE_KEY_SIZE];
+        uint8_t expected[P256_COMB_PUBLIC_KEY_SIZE];
+        uint8_t public_key[P256_COMB_PUBLIC_KEY_SIZE];
+
+        for (uint32_t j = 0; j < sizeof(private_key); ++j)
+        {
+            private_key[j] = (uint8_t) test_rand(&state);
+        }
+
+        bool valid = p256_comb_public_key_compute(private_key, public_key);
+        TEST_ASSERT_EQUAL(uECC_compute_public_key(private_key, expected, uECC_secp256r1()), valid);
+        if (valid)
+        {
+            TEST_ASSERT(memcmp(expected, public_key, sizeof(expected)) == 0);
+        }
+    }
+}
+#endif
+
+int main(void)
+{
+    TEST_RUN(test_vectors);
+    TEST_RUN(test_invalid_keys);
+    TEST_RUN(test_key_pair_generate_retries);
+#if TEST_UECC
+    TEST_RUN(test_uecc_equivalence);
+#endif
+    return 0;
+}
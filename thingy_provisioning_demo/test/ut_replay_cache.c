@@ -0,0 +1,271 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for SDKPatch/replay_cache.c. */
+
+#include "replay_cache.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh_config_core.h"
+#include "diag_model.h"
+#include "test_assert.h"
+
+static uint32_t m_iv_index;
+
+uint32_t net_state_beacon_iv_index_get(void)
+{
+    return m_iv_index;
+}
+
+static void setup(void)
+{
+    m_iv_index = 0;
+    replay_cache_init();
+}
+
+static void test_sequence_window(void)
+{
+    setup();
+    TEST_ASSERT(!replay_cache_has_elem(0x0001, 10, 0));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(0x0001, 10, 0));
+
+    TEST_ASSERT(replay_cache_has_elem(0x0001, 10, 0));
+    TEST_ASSERT(replay_cache_has_elem(0x0001, 9, 0));
+    TEST_ASSERT(!replay_cache_has_elem(0x0001, 11, 0));
+    TEST_ASSERT(!replay_cache_has_elem(0x0002, 1, 0));
+
+    /* A later IV index restarts the sequence numbers, an earlier one is always old. */
+    TEST_ASSERT(!replay_cache_has_elem(0x0001, 0, 1));
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(0x0001, 0, 1));
+    TEST_ASSERT(replay_cache_has_elem(0x0001, 1000, 0));
+
+    /* An older message does not move the window back. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(0x0001, 5000, 0));
+    TEST_ASSERT(replay_cache_has_elem(0x0001, 0, 1));
+}
+
+static void test_full_cache_evicts_least_recently_updated(void)
+{
+    setup();
+    uint32_t evictions = diag_counter_get(DIAG_COUNTER_REPLAY_EVICTIONS);
+    for (uint16_t src = 1; src <= REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, 100, 0));
+    }
+    /* Source 1 sends again, so source 2 is now the one silent for the longest time. */
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(1, 101, 0));
+
+    TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(0x7000, 1, 0));
+    TEST_ASSERT_EQUAL(evictions + 1, diag_counter_get(DIAG_COUNTER_REPLAY_EVICTIONS));
+    TEST_ASSERT(replay_cache_has_elem(0x7000, 1, 0));
+    TEST_ASSERT(replay_cache_has_elem(1, 101, 0));
+    TEST_ASSERT(!replay_cache_has_elem(2, 100, 0));
+    for (uint16_t src = 3; src <= REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT(replay_cache_has_elem(src, 100, 0));
+    }
+
+    /* New sources keep being accepted. */
+    for (uint16_t src = 0x7001; src < 0x7001 + 3 * REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, 1, 0));
+        TEST_ASSERT(replay_cache_has_elem(src, 1, 0));
+    }
+}
+
+static void test_iv_update_reclaims_old_entries(void)
+{
+    setup();
+    uint16_t half = REPLAY_CACHE_ENTRIES / 2;
+    for (uint16_t src = 1; src <= half; ++src)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, 100, 0));
+    }
+    for (uint16_t src = half + 1; src <= REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, 100, 1));
+    }
+
+    /* Entries of the previous IV index stay. */
+    m_iv_index = 1;
+    replay_cache_on_iv_update();
+    TEST_ASSERT(replay_cache_has_elem(1, 100, 0));
+
+    /* At IV index 2, messages from IV index 0 are no longer received: their entries are freed
+     * without evicting anything. */
+    m_iv_index = 2;
+    replay_cache_on_iv_update();
+    uint32_t evictions = diag_counter_get(DIAG_COUNTER_REPLAY_EVICTIONS);
+    for (uint16_t src = 0x1000; src < 0x1000 + half; ++src)
+    {
+        TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, 1, 2));
+    }
+    TEST_ASSERT_EQUAL(evictions, diag_counter_get(DIAG_COUNTER_REPLAY_EVICTIONS));
+    for (uint16_t src = half + 1; src <= REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT(replay_cache_has_elem(src, 100, 1));
+    }
+    for (uint16_t src = 0x1000; src < 0x1000 + half; ++src)
+    {
+        TEST_ASSERT(replay_cache_has_elem(src, 1, 2));
+    }
+}
+
+/* Reference model: the same policy over a plain array in update order. */
+typedef struct
+{
+    uint16_t src;
+    uint32_t seqno;
+    uint32_t iv_index;
+} model_entry_t;
+
+static model_entry_t m_model[REPLAY_CACHE_ENTRIES];
+static uint32_t m_model_count;
+
+static int model_find(uint16_t src)
+{
+    for (uint32_t i = 0; i < m_model_count; ++i)
+    {
+        if (m_model[i].src == src)
+        {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+static void model_remove(uint32_t i)
+{
+    memmove(&m_model[i], &m_model[i + 1], (m_model_count - i - 1) * sizeof(m_model[0]));
+    m_model_count--;
+}
+
+static void model_add(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    int i = model_find(src);
+    if (i >= 0)
+    {
+        if (iv_index > m_model[i].iv_index || (iv_index == m_model[i].iv_index && seqno > m_model[i].seqno))
+        {
+            model_remove((uint32_t) i);
+        }
+        else
+        {
+            return;
+        }
+    }
+    else if (m_model_count == REPLAY_CACHE_ENTRIES)
+    {
+        model_remove(0);
+    }
+    m_model[m_model_count].src = src;
+    m_model[m_model_count].seqno = seqno;
+    m_model[m_model_count].iv_index = iv_index;
+    m_model_count++;
+}
+
+static bool model_has_elem(uint16_t src, uint32_t seqno, uint32_t iv_index)
+{
+    int i = model_find(src);
+    return (i >= 0 &&
+            !(iv_index > m_model[i].iv_index || (iv_index == m_model[i].iv_index && seqno > m_model[i].seqno)));
+}
+
+static void model_on_iv_update(void)
+{
+    for (uint32_t i = m_model_count; i > 0; --i)
+    {
+        if (m_model[i - 1].iv_index + 1 < m_iv_index)
+        {
+            model_remove(i - 1);
+        }
+    }
+}
+
+/* Random operations against the model. Sources are drawn from a range larger than the cache, so
+ * evictions, reclaims and deletions from the middle of probe runs all happen. */
+static void test_random_operations_match_model(void)
+{
+    setup();
+    m_model_count = 0;
+    unsigned state = 12345;
+    uint32_t seqno[4 * REPLAY_CACHE_ENTRIES] = {0};
+
+    for (uint32_t op = 0; op < 200000; ++op)
+    {
+        unsigned r = test_rand(&state);
+        uint16_t src = (uint16_t) (1 + r % (4 * REPLAY_CACHE_ENTRIES));
+        if ((r >> 20) % 2000 == 0)
+        {
+            m_iv_index++;
+            replay_cache_on_iv_update();
+            model_on_iv_update();
+            continue;
+        }
+
+        uint32_t iv_index = m_iv_index - ((r >> 16) % 8 == 0 && m_iv_index > 0 ? 1 : 0);
+        uint32_t msg_seqno = seqno[src - 1] + (r >> 24) % 4;
+        seqno[src - 1] = msg_seqno;
+
+        bool expected = model_has_elem(src, msg_seqno, iv_index);
+        TEST_ASSERT_EQUAL(expected, replay_cache_has_elem(src, msg_seqno, iv_index));
+        if (!expected)
+        {
+            TEST_ASSERT_EQUAL(NRF_SUCCESS, replay_cache_add(src, msg_seqno, iv_index));
+            model_add(src, msg_seqno, iv_index);
+        }
+    }
+
+    for (uint16_t src = 1; src <= 4 * REPLAY_CACHE_ENTRIES; ++src)
+    {
+        TEST_ASSERT_EQUAL(model_has_elem(src, seqno[src - 1], m_iv_index),
+                          replay_cache_has_elem(src, seqno[src - 1], m_iv_index));
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_sequence_window);
+    TEST_RUN(test_full_cache_evicts_least_recently_updated);
+    TEST_RUN(test_iv_update_reclaims_old_entries);
+    TEST_RUN(test_random_operations_match_model);
+    return 0;
+}
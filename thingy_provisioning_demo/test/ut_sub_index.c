@@ -0,0 +1,440 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for src/sub_index.c, against a stand-in for the subscription lists of the access layer
+ * and the address pool of the DSM. The models are those of main.c, with the Power OnOff Setup
+ * server sharing the subscription list of the Power OnOff server as in ponoff_server.c. Changes
+ * are made to the lists first and then reported with the event the Config Server would send,
+ * which names one model only. */
+
+#include "sub_index.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_error.h"
+#include "nrf_mesh.h"
+#include "access.h"
+#include "access_config.h"
+#include "device_state_manager.h"
+#include "config_server_events.h"
+#include "test_assert.h"
+
+/* Model handles in the order main.c adds the models. */
+enum
+{
+    MODEL_CONFIG_SERVER,
+    MODEL_HEALTH_SERVER,
+    MODEL_ONOFF_SERVER,
+    MODEL_ONOFF_CLIENT,
+    MODEL_DIAG,
+    MODEL_LATENCY_PROBE,
+    MODEL_PONOFF_SERVER,
+    MODEL_PONOFF_SETUP_SERVER,
+    MODEL_COUNT
+};
+
+#define LIST_NONE       (0xFF)
+#define ADDR_COUNT      (DSM_NONVIRTUAL_ADDR_MAX + DSM_VIRTUAL_ADDR_MAX)
+#define GROUP_BASE      (0xC000)
+#define VIRTUAL_BASE    (0x8000)
+
+/* Subscription list of each model, the Config Server has none. */
+static const uint8_t m_model_list[MODEL_COUNT] =
+{
+    LIST_NONE, 0, 1, 2, 3, 4, 5, 5
+};
+#define LIST_COUNT      (6)
+
+static bool m_subscribed[LIST_COUNT][ADDR_COUNT];
+static nrf_mesh_address_t m_addresses[ADDR_COUNT];
+static bool m_address_allocated[ADDR_COUNT];
+
+uint32_t access_model_subscriptions_get(access_model_handle_t handle,
+                                        dsm_handle_t * p_address_handles,
+                                        uint16_t * p_count)
+{
+    if (handle >= MODEL_COUNT)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    if (m_model_list[handle] == LIST_NONE)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    uint16_t count = 0;
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        if (m_subscribed[m_model_list[handle]][i])
+        {
+            if (count == *p_count)
+            {
+                return NRF_ERROR_INVALID_LENGTH;
+            }
+            p_address_handles[count++] = i;
+        }
+    }
+    *p_count = count;
+    return NRF_SUCCESS;
+}
+
+uint32_t dsm_address_get(dsm_handle_t address_handle, nrf_mesh_address_t * p_address)
+{
+    if (address_handle >= ADDR_COUNT || !m_address_allocated[address_handle])
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
+    *p_address = m_addresses[address_handle];
+    return NRF_SUCCESS;
+}
+
+static void reset(void)
+{
+    memset(m_subscribed, 0, sizeof(m_subscribed));
+    memset(m_address_allocated, 0, sizeof(m_address_allocated));
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        if (i < DSM_NONVIRTUAL_ADDR_MAX)
+        {
+            m_addresses[i].type = NRF_MESH_ADDRESS_TYPE_GROUP;
+            m_addresses[i].value = (uint16_t) (GROUP_BASE + 0x100 - 7 * i);
+        }
+        else
+        {
+            m_addresses[i].type = NRF_MESH_ADDRESS_TYPE_VIRTUAL;
+            m_addresses[i].value = (uint16_t) (VIRTUAL_BASE + 0x35 * i);
+        }
+        m_addresses[i].p_virtual_uuid = NULL;
+    }
+    sub_index_rebuild();
+}
+
+static void evt_send(config_server_evt_type_t type, access_model_handle_t model_handle, dsm_handle_t address_handle)
+{
+    config_server_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.type = type;
+    switch (type)
+    {
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_ADD:
+            evt.params.model_subscription_add.model_handle = model_handle;
+            evt.params.model_subscription_add.address_handle = address_handle;
+            break;
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE:
+            evt.params.model_subscription_delete.model_handle = model_handle;
+            evt.params.model_subscription_delete.address_handle = address_handle;
+            break;
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE_ALL:
+            evt.params.model_subscription_delete_all.model_handle = model_handle;
+            break;
+        case CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_OVERWRITE:
+            evt.params.model_subscription_overwrite.model_handle = model_handle;
+            evt.params.model_subscription_overwrite.address_handle = address_handle;
+            break;
+        default:
+            break;
+    }
+    sub_index_config_server_evt(&evt);
+}
+
+/* The Config Server allocates the address in the DSM and adds it to the list before the event. */
+static void subscription_add(access_model_handle_t model_handle, dsm_handle_t address_handle)
+{
+    m_address_allocated[address_handle] = true;
+    m_subscribed[m_model_list[model_handle]][address_handle] = true;
+    evt_send(CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_ADD, model_handle, address_handle);
+}
+
+static bool address_in_use(dsm_handle_t address_handle)
+{
+    for (uint32_t list = 0; list < LIST_COUNT; ++list)
+    {
+        if (m_subscribed[list][address_handle])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The DSM frees an address once no list refers to it, before the event is sent. */
+static void subscription_delete(access_model_handle_t model_handle, dsm_handle_t address_handle)
+{
+    m_subscribed[m_model_list[model_handle]][address_handle] = false;
+    m_address_allocated[address_handle] = address_in_use(address_handle);
+    evt_send(CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE, model_handle, address_handle);
+}
+
+static void subscription_delete_all(access_model_handle_t model_handle)
+{
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        m_subscribed[m_model_list[model_handle]][i] = false;
+        m_address_allocated[i] = address_in_use(i);
+    }
+    evt_send(CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_DELETE_ALL, model_handle, DSM_HANDLE_INVALID);
+}
+
+static void subscription_overwrite(access_model_handle_t model_handle, dsm_handle_t address_handle)
+{
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        m_subscribed[m_model_list[model_handle]][i] = false;
+        m_address_allocated[i] = address_in_use(i);
+    }
+    m_address_allocated[address_handle] = true;
+    m_subscribed[m_model_list[model_handle]][address_handle] = true;
+    evt_send(CONFIG_SERVER_EVT_MODEL_SUBSCRIPTION_OVERWRITE, model_handle, address_handle);
+}
+
+/* Models subscribed to an address, computed from the lists. */
+static sub_index_model_mask_t expected_mask(uint16_t address)
+{
+    sub_index_model_mask_t mask = 0;
+    for (access_model_handle_t model = 0; model < MODEL_COUNT; ++model)
+    {
+        if (m_model_list[model] == LIST_NONE)
+        {
+            continue;
+        }
+        for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+        {
+            if (m_subscribed[m_model_list[model]][i] && m_addresses[i].value == address)
+            {
+                mask |= (sub_index_model_mask_t) (1u << model);
+            }
+        }
+    }
+    return mask;
+}
+
+static void index_check(void)
+{
+    uint32_t distinct = 0;
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        uint16_t address = m_addresses[i].value;
+        TEST_ASSERT_EQUAL(expected_mask(address), sub_index_lookup(address));
+        bool first = true;
+        for (dsm_handle_t j = 0; j < i; ++j)
+        {
+            first = first && (m_addresses[j].value != address);
+        }
+        if (first && expected_mask(address) != 0)
+        {
+            distinct++;
+        }
+    }
+    TEST_ASSERT_EQUAL(distinct, sub_index_count_get());
+}
+
+static void test_empty(void)
+{
+    reset();
+    TEST_ASSERT_EQUAL(0, sub_index_count_get());
+    TEST_ASSERT_EQUAL(0, sub_index_lookup(GROUP_BASE));
+    TEST_ASSERT_EQUAL(0, sub_index_lookup(0xFFFF));
+    TEST_ASSERT(!sub_index_is_subscribed(MODEL_ONOFF_SERVER, GROUP_BASE));
+}
+
+static void test_add_delete(void)
+{
+    reset();
+    subscription_add(MODEL_ONOFF_SERVER, 0);
+    TEST_ASSERT_EQUAL(1, sub_index_count_get());
+    TEST_ASSERT_EQUAL(1u << MODEL_ONOFF_SERVER, sub_index_lookup(m_addresses[0].value));
+    TEST_ASSERT(sub_index_is_subscribed(MODEL_ONOFF_SERVER, m_addresses[0].value));
+    TEST_ASSERT(!sub_index_is_subscribed(MODEL_ONOFF_CLIENT, m_addresses[0].value));
+    TEST_ASSERT(!sub_index_is_subscribed(ACCESS_MODEL_COUNT, m_addresses[0].value));
+
+    subscription_add(MODEL_HEALTH_SERVER, 0);
+    TEST_ASSERT_EQUAL(1, sub_index_count_get());
+    TEST_ASSERT_EQUAL((1u << MODEL_ONOFF_SERVER) | (1u << MODEL_HEALTH_SERVER), sub_index_lookup(m_addresses[0].value));
+
+    subscription_delete(MODEL_ONOFF_SERVER, 0);
+    TEST_ASSERT_EQUAL(1u << MODEL_HEALTH_SERVER, sub_index_lookup(m_addresses[0].value));
+    subscription_delete(MODEL_HEALTH_SERVER, 0);
+    TEST_ASSERT_EQUAL(0, sub_index_lookup(m_addresses[0].value));
+    TEST_ASSERT_EQUAL(0, sub_index_count_get());
+}
+
+/* The Config Server reports the change to the model it was addressed to, the index must also
+ * follow the model sharing its list. */
+static void test_shared_list(void)
+{
+    reset();
+    uint16_t address = m_addresses[1].value;
+    sub_index_model_mask_t both = (1u << MODEL_PONOFF_SERVER) | (1u << MODEL_PONOFF_SETUP_SERVER);
+
+    subscription_add(MODEL_PONOFF_SERVER, 1);
+    TEST_ASSERT_EQUAL(both, sub_index_lookup(address));
+    TEST_ASSERT(sub_index_is_subscribed(MODEL_PONOFF_SETUP_SERVER, address));
+
+    subscription_delete(MODEL_PONOFF_SETUP_SERVER, 1);
+    TEST_ASSERT_EQUAL(0, sub_index_lookup(address));
+
+    subscription_overwrite(MODEL_PONOFF_SETUP_SERVER, 1);
+    TEST_ASSERT_EQUAL(both, sub_index_lookup(address));
+
+    subscription_add(MODEL_ONOFF_SERVER, 1);
+    subscription_delete_all(MODEL_PONOFF_SERVER);
+    TEST_ASSERT_EQUAL(1u << MODEL_ONOFF_SERVER, sub_index_lookup(address));
+    index_check();
+}
+
+static void test_overwrite_delete_all(void)
+{
+    reset();
+    for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+    {
+        subscription_add(MODEL_DIAG, i);
+    }
+    subscription_add(MODEL_LATENCY_PROBE, 0);
+    TEST_ASSERT_EQUAL(ADDR_COUNT, sub_index_count_get());
+
+    subscription_overwrite(MODEL_DIAG, ADDR_COUNT - 1);
+    index_check();
+    TEST_ASSERT_EQUAL(2, sub_index_count_get());
+    TEST_ASSERT_EQUAL(1u << MODEL_DIAG, sub_index_lookup(m_addresses[ADDR_COUNT - 1].value));
+
+    subscription_delete_all(MODEL_DIAG);
+    index_check();
+    TEST_ASSERT_EQUAL(1, sub_index_count_get());
+    TEST_ASSERT_EQUAL(1u << MODEL_LATENCY_PROBE, sub_index_lookup(m_addresses[0].value));
+}
+
+/* Every model with a list subscribed to every address the DSM can hold. */
+static void test_full(void)
+{
+    reset();
+    for (access_model_handle_t model = 0; model < MODEL_COUNT; ++model)
+    {
+        if (m_model_list[model] == LIST_NONE)
+        {
+            continue;
+        }
+        for (dsm_handle_t i = 0; i < ADDR_COUNT; ++i)
+        {
+            subscription_add(model, i);
+        }
+    }
+    TEST_ASSERT_EQUAL(SUB_INDEX_ENTRIES_MAX, sub_index_count_get());
+    TEST_ASSERT_EQUAL(0xFF & ~(1u << MODEL_CONFIG_SERVER), sub_index_lookup(m_addresses[0].value));
+    index_check();
+}
+
+/* Two virtual labels with the same hash share an entry. */
+static void test_virtual_hash_collision(void)
+{
+    if (DSM_VIRTUAL_ADDR_MAX < 2)
+    {
+        return;
+    }
+    reset();
+    dsm_handle_t first = DSM_NONVIRTUAL_ADDR_MAX;
+    m_addresses[first + 1].value = m_addresses[first].value;
+    subscription_add(MODEL_ONOFF_SERVER, first);
+    subscription_add(MODEL_ONOFF_CLIENT, first + 1);
+    TEST_ASSERT_EQUAL(1, sub_index_count_get());
+    TEST_ASSERT_EQUAL((1u << MODEL_ONOFF_SERVER) | (1u << MODEL_ONOFF_CLIENT), sub_index_lookup(m_addresses[first].value));
+    subscription_delete(MODEL_ONOFF_SERVER, first);
+    TEST_ASSERT_EQUAL(1u << MODEL_ONOFF_CLIENT, sub_index_lookup(m_addresses[first].value));
+}
+
+static void test_node_reset(void)
+{
+    reset();
+    subscription_add(MODEL_ONOFF_SERVER, 0);
+    subscription_add(MODEL_PONOFF_SERVER, 1);
+    evt_send(CONFIG_SERVER_EVT_APPKEY_ADD, 0, 0);
+    TEST_ASSERT_EQUAL(2, sub_index_count_get());
+    evt_send(CONFIG_SERVER_EVT_NODE_RESET, 0, 0);
+    TEST_ASSERT_EQUAL(0, sub_index_count_get());
+    TEST_ASSERT_EQUAL(0, sub_index_lookup(m_addresses[0].value));
+}
+
+/* Random configuration sequences, checked against the lists after every event, including the
+ * addresses that are not subscribed. */
+static void test_random(void)
+{
+    static const access_model_handle_t models[] =
+    {
+        MODEL_HEALTH_SERVER, MODEL_ONOFF_SERVER, MODEL_ONOFF_CLIENT, MODEL_DIAG,
+        MODEL_LATENCY_PROBE, MODEL_PONOFF_SERVER, MODEL_PONOFF_SETUP_SERVER
+    };
+    unsigned state = 2028;
+    reset();
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        access_model_handle_t model = models[test_rand(&state) % (sizeof(models) / sizeof(models[0]))];
+        dsm_handle_t address_handle = (dsm_handle_t) (test_rand(&state) % ADDR_COUNT);
+        uint32_t op = test_rand(&state) % 16;
+        if (op < 8)
+        {
+            subscription_add(model, address_handle);
+        }
+        else if (op < 14)
+        {
+            subscription_delete(model, address_handle);
+        }
+        else if (op < 15)
+        {
+            subscription_overwrite(model, address_handle);
+        }
+        else
+        {
+            subscription_delete_all(model);
+        }
+        index_check();
+        TEST_ASSERT_EQUAL(0, sub_index_lookup((uint16_t) (GROUP_BASE + 0x101)));
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_empty);
+    TEST_RUN(test_add_delete);
+    TEST_RUN(test_shared_list);
+    TEST_RUN(test_overwrite_delete_all);
+    TEST_RUN(test_full);
+    TEST_RUN(test_virtual_hash_collision);
+    TEST_RUN(test_node_reset);
+    TEST_RUN(test_random);
+    return 0;
+}
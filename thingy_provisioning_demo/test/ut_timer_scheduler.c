@@ -0,0 +1,438 @@
+/* Copyright (c) 2010 - 2019, Nordic Semiconductor ASA
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form, except as embedded into a Nordic
+ *    Semiconductor ASA integrated circuit in a product or a software update for
+ *    such product, must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other
+ *    materials provided with the distribution.
+ *
+ * 3. Neither the name of Nordic Semiconductor ASA nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * 4. This software, with or without modification, must only be used with a
+ *    Nordic Semiconductor ASA integrated circuit.
+ *
+ * 5. Any software provided in binary form under this license must not be reverse
+ *    engineered, decompiled, modified and/or disassembled.
+ *
+ * THIS SOFTWARE IS PROVIDED BY NORDIC SEMICONDUCTOR ASA "AS IS" AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY, NONINFRINGEMENT, AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL NORDIC SEMICONDUCTOR ASA OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ * GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Unit tests for the heap-based timer scheduler in SDKPatch/timer_scheduler.c. The RTC timer and
+ * the bearer event flag are faked: advancing the clock past the programmed timeout calls the timer
+ * callback, which sets the flag, and the flag is processed right away, optionally after a delay to
+ * check the lateness statistics. */
+
+#include "timer_scheduler.h"
+#include "timer_scheduler_stats.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "nrf_mesh_config_core.h"
+#include "bearer_event.h"
+#include "timer.h"
+#include "test_assert.h"
+
+#define EVENTS_MAX  (TIMER_SCH_EVENTS_MAX)
+
+static timestamp_t m_now;
+static bool m_timer_running;
+static timestamp_t m_timer_timestamp;
+static timer_callback_t m_timer_cb;
+static bearer_event_flag_callback_t m_flag_cb;
+static bool m_flag_set;
+static uint32_t m_flag_latency_us;
+
+static timer_event_t m_events[EVENTS_MAX];
+/* Callback log. */
+static uint32_t m_fired[4 * EVENTS_MAX];
+static timestamp_t m_fired_at[4 * EVENTS_MAX];
+static uint32_t m_fired_count;
+/* Actions of the callbacks. */
+static timer_event_t * mp_abort_in_cb;
+static timer_event_t * mp_schedule_in_cb;
+static timestamp_t m_schedule_in_cb_timestamp;
+
+timestamp_t timer_now(void)
+{
+    return m_now;
+}
+
+void timer_start(timestamp_t timestamp, timer_callback_t cb)
+{
+    m_timer_running = true;
+    m_timer_timestamp = timestamp;
+    m_timer_cb = cb;
+}
+
+void timer_stop(void)
+{
+    m_timer_running = false;
+}
+
+bearer_event_flag_t bearer_event_flag_add(bearer_event_flag_callback_t callback)
+{
+    m_flag_cb = callback;
+    return 0;
+}
+
+void bearer_event_flag_set(bearer_event_flag_t flag)
+{
+    TEST_ASSERT_EQUAL(0, flag);
+    m_flag_set = true;
+}
+
+static void event_cb(timestamp_t timestamp, void * p_context)
+{
+    TEST_ASSERT_EQUAL(m_now, timestamp);
+    TEST_ASSERT(m_fired_count < sizeof(m_fired) / sizeof(m_fired[0]));
+    m_fired[m_fired_count] = (uint32_t) (uintptr_t) p_context;
+    m_fired_at[m_fired_count] = timestamp;
+    m_fired_count++;
+
+    timer_event_t * p_evt = &m_events[(uintptr_t) p_context];
+    if (mp_abort_in_cb == p_evt)
+    {
+        timer_sch_abort(p_evt);
+    }
+    if (mp_schedule_in_cb != NULL)
+    {
+        timer_event_t * p_other = mp_schedule_in_cb;
+        mp_schedule_in_cb = NULL;
+        p_other->timestamp = m_schedule_in_cb_timestamp;
+        timer_sch_schedule(p_other);
+    }
+}
+
+/* Runs the clock to @p until, firing the timer at every programmed timeout on the way. */
+static void clock_run(timestamp_t until)
+{
+    while (m_timer_running && (int32_t) (m_timer_timestamp - until) <= 0)
+    {
+        if ((int32_t) (m_timer_timestamp - m_now) > 0)
+        {
+            m_now = m_timer_timestamp;
+        }
+        m_timer_running = false;
+        m_timer_cb(m_now);
+        TEST_ASSERT(m_flag_set);
+        m_flag_set = false;
+        m_now += m_flag_latency_us;
+        TEST_ASSERT(m_flag_cb());
+    }
+    if ((int32_t) (until - m_now) > 0)
+    {
+        m_now = until;
+    }
+}
+
+static void reset(timestamp_t now)
+{
+    m_now = now;
+    m_timer_running = false;
+    m_flag_set = false;
+    m_flag_latency_us = 0;
+    m_fired_count = 0;
+    mp_abort_in_cb = NULL;
+    mp_schedule_in_cb = NULL;
+    memset(m_events, 0, sizeof(m_events));
+    for (uint32_t i = 0; i < EVENTS_MAX; ++i)
+    {
+        m_events[i].cb = event_cb;
+        m_events[i].p_context = (void *) (uintptr_t) i;
+    }
+    timer_sch_init();
+}
+
+static void schedule(uint32_t index, uint32_t timeout_us, uint32_t interval_us)
+{
+    m_events[index].timestamp = m_now + timeout_us;
+    m_events[index].interval = interval_us;
+    timer_sch_schedule(&m_events[index]);
+}
+
+static void test_order(void)
+{
+    reset(1000);
+    schedule(0, 500, 0);
+    schedule(1, 100, 0);
+    schedule(2, 300, 0);
+    schedule(3, 200, 0);
+    TEST_ASSERT(m_timer_running);
+    TEST_ASSERT_EQUAL(1100, m_timer_timestamp);
+
+    clock_run(2000);
+    TEST_ASSERT_EQUAL(4, m_fired_count);
+    TEST_ASSERT_EQUAL(1, m_fired[0]);
+    TEST_ASSERT_EQUAL(3, m_fired[1]);
+    TEST_ASSERT_EQUAL(2, m_fired[2]);
+    TEST_ASSERT_EQUAL(0, m_fired[3]);
+    TEST_ASSERT_EQUAL(1100, m_fired_at[0]);
+    TEST_ASSERT_EQUAL(1500, m_fired_at[3]);
+    TEST_ASSERT(!m_timer_running);
+    TEST_ASSERT(!timer_sch_is_scheduled(&m_events[0]));
+}
+
+static void test_abort(void)
+{
+    reset(0);
+    schedule(0, 100, 0);
+    schedule(1, 200, 0);
+    schedule(2, 300, 0);
+
+    /* Aborting the first event moves the timer to the next one. */
+    timer_sch_abort(&m_events[0]);
+    TEST_ASSERT_EQUAL(200, m_timer_timestamp);
+    TEST_ASSERT(!timer_sch_is_scheduled(&m_events[0]));
+    timer_sch_abort(&m_events[2]);
+    TEST_ASSERT_EQUAL(200, m_timer_timestamp);
+    /* Aborting an event that is not pending has no effect. */
+    timer_sch_abort(&m_events[2]);
+    timer_sch_abort(&m_events[3]);
+
+    clock_run(1000);
+    TEST_ASSERT_EQUAL(1, m_fired_count);
+    TEST_ASSERT_EQUAL(1, m_fired[0]);
+    timer_sch_abort(&m_events[1]);
+    TEST_ASSERT(!m_timer_running);
+}
+
+static void test_reschedule(void)
+{
+    reset(0);
+    schedule(0, 100, 0);
+    schedule(1, 200, 0);
+
+    /* Moving the first event later hands the timer to the next one. */
+    timer_sch_reschedule(&m_events[0], 500);
+    TEST_ASSERT_EQUAL(200, m_timer_timestamp);
+    timer_sch_reschedule(&m_events[1], 50);
+    TEST_ASSERT_EQUAL(50, m_timer_timestamp);
+    timer_sch_reschedule(&m_events[1], 80);
+    TEST_ASSERT_EQUAL(80, m_timer_timestamp);
+    /* Scheduling a pending event again only changes its expiry. */
+    m_events[0].timestamp = 60;
+    timer_sch_schedule(&m_events[0]);
+    TEST_ASSERT_EQUAL(60, m_timer_timestamp);
+
+    clock_run(1000);
+    TEST_ASSERT_EQUAL(2, m_fired_count);
+    TEST_ASSERT_EQUAL(0, m_fired[0]);
+    TEST_ASSERT_EQUAL(1, m_fired[1]);
+    TEST_ASSERT_EQUAL(80, m_fired_at[1]);
+}
+
+static void test_periodic(void)
+{
+    reset(0);
+    schedule(0, 100, 100);
+    schedule(1, 250, 0);
+    clock_run(450);
+    /* 100, 200, 250 (one shot), 300, 400 */
+    TEST_ASSERT_EQUAL(5, m_fired_count);
+    TEST_ASSERT_EQUAL(1, m_fired[2]);
+    TEST_ASSERT_EQUAL(400, m_fired_at[4]);
+    TEST_ASSERT(timer_sch_is_scheduled(&m_events[0]));
+    TEST_ASSERT_EQUAL(500, m_timer_timestamp);
+
+    /* A periodic event aborted from its own callback is not put back. */
+    mp_abort_in_cb = &m_events[0];
+    clock_run(1000);
+    TEST_ASSERT_EQUAL(6, m_fired_count);
+    TEST_ASSERT(!timer_sch_is_scheduled(&m_events[0]));
+    TEST_ASSERT(!m_timer_running);
+}
+
+static void test_schedule_from_callback(void)
+{
+    reset(0);
+    schedule(0, 100, 0);
+    schedule(1, 300, 0);
+    /* The callback of event 0 schedules event 2 ahead of event 1. */
+    mp_schedule_in_cb = &m_events[2];
+    m_schedule_in_cb_timestamp = 150;
+    clock_run(120);
+    TEST_ASSERT_EQUAL(1, m_fired_count);
+    TEST_ASSERT_EQUAL(150, m_timer_timestamp);
+
+    mp_schedule_in_cb = &m_events[2];
+    m_schedule_in_cb_timestamp = 200;
+    clock_run(1000);
+    /* Event 2 rescheduled itself from its own callback, so it fires twice. */
+    TEST_ASSERT_EQUAL(4, m_fired_count);
+    TEST_ASSERT_EQUAL(2, m_fired[1]);
+    TEST_ASSERT_EQUAL(2, m_fired[2]);
+    TEST_ASSERT_EQUAL(200, m_fired_at[2]);
+    TEST_ASSERT_EQUAL(1, m_fired[3]);
+}
+
+/* Timeouts on both sides of the timestamp wrap are ordered by time to expiry. */
+static void test_wrap(void)
+{
+    reset(0xFFFFFF00u);
+    schedule(0, 0x300, 0);
+    schedule(1, 0x80, 0);
+    schedule(2, 0x180, 0);
+    TEST_ASSERT_EQUAL(0xFFFFFF80u, m_timer_timestamp);
+    clock_run(0x1000);
+    TEST_ASSERT_EQUAL(3, m_fired_count);
+    TEST_ASSERT_EQUAL(1, m_fired[0]);
+    TEST_ASSERT_EQUAL(2, m_fired[1]);
+    TEST_ASSERT_EQUAL(0, m_fired[2]);
+    TEST_ASSERT_EQUAL(0x200, m_fired_at[2]);
+}
+
+static void test_stats(void)
+{
+    reset(0);
+    timer_sch_stats_t stats;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        schedule(i, 100 * (i + 1), 0);
+    }
+    timer_sch_abort(&m_events[9]);
+    timer_sch_stats_get(&stats);
+    TEST_ASSERT_EQUAL(9, stats.pending);
+    TEST_ASSERT_EQUAL(10, stats.pending_hwm);
+    TEST_ASSERT_EQUAL(0, stats.fired);
+
+    m_flag_latency_us = 70;
+    clock_run(350);
+    timer_sch_stats_get(&stats);
+    /* Every timeout is handled 70 us late: 100 at 170, 200 at 270 and 300 at 370. */
+    TEST_ASSERT_EQUAL(6, stats.pending);
+    TEST_ASSERT_EQUAL(10, stats.pending_hwm);
+    TEST_ASSERT_EQUAL(3, stats.fired);
+    TEST_ASSERT_EQUAL(70, stats.skew_max_us);
+    TEST_ASSERT_EQUAL(170, m_fired_at[0]);
+}
+
+/* Every slot in use, fired in order. */
+static void test_full(void)
+{
+    unsigned state = 32;
+    reset(0);
+    for (uint32_t i = 0; i < EVENTS_MAX; ++i)
+    {
+        schedule(i, 1 + test_rand(&state) % 100000, 0);
+    }
+    timer_sch_stats_t stats;
+    timer_sch_stats_get(&stats);
+    TEST_ASSERT_EQUAL(EVENTS_MAX, stats.pending_hwm);
+
+    clock_run(200000);
+    TEST_ASSERT_EQUAL(EVENTS_MAX, m_fired_count);
+    for (uint32_t i = 0; i < EVENTS_MAX; ++i)
+    {
+        TEST_ASSERT_EQUAL(m_events[m_fired[i]].timestamp, m_fired_at[i]);
+        if (i > 0)
+        {
+            TEST_ASSERT(m_fired_at[i - 1] <= m_fired_at[i]);
+        }
+    }
+}
+
+/* Random schedule, reschedule, abort and clock steps, against the expiry of every event. */
+static void test_random(void)
+{
+    static bool pending[EVENTS_MAX];
+    static timestamp_t expiry[EVENTS_MAX];
+    unsigned state = 2032;
+    reset(0xFFF00000u);
+    memset(pending, 0, sizeof(pending));
+
+    for (uint32_t step = 0; step < 200000; ++step)
+    {
+        uint32_t index = test_rand(&state) % EVENTS_MAX;
+        uint32_t op = test_rand(&state) % 8;
+        if (op < 3)
+        {
+            schedule(index, 1 + test_rand(&state) % 50000, 0);
+            pending[index] = true;
+            expiry[index] = m_events[index].timestamp;
+        }
+        else if (op < 5)
+        {
+            timestamp_t timestamp = m_now + 1 + test_rand(&state) % 50000;
+            timer_sch_reschedule(&m_events[index], timestamp);
+            pending[index] = true;
+            expiry[index] = timestamp;
+        }
+        else if (op < 6)
+        {
+            timer_sch_abort(&m_events[index]);
+            pending[index] = false;
+        }
+        else
+        {
+            timestamp_t until = m_now + test_rand(&state) % 20000;
+            m_fired_count = 0;
+            clock_run(until);
+            timestamp_t previous = 0;
+            for (uint32_t i = 0; i < m_fired_count; ++i)
+            {
+                uint32_t fired = m_fired[i];
+                TEST_ASSERT(pending[fired]);
+                TEST_ASSERT_EQUAL(expiry[fired], m_fired_at[i]);
+                TEST_ASSERT(i == 0 || (int32_t) (m_fired_at[i] - previous) >= 0);
+                previous = m_fired_at[i];
+                pending[fired] = false;
+            }
+            for (uint32_t i = 0; i < EVENTS_MAX; ++i)
+            {
+                TEST_ASSERT(!pending[i] || (int32_t) (expiry[i] - until) > 0);
+            }
+        }
+
+        /* The timer is always programmed for the first pending expiry. */
+        bool any = false;
+        timestamp_t first = 0;
+        for (uint32_t i = 0; i < EVENTS_MAX; ++i)
+        {
+            TEST_ASSERT_EQUAL(pending[i], timer_sch_is_scheduled(&m_events[i]));
+            if (pending[i] && (!any || (int32_t) (expiry[i] - first) < 0))
+            {
+                first = expiry[i];
+                any = true;
+            }
+        }
+        TEST_ASSERT_EQUAL(any, m_timer_running);
+        if (any)
+        {
+            TEST_ASSERT_EQUAL(first, m_timer_timestamp);
+        }
+    }
+}
+
+int main(void)
+{
+    TEST_RUN(test_order);
+    TEST_RUN(test_abort);
+    TEST_RUN(test_reschedule);
+    TEST_RUN(test_periodic);
+    TEST_RUN(test_schedule_from_callback);
+    TEST_RUN(test_wrap);
+    TEST_RUN(test_stats);
+    TEST_RUN(test_full);
+    TEST_RUN(test_random);
+    return 0;
+}